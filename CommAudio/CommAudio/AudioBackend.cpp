@@ -0,0 +1,817 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		AudioBackend.cpp - Where the program gets the devices it plays and captures audio with.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					AudioSink(QObject * parent = nullptr)
+--					AudioSource(QObject * parent = nullptr)
+--					static void Select(Backends backend, bool realTime, const QString & folder = QString())
+--					static Backends Backend(QAudio::Mode mode)
+--					static bool RealTime()
+--					static QString Folder()
+--					static AudioSink * CreateSink(const QAudioFormat & format, const QString & name,
+--						QObject * parent = nullptr)
+--					static AudioSource * CreateSource(const QAudioFormat & format, const QString & name,
+--						QObject * parent = nullptr)
+--					static QAudioFormat NearestFormat(const QAudioFormat & format, QAudio::Mode mode)
+--					static Settings & settings()
+--					QtAudioSink(const QAudioFormat & format, QObject * parent = nullptr)
+--					QAudioFormat QtAudioSink::format() const
+--					void QtAudioSink::start(QIODevice * device)
+--					void QtAudioSink::stop()
+--					void QtAudioSink::suspend()
+--					void QtAudioSink::resume()
+--					QAudio::State QtAudioSink::state() const
+--					QAudio::Error QtAudioSink::error() const
+--					qint64 QtAudioSink::processedUSecs() const
+--					void QtAudioSink::setBufferSize(int bytes)
+--					int QtAudioSink::bufferSize() const
+--					int QtAudioSink::bytesFree() const
+--					void QtAudioSink::setNotifyInterval(int ms)
+--					void QtAudioSink::setVolume(qreal volume)
+--					qreal QtAudioSink::volume() const
+--					QtAudioSource(const QAudioFormat & format, QObject * parent = nullptr)
+--					QAudioFormat QtAudioSource::format() const
+--					QIODevice * QtAudioSource::start()
+--					void QtAudioSource::stop()
+--					void QtAudioSource::setBufferSize(int bytes)
+--					void QtAudioSource::setNotifyInterval(int ms)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The media player and the voip module never make a QAudioOutput or QAudioInput themselves. They ask
+--					for an AudioSink or AudioSource by name and get one from the backend that is selected:
+--						QtBackend:		The default sound card through Qt Multimedia.
+--						NullBackend:	Audio is pulled and thrown away, capture is silence.
+--						WavBackend:		Each sink writes <name>.wav into the folder and each source loops <name>.wav
+--										from it.
+--
+--					The headless backends either keep to the clock, so buffering and latency behave as they would on a
+--					sound card, or run as fast as they are fed for throughput tests.
+--
+--					The backend is read from the environment the first time it is needed:
+--						COMMAUDIO_AUDIO:		qt, null or wav.
+--						COMMAUDIO_AUDIO_PACE:	realtime or fast.
+--						COMMAUDIO_AUDIO_FOLDER:	The folder of the wav backend, the working directory by default.
+--					If the Qt backend is selected but the machine has no device for a direction, the null backend is
+--					used for it instead, so the program still runs on a box without sound hardware.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "AudioBackend.h"
+#include "HeadlessAudio.h"
+
+#include <QDebug>
+#include <QDir>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AudioSink
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		AudioSink (QObject * parent)
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+AudioSink::AudioSink(QObject * parent)
+	: QObject(parent)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AudioSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		AudioSource (QObject * parent)
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+AudioSource::AudioSource(QObject * parent)
+	: QObject(parent)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Select
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Select (Backends backend, bool realTime, const QString & folder)
+--						Backends backend: The backend to create devices from.
+--						bool realTime: Whether the headless backends keep to the clock.
+--						QString folder: Where the wav backend reads and writes its files, the working directory if
+--										empty.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Overrides the environment. Has to be called before any device is created, devices that already
+--					exist keep the backend they were made with.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioBackend::Select(Backends backend, bool realTime, const QString & folder)
+{
+	Settings & current = settings();
+
+	current.backend = backend;
+	current.realTime = realTime;
+	current.folder = folder.isEmpty() ? QDir::currentPath() : folder;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Backend
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Backend (QAudio::Mode mode)
+--						QAudio::Mode mode: Whether the device plays or captures.
+--
+-- RETURNS:			The backend devices for the direction are created from.
+----------------------------------------------------------------------------------------------------------------------*/
+AudioBackend::Backends AudioBackend::Backend(QAudio::Mode mode)
+{
+	Backends backend = settings().backend;
+
+	if (backend == QtBackend)
+	{
+		QAudioDeviceInfo device = mode == QAudio::AudioOutput
+			? QAudioDeviceInfo::defaultOutputDevice()
+			: QAudioDeviceInfo::defaultInputDevice();
+
+		if (device.isNull())
+		{
+			return NullBackend;
+		}
+	}
+
+	return backend;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RealTime
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RealTime ()
+--
+-- RETURNS:			True if the headless backends play and capture at the rate of the format, false if they run as
+--					fast as they can.
+----------------------------------------------------------------------------------------------------------------------*/
+bool AudioBackend::RealTime()
+{
+	return settings().realTime;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Folder
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Folder ()
+--
+-- RETURNS:			The folder the wav backend reads and writes its files in.
+----------------------------------------------------------------------------------------------------------------------*/
+QString AudioBackend::Folder()
+{
+	return settings().folder;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CreateSink
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		CreateSink (const QAudioFormat & format, const QString & name, QObject * parent)
+--						const QAudioFormat & format: The format the sink plays.
+--						const QString & name: What is played on it, the name of its file on the wav backend.
+--						QObject * parent: The parent of the sink.
+--
+-- RETURNS:			A new sink from the selected backend.
+----------------------------------------------------------------------------------------------------------------------*/
+AudioSink * AudioBackend::CreateSink(const QAudioFormat & format, const QString & name, QObject * parent)
+{
+	switch (Backend(QAudio::AudioOutput))
+	{
+	case QtBackend:
+		return new QtAudioSink(format, parent);
+	case WavBackend:
+		return new WavSink(format, RealTime(), QDir(Folder()).filePath(name + ".wav"), parent);
+	default:
+		if (settings().backend == QtBackend)
+		{
+			qWarning() << "No audio output device," << name << "is played on the null backend.";
+		}
+		return new NullSink(format, RealTime(), parent);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CreateSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		CreateSource (const QAudioFormat & format, const QString & name, QObject * parent)
+--						const QAudioFormat & format: The format the source captures.
+--						const QString & name: What is captured from it, the name of its file on the wav backend.
+--						QObject * parent: The parent of the source.
+--
+-- RETURNS:			A new source from the selected backend.
+----------------------------------------------------------------------------------------------------------------------*/
+AudioSource * AudioBackend::CreateSource(const QAudioFormat & format, const QString & name, QObject * parent)
+{
+	switch (Backend(QAudio::AudioInput))
+	{
+	case QtBackend:
+		return new QtAudioSource(format, parent);
+	case WavBackend:
+		return new WavSource(format, RealTime(), QDir(Folder()).filePath(name + ".wav"), parent);
+	default:
+		if (settings().backend == QtBackend)
+		{
+			qWarning() << "No audio input device," << name << "is captured from the null backend.";
+		}
+		return new NullSource(format, RealTime(), parent);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NearestFormat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		NearestFormat (const QAudioFormat & format, QAudio::Mode mode)
+--						const QAudioFormat & format: The format that is wanted.
+--						QAudio::Mode mode: Whether it is to be played or captured.
+--
+-- RETURNS:			The format itself if the backend can use it, otherwise the closest format it can.
+--
+-- NOTES:
+--					The headless backends take any format.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat AudioBackend::NearestFormat(const QAudioFormat & format, QAudio::Mode mode)
+{
+	if (Backend(mode) != QtBackend)
+	{
+		return format;
+	}
+
+	QAudioDeviceInfo device = mode == QAudio::AudioOutput
+		? QAudioDeviceInfo::defaultOutputDevice()
+		: QAudioDeviceInfo::defaultInputDevice();
+
+	if (device.isFormatSupported(format))
+	{
+		return format;
+	}
+
+	return device.nearestFormat(format);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		settings
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		settings ()
+--
+-- RETURNS:			The selected backend, read from the environment the first time.
+----------------------------------------------------------------------------------------------------------------------*/
+AudioBackend::Settings & AudioBackend::settings()
+{
+	static Settings current = []()
+	{
+		Settings loaded;
+		QString backend = qgetenv("COMMAUDIO_AUDIO").toLower();
+		QString folder = qgetenv("COMMAUDIO_AUDIO_FOLDER");
+
+		if (backend == "null")
+		{
+			loaded.backend = NullBackend;
+		}
+		else if (backend == "wav")
+		{
+			loaded.backend = WavBackend;
+		}
+		else
+		{
+			loaded.backend = QtBackend;
+		}
+
+		loaded.realTime = qgetenv("COMMAUDIO_AUDIO_PACE").toLower() != "fast";
+		loaded.folder = folder.isEmpty() ? QDir::currentPath() : folder;
+
+		return loaded;
+	}();
+
+	return current;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		QtAudioSink (const QAudioFormat & format, QObject * parent)
+--						const QAudioFormat & format: The format to play.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Plays on the default output device. Every other function of the sink passes straight through to
+--					the QAudioOutput, and its signals are forwarded.
+----------------------------------------------------------------------------------------------------------------------*/
+QtAudioSink::QtAudioSink(const QAudioFormat & format, QObject * parent)
+	: AudioSink(parent)
+	, mOutput(new QAudioOutput(format, this))
+{
+	connect(mOutput, &QAudioOutput::stateChanged, this, &AudioSink::stateChanged);
+	connect(mOutput, &QAudioOutput::notify, this, &AudioSink::notify);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		format ()
+--
+-- RETURNS:			The format the device was opened with.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat QtAudioSink::format() const
+{
+	return mOutput->format();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::start
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		start (QIODevice * device)
+--						QIODevice * device: The device to pull audio from.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSink::start(QIODevice * device)
+{
+	mOutput->start(device);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::stop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		stop ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSink::stop()
+{
+	mOutput->stop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::suspend
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		suspend ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSink::suspend()
+{
+	mOutput->suspend();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::resume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		resume ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSink::resume()
+{
+	mOutput->resume();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::state
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		state ()
+--
+-- RETURNS:			The state of the output.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudio::State QtAudioSink::state() const
+{
+	return mOutput->state();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::error
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		error ()
+--
+-- RETURNS:			The last error of the output.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudio::Error QtAudioSink::error() const
+{
+	return mOutput->error();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::processedUSecs
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		processedUSecs ()
+--
+-- RETURNS:			The microseconds of audio played since the output was started.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 QtAudioSink::processedUSecs() const
+{
+	return mOutput->processedUSecs();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::setBufferSize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setBufferSize (int bytes)
+--						int bytes: The size of the device buffer, used on the next start.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSink::setBufferSize(int bytes)
+{
+	mOutput->setBufferSize(bytes);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::bufferSize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bufferSize ()
+--
+-- RETURNS:			The size of the device buffer in bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+int QtAudioSink::bufferSize() const
+{
+	return mOutput->bufferSize();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::bytesFree
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bytesFree ()
+--
+-- RETURNS:			The bytes of the device buffer that can be filled.
+----------------------------------------------------------------------------------------------------------------------*/
+int QtAudioSink::bytesFree() const
+{
+	return mOutput->bytesFree();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::setNotifyInterval
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setNotifyInterval (int ms)
+--						int ms: How often notify is emitted.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSink::setNotifyInterval(int ms)
+{
+	mOutput->setNotifyInterval(ms);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::setVolume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setVolume (qreal volume)
+--						qreal volume: The volume from 0 to 1.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSink::setVolume(qreal volume)
+{
+	mOutput->setVolume(volume);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSink::volume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		volume ()
+--
+-- RETURNS:			The volume from 0 to 1.
+----------------------------------------------------------------------------------------------------------------------*/
+qreal QtAudioSink::volume() const
+{
+	return mOutput->volume();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		QtAudioSource (const QAudioFormat & format, QObject * parent)
+--						const QAudioFormat & format: The format to capture.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Captures from the default input device. Every other function of the source passes straight
+--					through to the QAudioInput.
+----------------------------------------------------------------------------------------------------------------------*/
+QtAudioSource::QtAudioSource(const QAudioFormat & format, QObject * parent)
+	: AudioSource(parent)
+	, mInput(new QAudioInput(format, this))
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSource::format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		format ()
+--
+-- RETURNS:			The format the device was opened with.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat QtAudioSource::format() const
+{
+	return mInput->format();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSource::start
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		start ()
+--
+-- RETURNS:			The device the captured audio is read from.
+----------------------------------------------------------------------------------------------------------------------*/
+QIODevice * QtAudioSource::start()
+{
+	return mInput->start();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSource::stop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		stop ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSource::stop()
+{
+	mInput->stop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSource::setBufferSize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setBufferSize (int bytes)
+--						int bytes: The size of the device buffer, used on the next start.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSource::setBufferSize(int bytes)
+{
+	mInput->setBufferSize(bytes);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QtAudioSource::setNotifyInterval
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setNotifyInterval (int ms)
+--						int ms: How often notify is emitted.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void QtAudioSource::setNotifyInterval(int ms)
+{
+	mInput->setNotifyInterval(ms);
+}
\ No newline at end of file
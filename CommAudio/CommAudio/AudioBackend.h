@@ -0,0 +1,135 @@
+#pragma once
+
+#include <QAudioDeviceInfo>
+#include <QAudioFormat>
+#include <QAudioInput>
+#include <QAudioOutput>
+#include <QIODevice>
+#include <QObject>
+#include <QString>
+
+#include "globals.h"
+
+// Plays audio pulled from a device, the part of QAudioOutput the program uses
+class AudioSink : public QObject
+{
+	Q_OBJECT
+
+public:
+	AudioSink(QObject * parent = nullptr);
+	virtual ~AudioSink() = default;
+
+	virtual QAudioFormat format() const = 0;
+	virtual void start(QIODevice * device) = 0;
+	virtual void stop() = 0;
+	virtual void suspend() = 0;
+	virtual void resume() = 0;
+
+	virtual QAudio::State state() const = 0;
+	virtual QAudio::Error error() const = 0;
+	virtual qint64 processedUSecs() const = 0;
+
+	virtual void setBufferSize(int bytes) = 0;
+	virtual int bufferSize() const = 0;
+	virtual int bytesFree() const = 0;
+	virtual void setNotifyInterval(int ms) = 0;
+	virtual void setVolume(qreal volume) = 0;
+	virtual qreal volume() const = 0;
+
+signals:
+	void stateChanged(QAudio::State state);
+	void notify();
+};
+
+// Captures audio into a device it hands out, the part of QAudioInput the program uses
+class AudioSource : public QObject
+{
+	Q_OBJECT
+
+public:
+	AudioSource(QObject * parent = nullptr);
+	virtual ~AudioSource() = default;
+
+	virtual QAudioFormat format() const = 0;
+	virtual QIODevice * start() = 0;
+	virtual void stop() = 0;
+
+	virtual void setBufferSize(int bytes) = 0;
+	virtual void setNotifyInterval(int ms) = 0;
+};
+
+class AudioBackend
+{
+public:
+	enum Backends
+	{
+		QtBackend,
+		NullBackend,
+		WavBackend
+	};
+
+	static void Select(Backends backend, bool realTime, const QString & folder = QString());
+	static Backends Backend(QAudio::Mode mode);
+	static bool RealTime();
+	static QString Folder();
+
+	static AudioSink * CreateSink(const QAudioFormat & format, const QString & name, QObject * parent = nullptr);
+	static AudioSource * CreateSource(const QAudioFormat & format, const QString & name, QObject * parent = nullptr);
+	static QAudioFormat NearestFormat(const QAudioFormat & format, QAudio::Mode mode);
+
+private:
+	struct Settings
+	{
+		Backends backend;
+		bool realTime;
+		QString folder;
+	};
+
+	static Settings & settings();
+};
+
+class QtAudioSink : public AudioSink
+{
+	Q_OBJECT
+
+public:
+	QtAudioSink(const QAudioFormat & format, QObject * parent = nullptr);
+
+	QAudioFormat format() const override;
+	void start(QIODevice * device) override;
+	void stop() override;
+	void suspend() override;
+	void resume() override;
+
+	QAudio::State state() const override;
+	QAudio::Error error() const override;
+	qint64 processedUSecs() const override;
+
+	void setBufferSize(int bytes) override;
+	int bufferSize() const override;
+	int bytesFree() const override;
+	void setNotifyInterval(int ms) override;
+	void setVolume(qreal volume) override;
+	qreal volume() const override;
+
+private:
+	QAudioOutput * mOutput;
+};
+
+class QtAudioSource : public AudioSource
+{
+	Q_OBJECT
+
+public:
+	QtAudioSource(const QAudioFormat & format, QObject * parent = nullptr);
+
+	QAudioFormat format() const override;
+	QIODevice * start() override;
+	void stop() override;
+
+	void setBufferSize(int bytes) override;
+	void setNotifyInterval(int ms) override;
+
+private:
+	QAudioInput * mInput;
+};
\ No newline at end of file
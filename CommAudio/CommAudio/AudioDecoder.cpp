@@ -0,0 +1,1002 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		AudioDecoder.cpp - Plays compressed songs as if they were wav files.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					qint64 AudioDecoder::Duration() const
+--					static AudioDecoder * AudioDecoder::Create(const uchar * data, qint64 size)
+--					DecodeThread(AudioDecoder * decoder, int bufferBytes, QObject * parent = nullptr)
+--					~DecodeThread()
+--					void Start(qint64 frame)
+--					void Stop()
+--					int Read(char * data, int size)
+--					int Skip(int size)
+--					int Available() const
+--					bool Finished() const
+--					void run()
+--					DecodedSong(const QString & fileName, QObject * parent = nullptr)
+--					~DecodedSong()
+--					bool open(OpenMode mode)
+--					void close()
+--					qint64 size() const
+--					bool seek(qint64 pos)
+--					qint64 bytesAvailable() const
+--					const uchar * Data() const
+--					static MappedSong * Create(const QString & fileName, QObject * parent = nullptr)
+--					qint64 readData(char * data, qint64 maxSize)
+--					void restart(qint64 frame)
+--					SongReader()
+--					~SongReader()
+--					bool SongReader::Open(const QString & fileName)
+--					void SongReader::Close()
+--					int SongReader::Read(qint16 * out, int frames)
+--					const QAudioFormat & SongReader::Format() const
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Added SongReader for reading through a whole song as 16 bit samples.
+--					October 19, 2026 - agent: A read never waits for the decode thread.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					A DecodedSong is a MappedSong whose reads give a 44 byte wav header followed by the decoded audio,
+--					so everything that plays, streams or parses wav files takes a compressed song without knowing it.
+--					The audio is decoded by a DecodeThread into a ring buffer that holds DECODE_AHEAD_MS of it, which
+--					keeps the decoding off the audio thread and smooths over frames that take longer to decode. A read
+--					only takes what is already in the ring and never waits for the decoder, since it is made on the
+--					audio thread, so a decoder that falls behind is heard as a gap rather than holding up the device.
+--					A reader that wants whole blocks, like an upload on the GUI thread, can go by bytesAvailable, which
+--					only counts what has been decoded, and carry on when readyRead says there is more.
+--
+--					A seek to audio that is already in the ring skips to it. Any other seek stops the thread, seeks
+--					the decoder and starts decoding again from there.
+--
+--					A SongReader is for work that goes through a song once from start to end, like drawing its
+--					waveform or measuring its loudness. It reads a wav file straight out of a mapping and decodes a
+--					compressed song on the calling thread, since there is nothing to keep ahead of.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "AudioDecoder.h"
+#include "FlacDecoder.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Duration
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Duration ()
+--
+-- RETURNS:			The length of the song in microseconds.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 AudioDecoder::Duration() const
+{
+	int sampleRate = Format().sampleRate();
+
+	return sampleRate > 0 ? Frames() * 1000000 / sampleRate : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Create
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Create (const uchar * data, qint64 size)
+--						const uchar * data: The start of the file.
+--						qint64 size: How many bytes of the file data holds.
+--
+-- RETURNS:			A decoder for the file that has yet to be opened, or nullptr if no decoder knows the file.
+--
+-- NOTES:
+--					Only looks at the magic number of the file. The caller owns the decoder.
+----------------------------------------------------------------------------------------------------------------------*/
+AudioDecoder * AudioDecoder::Create(const uchar * data, qint64 size)
+{
+	if (FlacDecoder::StreamStart(data, size) >= 0)
+	{
+		return new FlacDecoder();
+	}
+
+	return nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DecodeThread
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DecodeThread (AudioDecoder * decoder, int bufferBytes, QObject * parent)
+--						AudioDecoder * decoder: The open decoder to run, which is only used by the thread while it
+--							runs.
+--						int bufferBytes: How much decoded audio to keep ahead of the reader.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The ring always has room for at least two chunks, since the thread only decodes a chunk once
+--					there is room for all of it.
+----------------------------------------------------------------------------------------------------------------------*/
+DecodeThread::DecodeThread(AudioDecoder * decoder, int bufferBytes, QObject * parent)
+	: QThread(parent)
+	, mDecoder(decoder)
+	, mRing(qMax(bufferBytes, 2 * DECODE_CHUNK_FRAMES * decoder->Format().bytesPerFrame()))
+	, mFrameBytes(decoder->Format().bytesPerFrame())
+	, mFinished(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~DecodeThread
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~DecodeThread ()
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+DecodeThread::~DecodeThread()
+{
+	Stop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Start
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Start (qint64 frame)
+--						qint64 frame: The frame to start decoding from.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Throws away whatever was decoded before, so nothing that is read after this is from before the
+--					frame.
+----------------------------------------------------------------------------------------------------------------------*/
+void DecodeThread::Start(qint64 frame)
+{
+	Stop();
+
+	mRing.Clear();
+	mDecoder->Seek(frame);
+	mFinished.store(0);
+
+	start();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Stop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Stop ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Wakes the thread if it is waiting for room and waits for it to finish, after which the decoder is
+--					not in use.
+----------------------------------------------------------------------------------------------------------------------*/
+void DecodeThread::Stop()
+{
+	if (!isRunning())
+	{
+		return;
+	}
+
+	requestInterruption();
+
+	mMutex.lock();
+	mConsumed.wakeAll();
+	mMutex.unlock();
+
+	wait();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Read
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Never waits for the decoder.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Read (char * data, int size)
+--						char * data: The buffer to fill.
+--						int size: The size of the buffer.
+--
+-- RETURNS:			The number of bytes read, which is 0 if nothing has been decoded yet.
+--
+-- NOTES:
+--					Takes no lock and does not wake the thread, which finds the room by itself, so this can be called
+--					from the audio thread.
+----------------------------------------------------------------------------------------------------------------------*/
+int DecodeThread::Read(char * data, int size)
+{
+	return mRing.Read(data, size);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Skip
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Does not wake the thread.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Skip (int size)
+--						int size: How many decoded bytes to throw away.
+--
+-- RETURNS:			The number of bytes thrown away, no more than were waiting.
+----------------------------------------------------------------------------------------------------------------------*/
+int DecodeThread::Skip(int size)
+{
+	return mRing.Skip(size);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Available
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Available ()
+--
+-- RETURNS:			The number of decoded bytes waiting to be read.
+----------------------------------------------------------------------------------------------------------------------*/
+int DecodeThread::Available() const
+{
+	return mRing.Available();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Finished
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Finished ()
+--
+-- RETURNS:			True once the decoder has reached the end of the song, after which nothing more is written.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DecodeThread::Finished() const
+{
+	return mFinished.loadAcquire() != 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		run
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Sleeps a little at a time while the ring is full.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		run ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Decodes DECODE_CHUNK_FRAMES at a time. While the ring has no room for a chunk the thread sleeps
+--					for DECODE_WAIT_MS at a time, since the reader never wakes it. Stop wakes it straight away. Every
+--					chunk, and the end of the song, is signalled with decoded for readers on other threads.
+----------------------------------------------------------------------------------------------------------------------*/
+void DecodeThread::run()
+{
+	QByteArray chunk(DECODE_CHUNK_FRAMES * mFrameBytes, 0);
+
+	while (!isInterruptionRequested())
+	{
+		mMutex.lock();
+		while (mRing.Free() < chunk.size() && !isInterruptionRequested())
+		{
+			mConsumed.wait(&mMutex, DECODE_WAIT_MS);
+		}
+		mMutex.unlock();
+
+		if (isInterruptionRequested())
+		{
+			break;
+		}
+
+		int frames = mDecoder->Decode(chunk.data(), DECODE_CHUNK_FRAMES);
+		if (frames > 0)
+		{
+			mRing.Write(chunk.constData(), frames * mFrameBytes);
+		}
+		else
+		{
+			mFinished.storeRelease(1);
+		}
+
+		emit decoded();
+
+		if (frames <= 0)
+		{
+			break;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DecodedSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DecodedSong (const QString & fileName, QObject * parent)
+--						const QString & fileName: The compressed song to play.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+DecodedSong::DecodedSong(const QString & fileName, QObject * parent)
+	: MappedSong(fileName, parent)
+	, mDecoder(nullptr)
+	, mThread(nullptr)
+	, mAudioBytes(0)
+	, mFrameBytes(1)
+	, mDecodedPos(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~DecodedSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~DecodedSong ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Stops the decoding before the mapping it reads from goes away.
+----------------------------------------------------------------------------------------------------------------------*/
+DecodedSong::~DecodedSong()
+{
+	close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		open (OpenMode mode)
+--						OpenMode mode: Has to be ReadOnly.
+--
+-- RETURNS:			True if the song could be opened and decoded, otherwise false.
+--
+-- NOTES:
+--					Maps the song, opens a decoder on the mapping and starts decoding from the start. Every chunk the
+--					thread decodes is passed on as readyRead. The wav header is made from the format of the decoder.
+--					A song of more than 4 GB of audio gets the largest data size a wav header can hold, which is taken
+--					to mean the audio runs to the end.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DecodedSong::open(OpenMode mode)
+{
+	if (!MappedSong::open(mode))
+	{
+		return false;
+	}
+
+	const uchar * data = MappedSong::Data();
+	qint64 fileSize = MappedSong::size();
+	mDecoder = data ? AudioDecoder::Create(data, fileSize) : nullptr;
+
+	if (!mDecoder || !mDecoder->Open(data, fileSize))
+	{
+		qWarning() << fileName() << (mDecoder ? mDecoder->ErrorString() : QString("The song could not be mapped"));
+		close();
+		return false;
+	}
+
+	QAudioFormat format = mDecoder->Format();
+	mFrameBytes = format.bytesPerFrame();
+	mAudioBytes = mDecoder->Frames() * mFrameBytes;
+
+	WavHeader header;
+	quint32 dataSize = (quint32)qMin<qint64>(mAudioBytes, 0xFFFFFFFF);
+
+	memcpy(header.id, "RIFF", 4);
+	memcpy(header.wavFormat, "WAVEfmt ", 8);
+	memcpy(header.data, "data", 4);
+	header.totalLength = (int)(quint32)qMin<qint64>(sizeof(WavHeader) - 8 + (qint64)dataSize, 0xFFFFFFFF);
+	header.format = 16;
+	header.pcm = 1;
+	header.channels = format.channelCount();
+	header.sampleRate = format.sampleRate();
+	header.bytesPerSecond = format.sampleRate() * mFrameBytes;
+	header.bytesByCapture = mFrameBytes;
+	header.bitsPerSample = format.sampleSize();
+	header.bytesInData = (int)dataSize;
+
+	mHeader = QByteArray((const char *)&header, sizeof(WavHeader));
+	SetAudio(0, size(), 1);
+
+	mThread = new DecodeThread(mDecoder, format.bytesForDuration(DECODE_AHEAD_MS * 1000), this);
+	connect(mThread, &DecodeThread::decoded, this, &QIODevice::readyRead);
+	restart(0);
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		close
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		close ()
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void DecodedSong::close()
+{
+	delete mThread;
+	mThread = nullptr;
+
+	delete mDecoder;
+	mDecoder = nullptr;
+
+	mHeader.clear();
+	mAudioBytes = 0;
+
+	MappedSong::close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		size
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		size ()
+--
+-- RETURNS:			The size of the wav header and the decoded audio, 0 when the song is not open.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 DecodedSong::size() const
+{
+	return mHeader.size() + mAudioBytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		seek
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		seek (qint64 pos)
+--						qint64 pos: The position to move to.
+--
+-- RETURNS:			True if the position could be moved to, otherwise false.
+--
+-- NOTES:
+--					A position in the audio is moved back to the start of its frame. When the audio there is waiting
+--					in the ring the audio before it is skipped, otherwise decoding starts again from its frame.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DecodedSong::seek(qint64 pos)
+{
+	qint64 start = mHeader.size();
+
+	if (pos > start)
+	{
+		pos -= (pos - start) % mFrameBytes;
+	}
+
+	if (!QIODevice::seek(pos))
+	{
+		return false;
+	}
+
+	if (!mThread)
+	{
+		return true;
+	}
+
+	qint64 target = qMax(pos, start);
+
+	if (target >= mDecodedPos && target - mDecodedPos <= mThread->Available())
+	{
+		mDecodedPos += mThread->Skip((int)(target - mDecodedPos));
+	}
+	else
+	{
+		restart((target - start) / mFrameBytes);
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		bytesAvailable
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bytesAvailable ()
+--
+-- RETURNS:			The number of bytes that can be read without waiting on the decoder.
+--
+-- NOTES:
+--					The header, and the rest of a song the decoder has finished, can always be read. Otherwise only
+--					what is waiting in the ring counts. A read from somewhere the decoder is not at has to start it
+--					again anyway, so it is not held back and counts the rest of the song.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 DecodedSong::bytesAvailable() const
+{
+	qint64 position = pos();
+
+	if (!mThread || position < mHeader.size() || position != mDecodedPos || mThread->Finished())
+	{
+		return MappedSong::bytesAvailable();
+	}
+
+	return qMin<qint64>(mThread->Available(), size() - position) + QIODevice::bytesAvailable();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Data
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Data ()
+--
+-- RETURNS:			nullptr, the mapping is of the compressed song and not of what is read, which has to be read
+--					through the device.
+----------------------------------------------------------------------------------------------------------------------*/
+const uchar * DecodedSong::Data() const
+{
+	return nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Create
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Create (const QString & fileName, QObject * parent)
+--						const QString & fileName: The song to play.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			A DecodedSong if a decoder knows the song, otherwise a MappedSong. Neither is open.
+--
+-- NOTES:
+--					The file is mapped to look at its start, since a tag in front of the audio can be of any size.
+----------------------------------------------------------------------------------------------------------------------*/
+MappedSong * DecodedSong::Create(const QString & fileName, QObject * parent)
+{
+	QFile file(fileName);
+	bool compressed = false;
+
+	if (file.open(QFile::ReadOnly) && file.size() > 0)
+	{
+		uchar * view = file.map(0, file.size());
+		if (view)
+		{
+			AudioDecoder * decoder = AudioDecoder::Create(view, file.size());
+			compressed = decoder != nullptr;
+
+			delete decoder;
+			file.unmap(view);
+		}
+	}
+
+	if (compressed)
+	{
+		return new DecodedSong(fileName, parent);
+	}
+
+	return new MappedSong(fileName, parent);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readData (char * data, qint64 maxSize)
+--						char * data: The buffer to fill.
+--						qint64 maxSize: The size of the buffer.
+--
+-- RETURNS:			The number of bytes read, 0 at the end of the audio or if the decoder has fallen behind.
+--
+-- NOTES:
+--					The header is read on its own, so parsing it does not wait on the decoder. Should the decoder stop
+--					short of the length in its header, the rest of the song is silence, so the output still gets to
+--					the end.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 DecodedSong::readData(char * data, qint64 maxSize)
+{
+	qint64 position = pos();
+	qint64 count = qMin(maxSize, size() - position);
+
+	if (count <= 0 || !mThread)
+	{
+		return 0;
+	}
+
+	if (position < mHeader.size())
+	{
+		count = qMin<qint64>(count, mHeader.size() - position);
+		memcpy(data, mHeader.constData() + position, count);
+		return count;
+	}
+
+	if (position != mDecodedPos)
+	{
+		restart((position - mHeader.size()) / mFrameBytes);
+	}
+
+	count = qMin<qint64>(count, mThread->Available() > 0 ? mThread->Available() : DECODE_CHUNK_FRAMES * mFrameBytes);
+	int read = mThread->Read(data, (int)count);
+
+	if (read == 0 && mThread->Finished() && mThread->Available() == 0)
+	{
+		memset(data, 0, count);
+		read = (int)count;
+	}
+
+	mDecodedPos += read;
+
+	return read;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		restart
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		restart (qint64 frame)
+--						qint64 frame: The frame to decode from.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void DecodedSong::restart(qint64 frame)
+{
+	mThread->Start(frame);
+	mDecodedPos = mHeader.size() + frame * mFrameBytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SongReader
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SongReader ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates a reader with no song open.
+----------------------------------------------------------------------------------------------------------------------*/
+SongReader::SongReader()
+	: mView(nullptr)
+	, mDecoder(nullptr)
+	, mAudio(nullptr)
+	, mFrames(0)
+	, mPosition(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~SongReader
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~SongReader ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Closes the song if one is open.
+----------------------------------------------------------------------------------------------------------------------*/
+SongReader::~SongReader()
+{
+	Close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SongReader::Open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Open (const QString & fileName)
+--						const QString & fileName: The song to read.
+--
+-- RETURNS:			True if the song is a wav file or a compressed song that a decoder could open.
+--
+-- NOTES:
+--					Maps the song and parses it as a wav file first, then hands it to an AudioDecoder. A wav file that
+--					is cut short is read up to where it ends. Any song that was open before is closed.
+----------------------------------------------------------------------------------------------------------------------*/
+bool SongReader::Open(const QString & fileName)
+{
+	Close();
+
+	mFile.setFileName(fileName);
+	if (!mFile.open(QFile::ReadOnly) || mFile.size() <= 0)
+	{
+		return false;
+	}
+
+	mView = mFile.map(0, mFile.size());
+	if (mView == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	WavParser wav;
+	if (wav.Parse(mView, mFile.size(), mFile.size()))
+	{
+		mFormat = wav.Format();
+		mAudio = (const char *)mView + wav.DataOffset();
+		mFrames = (qMin(wav.DataEnd(), mFile.size()) - wav.DataOffset()) / qMax(1, mFormat.bytesPerFrame());
+	}
+	else
+	{
+		mDecoder = AudioDecoder::Create(mView, mFile.size());
+		if (mDecoder && mDecoder->Open(mView, mFile.size()))
+		{
+			mFormat = mDecoder->Format();
+		}
+	}
+
+	if (mFormat.sampleRate() <= 0 || mFormat.channelCount() <= 0)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SongReader::Close
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Close ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+void SongReader::Close()
+{
+	delete mDecoder;
+	mDecoder = nullptr;
+
+	if (mView != nullptr)
+	{
+		mFile.unmap((uchar *)mView);
+		mView = nullptr;
+	}
+
+	mFile.close();
+	mFormat = QAudioFormat();
+	mAudio = nullptr;
+	mFrames = 0;
+	mPosition = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SongReader::Read
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Read (qint16 * out, int frames)
+--						qint16 * out: Where the samples are written, room for frames frames of every channel.
+--						int frames: How many frames to read at most.
+--
+-- RETURNS:			The number of frames read, 0 at the end of the song.
+--
+-- NOTES:
+--					Converts the next frames of the song to 16 bit with AudioKernels::ToInt16. A decoder may give back
+--					fewer frames than were asked for before the end of the song.
+----------------------------------------------------------------------------------------------------------------------*/
+int SongReader::Read(qint16 * out, int frames)
+{
+	const char * in;
+	int count;
+
+	if (mDecoder)
+	{
+		if (mDecoded.size() < frames * mFormat.bytesPerFrame())
+		{
+			mDecoded.resize(frames * mFormat.bytesPerFrame());
+		}
+
+		in = mDecoded.constData();
+		count = mDecoder->Decode(mDecoded.data(), frames);
+	}
+	else
+	{
+		in = mAudio + mPosition * mFormat.bytesPerFrame();
+		count = (int)qMin<qint64>(frames, mFrames - mPosition);
+	}
+
+	if (count <= 0)
+	{
+		return 0;
+	}
+
+	AudioKernels::ToInt16(in, count * mFormat.channelCount(), mFormat, out);
+	mPosition += count;
+
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SongReader::Format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Format ()
+--
+-- RETURNS:			The format of the song that is open.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const QAudioFormat & SongReader::Format() const
+{
+	return mFormat;
+}
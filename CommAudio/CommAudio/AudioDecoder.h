@@ -0,0 +1,137 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <cstring>
+
+#include "AudioKernels.h"
+#include "globals.h"
+#include "MappedSong.h"
+#include "RingBuffer.h"
+#include "WavParser.h"
+
+// Turns a compressed song that is held in memory into little endian PCM frames
+class AudioDecoder
+{
+public:
+	virtual ~AudioDecoder() = default;
+
+	virtual bool Open(const uchar * data, qint64 size) = 0;
+	virtual int Decode(char * out, int frames) = 0;
+	virtual bool Seek(qint64 frame) = 0;
+
+	virtual QAudioFormat Format() const = 0;
+	virtual qint64 Frames() const = 0;
+	virtual bool Truncated() const = 0;
+	virtual QString ErrorString() const = 0;
+
+	qint64 Duration() const;
+
+	static AudioDecoder * Create(const uchar * data, qint64 size);
+};
+
+// Decodes a song into a ring buffer on a thread of its own, ahead of whoever reads it
+class DecodeThread : public QThread
+{
+	Q_OBJECT
+
+public:
+	DecodeThread(AudioDecoder * decoder, int bufferBytes, QObject * parent = nullptr);
+	~DecodeThread();
+
+	void Start(qint64 frame);
+	void Stop();
+
+	int Read(char * data, int size);
+	int Skip(int size);
+	int Available() const;
+	bool Finished() const;
+
+signals:
+	void decoded();
+
+protected:
+	void run() override;
+
+private:
+	AudioDecoder * mDecoder;
+	RingBuffer mRing;
+	int mFrameBytes;
+
+	// Only used by the thread to sleep on while the ring is full, the ring buffer itself needs no lock
+	QMutex mMutex;
+	QWaitCondition mConsumed;
+	QAtomicInt mFinished;
+};
+
+// A compressed song read as if it were a wav file of the decoded audio
+class DecodedSong : public MappedSong
+{
+	Q_OBJECT
+
+public:
+	DecodedSong(const QString & fileName, QObject * parent = nullptr);
+	~DecodedSong();
+
+	bool open(OpenMode mode) override;
+	void close() override;
+	qint64 size() const override;
+	bool seek(qint64 pos) override;
+	qint64 bytesAvailable() const override;
+
+	const uchar * Data() const override;
+
+	static MappedSong * Create(const QString & fileName, QObject * parent = nullptr);
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+
+private:
+	AudioDecoder * mDecoder;
+	DecodeThread * mThread;
+	QByteArray mHeader;
+	qint64 mAudioBytes;
+	int mFrameBytes;
+
+	// Where in the song the first byte waiting in the decode thread is
+	qint64 mDecodedPos;
+
+	void restart(qint64 frame);
+};
+
+// Reads the audio of a wav file or a compressed song from start to end as 16 bit samples, for working something out
+// from a whole song
+class SongReader
+{
+public:
+	SongReader();
+	~SongReader();
+
+	bool Open(const QString & fileName);
+	void Close();
+	int Read(qint16 * out, int frames);
+
+	const QAudioFormat & Format() const;
+
+private:
+	QFile mFile;
+	const uchar * mView;
+	AudioDecoder * mDecoder;
+	QAudioFormat mFormat;
+
+	// Where the audio of a wav file is in the mapping, and how much of it has been read
+	const char * mAudio;
+	qint64 mFrames;
+	qint64 mPosition;
+
+	// A compressed song is decoded into this before it is converted
+	QByteArray mDecoded;
+};
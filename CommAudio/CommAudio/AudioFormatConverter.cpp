@@ -0,0 +1,321 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		AudioFormatConverter.cpp - A read only QIODevice that converts PCM audio between formats.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					AudioFormatConverter(QIODevice * source, const QAudioFormat & input, const QAudioFormat & output,
+--						QObject * parent = nullptr)
+--					bool isSequential() const
+--					qint64 bytesAvailable() const
+--					qint64 readData(char * data, qint64 maxSize)
+--					qint64 writeData(const char * data, qint64 maxSize)
+--					void appendInput(const char * in, int frames)
+--					void filter(qint16 * frames, int count, char * out, const QAudioFormat & format)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The audio device is not guaranteed to support the format of every song that is streamed to it.
+--					This class sits between the stream and the QAudioOutput and converts the sample size, sample type,
+--					channel count and sample rate of the stream into a format that the device does support. The
+--					samples are converted and the channels mapped with AudioKernels. The sample rate is converted with
+--					AudioKernels::ResampleCubic, carrying the position and the frames it still needs from one read to
+--					the next. Going down in rate the audio is low-passed first, so what is above half the new rate
+--					does not fold back into what is heard. Going up in rate it is low-passed after, which takes out
+--					the images the interpolation leaves above half the old rate.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "AudioFormatConverter.h"
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AudioFormatConverter
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		AudioFormatConverter (QIODevice * source, const QAudioFormat & input, const QAudioFormat & output,
+--						QObject * parent)
+--						QIODevice * source: The device that the raw audio is read from.
+--						const QAudioFormat & input: The format of the audio in the source.
+--						const QAudioFormat & output: The format that the audio will be converted into.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates the converter and opens it for reading. The readyRead signal of the source is forwarded
+--					so that anything pulling from the converter knows when there is new data. The low-pass is worked
+--					out at the higher of the two rates, since that is the side it runs on. The resampler starts with
+--					one silent frame before the first frame of the source.
+----------------------------------------------------------------------------------------------------------------------*/
+AudioFormatConverter::AudioFormatConverter(QIODevice * source, const QAudioFormat & input, const QAudioFormat & output,
+	QObject * parent)
+	: QIODevice(parent)
+	, mSource(source)
+	, mInput(input)
+	, mOutput(output)
+	, mWorking(output)
+	, mStep((double)input.sampleRate() / (double)output.sampleRate())
+	, mPosition(0)
+	, mPending(output.channelCount(), 0)
+	, mPendingFrames(1)
+	, mFilter(CONVERTER_SECTIONS * output.channelCount() * 2, 0)
+{
+	mWorking.setSampleSize(16);
+	mWorking.setSampleType(QAudioFormat::SignedInt);
+
+	if (input.sampleRate() != output.sampleRate())
+	{
+		mCoefs.resize(CONVERTER_SECTIONS * 5);
+		AudioKernels::LowPass(qMin(input.sampleRate(), output.sampleRate()) * CONVERTER_CUTOFF,
+			input.sampleRate() < output.sampleRate() ? output.sampleRate() : input.sampleRate(), CONVERTER_SECTIONS,
+			mCoefs.data());
+	}
+
+	connect(mSource, &QIODevice::readyRead, this, &QIODevice::readyRead);
+	open(QIODevice::ReadOnly);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		isSequential
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		isSequential ()
+--
+-- RETURNS:			Always true.
+--
+-- NOTES:
+--					The converted audio can only be read in order so this device is sequential.
+----------------------------------------------------------------------------------------------------------------------*/
+bool AudioFormatConverter::isSequential() const
+{
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		bytesAvailable
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bytesAvailable ()
+--
+-- RETURNS:			An estimate of the number of converted bytes that can be read.
+--
+-- NOTES:
+--					The number of bytes in the source is scaled by the ratio between the two formats, less the frames
+--					the resampler has to look ahead.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 AudioFormatConverter::bytesAvailable() const
+{
+	qint64 inputFrames = (mSource->bytesAvailable() + mPartial.size()) / mInput.bytesPerFrame() + mPendingFrames;
+	qint64 outputFrames = qMax((qint64)0, (qint64)((inputFrames - 4 - mPosition) / mStep) + 1);
+
+	return outputFrames * mOutput.bytesPerFrame() + QIODevice::bytesAvailable();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Reads the source without allocating, since it runs on the audio thread.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readData (char * data, qint64 maxSize)
+--						char * data: The buffer to fill with converted audio.
+--						qint64 maxSize: The size of the buffer.
+--
+-- RETURNS:			The number of bytes written into data.
+--
+-- NOTES:
+--					Reads enough audio from the source to fill the buffer and resamples it. Input frames that are
+--					still needed for interpolation are kept until the next read, and so are the bytes of an input
+--					frame that has not fully arrived. Going up in rate, the resampled frames are low-passed on their
+--					way into the buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 AudioFormatConverter::readData(char * data, qint64 maxSize)
+{
+	const int inputFrameSize = mInput.bytesPerFrame();
+	const int outputFrameSize = mOutput.bytesPerFrame();
+	const int channels = mOutput.channelCount();
+
+	int outputFrames = (int)(maxSize / outputFrameSize);
+	if (outputFrames == 0)
+	{
+		return 0;
+	}
+
+	// Pull in just enough input to produce the requested output, the resampler needs two frames past the last one
+	qint64 inputFrames = (qint64)(mPosition + (outputFrames - 1) * mStep) + 4 - mPendingFrames;
+	if (inputFrames > 0)
+	{
+		// Read straight in behind the bytes of a frame that has partly arrived, so nothing is allocated once the
+		// buffer has grown to the size of a read
+		int partial = mPartial.size();
+		mPartial.resize((int)(inputFrames * inputFrameSize));
+		qint64 read = mSource->read(mPartial.data() + partial, mPartial.size() - partial);
+		mPartial.resize(partial + (int)qMax((qint64)0, read));
+
+		int frames = mPartial.size() / inputFrameSize;
+		appendInput(mPartial.constData(), frames);
+		mPartial.remove(0, frames * inputFrameSize);
+	}
+
+	int ready = (int)floor((mPendingFrames - 4 - mPosition) / mStep) + 1;
+	int written = qMin(outputFrames, ready);
+	if (written <= 0)
+	{
+		return 0;
+	}
+
+	mConverted.resize(written * channels);
+	double position = AudioKernels::ResampleCubic(mPending.constData(), mConverted.data(), written, channels, mPosition,
+		mStep);
+
+	if (!mCoefs.isEmpty() && mStep < 1)
+	{
+		filter(mConverted.data(), written, data, mOutput);
+	}
+	else
+	{
+		AudioKernels::FromInt16(mConverted.constData(), written * channels, mOutput, data);
+	}
+
+	// Discard the input frames that have been fully consumed
+	int consumed = qMin((int)position, mPendingFrames);
+	memmove(mPending.data(), mPending.constData() + consumed * channels,
+		(mPendingFrames - consumed) * channels * sizeof(qint16));
+	mPendingFrames -= consumed;
+	mPosition = position - consumed;
+
+	return (qint64)written * outputFrameSize;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		writeData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeData (const char * data, qint64 maxSize)
+--						const char * data: Unused.
+--						qint64 maxSize: Unused.
+--
+-- RETURNS:			Always -1.
+--
+-- NOTES:
+--					The converter is read only.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 AudioFormatConverter::writeData(const char * data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		appendInput
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		appendInput (const char * in, int frames)
+--						const char * in: Whole frames of the source in the input format.
+--						int frames: The number of frames.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Converts the frames to 16 bit with AudioKernels::ToInt16 and maps them onto the output channels
+--					with AudioKernels::MapChannels, after the frames that are already pending. Going down in rate, the
+--					new frames are low-passed before the resampler sees them.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioFormatConverter::appendInput(const char * in, int frames)
+{
+	const int channels = mOutput.channelCount();
+
+	mSamples.resize(frames * mInput.channelCount());
+	AudioKernels::ToInt16(in, mSamples.size(), mInput, mSamples.data());
+
+	mPending.resize((mPendingFrames + frames) * channels);
+	qint16 * mapped = mPending.data() + mPendingFrames * channels;
+	AudioKernels::MapChannels(mSamples.constData(), frames, mInput.channelCount(), mapped, channels);
+	mPendingFrames += frames;
+
+	if (!mCoefs.isEmpty() && mStep > 1)
+	{
+		filter(mapped, frames, (char *)mapped, mWorking);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		filter
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		filter (qint16 * frames, int count, char * out, const QAudioFormat & format)
+--						qint16 * frames: 16 bit frames with the channels of the output.
+--						int count: The number of frames.
+--						char * out: Where the filtered frames are written, which may be the frames themselves.
+--						const QAudioFormat & format: The format to write the filtered frames in.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs the frames through the low-pass with AudioKernels::Biquads in float, carrying the delays of
+--					the filter from one call to the next.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioFormatConverter::filter(qint16 * frames, int count, char * out, const QAudioFormat & format)
+{
+	const int channels = mOutput.channelCount();
+
+	mFiltered.resize(count * channels);
+	AudioKernels::ToFloat((const char *)frames, mFiltered.size(), mWorking, mFiltered.data());
+	AudioKernels::Biquads(mFiltered.data(), count, channels, mCoefs.constData(), CONVERTER_SECTIONS, mFilter.data());
+	AudioKernels::FromFloat(mFiltered.constData(), mFiltered.size(), format, out);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QIODevice>
+#include <QVector>
+
+#include <cmath>
+
+#include "AudioKernels.h"
+#include "globals.h"
+
+class AudioFormatConverter : public QIODevice
+{
+	Q_OBJECT
+
+public:
+	AudioFormatConverter(QIODevice * source, const QAudioFormat & input, const QAudioFormat & output, QObject * parent = nullptr);
+	~AudioFormatConverter() = default;
+
+	bool isSequential() const override;
+	qint64 bytesAvailable() const override;
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+	qint64 writeData(const char * data, qint64 maxSize) override;
+
+private:
+	QIODevice * mSource;
+	QAudioFormat mInput;
+	QAudioFormat mOutput;
+
+	// The format the frames are filtered and resampled in, 16 bit with the channels of the output
+	QAudioFormat mWorking;
+
+	// Resampler state, the position is measured in input frames relative to the second frame in mPending
+	double mStep;
+	double mPosition;
+	QByteArray mPartial;
+	QVector<qint16> mPending;
+	int mPendingFrames;
+
+	// Low-pass in front of the resampler when going down in rate and behind it when going up
+	QVector<float> mCoefs;
+	QVector<float> mFilter;
+
+	// Scratch space for the conversion
+	QVector<qint16> mSamples;
+	QVector<qint16> mConverted;
+	QVector<float> mFiltered;
+
+	void filter(qint16 * frames, int count, char * out, const QAudioFormat & format);
+
+	void appendInput(const char * in, int frames);
+};
@@ -0,0 +1,1796 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		AudioKernels.cpp - Sample conversion, channel mapping and resampling on blocks of audio.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					static void ToInt16(const char * in, int samples, const QAudioFormat & format, qint16 * out)
+--					static void FromInt16(const qint16 * in, int samples, const QAudioFormat & format, char * out)
+--					static void MapChannels(const qint16 * in, int frames, int inChannels, qint16 * out,
+--						int outChannels)
+--					static void Resample(const qint16 * in, int inFrames, qint16 * out, int outFrames, int channels)
+--					static double ResampleCubic(const qint16 * in, qint16 * out, int outFrames, int channels,
+--						double position, double step)
+--					static void MixAdd(qint16 * mix, const qint16 * in, int samples, int gain)
+--					static void Accumulate(qint32 * sum, const qint16 * in, int samples)
+--					static void MixMinus(const qint32 * sum, const qint16 * own, qint16 * out, int samples)
+--					static void RestoreLpc(qint32 * samples, int count, const qint32 * coefs, int order, int shift,
+--						int bits, int precision, qint16 * history)
+--					static void Interleave(const qint32 * const * channels, int channelCount, int frames, int shift,
+--						int sampleSize, char * out)
+--					static void Peaks(const qint16 * in, int samples, qint16 * minimum, qint16 * maximum,
+--						quint64 * squares)
+--					static void KWeight(const qint16 * in, int frames, int channels, const double * coefs,
+--						double * state, double * squares)
+--					static void ApplyGain(char * data, int samples, const QAudioFormat & format, int gain)
+--					static void ToFloat(const char * in, int samples, const QAudioFormat & format, float * out)
+--					static void FromFloat(const float * in, int samples, const QAudioFormat & format, char * out)
+--					static void Ramp(float * data, int frames, int channels, float from, float to)
+--					static void Crossfade(const float * from, const float * to, float * out, int frames, int channels,
+--						float position, float step)
+--					static void Biquads(float * data, int frames, int channels, const float * coefs, int sections,
+--						float * state)
+--					static void LowPass(double frequency, int sampleRate, int sections, float * coefs)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Added MixAdd for mixing voice streams.
+--					October 19, 2026 - agent: Added ResampleCubic for playing voice streams at a varying rate.
+--					October 19, 2026 - agent: Added Accumulate and MixMinus for mixing on the host.
+--					October 19, 2026 - agent: Added RestoreLpc and Interleave for decoding FLAC.
+--					October 19, 2026 - agent: Added Peaks for drawing the waveform of a song.
+--					October 19, 2026 - agent: Added KWeight and ApplyGain for measuring and evening out the
+--									loudness of songs.
+--					October 19, 2026 - agent: Added ToFloat, FromFloat, Ramp, Crossfade and Biquads for the float
+--									chain that songs are played through.
+--					October 19, 2026 - agent: Added LowPass for the filters around the resamplers.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					These functions work on whole blocks of samples at a time and are used wherever audio has to be
+--					reshaped in bulk, like when a song is streamed at a lower quality. Most of the work is on signed
+--					16 bit samples. When SSE2 is available, which is always the case on x64, the common cases are done
+--					several samples at a time:
+--						- 32 bit integer and float samples are converted to and from 16 bit eight at a time.
+--						- Stereo is downmixed to mono and mono is spread to stereo eight frames at a time.
+--						- The interpolation of both resamplers is done four samples at a time. The samples themselves
+--						  are still gathered one by one since their positions do not line up with the output.
+--						- Mixing scales and adds eight samples at a time with saturation.
+--						- Sums are widened to 32 bits and voices taken back out of them eight samples at a time.
+--						- The prediction of every 16 bit sample restored from a FLAC residual is up to 32 multiplies
+--						  done eight at a time. Each sample still waits for the one before it.
+--						- Decoded 16 bit mono and stereo is packed and interleaved eight frames at a time.
+--						- The lowest and highest sample and the sum of the squares of a run are found eight samples at
+--						  a time.
+--						- The K-weighting filters run on two channels at a time in double precision. Each sample
+--						  still waits for the one before it.
+--						- 16 bit samples are scaled by a gain eight at a time and float samples four at a time.
+--
+--					The chain that songs are played through works on float samples instead, so a song can go through
+--					several steps without being rounded to 16 bits after each one. With SSE2:
+--						- 16 bit samples are converted to and from float eight at a time, 32 bit samples four at a time.
+--						- Gains and crossfades are applied four samples at a time, stepping the gain or the position
+--						  of the fade for every frame in the vector.
+--						- The biquads of an equalizer run on four channels, or a pair of channels, at a time. Each
+--						  sample still waits for the one before it.
+--					Every other case falls back to plain loops. They give the same results, apart from the resamplers
+--					which may each round differently by one step.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "AudioKernels.h"
+
+#include <cmath>
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ToInt16
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ToInt16 (const char * in, int samples, const QAudioFormat & format, qint16 * out)
+--						const char * in: The little endian samples to convert.
+--						int samples: The number of samples, counting every channel.
+--						const QAudioFormat & format: The format of the samples.
+--						qint16 * out: Where the 16 bit samples are written.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Converts any of the sample sizes and types that a wav file can hold to signed 16 bit.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::ToInt16(const char * in, int samples, const QAudioFormat & format, qint16 * out)
+{
+	const uchar * bytes = (const uchar *)in;
+	int i = 0;
+
+	switch (format.sampleSize())
+	{
+	case 8:
+		for (; i < samples; i++)
+		{
+			out[i] = format.sampleType() == QAudioFormat::UnSignedInt
+				? (qint16)((bytes[i] - 128) << 8)
+				: (qint16)((qint8)bytes[i] << 8);
+		}
+		break;
+	case 16:
+		for (; i < samples; i++)
+		{
+			out[i] = format.sampleType() == QAudioFormat::UnSignedInt
+				? (qint16)(qFromLittleEndian<quint16>(bytes + i * 2) - 32768)
+				: qFromLittleEndian<qint16>(bytes + i * 2);
+		}
+		break;
+	case 24:
+		for (; i < samples; i++)
+		{
+			out[i] = (qint16)(bytes[i * 3 + 1] | (bytes[i * 3 + 2] << 8));
+		}
+		break;
+	case 32:
+		if (format.sampleType() == QAudioFormat::Float)
+		{
+#ifdef AUDIO_KERNELS_SSE2
+			const __m128 scale = _mm_set1_ps(32767.0f);
+			const __m128 low = _mm_set1_ps(-32768.0f);
+			const __m128 high = _mm_set1_ps(32767.0f);
+
+			for (; i + 8 <= samples; i += 8)
+			{
+				__m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps((const float *)(bytes + i * 4)), scale), low), high);
+				__m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps((const float *)(bytes + i * 4 + 16)), scale), low), high);
+				_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+			}
+#endif
+			for (; i < samples; i++)
+			{
+				quint32 bits = qFromLittleEndian<quint32>(bytes + i * 4);
+				float value;
+				memcpy(&value, &bits, sizeof(value));
+				out[i] = (qint16)qBound(-32768.0f, value * 32767.0f, 32767.0f);
+			}
+		}
+		else
+		{
+#ifdef AUDIO_KERNELS_SSE2
+			for (; i + 8 <= samples; i += 8)
+			{
+				__m128i a = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(bytes + i * 4)), 16);
+				__m128i b = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(bytes + i * 4 + 16)), 16);
+				_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(a, b));
+			}
+#endif
+			for (; i < samples; i++)
+			{
+				out[i] = (qint16)(qFromLittleEndian<qint32>(bytes + i * 4) >> 16);
+			}
+		}
+		break;
+	default:
+		memset(out, 0, samples * sizeof(qint16));
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FromInt16
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FromInt16 (const qint16 * in, int samples, const QAudioFormat & format, char * out)
+--						const qint16 * in: The 16 bit samples to convert.
+--						int samples: The number of samples, counting every channel.
+--						const QAudioFormat & format: The format to convert the samples to.
+--						char * out: Where the little endian samples are written.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The reverse of ToInt16.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::FromInt16(const qint16 * in, int samples, const QAudioFormat & format, char * out)
+{
+	uchar * bytes = (uchar *)out;
+	int i = 0;
+
+	switch (format.sampleSize())
+	{
+	case 8:
+		for (; i < samples; i++)
+		{
+			bytes[i] = format.sampleType() == QAudioFormat::UnSignedInt ? (uchar)((in[i] >> 8) + 128) : (uchar)(in[i] >> 8);
+		}
+		break;
+	case 16:
+		for (; i < samples; i++)
+		{
+			if (format.sampleType() == QAudioFormat::UnSignedInt)
+			{
+				qToLittleEndian<quint16>((quint16)(in[i] + 32768), bytes + i * 2);
+			}
+			else
+			{
+				qToLittleEndian<qint16>(in[i], bytes + i * 2);
+			}
+		}
+		break;
+	case 24:
+		for (; i < samples; i++)
+		{
+			bytes[i * 3] = 0;
+			bytes[i * 3 + 1] = (uchar)in[i];
+			bytes[i * 3 + 2] = (uchar)(in[i] >> 8);
+		}
+		break;
+	case 32:
+		if (format.sampleType() == QAudioFormat::Float)
+		{
+#ifdef AUDIO_KERNELS_SSE2
+			const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+
+			for (; i + 8 <= samples; i += 8)
+			{
+				__m128i value = _mm_loadu_si128((const __m128i *)(in + i));
+				__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+				__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(value, value), 16);
+				_mm_storeu_ps((float *)(bytes + i * 4), _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+				_mm_storeu_ps((float *)(bytes + i * 4 + 16), _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+			}
+#endif
+			for (; i < samples; i++)
+			{
+				float converted = in[i] / 32768.0f;
+				quint32 bits;
+				memcpy(&bits, &converted, sizeof(bits));
+				qToLittleEndian<quint32>(bits, bytes + i * 4);
+			}
+		}
+		else
+		{
+#ifdef AUDIO_KERNELS_SSE2
+			const __m128i zero = _mm_setzero_si128();
+
+			for (; i + 8 <= samples; i += 8)
+			{
+				__m128i value = _mm_loadu_si128((const __m128i *)(in + i));
+				_mm_storeu_si128((__m128i *)(bytes + i * 4), _mm_unpacklo_epi16(zero, value));
+				_mm_storeu_si128((__m128i *)(bytes + i * 4 + 16), _mm_unpackhi_epi16(zero, value));
+			}
+#endif
+			for (; i < samples; i++)
+			{
+				qToLittleEndian<qint32>((qint32)in[i] << 16, bytes + i * 4);
+			}
+		}
+		break;
+	default:
+		memset(out, 0, samples * (format.sampleSize() / 8));
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		MapChannels
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		MapChannels (const qint16 * in, int frames, int inChannels, qint16 * out, int outChannels)
+--						const qint16 * in: The interleaved input frames.
+--						int frames: The number of frames.
+--						int inChannels: The number of channels in the input.
+--						qint16 * out: Where the interleaved output frames are written.
+--						int outChannels: The number of channels in the output.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Maps the channels the same way the AudioFormatConverter does. Going to mono averages every channel,
+--					mono is copied to every output channel and any extra output channels repeat the last input
+--					channel.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::MapChannels(const qint16 * in, int frames, int inChannels, qint16 * out, int outChannels)
+{
+	int i = 0;
+
+	if (inChannels == outChannels)
+	{
+		memcpy(out, in, frames * inChannels * sizeof(qint16));
+		return;
+	}
+
+#ifdef AUDIO_KERNELS_SSE2
+	if (inChannels == 2 && outChannels == 1)
+	{
+		const __m128i ones = _mm_set1_epi16(1);
+
+		for (; i + 8 <= frames; i += 8)
+		{
+			__m128i a = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(in + i * 2)), ones);
+			__m128i b = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(in + i * 2 + 8)), ones);
+			_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(_mm_srai_epi32(a, 1), _mm_srai_epi32(b, 1)));
+		}
+	}
+	else if (inChannels == 1 && outChannels == 2)
+	{
+		for (; i + 8 <= frames; i += 8)
+		{
+			__m128i value = _mm_loadu_si128((const __m128i *)(in + i));
+			_mm_storeu_si128((__m128i *)(out + i * 2), _mm_unpacklo_epi16(value, value));
+			_mm_storeu_si128((__m128i *)(out + i * 2 + 8), _mm_unpackhi_epi16(value, value));
+		}
+	}
+#endif
+
+	for (; i < frames; i++)
+	{
+		const qint16 * frame = in + i * inChannels;
+
+		if (outChannels == 1)
+		{
+			int sum = 0;
+			for (int channel = 0; channel < inChannels; channel++)
+			{
+				sum += frame[channel];
+			}
+			out[i] = (qint16)(inChannels == 2 ? sum >> 1 : sum / inChannels);
+			continue;
+		}
+
+		for (int channel = 0; channel < outChannels; channel++)
+		{
+			out[i * outChannels + channel] = frame[qMin(channel, inChannels - 1)];
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Resample
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Resample (const qint16 * in, int inFrames, qint16 * out, int outFrames, int channels)
+--						const qint16 * in: The interleaved input frames.
+--						int inFrames: The number of input frames.
+--						qint16 * out: Where the interleaved output frames are written.
+--						int outFrames: The number of output frames wanted.
+--						int channels: The number of channels in both the input and the output.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Stretches the block of input frames over exactly outFrames output frames using linear
+--					interpolation. Output frame j is taken from position j * inFrames / outFrames in the input, which
+--					is tracked in 16.16 fixed point. Since a block always maps onto a fixed number of output frames,
+--					blocks that were resampled separately line up with each other.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::Resample(const qint16 * in, int inFrames, qint16 * out, int outFrames, int channels)
+{
+	if (inFrames <= 0 || outFrames <= 0)
+	{
+		return;
+	}
+
+	if (inFrames == outFrames)
+	{
+		memcpy(out, in, outFrames * channels * sizeof(qint16));
+		return;
+	}
+
+	const qint64 step = ((qint64)inFrames << 16) / outFrames;
+	const int last = inFrames - 1;
+	int j = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	if (channels <= 2)
+	{
+		const int framesPerPass = 4 / channels;
+		const __m128 scale = _mm_set1_ps(1.0f / 65536.0f);
+
+		for (; j + framesPerPass <= outFrames; j += framesPerPass)
+		{
+			float a[4];
+			float b[4];
+			float f[4];
+
+			for (int k = 0; k < 4; k++)
+			{
+				qint64 position = (j + k / channels) * step;
+				int index = (int)(position >> 16);
+				int channel = k % channels;
+
+				a[k] = in[index * channels + channel];
+				b[k] = in[qMin(index + 1, last) * channels + channel];
+				f[k] = (float)(position & 0xFFFF);
+			}
+
+			__m128 va = _mm_loadu_ps(a);
+			__m128 vb = _mm_loadu_ps(b);
+			__m128 vf = _mm_mul_ps(_mm_loadu_ps(f), scale);
+			__m128i result = _mm_cvtps_epi32(_mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), vf)));
+			_mm_storel_epi64((__m128i *)(out + j * channels), _mm_packs_epi32(result, result));
+		}
+	}
+#endif
+
+	for (; j < outFrames; j++)
+	{
+		qint64 position = j * step;
+		int index = (int)(position >> 16);
+		qint64 fraction = position & 0xFFFF;
+
+		for (int channel = 0; channel < channels; channel++)
+		{
+			qint64 a = in[index * channels + channel];
+			qint64 b = in[qMin(index + 1, last) * channels + channel];
+			out[j * channels + channel] = (qint16)(a + (((b - a) * fraction) >> 16));
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ResampleCubic
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ResampleCubic (const qint16 * in, qint16 * out, int outFrames, int channels, double position,
+--						double step)
+--						const qint16 * in: The interleaved input frames, starting one frame before the position.
+--						qint16 * out: Where the interleaved output frames are written.
+--						int outFrames: The number of output frames wanted.
+--						int channels: The number of channels in both the input and the output.
+--						double position: Where the first output frame is taken from, counted from in[1].
+--						double step: How many input frames each output frame moves on, which may be any ratio.
+--
+-- RETURNS:			The position of the frame after the last one written, to carry into the next block.
+--
+-- NOTES:
+--					Output frame j is taken from position + j * step with a Catmull-Rom cubic through the two input
+--					frames on either side of it, so the input must hold floor(position + (outFrames - 1) * step) + 4
+--					frames. Unlike Resample the ratio is not tied to the size of the block and the fraction is carried
+--					between calls, so a stream can be played a few parts per million faster or slower without a seam
+--					between blocks. At whole positions the cubic passes the input through unchanged, and at ratios near
+--					one it keeps far more of the top of the voice band than linear interpolation would.
+----------------------------------------------------------------------------------------------------------------------*/
+double AudioKernels::ResampleCubic(const qint16 * in, qint16 * out, int outFrames, int channels, double position,
+	double step)
+{
+	int j = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	if (channels <= 2)
+	{
+		const int framesPerPass = 4 / channels;
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 three = _mm_set1_ps(3.0f);
+		const __m128 four = _mm_set1_ps(4.0f);
+		const __m128 five = _mm_set1_ps(5.0f);
+
+		for (; j + framesPerPass <= outFrames; j += framesPerPass)
+		{
+			float x0[4];
+			float x1[4];
+			float x2[4];
+			float x3[4];
+			float f[4];
+
+			for (int k = 0; k < 4; k++)
+			{
+				double at = position + (j + k / channels) * step;
+				int index = (int)at;
+				const qint16 * tap = in + index * channels + k % channels;
+
+				x0[k] = tap[0];
+				x1[k] = tap[channels];
+				x2[k] = tap[channels * 2];
+				x3[k] = tap[channels * 3];
+				f[k] = (float)(at - index);
+			}
+
+			__m128 v0 = _mm_loadu_ps(x0);
+			__m128 v1 = _mm_loadu_ps(x1);
+			__m128 v2 = _mm_loadu_ps(x2);
+			__m128 v3 = _mm_loadu_ps(x3);
+			__m128 vf = _mm_loadu_ps(f);
+
+			// x1 + f / 2 * (x2 - x0 + f * (2 x0 - 5 x1 + 4 x2 - x3 + f * (3 (x1 - x2) + x3 - x0)))
+			__m128 cubic = _mm_add_ps(_mm_mul_ps(three, _mm_sub_ps(v1, v2)), _mm_sub_ps(v3, v0));
+			__m128 square = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(two, v0), _mm_mul_ps(four, v2)),
+				_mm_add_ps(_mm_mul_ps(five, v1), v3));
+			__m128 sum = _mm_add_ps(square, _mm_mul_ps(vf, cubic));
+			sum = _mm_add_ps(_mm_sub_ps(v2, v0), _mm_mul_ps(vf, sum));
+			sum = _mm_add_ps(v1, _mm_mul_ps(_mm_mul_ps(half, vf), sum));
+
+			__m128i result = _mm_cvtps_epi32(sum);
+			_mm_storel_epi64((__m128i *)(out + j * channels), _mm_packs_epi32(result, result));
+		}
+	}
+#endif
+
+	for (; j < outFrames; j++)
+	{
+		double at = position + j * step;
+		int index = (int)at;
+		float fraction = (float)(at - index);
+
+		for (int channel = 0; channel < channels; channel++)
+		{
+			const qint16 * tap = in + index * channels + channel;
+			float x0 = tap[0];
+			float x1 = tap[channels];
+			float x2 = tap[channels * 2];
+			float x3 = tap[channels * 3];
+
+			float sum = 2 * x0 - 5 * x1 + 4 * x2 - x3 + fraction * (3 * (x1 - x2) + x3 - x0);
+			sum = x1 + 0.5f * fraction * (x2 - x0 + fraction * sum);
+			out[j * channels + channel] = (qint16)qBound(-32768, qRound(sum), 32767);
+		}
+	}
+
+	return position + outFrames * step;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		MixAdd
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		MixAdd (qint16 * mix, const qint16 * in, int samples, int gain)
+--						qint16 * mix: The mix the samples are added to.
+--						const qint16 * in: The samples to add.
+--						int samples: The number of samples, counting every channel.
+--						int gain: The gain of the samples in 8.8 fixed point, 256 leaves them as they are.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Scales every sample by the gain and adds it to the mix. Both steps saturate so loud voices clip
+--					instead of wrapping around.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::MixAdd(qint16 * mix, const qint16 * in, int samples, int gain)
+{
+	int i = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	const __m128i scale = _mm_set1_epi16((short)gain);
+
+	for (; i + 8 <= samples; i += 8)
+	{
+		__m128i value = _mm_loadu_si128((const __m128i *)(in + i));
+		__m128i low = _mm_mullo_epi16(value, scale);
+		__m128i high = _mm_mulhi_epi16(value, scale);
+		__m128i first = _mm_srai_epi32(_mm_unpacklo_epi16(low, high), 8);
+		__m128i second = _mm_srai_epi32(_mm_unpackhi_epi16(low, high), 8);
+		__m128i scaled = _mm_packs_epi32(first, second);
+
+		_mm_storeu_si128((__m128i *)(mix + i), _mm_adds_epi16(_mm_loadu_si128((const __m128i *)(mix + i)), scaled));
+	}
+#endif
+
+	for (; i < samples; i++)
+	{
+		int scaled = qBound(-32768, (in[i] * gain) >> 8, 32767);
+		mix[i] = (qint16)qBound(-32768, mix[i] + scaled, 32767);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Accumulate
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Accumulate (qint32 * sum, const qint16 * in, int samples)
+--						qint32 * sum: The running sum the samples are added to.
+--						const qint16 * in: The samples to add.
+--						int samples: The number of samples, counting every channel.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Widens every sample to 32 bits and adds it to the sum, so the sum of up to 65536 voices never
+--					clips and any one of them can be taken back out exactly with MixMinus.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::Accumulate(qint32 * sum, const qint16 * in, int samples)
+{
+	int i = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	for (; i + 8 <= samples; i += 8)
+	{
+		__m128i value = _mm_loadu_si128((const __m128i *)(in + i));
+		__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+		__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(value, value), 16);
+
+		_mm_storeu_si128((__m128i *)(sum + i), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(sum + i)), low));
+		_mm_storeu_si128((__m128i *)(sum + i + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(sum + i + 4)), high));
+	}
+#endif
+
+	for (; i < samples; i++)
+	{
+		sum[i] += in[i];
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		MixMinus
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		MixMinus (const qint32 * sum, const qint16 * own, qint16 * out, int samples)
+--						const qint32 * sum: The sum of every voice from Accumulate.
+--						const qint16 * own: The voice to leave out of the mix, or nullptr to leave nothing out.
+--						qint16 * out: Where the mix is written.
+--						int samples: The number of samples, counting every channel.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Takes one voice back out of the sum and saturates what is left to 16 bits, eight samples at a time.
+--					Everyone on a conference bridge hears everyone but themselves, so the sum is made once and each
+--					listener only costs one pass, instead of adding up every other voice again for every listener.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::MixMinus(const qint32 * sum, const qint16 * own, qint16 * out, int samples)
+{
+	int i = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 8 <= samples; i += 8)
+	{
+		__m128i value = own ? _mm_loadu_si128((const __m128i *)(own + i)) : zero;
+		__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+		__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(value, value), 16);
+
+		low = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(sum + i)), low);
+		high = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(sum + i + 4)), high);
+		_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(low, high));
+	}
+#endif
+
+	for (; i < samples; i++)
+	{
+		out[i] = (qint16)qBound(-32768, sum[i] - (own ? own[i] : 0), 32767);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RestoreLpc
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RestoreLpc (qint32 * samples, int count, const qint32 * coefs, int order, int shift, int bits,
+--						int precision, qint16 * history)
+--						qint32 * samples: The warm up samples followed by the residual, replaced by the signal.
+--						int count: The number of samples, counting the warm up.
+--						const qint32 * coefs: The quantized coefficients, the one for the previous sample first.
+--						int order: The number of coefficients and of warm up samples, at most 32.
+--						int shift: How far the sum of the products is shifted down.
+--						int bits: How many bits the samples of the signal take.
+--						int precision: How many bits the coefficients take.
+--						qint16 * history: Room for count + 32 samples, used when the signal fits in 16 bits.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Every sample is its residual plus the coefficients times the samples before it, shifted down.
+--					When the sum of the products can not overflow 32 bits it is done in 32 bits, as the FLAC reference
+--					decoder does, otherwise in 64. A signal of up to 16 bits is also kept as 16 bit samples in the
+--					history, so eight products at a time are made and added in pairs. The coefficients are reversed
+--					and padded at the front with zeros to a multiple of eight, and the history starts with 32 zeros,
+--					so the products for a sample are one run of loads that ends at the sample before it.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::RestoreLpc(qint32 * samples, int count, const qint32 * coefs, int order, int shift, int bits,
+	int precision, qint16 * history)
+{
+	int orderBits = 0;
+	while ((1 << orderBits) < order)
+	{
+		orderBits++;
+	}
+
+	bool narrow = bits + precision + orderBits <= 32;
+	int i = order;
+
+#ifdef AUDIO_KERNELS_SSE2
+	if (narrow && bits <= 16 && history != nullptr)
+	{
+		const int padded = (order + 7) & ~7;
+		qint16 taps[32] = { 0 };
+		for (int k = 0; k < order; k++)
+		{
+			taps[padded - order + k] = (qint16)coefs[order - 1 - k];
+		}
+
+		const __m128i tap0 = _mm_loadu_si128((const __m128i *)taps);
+		const __m128i tap1 = _mm_loadu_si128((const __m128i *)(taps + 8));
+		const __m128i tap2 = _mm_loadu_si128((const __m128i *)(taps + 16));
+		const __m128i tap3 = _mm_loadu_si128((const __m128i *)(taps + 24));
+
+		memset(history, 0, 32 * sizeof(qint16));
+		qint16 * signal = history + 32;
+		for (int k = 0; k < order; k++)
+		{
+			signal[k] = (qint16)samples[k];
+		}
+
+		for (; i < count; i++)
+		{
+			const qint16 * window = signal + i - padded;
+			__m128i sum = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)window), tap0);
+
+			if (padded > 8)
+			{
+				sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(window + 8)), tap1));
+			}
+			if (padded > 16)
+			{
+				sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(window + 16)), tap2));
+			}
+			if (padded > 24)
+			{
+				sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(window + 24)), tap3));
+			}
+
+			sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+			sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+
+			qint32 value = samples[i] + (_mm_cvtsi128_si32(sum) >> shift);
+			samples[i] = value;
+			signal[i] = (qint16)value;
+		}
+
+		return;
+	}
+#else
+	Q_UNUSED(history);
+#endif
+
+	if (narrow)
+	{
+		for (; i < count; i++)
+		{
+			qint32 sum = 0;
+			for (int j = 0; j < order; j++)
+			{
+				sum += coefs[j] * samples[i - 1 - j];
+			}
+			samples[i] += sum >> shift;
+		}
+	}
+	else
+	{
+		for (; i < count; i++)
+		{
+			qint64 sum = 0;
+			for (int j = 0; j < order; j++)
+			{
+				sum += (qint64)coefs[j] * samples[i - 1 - j];
+			}
+			samples[i] += (qint32)(sum >> shift);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Interleave
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Interleave (const qint32 * const * channels, int channelCount, int frames, int shift,
+--						int sampleSize, char * out)
+--						const qint32 * const * channels: The samples of each channel.
+--						int channelCount: The number of channels.
+--						int frames: The number of samples in each channel.
+--						int shift: How far each sample is shifted up to fill the sample size.
+--						int sampleSize: 16, 24 or 32 bits.
+--						char * out: Where the little endian frames are written.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Turns the separate channels a decoder works in into the frames the output plays. Samples that
+--					are fewer bits than the sample size, like 12 bit audio in 16 bits, are moved to the top bits.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::Interleave(const qint32 * const * channels, int channelCount, int frames, int shift, int sampleSize,
+	char * out)
+{
+	uchar * bytes = (uchar *)out;
+	int i = 0;
+
+	if (sampleSize == 16)
+	{
+#ifdef AUDIO_KERNELS_SSE2
+		qint16 * samples = (qint16 *)out;
+
+		if (channelCount == 1)
+		{
+			for (; i + 8 <= frames; i += 8)
+			{
+				__m128i a = _mm_slli_epi32(_mm_loadu_si128((const __m128i *)(channels[0] + i)), shift);
+				__m128i b = _mm_slli_epi32(_mm_loadu_si128((const __m128i *)(channels[0] + i + 4)), shift);
+				_mm_storeu_si128((__m128i *)(samples + i), _mm_packs_epi32(a, b));
+			}
+		}
+		else if (channelCount == 2)
+		{
+			for (; i + 8 <= frames; i += 8)
+			{
+				__m128i left = _mm_packs_epi32(
+					_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(channels[0] + i)), shift),
+					_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(channels[0] + i + 4)), shift));
+				__m128i right = _mm_packs_epi32(
+					_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(channels[1] + i)), shift),
+					_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(channels[1] + i + 4)), shift));
+				_mm_storeu_si128((__m128i *)(samples + i * 2), _mm_unpacklo_epi16(left, right));
+				_mm_storeu_si128((__m128i *)(samples + i * 2 + 8), _mm_unpackhi_epi16(left, right));
+			}
+		}
+#endif
+
+		for (; i < frames; i++)
+		{
+			for (int c = 0; c < channelCount; c++)
+			{
+				qToLittleEndian<qint16>((qint16)(channels[c][i] << shift), bytes + (i * channelCount + c) * 2);
+			}
+		}
+	}
+	else if (sampleSize == 24)
+	{
+		for (; i < frames; i++)
+		{
+			for (int c = 0; c < channelCount; c++)
+			{
+				quint32 value = (quint32)channels[c][i] << shift;
+				uchar * sample = bytes + (i * channelCount + c) * 3;
+				sample[0] = (uchar)value;
+				sample[1] = (uchar)(value >> 8);
+				sample[2] = (uchar)(value >> 16);
+			}
+		}
+	}
+	else
+	{
+		for (; i < frames; i++)
+		{
+			for (int c = 0; c < channelCount; c++)
+			{
+				qToLittleEndian<quint32>((quint32)channels[c][i] << shift, bytes + (i * channelCount + c) * 4);
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Peaks
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Peaks (const qint16 * in, int samples, qint16 * minimum, qint16 * maximum, quint64 * squares)
+--						const qint16 * in: The samples to look at.
+--						int samples: The number of samples, counting every channel.
+--						qint16 * minimum: The lowest sample so far, which is lowered to the lowest of the run.
+--						qint16 * maximum: The highest sample so far, which is raised to the highest of the run.
+--						quint64 * squares: The sum of the squares so far, which the squares of the run are added to.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Adds a run of samples to the minimum, maximum and sum of squares that a column of a waveform is
+--					drawn from, so a column can be built up out of several runs. Two squares added together are at
+--					most 2^31, so the pairs that _mm_madd_epi16 gives fit a 32 bit lane when it is read as unsigned,
+--					and are widened to 64 bits before they are summed.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::Peaks(const qint16 * in, int samples, qint16 * minimum, qint16 * maximum, quint64 * squares)
+{
+	int i = 0;
+	qint16 low = *minimum;
+	qint16 high = *maximum;
+	quint64 sum = *squares;
+
+#ifdef AUDIO_KERNELS_SSE2
+	if (samples >= 8)
+	{
+		__m128i zero = _mm_setzero_si128();
+		__m128i lows = _mm_set1_epi16(low);
+		__m128i highs = _mm_set1_epi16(high);
+		__m128i sums = _mm_setzero_si128();
+
+		for (; i + 8 <= samples; i += 8)
+		{
+			__m128i value = _mm_loadu_si128((const __m128i *)(in + i));
+			__m128i pairs = _mm_madd_epi16(value, value);
+
+			lows = _mm_min_epi16(lows, value);
+			highs = _mm_max_epi16(highs, value);
+			sums = _mm_add_epi64(sums, _mm_unpacklo_epi32(pairs, zero));
+			sums = _mm_add_epi64(sums, _mm_unpackhi_epi32(pairs, zero));
+		}
+
+		lows = _mm_min_epi16(lows, _mm_shuffle_epi32(lows, _MM_SHUFFLE(1, 0, 3, 2)));
+		lows = _mm_min_epi16(lows, _mm_shuffle_epi32(lows, _MM_SHUFFLE(2, 3, 0, 1)));
+		lows = _mm_min_epi16(lows, _mm_shufflelo_epi16(lows, _MM_SHUFFLE(2, 3, 0, 1)));
+		highs = _mm_max_epi16(highs, _mm_shuffle_epi32(highs, _MM_SHUFFLE(1, 0, 3, 2)));
+		highs = _mm_max_epi16(highs, _mm_shuffle_epi32(highs, _MM_SHUFFLE(2, 3, 0, 1)));
+		highs = _mm_max_epi16(highs, _mm_shufflelo_epi16(highs, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		quint64 lanes[2];
+		_mm_storeu_si128((__m128i *)lanes, sums);
+
+		low = (qint16)_mm_extract_epi16(lows, 0);
+		high = (qint16)_mm_extract_epi16(highs, 0);
+		sum += lanes[0] + lanes[1];
+	}
+#endif
+
+	for (; i < samples; i++)
+	{
+		low = qMin(low, in[i]);
+		high = qMax(high, in[i]);
+		sum += (quint64)(in[i] * in[i]);
+	}
+
+	*minimum = low;
+	*maximum = high;
+	*squares = sum;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		KWeight
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		KWeight (const qint16 * in, int frames, int channels, const double * coefs, double * state,
+--						double * squares)
+--						const qint16 * in: The interleaved frames to filter.
+--						int frames: The number of frames.
+--						int channels: The number of channels in a frame.
+--						const double * coefs: b0, b1, b2, a1 and a2 of the first filter, then of the second.
+--						double * state: The two delays of each filter for every channel, kept as four runs of one
+--							value for every channel, which carry on from one call to the next.
+--						double * squares: The sum of the squares of the filtered samples of every channel so far,
+--							which the squares of these frames are added to.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs every channel through two biquads in transposed direct form II, the shelf and high pass of
+--					the K-weighting of ITU-R BS.1770, and sums the squares of what comes out. The filters are done in
+--					double precision since the poles of the high pass are very close to one. A delay that has decayed
+--					to almost nothing is set to zero at the end, so a long silence never slows the filters down with
+--					denormal numbers.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::KWeight(const qint16 * in, int frames, int channels, const double * coefs, double * state,
+	double * squares)
+{
+	double * z1 = state;
+	double * z2 = state + channels;
+	double * w1 = state + channels * 2;
+	double * w2 = state + channels * 3;
+	int c = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	const __m128d b0 = _mm_set1_pd(coefs[0]);
+	const __m128d b1 = _mm_set1_pd(coefs[1]);
+	const __m128d b2 = _mm_set1_pd(coefs[2]);
+	const __m128d a1 = _mm_set1_pd(coefs[3]);
+	const __m128d a2 = _mm_set1_pd(coefs[4]);
+	const __m128d d0 = _mm_set1_pd(coefs[5]);
+	const __m128d d1 = _mm_set1_pd(coefs[6]);
+	const __m128d d2 = _mm_set1_pd(coefs[7]);
+	const __m128d c1 = _mm_set1_pd(coefs[8]);
+	const __m128d c2 = _mm_set1_pd(coefs[9]);
+
+	for (; c + 2 <= channels; c += 2)
+	{
+		__m128d first1 = _mm_loadu_pd(z1 + c);
+		__m128d first2 = _mm_loadu_pd(z2 + c);
+		__m128d second1 = _mm_loadu_pd(w1 + c);
+		__m128d second2 = _mm_loadu_pd(w2 + c);
+		__m128d sum = _mm_loadu_pd(squares + c);
+
+		for (int f = 0; f < frames; f++)
+		{
+			const qint16 * frame = in + f * channels + c;
+			__m128d x = _mm_set_pd(frame[1], frame[0]);
+
+			__m128d y = _mm_add_pd(_mm_mul_pd(b0, x), first1);
+			first1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1, x), _mm_mul_pd(a1, y)), first2);
+			first2 = _mm_sub_pd(_mm_mul_pd(b2, x), _mm_mul_pd(a2, y));
+
+			__m128d out = _mm_add_pd(_mm_mul_pd(d0, y), second1);
+			second1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(d1, y), _mm_mul_pd(c1, out)), second2);
+			second2 = _mm_sub_pd(_mm_mul_pd(d2, y), _mm_mul_pd(c2, out));
+
+			sum = _mm_add_pd(sum, _mm_mul_pd(out, out));
+		}
+
+		_mm_storeu_pd(z1 + c, first1);
+		_mm_storeu_pd(z2 + c, first2);
+		_mm_storeu_pd(w1 + c, second1);
+		_mm_storeu_pd(w2 + c, second2);
+		_mm_storeu_pd(squares + c, sum);
+	}
+#endif
+
+	for (; c < channels; c++)
+	{
+		double sum = squares[c];
+
+		for (int f = 0; f < frames; f++)
+		{
+			double x = in[f * channels + c];
+
+			double y = coefs[0] * x + z1[c];
+			z1[c] = coefs[1] * x - coefs[3] * y + z2[c];
+			z2[c] = coefs[2] * x - coefs[4] * y;
+
+			double out = coefs[5] * y + w1[c];
+			w1[c] = coefs[6] * y - coefs[8] * out + w2[c];
+			w2[c] = coefs[7] * y - coefs[9] * out;
+
+			sum += out * out;
+		}
+
+		squares[c] = sum;
+	}
+
+	for (int i = 0; i < channels * 4; i++)
+	{
+		if (std::fabs(state[i]) < 1e-20)
+		{
+			state[i] = 0;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ApplyGain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ApplyGain (char * data, int samples, const QAudioFormat & format, int gain)
+--						char * data: The little endian samples to scale in place.
+--						int samples: The number of samples, counting every channel.
+--						const QAudioFormat & format: The format of the samples.
+--						int gain: The gain in 8.8 fixed point, 256 leaves the samples as they are.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Scales samples of any of the formats an output can be opened in, so a song can be turned up or
+--					down after it has been converted to the format of the output. Integer samples saturate instead of
+--					wrapping around. Float samples are left to go past full scale, the output clips them.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::ApplyGain(char * data, int samples, const QAudioFormat & format, int gain)
+{
+	uchar * bytes = (uchar *)data;
+	int i = 0;
+
+	switch (format.sampleSize())
+	{
+	case 8:
+		for (; i < samples; i++)
+		{
+			if (format.sampleType() == QAudioFormat::UnSignedInt)
+			{
+				bytes[i] = (uchar)(qBound(-128, ((bytes[i] - 128) * gain) >> 8, 127) + 128);
+			}
+			else
+			{
+				bytes[i] = (uchar)qBound(-128, ((qint8)bytes[i] * gain) >> 8, 127);
+			}
+		}
+		break;
+	case 16:
+		if (format.sampleType() == QAudioFormat::UnSignedInt)
+		{
+			for (; i < samples; i++)
+			{
+				int value = qFromLittleEndian<quint16>(bytes + i * 2) - 32768;
+				qToLittleEndian<quint16>((quint16)(qBound(-32768, (value * gain) >> 8, 32767) + 32768), bytes + i * 2);
+			}
+			break;
+		}
+
+#ifdef AUDIO_KERNELS_SSE2
+		{
+			const __m128i scale = _mm_set1_epi16((short)gain);
+
+			for (; i + 8 <= samples; i += 8)
+			{
+				__m128i value = _mm_loadu_si128((const __m128i *)(bytes + i * 2));
+				__m128i low = _mm_mullo_epi16(value, scale);
+				__m128i high = _mm_mulhi_epi16(value, scale);
+				__m128i first = _mm_srai_epi32(_mm_unpacklo_epi16(low, high), 8);
+				__m128i second = _mm_srai_epi32(_mm_unpackhi_epi16(low, high), 8);
+
+				_mm_storeu_si128((__m128i *)(bytes + i * 2), _mm_packs_epi32(first, second));
+			}
+		}
+#endif
+		for (; i < samples; i++)
+		{
+			int value = qFromLittleEndian<qint16>(bytes + i * 2);
+			qToLittleEndian<qint16>((qint16)qBound(-32768, (value * gain) >> 8, 32767), bytes + i * 2);
+		}
+		break;
+	case 24:
+		for (; i < samples; i++)
+		{
+			uchar * sample = bytes + i * 3;
+			qint32 value = (qint32)((sample[0] << 8) | (sample[1] << 16) | ((quint32)sample[2] << 24)) >> 8;
+			qint32 scaled = (qint32)qBound<qint64>(-8388608, ((qint64)value * gain) >> 8, 8388607);
+
+			sample[0] = (uchar)scaled;
+			sample[1] = (uchar)(scaled >> 8);
+			sample[2] = (uchar)(scaled >> 16);
+		}
+		break;
+	case 32:
+		if (format.sampleType() == QAudioFormat::Float)
+		{
+#ifdef AUDIO_KERNELS_SSE2
+			const __m128 scale = _mm_set1_ps(gain / 256.0f);
+
+			for (; i + 4 <= samples; i += 4)
+			{
+				__m128 value = _mm_loadu_ps((const float *)(bytes + i * 4));
+				_mm_storeu_ps((float *)(bytes + i * 4), _mm_mul_ps(value, scale));
+			}
+#endif
+			for (; i < samples; i++)
+			{
+				quint32 bits = qFromLittleEndian<quint32>(bytes + i * 4);
+				float value;
+				memcpy(&value, &bits, sizeof(value));
+
+				value *= gain / 256.0f;
+				memcpy(&bits, &value, sizeof(bits));
+				qToLittleEndian<quint32>(bits, bytes + i * 4);
+			}
+		}
+		else
+		{
+			for (; i < samples; i++)
+			{
+				qint64 value = qFromLittleEndian<qint32>(bytes + i * 4);
+				qint64 scaled = qBound<qint64>(-2147483647 - 1, (value * gain) >> 8, 2147483647);
+				qToLittleEndian<qint32>((qint32)scaled, bytes + i * 4);
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ToFloat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ToFloat (const char * in, int samples, const QAudioFormat & format, float * out)
+--						const char * in: The little endian samples to convert.
+--						int samples: The number of samples, counting every channel.
+--						const QAudioFormat & format: The format of the samples.
+--						float * out: Where the float samples are written.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Converts samples of any of the formats an output can be opened in to float, with full scale at
+--					one. Integer samples are divided by the magnitude of their lowest value, so 16 bit samples go to
+--					float and back with FromFloat unchanged.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::ToFloat(const char * in, int samples, const QAudioFormat & format, float * out)
+{
+	const uchar * bytes = (const uchar *)in;
+	int i = 0;
+
+	switch (format.sampleSize())
+	{
+	case 8:
+		for (; i < samples; i++)
+		{
+			out[i] = format.sampleType() == QAudioFormat::UnSignedInt
+				? (bytes[i] - 128) / 128.0f
+				: (qint8)bytes[i] / 128.0f;
+		}
+		break;
+	case 16:
+		if (format.sampleType() == QAudioFormat::UnSignedInt)
+		{
+			for (; i < samples; i++)
+			{
+				out[i] = (qFromLittleEndian<quint16>(bytes + i * 2) - 32768) / 32768.0f;
+			}
+			break;
+		}
+
+#ifdef AUDIO_KERNELS_SSE2
+		{
+			const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+
+			for (; i + 8 <= samples; i += 8)
+			{
+				__m128i value = _mm_loadu_si128((const __m128i *)(bytes + i * 2));
+				__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+				__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(value, value), 16);
+
+				_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+				_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+			}
+		}
+#endif
+		for (; i < samples; i++)
+		{
+			out[i] = qFromLittleEndian<qint16>(bytes + i * 2) / 32768.0f;
+		}
+		break;
+	case 24:
+		for (; i < samples; i++)
+		{
+			const uchar * sample = bytes + i * 3;
+			qint32 value = (qint32)((sample[0] << 8) | (sample[1] << 16) | ((quint32)sample[2] << 24)) >> 8;
+			out[i] = value / 8388608.0f;
+		}
+		break;
+	case 32:
+		if (format.sampleType() == QAudioFormat::Float)
+		{
+			memcpy(out, bytes, samples * sizeof(float));
+			break;
+		}
+
+#ifdef AUDIO_KERNELS_SSE2
+		{
+			const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+
+			for (; i + 4 <= samples; i += 4)
+			{
+				__m128i value = _mm_loadu_si128((const __m128i *)(bytes + i * 4));
+				_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+			}
+		}
+#endif
+		for (; i < samples; i++)
+		{
+			out[i] = qFromLittleEndian<qint32>(bytes + i * 4) / 2147483648.0f;
+		}
+		break;
+	default:
+		memset(out, 0, samples * sizeof(float));
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FromFloat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FromFloat (const float * in, int samples, const QAudioFormat & format, char * out)
+--						const float * in: The float samples to convert, with full scale at one.
+--						int samples: The number of samples, counting every channel.
+--						const QAudioFormat & format: The format to convert the samples to.
+--						char * out: Where the little endian samples are written.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Converts float samples back to the format of an output. Integer samples are rounded to the nearest
+--					step and clipped at full scale. The samples are clamped before they are converted since
+--					_mm_cvtps_epi32 turns anything out of range into the lowest value, which would flip a loud
+--					positive sample to full scale negative. Float samples are copied as they are.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::FromFloat(const float * in, int samples, const QAudioFormat & format, char * out)
+{
+	uchar * bytes = (uchar *)out;
+	int i = 0;
+
+	switch (format.sampleSize())
+	{
+	case 8:
+		for (; i < samples; i++)
+		{
+			int value = qBound(-128, qRound(in[i] * 128.0f), 127);
+			bytes[i] = format.sampleType() == QAudioFormat::UnSignedInt ? (uchar)(value + 128) : (uchar)value;
+		}
+		break;
+	case 16:
+		if (format.sampleType() == QAudioFormat::UnSignedInt)
+		{
+			for (; i < samples; i++)
+			{
+				int value = qBound(-32768, qRound(in[i] * 32768.0f), 32767);
+				qToLittleEndian<quint16>((quint16)(value + 32768), bytes + i * 2);
+			}
+			break;
+		}
+
+#ifdef AUDIO_KERNELS_SSE2
+		{
+			const __m128 scale = _mm_set1_ps(32768.0f);
+			const __m128 low = _mm_set1_ps(-32768.0f);
+			const __m128 high = _mm_set1_ps(32767.0f);
+
+			for (; i + 8 <= samples; i += 8)
+			{
+				__m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), low), high);
+				__m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), low), high);
+				_mm_storeu_si128((__m128i *)(bytes + i * 2), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+			}
+		}
+#endif
+		for (; i < samples; i++)
+		{
+			qToLittleEndian<qint16>((qint16)qBound(-32768, qRound(in[i] * 32768.0f), 32767), bytes + i * 2);
+		}
+		break;
+	case 24:
+		for (; i < samples; i++)
+		{
+			qint32 value = (qint32)qBound(-8388608.0, std::floor(in[i] * 8388608.0 + 0.5), 8388607.0);
+			uchar * sample = bytes + i * 3;
+
+			sample[0] = (uchar)value;
+			sample[1] = (uchar)(value >> 8);
+			sample[2] = (uchar)(value >> 16);
+		}
+		break;
+	case 32:
+		if (format.sampleType() == QAudioFormat::Float)
+		{
+			memcpy(bytes, in, samples * sizeof(float));
+			break;
+		}
+
+		for (; i < samples; i++)
+		{
+			double value = qBound(-2147483648.0, std::floor(in[i] * 2147483648.0 + 0.5), 2147483647.0);
+			qToLittleEndian<qint32>((qint32)value, bytes + i * 4);
+		}
+		break;
+	default:
+		memset(bytes, 0, samples * (format.sampleSize() / 8));
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Ramp
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Ramp (float * data, int frames, int channels, float from, float to)
+--						float * data: The interleaved frames to scale in place.
+--						int frames: The number of frames.
+--						int channels: The number of channels in a frame.
+--						float from: The gain of the first frame.
+--						float to: The gain the frame after the last one would have.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Scales the frames by a gain that moves in a straight line from one value to another, so a gain
+--					can change without a click. A ramp that ends where the next one starts carries on smoothly. When
+--					the gain does not change every sample is simply multiplied. With SSE2 a vector holds four frames
+--					of mono, two frames of stereo or one frame of four channels, and the gains of the vector step by
+--					as many frames at once. Other channel counts ramp with a plain loop.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::Ramp(float * data, int frames, int channels, float from, float to)
+{
+	int samples = frames * channels;
+	float step = frames > 0 ? (to - from) / frames : 0;
+	int i = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	if (from == to)
+	{
+		const __m128 gain = _mm_set1_ps(from);
+
+		for (; i + 4 <= samples; i += 4)
+		{
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+		}
+	}
+	else if (channels == 1 || channels == 2 || channels == 4)
+	{
+		int perVector = 4 / channels;
+		__m128 gain = channels == 1
+			? _mm_set_ps(from + step * 3, from + step * 2, from + step, from)
+			: channels == 2
+			? _mm_set_ps(from + step, from + step, from, from)
+			: _mm_set1_ps(from);
+		const __m128 advance = _mm_set1_ps(step * perVector);
+
+		for (; i + 4 <= samples; i += 4)
+		{
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+			gain = _mm_add_ps(gain, advance);
+		}
+	}
+#endif
+	for (; i < samples; i++)
+	{
+		data[i] *= from + step * (i / channels);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Crossfade
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Crossfade (const float * from, const float * to, float * out, int frames, int channels,
+--						float position, float step)
+--						const float * from: The interleaved frames that are fading out.
+--						const float * to: The interleaved frames that are fading in.
+--						float * out: Where the mix is written, which may be either of the inputs.
+--						int frames: The number of frames.
+--						int channels: The number of channels in a frame.
+--						float position: How far through the fade the first frame is, from zero to one.
+--						float step: How much further through the fade each frame is.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Mixes two runs of audio with an equal power fade, the frames fading in are scaled by the square
+--					root of the position and the frames fading out by the square root of what is left. Two songs that
+--					have nothing in common then keep the same loudness the whole way through instead of dipping in
+--					the middle. Positions past either end are held at the end. With SSE2 the square roots are taken
+--					four at a time and the frames are laid out in a vector the same way as in Ramp.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::Crossfade(const float * from, const float * to, float * out, int frames, int channels,
+	float position, float step)
+{
+	int samples = frames * channels;
+	int i = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+	if (channels == 1 || channels == 2 || channels == 4)
+	{
+		int perVector = 4 / channels;
+		__m128 at = channels == 1
+			? _mm_set_ps(position + step * 3, position + step * 2, position + step, position)
+			: channels == 2
+			? _mm_set_ps(position + step, position + step, position, position)
+			: _mm_set1_ps(position);
+		const __m128 advance = _mm_set1_ps(step * perVector);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		for (; i + 4 <= samples; i += 4)
+		{
+			__m128 rising = _mm_sqrt_ps(_mm_min_ps(_mm_max_ps(at, zero), one));
+			__m128 falling = _mm_sqrt_ps(_mm_min_ps(_mm_max_ps(_mm_sub_ps(one, at), zero), one));
+			__m128 mix = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(from + i), falling),
+				_mm_mul_ps(_mm_loadu_ps(to + i), rising));
+
+			_mm_storeu_ps(out + i, mix);
+			at = _mm_add_ps(at, advance);
+		}
+	}
+#endif
+	for (; i < samples; i++)
+	{
+		float at = qBound(0.0f, position + step * (i / channels), 1.0f);
+		out[i] = from[i] * std::sqrt(1.0f - at) + to[i] * std::sqrt(at);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Biquads
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Biquads (float * data, int frames, int channels, const float * coefs, int sections, float * state)
+--						float * data: The interleaved frames to filter in place.
+--						int frames: The number of frames.
+--						int channels: The number of channels in a frame.
+--						const float * coefs: b0, b1, b2, a1 and a2 of every section, one section after another.
+--						int sections: The number of biquads the frames go through one after the other.
+--						float * state: The two delays of each section for every channel, kept as two runs of one value
+--							for every channel per section, which carry on from one call to the next.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs every channel through a chain of biquads in transposed direct form II, like the bands of an
+--					equalizer. The whole block goes through two sections at a time, so the delays and coefficients
+--					of both stay in registers and the second section can work on one frame while the first is
+--					already on the next, which hides much of the wait of each sample on the one before it. An odd
+--					section at the end is paired with one that changes nothing. With SSE2 four channels, or a pair of
+--					channels, are filtered together, and a single channel that is left over is filtered with a plain
+--					loop. A delay that has decayed to almost nothing is set to zero at the end, so a long silence
+--					never slows the filters down with denormal numbers.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::Biquads(float * data, int frames, int channels, const float * coefs, int sections, float * state)
+{
+	// A section that passes its input through unchanged, which stands in for the second of a pair when the number of
+	// sections is odd
+	static const float identity[5] = { 1, 0, 0, 0, 0 };
+	float spare[8] = {};
+
+	for (int s = 0; s < sections; s += 2)
+	{
+		bool pair = s + 1 < sections;
+		const float * coef = coefs + s * 5;
+		const float * next = pair ? coef + 5 : identity;
+		float * z1 = state + s * channels * 2;
+		float * z2 = z1 + channels;
+		float * w1 = pair ? z2 + channels : spare;
+		float * w2 = pair ? w1 + channels : spare + 4;
+		int c = 0;
+
+#ifdef AUDIO_KERNELS_SSE2
+		const __m128 b0 = _mm_set1_ps(coef[0]);
+		const __m128 b1 = _mm_set1_ps(coef[1]);
+		const __m128 b2 = _mm_set1_ps(coef[2]);
+		const __m128 a1 = _mm_set1_ps(coef[3]);
+		const __m128 a2 = _mm_set1_ps(coef[4]);
+		const __m128 d0 = _mm_set1_ps(next[0]);
+		const __m128 d1 = _mm_set1_ps(next[1]);
+		const __m128 d2 = _mm_set1_ps(next[2]);
+		const __m128 c1 = _mm_set1_ps(next[3]);
+		const __m128 c2 = _mm_set1_ps(next[4]);
+
+		for (; c + 4 <= channels; c += 4)
+		{
+			__m128 first = _mm_loadu_ps(z1 + c);
+			__m128 second = _mm_loadu_ps(z2 + c);
+			__m128 third = pair ? _mm_loadu_ps(w1 + c) : _mm_setzero_ps();
+			__m128 fourth = pair ? _mm_loadu_ps(w2 + c) : _mm_setzero_ps();
+
+			for (int f = 0; f < frames; f++)
+			{
+				float * frame = data + f * channels + c;
+				__m128 x = _mm_loadu_ps(frame);
+				__m128 y = _mm_add_ps(_mm_mul_ps(b0, x), first);
+				__m128 z = _mm_add_ps(_mm_mul_ps(d0, y), third);
+
+				first = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1, x), second), _mm_mul_ps(a1, y));
+				second = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+				third = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(d1, y), fourth), _mm_mul_ps(c1, z));
+				fourth = _mm_sub_ps(_mm_mul_ps(d2, y), _mm_mul_ps(c2, z));
+				_mm_storeu_ps(frame, z);
+			}
+
+			_mm_storeu_ps(z1 + c, first);
+			_mm_storeu_ps(z2 + c, second);
+			if (pair)
+			{
+				_mm_storeu_ps(w1 + c, third);
+				_mm_storeu_ps(w2 + c, fourth);
+			}
+		}
+
+		for (; c + 2 <= channels; c += 2)
+		{
+			__m128 first = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(z1 + c));
+			__m128 second = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(z2 + c));
+			__m128 third = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(w1 + (pair ? c : 0)));
+			__m128 fourth = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(w2 + (pair ? c : 0)));
+
+			for (int f = 0; f < frames; f++)
+			{
+				float * frame = data + f * channels + c;
+				__m128 x = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)frame);
+				__m128 y = _mm_add_ps(_mm_mul_ps(b0, x), first);
+				__m128 z = _mm_add_ps(_mm_mul_ps(d0, y), third);
+
+				first = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1, x), second), _mm_mul_ps(a1, y));
+				second = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+				third = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(d1, y), fourth), _mm_mul_ps(c1, z));
+				fourth = _mm_sub_ps(_mm_mul_ps(d2, y), _mm_mul_ps(c2, z));
+				_mm_storel_pi((__m64 *)frame, z);
+			}
+
+			_mm_storel_pi((__m64 *)(z1 + c), first);
+			_mm_storel_pi((__m64 *)(z2 + c), second);
+			if (pair)
+			{
+				_mm_storel_pi((__m64 *)(w1 + c), third);
+				_mm_storel_pi((__m64 *)(w2 + c), fourth);
+			}
+		}
+#endif
+
+		for (; c < channels; c++)
+		{
+			float first = z1[c];
+			float second = z2[c];
+			float third = pair ? w1[c] : 0;
+			float fourth = pair ? w2[c] : 0;
+
+			for (int f = 0; f < frames; f++)
+			{
+				float x = data[f * channels + c];
+				float y = coef[0] * x + first;
+				float z = next[0] * y + third;
+
+				first = coef[1] * x + second - coef[3] * y;
+				second = coef[2] * x - coef[4] * y;
+				third = next[1] * y + fourth - next[3] * z;
+				fourth = next[2] * y - next[4] * z;
+				data[f * channels + c] = z;
+			}
+
+			z1[c] = first;
+			z2[c] = second;
+			if (pair)
+			{
+				w1[c] = third;
+				w2[c] = fourth;
+			}
+		}
+	}
+
+	for (int i = 0; i < sections * channels * 2; i++)
+	{
+		if (std::fabs(state[i]) < 1e-15f)
+		{
+			state[i] = 0;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LowPass
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		LowPass (double frequency, int sampleRate, int sections, float * coefs)
+--						double frequency: The cutoff in Hz.
+--						int sampleRate: The sample rate the filter runs at.
+--						int sections: The number of biquads.
+--						float * coefs: Where b0, b1, b2, a1 and a2 of each biquad are written, ready for Biquads.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Works out a Butterworth low-pass filter as a chain of low-pass biquads from the Audio EQ Cookbook by
+--					Robert Bristow-Johnson. The biquads share the cutoff and each gets the Q of one pair of poles of
+--					the Butterworth filter, so together they are flat up to the cutoff and fall off steeply after it.
+--					This is what keeps the resamplers from folding what is above half the lower rate back into what
+--					is heard.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioKernels::LowPass(double frequency, int sampleRate, int sections, float * coefs)
+{
+	const double pi = 3.14159265358979323846;
+
+	double w0 = 2 * pi * frequency / sampleRate;
+
+	for (int i = 0; i < sections; i++)
+	{
+		double q = 1 / (2 * cos((2 * i + 1) * pi / (4 * sections)));
+		double alpha = sin(w0) / (2 * q);
+		double a0 = 1 + alpha;
+		float * section = coefs + i * 5;
+
+		section[0] = (float)((1 - cos(w0)) / 2 / a0);
+		section[1] = (float)((1 - cos(w0)) / a0);
+		section[2] = (float)((1 - cos(w0)) / 2 / a0);
+		section[3] = (float)(-2 * cos(w0) / a0);
+		section[4] = (float)((1 - alpha) / a0);
+	}
+}
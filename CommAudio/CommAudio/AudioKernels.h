@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QtEndian>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+class AudioKernels
+{
+public:
+	static void ToInt16(const char * in, int samples, const QAudioFormat & format, qint16 * out);
+	static void FromInt16(const qint16 * in, int samples, const QAudioFormat & format, char * out);
+
+	static void MapChannels(const qint16 * in, int frames, int inChannels, qint16 * out, int outChannels);
+	static void Resample(const qint16 * in, int inFrames, qint16 * out, int outFrames, int channels);
+	static double ResampleCubic(const qint16 * in, qint16 * out, int outFrames, int channels, double position,
+		double step);
+
+	static void MixAdd(qint16 * mix, const qint16 * in, int samples, int gain);
+	static void Accumulate(qint32 * sum, const qint16 * in, int samples);
+	static void MixMinus(const qint32 * sum, const qint16 * own, qint16 * out, int samples);
+
+	static void RestoreLpc(qint32 * samples, int count, const qint32 * coefs, int order, int shift, int bits,
+		int precision, qint16 * history);
+	static void Interleave(const qint32 * const * channels, int channelCount, int frames, int shift, int sampleSize,
+		char * out);
+
+	static void Peaks(const qint16 * in, int samples, qint16 * minimum, qint16 * maximum, quint64 * squares);
+	static void KWeight(const qint16 * in, int frames, int channels, const double * coefs, double * state,
+		double * squares);
+	static void ApplyGain(char * data, int samples, const QAudioFormat & format, int gain);
+
+	static void ToFloat(const char * in, int samples, const QAudioFormat & format, float * out);
+	static void FromFloat(const float * in, int samples, const QAudioFormat & format, char * out);
+	static void Ramp(float * data, int frames, int channels, float from, float to);
+	static void Crossfade(const float * from, const float * to, float * out, int frames, int channels, float position,
+		float step);
+	static void Biquads(float * data, int frames, int channels, const float * coefs, int sections, float * state);
+	static void LowPass(double frequency, int sampleRate, int sections, float * coefs);
+};
@@ -0,0 +1,404 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		AudioThread.cpp - Plays a QIODevice on a thread of its own.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					AudioThread(const QAudioFormat & format, QIODevice * source, const QString & name,
+--						QObject * parent = nullptr)
+--					~AudioThread()
+--					void Start(int bufferBytes)
+--					void Stop()
+--					void SetFormat(const QAudioFormat & format)
+--					void SetVolume(qreal volume)
+--					QAudioFormat Format() const
+--					int BufferedBytes() const
+--					int Underruns() const
+--					qint64 ProcessedUSecs() const
+--					void run()
+--					void notifyHandler()
+--					void stateHandler(QAudio::State state)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Plays on a sink from the selected AudioBackend.
+--					October 19, 2026 - agent: The format and volume can be changed and the played time is counted, so
+--									the media player can play on one.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					A QAudioOutput in pull mode reads its source from the event loop of the thread it was made on. On
+--					the GUI thread that means a slow repaint or a burst of network traffic holds the device up and the
+--					audio glitches. This class runs the output and its source on a time critical thread with nothing
+--					else on it.
+--
+--					The source is moved to the audio thread, so everything it reads from the rest of the program has to
+--					come through something that is safe across threads without blocking, like a RingBuffer. The output
+--					is made and destroyed inside run, so it is never touched from another thread. What the rest of the
+--					program wants to know about it is copied into atomics as it plays, and what it wants to change about
+--					it, like the volume, is picked up from atomics the same way.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "AudioThread.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AudioThread
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Takes the name of the sink to play on.
+--					October 19, 2026 - agent: Registers QAudio::State so stateChanged can be queued.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		AudioThread (const QAudioFormat & format, QIODevice * source, const QString & name,
+--						QObject * parent)
+--						const QAudioFormat & format: The format of the audio the source gives.
+--						QIODevice * source: An open device with no parent to play from.
+--						const QString & name: What is played, the name of the sink on the headless backends.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The source is moved to the audio thread straight away. It stays owned by the caller, which must
+--					stop the thread before deleting it.
+----------------------------------------------------------------------------------------------------------------------*/
+AudioThread::AudioThread(const QAudioFormat & format, QIODevice * source, const QString & name, QObject * parent)
+	: QThread(parent)
+	, mFormat(format)
+	, mSource(source)
+	, mName(name)
+	, mBufferBytes(0)
+	, mOutput(nullptr)
+	, mProcessedBase(0)
+	, mBuffered(0)
+	, mUnderruns(0)
+	, mVolume(1000)
+	, mProcessed(0)
+{
+	// stateChanged is queued to the thread of its receivers, which needs the state registered
+	qRegisterMetaType<QAudio::State>();
+
+	mSource->moveToThread(this);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~AudioThread
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~AudioThread ()
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+AudioThread::~AudioThread()
+{
+	Stop();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Start
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Start (int bufferBytes)
+--						int bufferBytes: The size of the buffer of the output device.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Restarts the thread if it is already playing so a new buffer size takes effect.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioThread::Start(int bufferBytes)
+{
+	Stop();
+
+	mBufferBytes = bufferBytes;
+	start(QThread::TimeCriticalPriority);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Stop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Stop ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Stops the output and waits for the thread to finish, after which the source is not being read.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioThread::Stop()
+{
+	if (isRunning())
+	{
+		quit();
+		wait();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetFormat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetFormat (const QAudioFormat & format)
+--						const QAudioFormat & format: The format of the audio the source gives from now on.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Only called while the thread is stopped. The next Start opens the output in the new format.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioThread::SetFormat(const QAudioFormat & format)
+{
+	mFormat = format;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetVolume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetVolume (qreal volume)
+--						qreal volume: The volume from 0 to 1.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Can be called at any time. The output picks the volume up at its next notify, and keeps it when
+--					it is started again.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioThread::SetVolume(qreal volume)
+{
+	mVolume.store(qRound(qBound<qreal>(0, volume, 1) * 1000));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Format ()
+--
+-- RETURNS:			The format the output is opened in.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat AudioThread::Format() const
+{
+	return mFormat;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		BufferedBytes
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		BufferedBytes ()
+--
+-- RETURNS:			How much audio the output device had yet to play when it last reported, 0 when stopped.
+----------------------------------------------------------------------------------------------------------------------*/
+int AudioThread::BufferedBytes() const
+{
+	return mBuffered.load();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Underruns
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Underruns ()
+--
+-- RETURNS:			How many times the output device ran out of audio.
+----------------------------------------------------------------------------------------------------------------------*/
+int AudioThread::Underruns() const
+{
+	return mUnderruns.load();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ProcessedUSecs
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ProcessedUSecs ()
+--
+-- RETURNS:			How much audio the output has played over every time it was started, in microseconds.
+--
+-- NOTES:
+--					This is as of the last notify while the thread runs, so it is up to AUDIO_THREAD_NOTIFY_MS behind.
+--					Once the thread has stopped it is exact and stays put until the thread is started again.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 AudioThread::ProcessedUSecs() const
+{
+	return mProcessed.load();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		run
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The sink comes from the AudioBackend.
+--					October 19, 2026 - agent: Sets the volume and counts the played time on from the last run.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		run ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs on the audio thread. The handlers are connected directly so they run here too, instead of
+--					being queued to the GUI thread where AudioThread itself lives. The sink is made here so a headless
+--					one runs its timer on this thread as well.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioThread::run()
+{
+	QScopedPointer<AudioSink> output(AudioBackend::CreateSink(mFormat, mName));
+	mOutput = output.data();
+
+	output->setBufferSize(mBufferBytes);
+	output->setNotifyInterval(AUDIO_THREAD_NOTIFY_MS);
+	output->setVolume(mVolume.load() / 1000.0);
+	mProcessedBase = mProcessed.load();
+
+	connect(mOutput, &AudioSink::notify, this, &AudioThread::notifyHandler, Qt::DirectConnection);
+	connect(mOutput, &AudioSink::stateChanged, this, &AudioThread::stateHandler, Qt::DirectConnection);
+
+	output->start(mSource);
+	exec();
+	output->stop();
+
+	mProcessed.store(mProcessedBase + output->processedUSecs());
+	mOutput = nullptr;
+	mBuffered.store(0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		notifyHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Records the played time and picks up a new volume.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		notifyHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is the Qt slot that is triggered every AUDIO_THREAD_NOTIFY_MS of played audio. It runs on the
+--					audio thread and records how full the device is and how much it has played. A volume set since
+--					the last notify is passed on to the device.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioThread::notifyHandler()
+{
+	if (mOutput)
+	{
+		mBuffered.store(mOutput->bufferSize() - mOutput->bytesFree());
+		mProcessed.store(mProcessedBase + mOutput->processedUSecs());
+
+		int volume = mVolume.load();
+		if (qRound(mOutput->volume() * 1000) != volume)
+		{
+			mOutput->setVolume(volume / 1000.0);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		stateHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Passes the state on with stateChanged.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		stateHandler (QAudio::State state)
+--						QAudio::State state: The new state of the output.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is the Qt slot that is triggered when the output changes state. It runs on the audio thread.
+--					The output going idle with an underrun error means the device played everything it had. The state
+--					is passed on with stateChanged, which reaches receivers on other threads through their event loop.
+----------------------------------------------------------------------------------------------------------------------*/
+void AudioThread::stateHandler(QAudio::State state)
+{
+	if (mOutput && state == QAudio::IdleState && mOutput->error() == QAudio::UnderrunError)
+	{
+		mUnderruns.fetchAndAddRelaxed(1);
+	}
+
+	emit stateChanged(state);
+}
\ No newline at end of file
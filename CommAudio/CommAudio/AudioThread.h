@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QAudioFormat>
+#include <QIODevice>
+#include <QScopedPointer>
+#include <QString>
+#include <QThread>
+
+#include "AudioBackend.h"
+#include "globals.h"
+
+class AudioThread : public QThread
+{
+	Q_OBJECT
+
+public:
+	AudioThread(const QAudioFormat & format, QIODevice * source, const QString & name, QObject * parent = nullptr);
+	~AudioThread();
+
+	void Start(int bufferBytes);
+	void Stop();
+	void SetFormat(const QAudioFormat & format);
+	void SetVolume(qreal volume);
+
+	QAudioFormat Format() const;
+	int BufferedBytes() const;
+	int Underruns() const;
+	qint64 ProcessedUSecs() const;
+
+protected:
+	void run() override;
+
+private:
+	QAudioFormat mFormat;
+	QIODevice * mSource;
+	QString mName;
+	int mBufferBytes;
+
+	// Only touched from the audio thread while it runs, along with where the played time of this run counts on from
+	AudioSink * mOutput;
+	qint64 mProcessedBase;
+
+	QAtomicInt mBuffered;
+	QAtomicInt mUnderruns;
+
+	// The volume in thousandths, and the audio played over every run in microseconds
+	QAtomicInt mVolume;
+	QAtomicInteger<qint64> mProcessed;
+
+private slots:
+	void notifyHandler();
+	void stateHandler(QAudio::State state);
+
+signals:
+	void stateChanged(QAudio::State state);
+};
\ No newline at end of file
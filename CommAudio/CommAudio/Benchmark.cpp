@@ -0,0 +1,2417 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		Benchmark.cpp - Timings of the hot paths of the program, printed with --benchmark.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					static QStringList Run()
+--					static QStringList VoiceCodecReport()
+--					static QStringList VoiceActivityReport()
+--					static QStringList VoiceLatencyReport()
+--					static QStringList AudioBackendReport()
+--					static qint64 playHeadless(QIODevice * device, const QAudioFormat & format, bool realTime,
+--						qint64 * processed)
+--					static QStringList VoiceFecReport()
+--					static QStringList VoiceDriftReport()
+--					static QStringList VoiceBridgeReport()
+--					static QStringList WavParserReport()
+--					static QStringList MappedSongReport()
+--					static QStringList LibraryIndexReport()
+--					static QStringList FlacDecoderReport()
+--					static QStringList LoudnessReport()
+--					static QStringList PlaylistReport()
+--					static QStringList DspReport()
+--					static QVector<qint16> voiceSignal(int samples, int sampleRate)
+--					static QVector<qint16> meetingSignal(int seconds, int sampleRate)
+--					static double snr(const qint16 * reference, const qint16 * decoded, int samples)
+--					static QByteArray wavFile(int layout, int frames)
+--					static QByteArray flacFile(const QVector<qint16> & samples, int sampleRate, int order,
+--						int precision)
+--					static void flacSubframe(QByteArray & bytes, quint64 & cache, int & count, const qint32 * signal,
+--						int samples, int bits, int order, int precision)
+--					static int lpcCoefficients(const qint32 * signal, int samples, int order, int precision,
+--						qint32 * coefs)
+--					static void writeBits(QByteArray & bytes, quint64 & cache, int & count, quint32 value, int bits)
+--					static double pullNs(DspNode * node, const QVector<QBuffer *> & buffers, int frames)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Added the silence suppression report.
+--					October 19, 2026 - agent: Added the voice latency loopback test.
+--					October 19, 2026 - agent: Added the headless audio backend report.
+--					October 19, 2026 - agent: Added the voice FEC loss test.
+--					October 19, 2026 - agent: Added the voice clock drift test.
+--					October 19, 2026 - agent: Added the host mixing report.
+--					October 19, 2026 - agent: Added the wav header parsing report.
+--					October 19, 2026 - agent: Added the mapped playback report.
+--					October 19, 2026 - agent: Added the library index report.
+--					October 19, 2026 - agent: Added the FLAC decoder report.
+--					October 19, 2026 - agent: Added the loudness report.
+--					October 19, 2026 - agent: Added the playlist report.
+--					October 19, 2026 - agent: Added the playback chain report.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Starting the program with --benchmark prints these reports and exits without opening the window.
+--					Everything runs on a synthetic signal, so the numbers can be compared between machines and builds
+--					without needing a microphone or a network.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "Benchmark.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Run
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Runs the silence suppression report.
+--					October 19, 2026 - agent: Runs the voice latency loopback test.
+--					October 19, 2026 - agent: Runs the headless audio backend report.
+--					October 19, 2026 - agent: Runs the voice FEC loss test.
+--					October 19, 2026 - agent: Runs the voice clock drift test.
+--					October 19, 2026 - agent: Runs the host mixing report.
+--					October 19, 2026 - agent: Runs the wav header parsing report.
+--					October 19, 2026 - agent: Runs the mapped playback report.
+--					October 19, 2026 - agent: Runs the library index report.
+--					October 19, 2026 - agent: Runs the FLAC decoder report.
+--					October 19, 2026 - agent: Runs the loudness report.
+--					October 19, 2026 - agent: Runs the playlist report.
+--					October 19, 2026 - agent: Runs the playback chain report.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Run ()
+--
+-- RETURNS:			The lines of every report.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::Run()
+{
+	return VoiceCodecReport() + VoiceActivityReport() + VoiceLatencyReport() + AudioBackendReport() + VoiceFecReport()
+		+ VoiceDriftReport() + VoiceBridgeReport() + WavParserReport() + MappedSongReport()
+		+ LibraryIndexReport() + FlacDecoderReport() + LoudnessReport() + PlaylistReport() + DspReport();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceCodecReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceCodecReport ()
+--
+-- RETURNS:			One line for raw 44.1 kHz stereo and one for every built in voice codec.
+--
+-- NOTES:
+--					Every codec encodes and then decodes BENCHMARK_ITERATIONS frames of VOIP_FRAME_MS at
+--					VOIP_SAMPLE_RATE. The time of each pass is divided by the number of frames. The bandwidth counts
+--					the packet header, but not TCP/IP, and the uplink is what one client sends to BENCHMARK_MESH_PEERS
+--					peers. The signal to noise ratio shows how much the codec costs in quality.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::VoiceCodecReport()
+{
+	const int samples = VOIP_SAMPLE_RATE * VOIP_FRAME_MS / 1000;
+	const int framesPerSecond = 1000 / VOIP_FRAME_MS;
+	const int signalFrames = framesPerSecond;
+
+	QVector<qint16> signal = voiceSignal(samples * signalFrames, VOIP_SAMPLE_RATE);
+	QStringList report;
+
+	report << QString("Voice codecs, %1 ms frames of %2 Hz mono, %3 frames each")
+		.arg(VOIP_FRAME_MS).arg(VOIP_SAMPLE_RATE).arg(BENCHMARK_ITERATIONS);
+
+	double rawKbps = 44100 * 2 * sizeof(qint16) * 8 / 1000.0;
+	report << QString("  raw 44.1 kHz stereo: %1 kbit/s per direction, %2 kbit/s uplink")
+		.arg(rawKbps, 0, 'f', 1).arg(rawKbps * BENCHMARK_MESH_PEERS, 0, 'f', 1);
+
+	QList<quint8> codecs = VoiceCodec::Preferred();
+	for (int i = 0; i < codecs.size(); i++)
+	{
+		if (!VoiceCodec::Linked(codecs[i]))
+		{
+			continue;
+		}
+
+		VoiceCodec * codec = VoiceCodec::Create(codecs[i]);
+		QVector<QByteArray> packets(signalFrames);
+		QVector<qint16> decoded(signal.size());
+
+		QElapsedTimer timer;
+		timer.start();
+		for (int n = 0; n < BENCHMARK_ITERATIONS; n++)
+		{
+			int frame = n % signalFrames;
+			packets[frame] = codec->Encode(signal.constData() + frame * samples, samples);
+		}
+		double encodeNs = (double)timer.nsecsElapsed() / BENCHMARK_ITERATIONS;
+
+		timer.restart();
+		for (int n = 0; n < BENCHMARK_ITERATIONS; n++)
+		{
+			int frame = n % signalFrames;
+			QVector<qint16> out = codec->Decode(packets[frame]);
+
+			if (out.size() == samples)
+			{
+				memcpy(decoded.data() + frame * samples, out.constData(), samples * sizeof(qint16));
+			}
+		}
+		double decodeNs = (double)timer.nsecsElapsed() / BENCHMARK_ITERATIONS;
+
+		int bytes = packets[0].size() + VOIP_PACKET_HEADER_SIZE;
+		double kbps = bytes * 8.0 * framesPerSecond / 1000.0;
+
+		report << QString("  %1: %2 bytes/frame, encode %3 ns/frame, decode %4 ns/frame, %5 kbit/s per direction, "
+			"%6 kbit/s uplink, SNR %7 dB")
+			.arg(codec->Name()).arg(bytes).arg(encodeNs, 0, 'f', 0).arg(decodeNs, 0, 'f', 0)
+			.arg(kbps, 0, 'f', 1).arg(kbps * BENCHMARK_MESH_PEERS, 0, 'f', 1)
+			.arg(snr(signal.constData(), decoded.constData(), signal.size()), 0, 'f', 1);
+
+		delete codec;
+	}
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceActivityReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceActivityReport ()
+--
+-- RETURNS:			The time the detector takes per frame and what silence suppression saves over a minute of meeting.
+--
+-- NOTES:
+--					The frames are sent the way VoipModule sends them, with IMA ADPCM and a comfort noise packet every
+--					VOIP_COMFORT_NOISE_INTERVAL silent frames, and compared to sending every frame.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::VoiceActivityReport()
+{
+	const int samples = VOIP_SAMPLE_RATE * VOIP_FRAME_MS / 1000;
+	const int seconds = 60;
+
+	QVector<qint16> signal = meetingSignal(seconds, VOIP_SAMPLE_RATE);
+	int frames = signal.size() / samples;
+	int frameBytes = VOIP_PACKET_HEADER_SIZE + ImaAdpcm::Encode(signal.constData(), samples).size();
+	int comfortBytes = VOIP_PACKET_HEADER_SIZE + sizeof(quint16);
+
+	VoiceActivityDetector vad;
+	qint64 sent = 0;
+	int speechFrames = 0;
+	int silentFrames = 0;
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < frames; i++)
+	{
+		if (vad.IsSpeech(signal.constData() + i * samples, samples))
+		{
+			sent += frameBytes;
+			speechFrames++;
+			silentFrames = 0;
+		}
+		else
+		{
+			if (silentFrames % VOIP_COMFORT_NOISE_INTERVAL == 0)
+			{
+				sent += comfortBytes;
+			}
+			silentFrames++;
+		}
+	}
+	double vadNs = (double)timer.nsecsElapsed() / frames;
+
+	qint64 unsuppressed = (qint64)frames * frameBytes;
+
+	QStringList report;
+	report << QString("Silence suppression, %1 s of a meeting where the user talks 40% of the time").arg(seconds);
+	report << QString("  detector %1 ns/frame, %2 of %3 frames sent, %4 of %5 bytes sent, %6% saved")
+		.arg(vadNs, 0, 'f', 0).arg(speechFrames).arg(frames).arg(sent).arg(unsuppressed)
+		.arg(100.0 * (unsuppressed - sent) / unsuppressed, 0, 'f', 1);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceLatencyReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceLatencyReport ()
+--
+-- RETURNS:			The latency budget of the voice path from capture to playout.
+--
+-- NOTES:
+--					Frames are sent through a loopback TCP connection set up like a voice socket. Each is preceded by a
+--					LatencyProbe holding the time it was captured, so the receiver measures encoding, the network and
+--					decoding together. The decoded frames are then pushed into a VoiceMixer the way they would arrive,
+--					one every VOIP_FRAME_MS, while a simulated output pulls from the mixer every playback period. The
+--					time a frame waits in the mixer before the output takes it is the jitter buffer delay.
+--
+--					Capture and playout are the device buffers from VOIP_CAPTURE_BUFFER_MS and
+--					VOIP_PLAYBACK_BUFFER_MS since there are no devices in the test.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::VoiceLatencyReport()
+{
+	const int frames = 250;
+	const int periodMs = VOIP_PLAYBACK_BUFFER_MS / 2;
+	const quint32 address = 1;
+
+	QStringList report;
+	report << QString("Voice latency, %1 timestamped frames through a loopback voice socket").arg(frames);
+
+	QTcpServer server;
+	QTcpSocket sender;
+	server.listen(QHostAddress::LocalHost);
+	sender.connectToHost(QHostAddress::LocalHost, server.serverPort());
+
+	if (!sender.waitForConnected(1000) || !server.waitForNewConnection(1000))
+	{
+		report << "  could not open a loopback connection";
+		return report;
+	}
+
+	QTcpSocket * receiver = server.nextPendingConnection();
+	sender.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+	sender.setSocketOption(QAbstractSocket::TypeOfServiceOption, VOIP_LOW_DELAY_TOS);
+
+	QAudioFormat format;
+	format.setSampleRate(VOIP_SAMPLE_RATE);
+	format.setSampleSize(16);
+	format.setChannelCount(1);
+	format.setCodec("audio/pcm");
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setSampleType(QAudioFormat::SignedInt);
+
+	const int samples = VOIP_SAMPLE_RATE * VOIP_FRAME_MS / 1000;
+	QVector<qint16> signal = voiceSignal(samples * frames, VOIP_SAMPLE_RATE);
+
+	AdpcmCodec codec;
+	QElapsedTimer clock;
+	clock.start();
+
+	// Send every frame through the socket and note how long it took to come out decoded
+	QVector<qint64> network(frames);
+	QVector<QByteArray> decoded(frames);
+	QByteArray received;
+
+	for (int i = 0; i < frames; i++)
+	{
+		quint64 captured = clock.nsecsElapsed() / 1000;
+		QByteArray payload = codec.Encode(signal.constData() + i * samples, samples);
+
+		QByteArray packets;
+		packets << (quint8)VoicePackets::LatencyProbe << (quint16)VOIP_PROBE_SIZE
+			<< (quint32)(captured >> 32) << (quint32)captured;
+		packets << (quint8)VoicePackets::VoiceFrame << (quint16)payload.size();
+		packets.append(payload);
+
+		sender.write(packets);
+		sender.flush();
+
+		while (received.size() < packets.size() && receiver->waitForReadyRead(1000))
+		{
+			received.append(receiver->readAll());
+		}
+
+		if (received.size() < packets.size())
+		{
+			report << "  the loopback connection stalled";
+			delete receiver;
+			return report;
+		}
+
+		quint64 stamp;
+		QDataStream(received.mid(VOIP_PACKET_HEADER_SIZE, VOIP_PROBE_SIZE)) >> stamp;
+
+		int frameStart = VOIP_PACKET_HEADER_SIZE + VOIP_PROBE_SIZE;
+		QVector<qint16> audio = codec.Decode(received.mid(frameStart + VOIP_PACKET_HEADER_SIZE, payload.size()));
+		received.remove(0, packets.size());
+
+		network[i] = clock.nsecsElapsed() / 1000 - (qint64)stamp;
+		decoded[i] = QByteArray((const char *)audio.constData(), audio.size() * sizeof(qint16));
+	}
+
+	delete receiver;
+
+	// Play the frames out on a simulated clock in microseconds
+	VoiceMixer mixer(format);
+	QByteArray period(format.bytesForDuration(periodMs * 1000), 0);
+	QVector<qint64> jitter(frames);
+	qint64 pushed = 0;
+	int next = 0;
+	int played = 0;
+
+	// A few frames left over after a late arrival may never fill the jitter queue again, so give up after a while
+	const qint64 end = (qint64)(frames + VOIP_JITTER_MAX_FRAMES) * VOIP_FRAME_MS * 1000 + 1000 * 1000;
+
+	for (qint64 now = 0; played < frames && now < end; now += periodMs * 1000)
+	{
+		while (next < frames && (qint64)next * VOIP_FRAME_MS * 1000 + network[next] <= now)
+		{
+			mixer.Push(address, decoded[next]);
+			pushed += decoded[next].size();
+			next++;
+		}
+
+		mixer.read(period.data(), period.size());
+
+		// Every frame whose first sample has left the mixer has been played
+		qint64 consumed = pushed - mixer.QueuedBytes(address);
+		while (played < next && (qint64)played * format.bytesForDuration(VOIP_FRAME_MS * 1000) < consumed)
+		{
+			jitter[played] = now - ((qint64)played * VOIP_FRAME_MS * 1000 + network[played]);
+			played++;
+		}
+	}
+
+	qint64 networkTotal = 0;
+	qint64 networkMax = 0;
+	qint64 jitterTotal = 0;
+	qint64 jitterMax = 0;
+
+	for (int i = 0; i < frames; i++)
+	{
+		networkTotal += network[i];
+		networkMax = qMax(networkMax, network[i]);
+	}
+
+	for (int i = 0; i < played; i++)
+	{
+		jitterTotal += jitter[i];
+		jitterMax = qMax(jitterMax, jitter[i]);
+	}
+
+	VoiceLatency latency;
+	latency.capture = (qint64)(VOIP_CAPTURE_BUFFER_MS + VOIP_FRAME_MS) * 1000;
+	latency.network = networkTotal / frames;
+	latency.jitter = played > 0 ? jitterTotal / played : 0;
+	latency.playout = (qint64)VOIP_PLAYBACK_BUFFER_MS * 1000;
+
+	report << QString("  capture %1 ms: %2 ms device buffer and one %3 ms frame")
+		.arg(latency.capture / 1000.0, 0, 'f', 1).arg(VOIP_CAPTURE_BUFFER_MS).arg(VOIP_FRAME_MS);
+	report << QString("  encode, network and decode %1 ms, at most %2 ms")
+		.arg(latency.network / 1000.0, 0, 'f', 2).arg(networkMax / 1000.0, 0, 'f', 2);
+	report << QString("  jitter buffer %1 ms, at most %2 ms")
+		.arg(latency.jitter / 1000.0, 0, 'f', 1).arg(jitterMax / 1000.0, 0, 'f', 1);
+	report << QString("  playout %1 ms device buffer").arg(latency.playout / 1000.0, 0, 'f', 1);
+	report << QString("  mouth to ear %1 ms").arg(latency.total() / 1000.0, 0, 'f', 1);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AudioBackendReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		AudioBackendReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Plays a song through a NullSink as fast as it goes, which is the ceiling on how quickly a headless
+--					test can push audio through the player, then a short one in real time to check the sink keeps to
+--					the clock the way a sound card would.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::AudioBackendReport()
+{
+	const int fastSeconds = 60;
+	const int realTimeSeconds = 2;
+
+	QAudioFormat format;
+	format.setSampleRate(44100);
+	format.setSampleSize(16);
+	format.setChannelCount(2);
+	format.setCodec("audio/pcm");
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setSampleType(QAudioFormat::SignedInt);
+
+	QStringList report;
+	report << QString("Headless audio, 44.1 kHz stereo through a null sink");
+
+	QByteArray song(format.bytesForDuration((qint64)fastSeconds * 1000000), 0);
+	QBuffer fast(&song);
+	fast.open(QIODevice::ReadOnly);
+
+	qint64 processed = 0;
+	qint64 elapsed = playHeadless(&fast, format, false, &processed);
+
+	report << QString("  fast: %1 s played in %2 ms, %3x real time")
+		.arg(processed / 1000000.0, 0, 'f', 1).arg(elapsed / 1000.0, 0, 'f', 1)
+		.arg(processed / (double)qMax<qint64>(elapsed, 1), 0, 'f', 0);
+
+	song.resize(format.bytesForDuration((qint64)realTimeSeconds * 1000000));
+	QBuffer paced(&song);
+	paced.open(QIODevice::ReadOnly);
+
+	elapsed = playHeadless(&paced, format, true, &processed);
+
+	report << QString("  real time: %1 s played in %2 s, %3 ms off the clock")
+		.arg(processed / 1000000.0, 0, 'f', 2).arg(elapsed / 1000000.0, 0, 'f', 2)
+		.arg((elapsed - processed) / 1000.0, 0, 'f', 1);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		playHeadless
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		playHeadless (QIODevice * device, const QAudioFormat & format, bool realTime, qint64 * processed)
+--						QIODevice * device: An open device to play to the end.
+--						const QAudioFormat & format: The format of the audio in the device.
+--						bool realTime: Whether the sink keeps to the clock.
+--						qint64 * processed: Set to the microseconds of audio the sink played.
+--
+-- RETURNS:			The microseconds it took to play the device.
+--
+-- NOTES:
+--					Runs an event loop until the sink goes idle, which it does once everything has been played. The
+--					loop is given up after twice the length of the audio in case the sink stalls.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 Benchmark::playHeadless(QIODevice * device, const QAudioFormat & format, bool realTime, qint64 * processed)
+{
+	NullSink sink(format, realTime);
+	QEventLoop loop;
+	QTimer guard;
+
+	QObject::connect(&sink, &AudioSink::stateChanged, &loop, &QEventLoop::quit);
+	QObject::connect(&guard, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+	guard.setSingleShot(true);
+	guard.start(qMax<qint64>(format.durationForBytes(device->bytesAvailable()) / 500, 1000));
+
+	QElapsedTimer timer;
+	timer.start();
+	sink.start(device);
+
+	while (sink.state() == QAudio::ActiveState && guard.isActive())
+	{
+		loop.exec();
+	}
+
+	qint64 elapsed = timer.nsecsElapsed() / 1000;
+	*processed = sink.processedUSecs();
+	sink.stop();
+
+	return elapsed;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceFecReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceFecReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Sends IMA ADPCM voice frames as datagrams through a proxy on the loopback that drops them at random
+--					at 1 to 10 percent loss. The receiver reports back once every probe interval's worth of frames, as
+--					it would over the voice connection, so the number of copies adapts as it does in a call. For each
+--					rate it prints how many of the lost frames were recovered, how many were left lost and how many
+--					more bytes the copies cost.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::VoiceFecReport()
+{
+	const int frames = BENCHMARK_ITERATIONS;
+	const int samples = VOIP_SAMPLE_RATE * VOIP_FRAME_MS / 1000;
+	const int reportFrames = VOIP_PROBE_INTERVAL / VOIP_FRAME_MS;
+	const int losses[] = { 1, 2, 5, 10 };
+
+	QStringList report;
+	report << QString("Voice FEC, %1 IMA ADPCM frames through a loopback proxy that drops datagrams").arg(frames);
+
+	QVector<qint16> signal = voiceSignal(samples * frames, VOIP_SAMPLE_RATE);
+	AdpcmCodec codec;
+	QVector<QByteArray> packets(frames);
+
+	for (int i = 0; i < frames; i++)
+	{
+		QByteArray payload = codec.Encode(signal.constData() + i * samples, samples);
+		packets[i] << (quint8)VoicePackets::VoiceFrame << (quint16)payload.size();
+		packets[i].append(payload);
+	}
+
+	QUdpSocket sender;
+	QUdpSocket proxy;
+	QUdpSocket receiver;
+
+	if (!proxy.bind(QHostAddress::LocalHost) || !receiver.bind(QHostAddress::LocalHost))
+	{
+		report << "  could not bind the loopback sockets";
+		return report;
+	}
+
+	for (int loss : losses)
+	{
+		VoiceFec sending;
+		VoiceFec receiving;
+		quint32 seed = 20180420 + loss;
+		qint64 plainBytes = 0;
+		qint64 sentBytes = 0;
+
+		for (int i = 0; i < frames; i++)
+		{
+			QByteArray datagram = sending.Protect(packets[i]);
+			plainBytes += VOIP_DATAGRAM_HEADER_SIZE + packets[i].size();
+			sentBytes += datagram.size();
+
+			sender.writeDatagram(datagram, QHostAddress::LocalHost, proxy.localPort());
+
+			if (!proxy.waitForReadyRead(1000))
+			{
+				report << "  the loopback proxy stalled";
+				return report;
+			}
+
+			QByteArray relayed((int)proxy.pendingDatagramSize(), 0);
+			proxy.readDatagram(relayed.data(), relayed.size());
+
+			// The same generator as the signal noise, so every run drops the same datagrams
+			seed = seed * 1103515245 + 12345;
+			if ((int)((seed >> 16) % 1000) >= loss * 10)
+			{
+				proxy.writeDatagram(relayed, QHostAddress::LocalHost, receiver.localPort());
+
+				if (receiver.waitForReadyRead(1000))
+				{
+					QByteArray arrived((int)receiver.pendingDatagramSize(), 0);
+					receiver.readDatagram(arrived.data(), arrived.size());
+					receiving.Receive(arrived);
+				}
+			}
+
+			if ((i + 1) % reportFrames == 0)
+			{
+				sending.ReportedLoss(receiving.Received(), receiving.Lost());
+			}
+		}
+
+		quint32 lost = receiving.Lost();
+		quint32 recovered = receiving.Recovered();
+
+		report << QString("  %1% loss: %2 of %3 lost frames recovered (%4%), %5% of frames left lost, %6 copies, "
+			"%7% more bytes")
+			.arg(loss, 2).arg(recovered).arg(lost).arg(lost ? 100.0 * recovered / lost : 100.0, 0, 'f', 1)
+			.arg(100.0 * (lost - recovered) / frames, 0, 'f', 2).arg(sending.Depth())
+			.arg(100.0 * (sentBytes - plainBytes) / plainBytes, 0, 'f', 0);
+	}
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceDriftReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceDriftReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Plays a long call through a VoiceMixer on a simulated clock in microseconds, like the latency test.
+--					The peer sends a frame every VOIP_FRAME_MS by its own clock, which runs a few hundred parts per
+--					million fast or slow, and each frame takes a random part of the jitter on the way. The output pulls
+--					from the mixer every AUDIO_THREAD_NOTIFY_MS by ours. For each drift it prints how much was queued
+--					at the start, an hour in and at the end, how far the queue would have moved had the mixer not
+--					followed the drift, what the mixer estimated the drift to be and how long mixing took.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::VoiceDriftReport()
+{
+	const int hours = 2;
+	const int drifts[] = { 300, -300 };
+	const int jitterMs = 15;
+	const int periodMs = AUDIO_THREAD_NOTIFY_MS;
+	const quint32 address = 1;
+
+	QStringList report;
+	report << QString("Voice clock drift, %1 hours of speech from a peer whose clock runs fast or slow").arg(hours);
+
+	QAudioFormat format;
+	format.setSampleRate(VOIP_SAMPLE_RATE);
+	format.setSampleSize(16);
+	format.setChannelCount(1);
+	format.setCodec("audio/pcm");
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setSampleType(QAudioFormat::SignedInt);
+
+	// A second of voice sent over and over
+	const int samples = VOIP_SAMPLE_RATE * VOIP_FRAME_MS / 1000;
+	QVector<qint16> voice = voiceSignal(VOIP_SAMPLE_RATE, VOIP_SAMPLE_RATE);
+	QByteArray period(format.bytesForDuration(periodMs * 1000), 0);
+
+	for (int drift : drifts)
+	{
+		VoiceMixer mixer(format);
+		QElapsedTimer timer;
+		QVector<double> minutes;
+		quint32 seed = 20180420;
+		qint64 arrival = 0;
+		qint64 next = 0;
+		qint64 mixNs = 0;
+		qint64 queued = 0;
+		int reads = 0;
+
+		const qint64 end = (qint64)hours * 3600 * 1000 * 1000;
+
+		for (qint64 now = 0; now < end; now += periodMs * 1000)
+		{
+			// Frames arrive in order, each no sooner than it was sent plus its share of the jitter
+			while (arrival <= now)
+			{
+				int offset = (int)(next % (VOIP_SAMPLE_RATE / samples)) * samples;
+				mixer.Push(address, QByteArray((const char *)(voice.constData() + offset), samples * sizeof(qint16)));
+				next++;
+
+				seed = seed * 1664525 + 1013904223;
+				qint64 sent = (qint64)(next * VOIP_FRAME_MS * 1000 / (1 + drift / 1e6));
+				arrival = qMax(arrival, sent + (qint64)((seed >> 16) % (jitterMs + 1)) * 1000);
+			}
+
+			timer.start();
+			mixer.read(period.data(), period.size());
+			mixNs += timer.nsecsElapsed();
+
+			// Average what is queued over every minute
+			queued += mixer.QueuedBytes(address);
+			reads++;
+
+			if ((now / 1000 + periodMs) % (60 * 1000) == 0)
+			{
+				minutes.append(format.durationForBytes((qint32)(queued / reads)) / 1000.0);
+				queued = 0;
+				reads = 0;
+			}
+		}
+
+		report << QString("  %1 ppm: %2 ms queued after a minute, %3 ms after an hour, %4 ms after %5 hours, "
+			"it would have moved %6 ms without following the drift")
+			.arg(drift, 4).arg(minutes.first(), 0, 'f', 1).arg(minutes[qMin(59, minutes.size() - 1)], 0, 'f', 1)
+			.arg(minutes.last(), 0, 'f', 1).arg(hours).arg(drift / 1e6 * end / 1000.0, 0, 'f', 0);
+		report << QString("    estimated %1 ppm, %2 underruns, %3 overruns, mixing %4 us per second of audio")
+			.arg(mixer.Drift(address)).arg(mixer.Underruns()).arg(mixer.Overruns())
+			.arg(mixNs / 1000.0 / (hours * 3600), 0, 'f', 1);
+	}
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceBridgeReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceBridgeReport ()
+--
+-- RETURNS:			One line for every size of session.
+--
+-- NOTES:
+--					Runs what the host does for every frame when every other peer is in mixed mode: decode the voice of
+--					each peer, queue it on a VoiceBridge, mix, then take the mix without each peer and encode it for
+--					them with IMA ADPCM. Prints the CPU time of the host for each peer, and how many streams a peer
+--					receives and decodes in mixed mode compared to the full mesh.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::VoiceBridgeReport()
+{
+	const int sizes[] = { 4, 8, 16 };
+	const int seconds = 10;
+	const int samples = VOIP_SAMPLE_RATE * VOIP_FRAME_MS / 1000;
+	const int framesPerSecond = 1000 / VOIP_FRAME_MS;
+	const int frames = seconds * framesPerSecond;
+
+	QStringList report;
+	report << QString("Host mixing, %1 seconds of everyone talking, IMA ADPCM").arg(seconds);
+
+	QVector<qint16> voice = voiceSignal(samples * framesPerSecond, VOIP_SAMPLE_RATE);
+	VoiceCodec * codec = VoiceCodec::Create(VoiceCodecs::AdpcmVoiceCodec);
+
+	QVector<QByteArray> packets(framesPerSecond);
+	for (int frame = 0; frame < framesPerSecond; frame++)
+	{
+		packets[frame] = codec->Encode(voice.constData() + frame * samples, samples);
+	}
+
+	double kbps = (packets[0].size() + VOIP_PACKET_HEADER_SIZE) * 8.0 * framesPerSecond / 1000.0;
+
+	for (int peers : sizes)
+	{
+		VoiceBridge bridge(samples);
+		QElapsedTimer timer;
+
+		timer.start();
+		for (int n = 0; n < frames; n++)
+		{
+			for (int peer = 0; peer < peers; peer++)
+			{
+				// Every peer is a little behind the next so they do not all say the same thing
+				QVector<qint16> decoded = codec->Decode(packets[(n + peer) % framesPerSecond]);
+				bridge.Push(peer + 1, decoded.constData(), decoded.size());
+			}
+
+			bridge.Mix(voice.constData() + (n % framesPerSecond) * samples);
+
+			for (int peer = 0; peer < peers; peer++)
+			{
+				const qint16 * mix = bridge.MixMinus(peer + 1);
+
+				if (mix)
+				{
+					codec->Encode(mix, samples);
+				}
+			}
+		}
+		qint64 ns = timer.nsecsElapsed();
+
+		report << QString("  %1 peers: %2 us of host CPU per peer per second (%3% of a core in all), "
+			"a peer receives 1 stream of %4 kbit/s instead of %5 streams of %6 kbit/s")
+			.arg(peers, 2).arg(ns / 1000.0 / seconds / peers, 0, 'f', 1).arg(ns / (seconds * 1e9) * 100, 0, 'f', 2)
+			.arg(kbps, 0, 'f', 1).arg(peers).arg(kbps * peers, 0, 'f', 1);
+	}
+
+	delete codec;
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavParserReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		WavParserReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Writes BENCHMARK_WAV_FILES small wav files to a temporary folder, cycling through the layouts that
+--					wavFile makes, then opens every one of them twice: once reading the fixed 44 byte WavHeader the
+--					way songs used to be opened, and once with WavParser. Both passes run on a warm disk cache, so the
+--					rate is the cost of opening and parsing rather than of the disk. It prints how many files each way
+--					found the audio of and how fast WavParser::Parse runs on headers already in memory.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::WavParserReport()
+{
+	const int layouts = 5;
+	const int frames = 256;
+
+	QStringList report;
+	report << QString("Wav headers, %1 files of %2 layouts").arg(BENCHMARK_WAV_FILES).arg(layouts);
+
+	QTemporaryDir folder;
+	if (!folder.isValid())
+	{
+		report << "  could not make a temporary folder";
+		return report;
+	}
+
+	QVector<QByteArray> files(layouts);
+	QVector<qint64> dataSizes(layouts);
+	for (int layout = 0; layout < layouts; layout++)
+	{
+		files[layout] = wavFile(layout, frames);
+
+		WavParser wav;
+		wav.Parse((const uchar *)files[layout].constData(), files[layout].size(), files[layout].size());
+		dataSizes[layout] = wav.DataSize();
+	}
+
+	QStringList names;
+	for (int i = 0; i < BENCHMARK_WAV_FILES; i++)
+	{
+		names << folder.filePath(QString("%1.wav").arg(i));
+
+		QFile file(names.last());
+		file.open(QFile::WriteOnly);
+		file.write(files[i % layouts]);
+	}
+
+	// The fixed header is only right when the audio really does start at byte 44
+	int headerFound = 0;
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < names.size(); i++)
+	{
+		QFile file(names[i]);
+		WavHeader header;
+
+		if (file.open(QFile::ReadOnly) && file.read((char *)&header, sizeof(WavHeader)) == sizeof(WavHeader)
+			&& memcmp(header.data, "data", 4) == 0 && header.pcm == WAV_FORMAT_PCM
+			&& header.bytesInData == dataSizes[i % layouts])
+		{
+			headerFound++;
+		}
+	}
+	qint64 headerNs = timer.nsecsElapsed();
+
+	int parserFound = 0;
+	timer.restart();
+	for (int i = 0; i < names.size(); i++)
+	{
+		QFile file(names[i]);
+		WavParser wav;
+
+		if (file.open(QFile::ReadOnly) && wav.Read(file) && wav.DataSize() == dataSizes[i % layouts])
+		{
+			parserFound++;
+		}
+	}
+	qint64 parserNs = timer.nsecsElapsed();
+
+	report << QString("  fixed header: %1 files/s, found the audio of %2 files")
+		.arg(names.size() * 1e9 / qMax<qint64>(headerNs, 1), 0, 'f', 0).arg(headerFound);
+	report << QString("  WavParser: %1 files/s, found the audio of %2 files")
+		.arg(names.size() * 1e9 / qMax<qint64>(parserNs, 1), 0, 'f', 0).arg(parserFound);
+
+	timer.restart();
+	for (int i = 0; i < BENCHMARK_WAV_FILES; i++)
+	{
+		const QByteArray & file = files[i % layouts];
+		WavParser wav;
+		wav.Parse((const uchar *)file.constData(), file.size(), file.size());
+	}
+	double parseNs = (double)timer.nsecsElapsed() / BENCHMARK_WAV_FILES;
+
+	report << QString("  in memory: %1 ns per header").arg(parseNs, 0, 'f', 0);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		MappedSongReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		MappedSongReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Writes a song of BENCHMARK_SONG_SECONDS of 44.1 kHz stereo to a temporary folder and reads it
+--					through in pieces the size the audio output pulls, once from a QFile and once from a MappedSong.
+--					The time is scaled up to an hour of playback. Each then seeks to a thousand places in the song and
+--					reads one piece after every seek. The song is still in the disk cache from being written, so this
+--					is the cost of the reads and seeks themselves.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::MappedSongReport()
+{
+	const int piece = 4096;
+	const int seeks = 1000;
+
+	QStringList report;
+	report << QString("Local playback, a %1 s song of 44.1 kHz stereo read %2 bytes at a time")
+		.arg(BENCHMARK_SONG_SECONDS).arg(piece);
+
+	QTemporaryDir folder;
+	if (!folder.isValid())
+	{
+		report << "  could not make a temporary folder";
+		return report;
+	}
+
+	QString fileName = folder.filePath("song.wav");
+	QByteArray song = wavFile(0, BENCHMARK_SONG_SECONDS * 44100);
+	const qint64 dataOffset = 44;
+	const int frameBytes = 4;
+	{
+		QFile file(fileName);
+		file.open(QFile::WriteOnly);
+		file.write(song);
+	}
+
+	QFile file(fileName);
+	MappedSong mapped(fileName);
+	QIODevice * devices[] = { &file, &mapped };
+	const char * names[] = { "QFile", "MappedSong" };
+	QByteArray buffer(piece, 0);
+
+	for (int d = 0; d < 2; d++)
+	{
+		QIODevice * device = devices[d];
+		QElapsedTimer timer;
+		timer.start();
+
+		device->open(QIODevice::ReadOnly);
+		if (device == &mapped)
+		{
+			mapped.SetAudio(dataOffset, song.size(), frameBytes);
+		}
+		device->seek(dataOffset);
+
+		qint64 total = 0;
+		qint64 read;
+		while ((read = device->read(buffer.data(), piece)) > 0)
+		{
+			total += read;
+		}
+		qint64 playNs = timer.nsecsElapsed();
+
+		quint32 seed = 20180420;
+		timer.restart();
+		for (int i = 0; i < seeks; i++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			qint64 frame = (seed >> 8) % (BENCHMARK_SONG_SECONDS * 44100);
+			device->seek(dataOffset + frame * frameBytes);
+			device->read(buffer.data(), piece);
+		}
+		qint64 seekNs = timer.nsecsElapsed();
+
+		device->close();
+
+		report << QString("  %1: %2 ms per hour of playback, %3 us per seek, %4 MB read")
+			.arg(names[d]).arg(playNs / 1e6 * 3600 / BENCHMARK_SONG_SECONDS, 0, 'f', 1)
+			.arg(seekNs / 1000.0 / seeks, 0, 'f', 2).arg(total / 1e6, 0, 'f', 1);
+	}
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryIndexReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		LibraryIndexReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Writes BENCHMARK_WAV_FILES small wav files spread over BENCHMARK_LIBRARY_FOLDERS sub folders of a
+--					temporary folder and indexes it three times with a LibraryIndex. The first time there is no
+--					saved index, so every song is parsed. The second time is a start up: the saved index is loaded and
+--					shown, then the scan finds nothing to parse. The third time a tenth of the songs have been touched
+--					since. The times are also scaled to a library of 100000 songs.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::LibraryIndexReport()
+{
+	const int layouts = 5;
+	const int frames = 256;
+	const double scale = 100000.0 / BENCHMARK_WAV_FILES;
+
+	QStringList report;
+	report << QString("Library index, %1 songs in %2 folders").arg(BENCHMARK_WAV_FILES).arg(BENCHMARK_LIBRARY_FOLDERS);
+
+	QTemporaryDir folder;
+	if (!folder.isValid())
+	{
+		report << "  could not make a temporary folder";
+		return report;
+	}
+
+	QDir songs(folder.filePath("songs"));
+	QDir indexes(folder.filePath("index"));
+	for (int i = 0; i < BENCHMARK_LIBRARY_FOLDERS; i++)
+	{
+		songs.mkpath(QString::number(i));
+	}
+
+	QVector<QByteArray> files(layouts);
+	for (int layout = 0; layout < layouts; layout++)
+	{
+		files[layout] = wavFile(layout, frames);
+	}
+
+	QStringList names;
+	for (int i = 0; i < BENCHMARK_WAV_FILES; i++)
+	{
+		names << songs.filePath(QString("%1/%2.wav").arg(i % BENCHMARK_LIBRARY_FOLDERS).arg(i));
+
+		QFile file(names.last());
+		file.open(QFile::WriteOnly);
+		file.write(files[i % layouts]);
+	}
+
+	const char * passes[] = { "first scan", "start up", "a tenth changed" };
+	for (int pass = 0; pass < 3; pass++)
+	{
+		if (pass == 2)
+		{
+			for (int i = 0; i < names.size(); i += 10)
+			{
+				QFile file(names[i]);
+				file.open(QFile::Append);
+				file.write(QByteArray(4, 0));
+			}
+		}
+
+		LibraryIndex index(indexes);
+		QEventLoop loop;
+		int parsed = 0;
+		QObject::connect(&index, &LibraryIndex::scanFinished, &loop, &QEventLoop::quit);
+
+		QElapsedTimer timer;
+		timer.start();
+		index.Open(songs);
+		qint64 listedNs = timer.nsecsElapsed();
+		int listed = index.Entries().size();
+
+		while (index.IsScanning())
+		{
+			loop.exec();
+		}
+		qint64 scannedNs = timer.nsecsElapsed();
+
+		for (const LibraryEntry & entry : index.Entries())
+		{
+			parsed += entry.sampleRate > 0 ? 1 : 0;
+		}
+
+		report << QString("  %1: %2 songs listed in %3 ms, scan done in %4 ms, %5 songs with a format")
+			.arg(passes[pass]).arg(listed).arg(listedNs / 1e6, 0, 'f', 1).arg(scannedNs / 1e6, 0, 'f', 1)
+			.arg(parsed);
+		report << QString("    for 100000 songs: listed in %1 ms, scan done in %2 ms")
+			.arg(listedNs * scale / 1e6, 0, 'f', 1).arg(scannedNs * scale / 1e6, 0, 'f', 1);
+	}
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FlacDecoderReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FlacDecoderReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Encodes BENCHMARK_SONG_SECONDS of 44.1 kHz stereo tones with some noise through flacFile and
+--					decodes it all with a FlacDecoder, which has to give back every sample as it was. It is then
+--					read through a DecodedSong the way the audio output reads it and seeked to a hundred places,
+--					checking the piece read after each seek against the song. Last, the LPC restore of one block is
+--					timed for 16 bit audio, which can use SSE2, and for the same samples said to be 24 bit, which
+--					can not. A short file at BENCHMARK_FLAC_HIGH_ORDER is decoded too, and a block of it restored
+--					both ways, since orders from 17 to 24 take three of the four runs of taps in the SSE2 restore.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::FlacDecoderReport()
+{
+	const double pi = 3.14159265358979323846;
+	const int sampleRate = 44100;
+	const int frames = BENCHMARK_SONG_SECONDS * sampleRate;
+	const int piece = 4096;
+	const int seeks = 100;
+
+	QStringList report;
+	report << QString("FLAC, a %1 s song of 44.1 kHz stereo in blocks of %2 with order %3 LPC")
+		.arg(BENCHMARK_SONG_SECONDS).arg(BENCHMARK_FLAC_BLOCK).arg(BENCHMARK_FLAC_ORDER);
+
+	// Tones that drift between the channels, so mid and side both have something in them
+	QVector<qint16> samples(frames * 2);
+	quint32 seed = 20180420;
+	for (int i = 0; i < frames; i++)
+	{
+		double t = (double)i / sampleRate;
+		double swell = 0.5 + 0.5 * sin(2 * pi * 0.25 * t);
+		double tones = 6000 * sin(2 * pi * 220 * t) + 3000 * sin(2 * pi * 331 * t + 0.5)
+			+ 1500 * swell * sin(2 * pi * 1250 * t);
+
+		seed = seed * 1664525 + 1013904223;
+		int noise = (int)(seed >> 23) - 256;
+
+		samples[i * 2] = (qint16)qBound(-32768.0, tones * swell + noise, 32767.0);
+		samples[i * 2 + 1] = (qint16)qBound(-32768.0, tones * (1 - swell) + 2000 * sin(2 * pi * 440 * t) - noise,
+			32767.0);
+	}
+
+	QByteArray flac = flacFile(samples, sampleRate, BENCHMARK_FLAC_ORDER, BENCHMARK_FLAC_PRECISION);
+	report << QString("  compressed to %1 % of the wav file")
+		.arg(100.0 * flac.size() / (44 + frames * 4), 0, 'f', 1);
+
+	// Decoding straight from memory
+	FlacDecoder decoder;
+	QVector<qint16> decoded(frames * 2);
+	QElapsedTimer timer;
+	timer.start();
+
+	int done = 0;
+	if (decoder.Open((const uchar *)flac.constData(), flac.size()))
+	{
+		int count = 1;
+		while (done < frames && count > 0)
+		{
+			count = decoder.Decode((char *)(decoded.data() + done * 2), qMin(piece, frames - done));
+			done += count;
+		}
+	}
+	qint64 decodeNs = timer.nsecsElapsed();
+
+	int differ = 0;
+	for (int i = 0; i < frames * 2; i++)
+	{
+		differ += decoded[i] != samples[i] ? 1 : 0;
+	}
+
+	double realTime = BENCHMARK_SONG_SECONDS * 1e9 / qMax<qint64>(1, decodeNs);
+	report << QString("  FlacDecoder: %1 of %2 frames, %3x real time, %4 % of a core per song, %5 samples differ")
+		.arg(done).arg(frames).arg(realTime, 0, 'f', 0).arg(100.0 / realTime, 0, 'f', 2).arg(differ)
+		+ (decoder.Truncated() ? ", truncated" : "");
+
+	// Reading it as a song
+	QTemporaryDir folder;
+	if (!folder.isValid())
+	{
+		report << "  could not make a temporary folder";
+		return report;
+	}
+
+	QString fileName = folder.filePath("song.flac");
+	{
+		QFile file(fileName);
+		file.open(QFile::WriteOnly);
+		file.write(flac);
+	}
+
+	DecodedSong song(fileName);
+	QByteArray buffer(piece, 0);
+	const qint64 dataOffset = 44;
+	const qint16 * original = samples.constData();
+	differ = 0;
+
+	timer.restart();
+	if (song.open(QIODevice::ReadOnly))
+	{
+		song.seek(dataOffset);
+
+		qint64 position = 0;
+		while (!song.atEnd())
+		{
+			qint64 read = song.read(buffer.data(), piece);
+			if (read > 0)
+			{
+				differ += memcmp(buffer.constData(), (const char *)original + position, read) != 0 ? 1 : 0;
+				position += read;
+			}
+		}
+	}
+	qint64 readNs = timer.nsecsElapsed();
+
+	timer.restart();
+	for (int i = 0; i < seeks && song.isOpen(); i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		qint64 frame = (seed >> 8) % (frames - piece);
+		song.seek(dataOffset + frame * 4);
+
+		qint64 read = 0;
+		while (read < piece)
+		{
+			read += song.read(buffer.data() + read, piece - read);
+		}
+		differ += memcmp(buffer.constData(), (const char *)(original + frame * 2), piece) != 0 ? 1 : 0;
+	}
+	qint64 seekNs = timer.nsecsElapsed();
+
+	report << QString("  DecodedSong: %1 ms to read through, %2 us per seek and read, %3 pieces differ")
+		.arg(readNs / 1e6, 0, 'f', 1).arg(seekNs / 1000.0 / seeks, 0, 'f', 1).arg(differ);
+	song.close();
+
+	// The LPC restore on its own, on the mid channel of the second block
+	const int count = BENCHMARK_FLAC_BLOCK;
+	QVector<qint32> signal(count);
+	for (int i = 0; i < count; i++)
+	{
+		signal[i] = (samples[(count + i) * 2] + samples[(count + i) * 2 + 1]) >> 1;
+	}
+
+	qint32 coefs[32];
+	int shift = lpcCoefficients(signal.constData(), count, BENCHMARK_FLAC_ORDER, BENCHMARK_FLAC_PRECISION, coefs);
+
+	QVector<qint32> residual = signal;
+	for (int i = BENCHMARK_FLAC_ORDER; i < count; i++)
+	{
+		qint64 prediction = 0;
+		for (int j = 0; j < BENCHMARK_FLAC_ORDER; j++)
+		{
+			prediction += (qint64)coefs[j] * signal[i - 1 - j];
+		}
+		residual[i] = signal[i] - (qint32)(prediction >> shift);
+	}
+
+	QVector<qint32> restored(count);
+	QVector<qint16> history(count + 32);
+	double nsPerSample[2];
+	differ = 0;
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		timer.restart();
+		for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+		{
+			memcpy(restored.data(), residual.constData(), count * sizeof(qint32));
+			AudioKernels::RestoreLpc(restored.data(), count, coefs, BENCHMARK_FLAC_ORDER, shift, pass == 0 ? 16 : 24,
+				BENCHMARK_FLAC_PRECISION, history.data());
+		}
+		nsPerSample[pass] = (double)timer.nsecsElapsed() / BENCHMARK_ITERATIONS / count;
+		differ += restored != signal ? 1 : 0;
+	}
+
+	report << QString("  RestoreLpc: %1 ns per sample for 16 bit audio, %2 ns per sample for 24 bit, %3 differ")
+		.arg(nsPerSample[0], 0, 'f', 2).arg(nsPerSample[1], 0, 'f', 2).arg(differ);
+
+	// A few blocks at an order from 17 to 24, which the SSE2 restore does in three runs of eight taps. Every full
+	// block is as long as the largest in STREAMINFO, so the decoder fills its history to the end
+	const int highFrames = BENCHMARK_FLAC_BLOCK * 4;
+	QByteArray highFlac = flacFile(samples.mid(0, highFrames * 2), sampleRate, BENCHMARK_FLAC_HIGH_ORDER,
+		BENCHMARK_FLAC_HIGH_PRECISION);
+
+	FlacDecoder highDecoder;
+	QVector<qint16> highDecoded(highFrames * 2);
+	done = 0;
+	if (highDecoder.Open((const uchar *)highFlac.constData(), highFlac.size()))
+	{
+		int read = 1;
+		while (done < highFrames && read > 0)
+		{
+			read = highDecoder.Decode((char *)(highDecoded.data() + done * 2), qMin(piece, highFrames - done));
+			done += read;
+		}
+	}
+
+	differ = 0;
+	for (int i = 0; i < highFrames * 2; i++)
+	{
+		differ += highDecoded[i] != samples[i] ? 1 : 0;
+	}
+
+	// The same block restored with SSE2 and with the plain loop, which has to give the same samples
+	shift = lpcCoefficients(signal.constData(), count, BENCHMARK_FLAC_HIGH_ORDER, BENCHMARK_FLAC_HIGH_PRECISION, coefs);
+	for (int i = BENCHMARK_FLAC_HIGH_ORDER; i < count; i++)
+	{
+		qint64 prediction = 0;
+		for (int j = 0; j < BENCHMARK_FLAC_HIGH_ORDER; j++)
+		{
+			prediction += (qint64)coefs[j] * signal[i - 1 - j];
+		}
+		residual[i] = signal[i] - (qint32)(prediction >> shift);
+	}
+
+	QVector<qint32> plain = residual;
+	restored = residual;
+	AudioKernels::RestoreLpc(restored.data(), count, coefs, BENCHMARK_FLAC_HIGH_ORDER, shift, 16,
+		BENCHMARK_FLAC_HIGH_PRECISION, history.data());
+	AudioKernels::RestoreLpc(plain.data(), count, coefs, BENCHMARK_FLAC_HIGH_ORDER, shift, 24,
+		BENCHMARK_FLAC_HIGH_PRECISION, history.data());
+
+	int restoreDiffer = 0;
+	for (int i = 0; i < count; i++)
+	{
+		restoreDiffer += restored[i] != plain[i] ? 1 : 0;
+	}
+
+	report << QString("  order %1 LPC: FlacDecoder gave %2 of %3 frames with %4 samples differing, the SSE2 and "
+		"plain restores differ in %5 samples").arg(BENCHMARK_FLAC_HIGH_ORDER).arg(done).arg(highFrames).arg(differ)
+		.arg(restoreDiffer);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LoudnessReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		LoudnessReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Measures a 1 kHz tone at -23 dBFS in both channels, which a BS.1770 meter reads as -23 LUFS, at
+--					48 and 44.1 kHz. The meter is then timed in stereo, where SSE2 filters both channels at once,
+--					and in mono, where it can not, and ApplyGain is timed on 16 bit and float samples. Last, a
+--					library of BENCHMARK_LOUDNESS_SONGS songs is written to a temporary folder and timed from the
+--					first scan until every song has been measured.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::LoudnessReport()
+{
+	const double pi = 3.14159265358979323846;
+	const int sampleRate = 44100;
+	const int frames = BENCHMARK_LOUDNESS_SECONDS * sampleRate;
+	const double amplitude = 32767 * pow(10.0, -23 / 20.0);
+
+	QStringList report;
+	report << QString("Loudness, %1 s songs of 44.1 kHz stereo").arg(BENCHMARK_LOUDNESS_SECONDS);
+
+	QVector<qint16> samples(frames * 2);
+	for (int i = 0; i < frames; i++)
+	{
+		double t = (double)i / sampleRate;
+		double swell = 0.75 + 0.25 * sin(2 * pi * 0.5 * t);
+
+		samples[i * 2] = (qint16)(amplitude * swell * sin(2 * pi * 440 * t));
+		samples[i * 2 + 1] = (qint16)(amplitude * swell * sin(2 * pi * 660 * t));
+	}
+
+	// A tone whose loudness is known
+	const int rates[] = { 48000, 44100 };
+	for (int rate : rates)
+	{
+		QVector<qint16> tone(rate * 20 * 2);
+		for (int i = 0; i < tone.size() / 2; i++)
+		{
+			tone[i * 2] = tone[i * 2 + 1] = (qint16)qRound(amplitude * sin(2 * pi * 1000 * i / rate));
+		}
+
+		LoudnessMeter meter(rate, 2);
+		meter.Add(tone.constData(), tone.size() / 2);
+		report << QString("  -23 dBFS 1 kHz tone at %1 Hz: %2 LUFS").arg(rate).arg(meter.Loudness(), 0, 'f', 2);
+	}
+
+	// The meter on its own, over the whole song in stereo and over its left channel in mono
+	QVector<qint16> left(frames);
+	for (int i = 0; i < frames; i++)
+	{
+		left[i] = samples[i * 2];
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	LoudnessMeter stereo(sampleRate, 2);
+	stereo.Add(samples.constData(), frames);
+	double stereoNs = (double)timer.nsecsElapsed() / frames;
+
+	timer.restart();
+	LoudnessMeter mono(sampleRate, 1);
+	mono.Add(left.constData(), frames);
+	double monoNs = (double)timer.nsecsElapsed() / frames;
+
+	report << QString("  LoudnessMeter: %1 ns per stereo frame, %2 ns per mono frame, %3 LUFS")
+		.arg(stereoNs, 0, 'f', 2).arg(monoNs, 0, 'f', 2).arg(stereo.Loudness(), 0, 'f', 2);
+
+	// Scaling a read of the song the way the playback queue does
+	QAudioFormat format;
+	format.setSampleRate(sampleRate);
+	format.setChannelCount(2);
+	format.setSampleSize(16);
+	format.setSampleType(QAudioFormat::SignedInt);
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setCodec("audio/pcm");
+
+	const int piece = 4096;
+	QByteArray buffer((const char *)samples.constData(), piece * 4);
+	QVector<float> floats(piece * 2);
+	for (int i = 0; i < piece * 2; i++)
+	{
+		floats[i] = samples[i] / 32768.0f;
+	}
+
+	timer.restart();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+	{
+		AudioKernels::ApplyGain(buffer.data(), piece * 2, format, i & 1 ? 180 : 364);
+	}
+	double shortNs = (double)timer.nsecsElapsed() / BENCHMARK_ITERATIONS / (piece * 2);
+
+	format.setSampleSize(32);
+	format.setSampleType(QAudioFormat::Float);
+	timer.restart();
+	for (int i = 0; i < BENCHMARK_ITERATIONS; i++)
+	{
+		AudioKernels::ApplyGain((char *)floats.data(), piece * 2, format, i & 1 ? 180 : 364);
+	}
+	double floatNs = (double)timer.nsecsElapsed() / BENCHMARK_ITERATIONS / (piece * 2);
+
+	report << QString("  ApplyGain: %1 ns per 16 bit sample, %2 ns per float sample")
+		.arg(shortNs, 0, 'f', 3).arg(floatNs, 0, 'f', 3);
+
+	// A library measured in the background
+	QTemporaryDir folder;
+	if (!folder.isValid())
+	{
+		report << "  could not make a temporary folder";
+		return report;
+	}
+
+	QDir songs(folder.filePath("songs"));
+	QDir indexes(folder.filePath("index"));
+	songs.mkpath(".");
+
+	QByteArray wav = wavFile(0, frames);
+	memcpy(wav.data() + 44, samples.constData(), frames * 4);
+	for (int i = 0; i < BENCHMARK_LOUDNESS_SONGS; i++)
+	{
+		QFile file(songs.filePath(QString("%1.wav").arg(i)));
+		file.open(QFile::WriteOnly);
+		file.write(wav);
+	}
+
+	LibraryIndex index(indexes);
+	QEventLoop loop;
+	QObject::connect(&index, &LibraryIndex::scanFinished, &loop, &QEventLoop::quit);
+	QObject::connect(&index, &LibraryIndex::analysisFinished, &loop, &QEventLoop::quit);
+
+	timer.restart();
+	index.Open(songs);
+	while (index.IsScanning() || index.IsAnalyzing())
+	{
+		loop.exec();
+	}
+	qint64 elapsedNs = timer.nsecsElapsed();
+
+	int measured = 0;
+	for (const LibraryEntry & entry : index.Entries())
+	{
+		measured += std::isfinite(entry.loudness) ? 1 : 0;
+	}
+
+	double perSecond = measured * 1e9 / qMax<qint64>(1, elapsedNs);
+	report << QString("  library: %1 of %2 songs measured in %3 ms, %4 songs per second, %5x real time")
+		.arg(measured).arg(BENCHMARK_LOUDNESS_SONGS).arg(elapsedNs / 1e6, 0, 'f', 1).arg(perSecond, 0, 'f', 1)
+		.arg(perSecond * BENCHMARK_LOUDNESS_SECONDS, 0, 'f', 0);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PlaylistReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PlaylistReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Fills a Playlist with BENCHMARK_PLAYLIST_TRACKS songs and times moving to the next song, in list
+--					order and shuffled, against finding the current song in a list of that many with indexOf the way
+--					the player used to. A shuffled pass is checked to play every song once. Last, the time to add a
+--					song to the middle and take it out again is shown, which is what a change to the song folder
+--					costs.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::PlaylistReport()
+{
+	const int count = BENCHMARK_PLAYLIST_TRACKS;
+	const int steps = 1000;
+
+	QStringList report;
+	report << QString("Playlist, %1 songs").arg(count);
+
+	QVector<PlaylistTrack> tracks(count);
+	QList<quint32> list;
+	for (int i = 0; i < count; i++)
+	{
+		tracks[i].song = QString("%1/%2.wav").arg(i % BENCHMARK_LIBRARY_FOLDERS).arg(i);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	Playlist playlist(20180420);
+	quint32 first = playlist.Insert(0, tracks);
+	qint64 fillNs = timer.nsecsElapsed();
+
+	for (int i = 0; i < count; i++)
+	{
+		list.append(first + i);
+	}
+
+	// The old way, a search for the current song in the list for every step
+	quint32 current = list[count / 2];
+	timer.restart();
+	for (int i = 0; i < steps; i++)
+	{
+		int index = list.indexOf(current) + 1;
+		current = list[index < list.size() ? index : 0];
+	}
+	double searchNs = (double)timer.nsecsElapsed() / steps;
+
+	double stepNs[2];
+	int played = 0;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		playlist.SetCurrent(first);
+		playlist.SetShuffle(pass == 1);
+
+		QVector<bool> seen(count, false);
+		timer.restart();
+		for (int i = 0; i < count; i++)
+		{
+			quint32 id = playlist.Current();
+			seen[id - first] = true;
+			playlist.SetCurrent(playlist.Next(true));
+		}
+		stepNs[pass] = (double)timer.nsecsElapsed() / count;
+
+		played = (int)std::count(seen.begin(), seen.end(), true);
+	}
+
+	report << QString("  filled in %1 ms, indexOf %2 us per step, next %3 ns per step in order and %4 ns shuffled")
+		.arg(fillNs / 1e6, 0, 'f', 1).arg(searchNs / 1000, 0, 'f', 1).arg(stepNs[0], 0, 'f', 1)
+		.arg(stepNs[1], 0, 'f', 1);
+	report << QString("  a shuffled pass played %1 of %2 songs").arg(played).arg(count);
+
+	timer.restart();
+	for (int i = 0; i < 10; i++)
+	{
+		playlist.Remove(playlist.Insert(count / 2, tracks[0]));
+	}
+	report << QString("  adding and taking out a song: %1 ms").arg(timer.nsecsElapsed() / 1e7, 0, 'f', 2);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DspReport
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DspReport ()
+--
+-- RETURNS:			The lines of the report.
+--
+-- NOTES:
+--					Times every node of the chain songs are played through over BENCHMARK_DSP_SECONDS of 48 kHz
+--					stereo. The nodes pull from a DspSource that reads float samples, which is only a copy, and the
+--					time of that source is taken off theirs so each line is the node on its own. The ramp of a gain
+--					that is changing is timed on AudioKernels::Ramp directly. The equalizer is timed with every band
+--					in use, in stereo, where SSE2 filters both channels at once, and in mono, where it can not. Last,
+--					two songs are read through a PlaybackQueue the way the output reads them, crossfading through
+--					the equalizer, which times the whole chain.
+----------------------------------------------------------------------------------------------------------------------*/
+QStringList Benchmark::DspReport()
+{
+	const double pi = 3.14159265358979323846;
+	const int sampleRate = 48000;
+	const int frames = BENCHMARK_DSP_SECONDS * sampleRate;
+	const float bands[] = { 4.0f, 3.0f, -2.0f, 1.5f, -1.0f, 2.0f, -3.0f, 2.5f, 3.5f, -1.5f };
+
+	QStringList report;
+	report << QString("Playback chain, %1 s of 48 kHz stereo").arg(BENCHMARK_DSP_SECONDS);
+
+	QAudioFormat format;
+	format.setSampleRate(sampleRate);
+	format.setChannelCount(2);
+	format.setSampleSize(16);
+	format.setSampleType(QAudioFormat::SignedInt);
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setCodec("audio/pcm");
+
+	QAudioFormat floatFormat = format;
+	floatFormat.setSampleSize(32);
+	floatFormat.setSampleType(QAudioFormat::Float);
+
+	QAudioFormat monoFormat = floatFormat;
+	monoFormat.setChannelCount(1);
+
+	// A second of two tones that the nodes go round and round
+	QVector<qint16> samples(sampleRate * 2);
+	QVector<float> floats(sampleRate * 2);
+	for (int i = 0; i < sampleRate; i++)
+	{
+		samples[i * 2] = (qint16)(12000 * sin(2 * pi * 440 * i / sampleRate));
+		samples[i * 2 + 1] = (qint16)(12000 * sin(2 * pi * 660 * i / sampleRate));
+		floats[i * 2] = samples[i * 2] / 32768.0f;
+		floats[i * 2 + 1] = samples[i * 2 + 1] / 32768.0f;
+	}
+
+	QByteArray shortBytes((const char *)samples.constData(), samples.size() * sizeof(qint16));
+	QByteArray floatBytes((const char *)floats.constData(), floats.size() * sizeof(float));
+
+	QBuffer shortBuffer(&shortBytes);
+	QBuffer first(&floatBytes);
+	QBuffer second(&floatBytes);
+	QBuffer mono(&floatBytes);
+	shortBuffer.open(QIODevice::ReadOnly);
+	first.open(QIODevice::ReadOnly);
+	second.open(QIODevice::ReadOnly);
+	mono.open(QIODevice::ReadOnly);
+
+	DspSource shortSource(&shortBuffer, format);
+	DspSource base(&first, floatFormat);
+	DspSource other(&second, floatFormat);
+	DspSource monoBase(&mono, monoFormat);
+
+	double baseNs = pullNs(&base, QVector<QBuffer *>() << &first, frames);
+	double monoBaseNs = pullNs(&monoBase, QVector<QBuffer *>() << &mono, frames);
+	double sourceNs = pullNs(&shortSource, QVector<QBuffer *>() << &shortBuffer, frames);
+
+	report << QString("  DspSource: %1 ns per 16 bit frame, %2 ns per float frame")
+		.arg(sourceNs, 0, 'f', 2).arg(baseNs, 0, 'f', 2);
+
+	// A gain that holds still and one that is always ramping
+	DspGain gain(&base, 0.7f);
+	double gainNs = pullNs(&gain, QVector<QBuffer *>() << &first, frames) - baseNs;
+
+	QVector<float> block(floats.mid(0, DSP_BLOCK_FRAMES * 2));
+	QElapsedTimer timer;
+	timer.start();
+	for (int done = 0; done < frames; done += DSP_BLOCK_FRAMES)
+	{
+		AudioKernels::Ramp(block.data(), DSP_BLOCK_FRAMES, 2, done & DSP_BLOCK_FRAMES ? 0.5f : 1.5f,
+			done & DSP_BLOCK_FRAMES ? 1.5f : 0.5f);
+	}
+	double rampNs = (double)timer.nsecsElapsed() / frames;
+
+	report << QString("  DspGain: %1 ns per frame, %2 ns per frame while ramping")
+		.arg(gainNs, 0, 'f', 2).arg(rampNs, 0, 'f', 2);
+
+	// A fade long enough that it never ends, on top of two sources
+	DspCrossfade fade(2);
+	fade.Start(&base, &other, frames * 2);
+	double fadeNs = pullNs(&fade, QVector<QBuffer *>() << &first << &second, frames) - baseNs * 2;
+
+	report << QString("  DspCrossfade: %1 ns per frame").arg(fadeNs, 0, 'f', 2);
+
+	// Every band of the equalizer in use
+	QVector<float> gains;
+	for (float band : bands)
+	{
+		gains.append(band);
+	}
+
+	DspEqualizer stereo(&base, 2, sampleRate);
+	DspEqualizer single(&monoBase, 1, sampleRate);
+	stereo.SetGains(gains);
+	single.SetGains(gains);
+	double stereoNs = pullNs(&stereo, QVector<QBuffer *>() << &first, frames) - baseNs;
+	double singleNs = pullNs(&single, QVector<QBuffer *>() << &mono, frames) - monoBaseNs;
+
+	report << QString("  DspEqualizer, %1 bands: %2 ns per stereo frame, %3 ns per mono frame")
+		.arg(EQUALIZER_BANDS).arg(stereoNs, 0, 'f', 2).arg(singleNs, 0, 'f', 2);
+
+	// Back to 16 bit, read the way the output reads
+	DspOutput output(&base, format);
+	QByteArray chunk(DSP_BLOCK_FRAMES * 4, 0);
+	first.seek(0);
+
+	timer.restart();
+	for (qint64 done = 0; done < (qint64)frames * 4;)
+	{
+		qint64 read = output.Read(chunk.data(), chunk.size());
+		done += read;
+		if (read < chunk.size())
+		{
+			first.seek(0);
+		}
+	}
+	double outputNs = (double)timer.nsecsElapsed() / frames - baseNs;
+
+	report << QString("  DspOutput: %1 ns per 16 bit frame").arg(outputNs, 0, 'f', 2);
+
+	// The whole chain, two songs crossfading through the equalizer
+	QByteArray song;
+	for (int i = 0; i < BENCHMARK_DSP_SECONDS / 2; i++)
+	{
+		song.append(shortBytes);
+	}
+
+	QBuffer current(&song);
+	QBuffer next(&song);
+	current.open(QIODevice::ReadOnly);
+	next.open(QIODevice::ReadOnly);
+
+	PlaybackQueue queue;
+	queue.SetFormat(format);
+	queue.SetCrossfade(CROSSFADE_MS);
+	queue.SetEqualizer(gains);
+	queue.SetCurrent(&current, format, song.size(), 200);
+	queue.SetNext(&next, format, song.size(), 300);
+
+	qint64 played = 0;
+	timer.restart();
+	for (qint64 read = 1; read > 0; played += read)
+	{
+		read = queue.read(chunk.data(), chunk.size());
+	}
+	double queueNs = (double)timer.nsecsElapsed() / qMax<qint64>(1, played / 4);
+
+	report << QString("  PlaybackQueue: %1 ns per frame, %2 s played from two %3 s songs fading over %4 ms")
+		.arg(queueNs, 0, 'f', 2).arg(played / 4.0 / sampleRate, 0, 'f', 2).arg(BENCHMARK_DSP_SECONDS / 2)
+		.arg(CROSSFADE_MS);
+
+	return report;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		voiceSignal
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		voiceSignal (int samples, int sampleRate)
+--						int samples: The number of samples to make.
+--						int sampleRate: The rate of the samples.
+--
+-- RETURNS:			A mono signal shaped roughly like speech.
+--
+-- NOTES:
+--					A 140 Hz voice with falling harmonics, rising and falling four times a second like syllables, with
+--					a little noise on top. The noise comes from a fixed generator so every run gets the same signal.
+----------------------------------------------------------------------------------------------------------------------*/
+QVector<qint16> Benchmark::voiceSignal(int samples, int sampleRate)
+{
+	const double pi = 3.14159265358979323846;
+	QVector<qint16> signal(samples);
+	quint32 seed = 1;
+
+	for (int i = 0; i < samples; i++)
+	{
+		double t = (double)i / sampleRate;
+		double value = 0;
+
+		for (int harmonic = 1; harmonic <= 8; harmonic++)
+		{
+			value += sin(2 * pi * 140 * harmonic * t) / harmonic;
+		}
+
+		seed = seed * 1664525 + 1013904223;
+		double noise = ((seed >> 16) / 65536.0 - 0.5) * 0.05;
+		double envelope = 0.5 + 0.5 * sin(2 * pi * 4 * t);
+
+		signal[i] = (qint16)qBound(-32768.0, (value * envelope + noise) * 8000, 32767.0);
+	}
+
+	return signal;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		meetingSignal
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		meetingSignal (int seconds, int sampleRate)
+--						int seconds: How long the signal is.
+--						int sampleRate: The rate of the samples.
+--
+-- RETURNS:			A mono signal of two seconds of talking then three seconds of listening, over and over.
+--
+-- NOTES:
+--					A quiet room hum runs under the whole signal so the detector has a background to follow.
+----------------------------------------------------------------------------------------------------------------------*/
+QVector<qint16> Benchmark::meetingSignal(int seconds, int sampleRate)
+{
+	QVector<qint16> voice = voiceSignal(sampleRate * 2, sampleRate);
+	QVector<qint16> signal(seconds * sampleRate);
+	quint32 seed = 7;
+
+	for (int i = 0; i < signal.size(); i++)
+	{
+		int position = i % (sampleRate * 5);
+
+		seed = seed * 1664525 + 1013904223;
+		int value = (int)((seed >> 16) % 341) - 170;
+
+		if (position < voice.size())
+		{
+			value += voice[position];
+		}
+
+		signal[i] = (qint16)qBound(-32768, value, 32767);
+	}
+
+	return signal;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		snr
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		snr (const qint16 * reference, const qint16 * decoded, int samples)
+--						const qint16 * reference: The signal that was encoded.
+--						const qint16 * decoded: The signal that came back out.
+--						int samples: The number of samples in each.
+--
+-- RETURNS:			The signal to noise ratio in decibels, infinite if the signals match exactly.
+----------------------------------------------------------------------------------------------------------------------*/
+double Benchmark::snr(const qint16 * reference, const qint16 * decoded, int samples)
+{
+	double signal = 0;
+	double noise = 0;
+
+	for (int i = 0; i < samples; i++)
+	{
+		double error = reference[i] - decoded[i];
+		signal += (double)reference[i] * reference[i];
+		noise += error * error;
+	}
+
+	if (noise == 0)
+	{
+		return HUGE_VAL;
+	}
+
+	return 10 * log10(signal / noise);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		wavFile
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		wavFile (int layout, int frames)
+--						int layout: Which of the layouts below to make.
+--						int frames: The number of frames of silence in the file.
+--
+-- RETURNS:			A whole wav file of 44.1 kHz stereo.
+--
+-- NOTES:
+--					The layouts are the ones seen in music folders:
+--						0:	The plain 44 byte header of 16 bit PCM.
+--						1:	A LIST chunk with a title of odd size, and so a pad byte, before the data.
+--						2:	A fact chunk, then 24 bit PCM in a WAVE_FORMAT_EXTENSIBLE fmt chunk.
+--						3:	32 bit float.
+--						4:	A data chunk whose size was left at zero by a recorder that streams to disk.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray Benchmark::wavFile(int layout, int frames)
+{
+	const int channels = 2;
+	const int sampleRate = 44100;
+	const int bits = layout == 2 ? 24 : (layout == 3 ? 32 : 16);
+	const int blockAlign = channels * bits / 8;
+
+	QByteArray file;
+	QDataStream out(&file, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+
+	out.writeRawData("RIFF", 4);
+	out << (quint32)0;
+	out.writeRawData("WAVE", 4);
+
+	if (layout == 2)
+	{
+		out.writeRawData("fact", 4);
+		out << (quint32)4 << (quint32)frames;
+	}
+
+	out.writeRawData("fmt ", 4);
+	if (layout == 2)
+	{
+		out << (quint32)40 << (quint16)WAV_FORMAT_EXTENSIBLE;
+	}
+	else
+	{
+		out << (quint32)16 << (quint16)(layout == 3 ? WAV_FORMAT_FLOAT : WAV_FORMAT_PCM);
+	}
+	out << (quint16)channels << (quint32)sampleRate << (quint32)(sampleRate * blockAlign) << (quint16)blockAlign
+		<< (quint16)bits;
+
+	if (layout == 2)
+	{
+		// Extra size, valid bits, front left and right, then the rest of the PCM sub format GUID
+		out << (quint16)22 << (quint16)bits << (quint32)3 << (quint16)WAV_FORMAT_PCM;
+		out.writeRawData("\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 14);
+	}
+
+	if (layout == 1)
+	{
+		out.writeRawData("LIST", 4);
+		out << (quint32)17;
+		out.writeRawData("INFOINAM", 8);
+		out << (quint32)5;
+		out.writeRawData("Song", 5);
+		out << (quint8)0;
+	}
+
+	out.writeRawData("data", 4);
+	out << (quint32)(layout == 4 ? 0 : frames * blockAlign);
+	out.writeRawData(QByteArray(frames * blockAlign, 0).constData(), frames * blockAlign);
+
+	qToLittleEndian<quint32>(file.size() - 8, (uchar *)file.data() + 4);
+
+	return file;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		flacFile
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		flacFile (const QVector<qint16> & samples, int sampleRate, int order, int precision)
+--						const QVector<qint16> & samples: Interleaved 16 bit stereo.
+--						int sampleRate: The sample rate of the samples.
+--						int order: The LPC order of every subframe.
+--						int precision: How many bits the LPC coefficients take.
+--
+-- RETURNS:			A whole FLAC file of the samples.
+--
+-- NOTES:
+--					A small encoder, only so there is a FLAC file to decode without needing one on disk. Every frame
+--					is BENCHMARK_FLAC_BLOCK frames of mid and side, apart from the last which is shorter, and each
+--					subframe is LPC of the given order with one Rice partition. The STREAMINFO block has the
+--					smallest and largest frame sizes and the length, but no MD5, which is allowed.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray Benchmark::flacFile(const QVector<qint16> & samples, int sampleRate, int order, int precision)
+{
+	const int blockSize = BENCHMARK_FLAC_BLOCK;
+	const int frames = samples.size() / 2;
+
+	QByteArray audio;
+	QVector<qint32> mid(blockSize);
+	QVector<qint32> side(blockSize);
+	int minFrame = 0xFFFFFF;
+	int maxFrame = 0;
+
+	for (int start = 0, number = 0; start < frames; start += blockSize, number++)
+	{
+		int count = qMin(blockSize, frames - start);
+		for (int i = 0; i < count; i++)
+		{
+			qint32 left = samples[(start + i) * 2];
+			qint32 right = samples[(start + i) * 2 + 1];
+			mid[i] = (left + right) >> 1;
+			side[i] = left - right;
+		}
+
+		// Fixed block size, 44.1 kHz or the size at the end, mid and side of 16 bit samples, then the frame number
+		QByteArray frame;
+		frame.append((char)0xFF);
+		frame.append((char)0xF8);
+		frame.append((char)(((count == blockSize ? 12 : 7) << 4) | 9));
+		frame.append((char)((10 << 4) | (4 << 1)));
+
+		if (number < 0x80)
+		{
+			frame.append((char)number);
+		}
+		else if (number < 0x800)
+		{
+			frame.append((char)(0xC0 | (number >> 6)));
+			frame.append((char)(0x80 | (number & 0x3F)));
+		}
+		else
+		{
+			frame.append((char)(0xE0 | (number >> 12)));
+			frame.append((char)(0x80 | ((number >> 6) & 0x3F)));
+			frame.append((char)(0x80 | (number & 0x3F)));
+		}
+
+		if (count != blockSize)
+		{
+			frame.append((char)((count - 1) >> 8));
+			frame.append((char)((count - 1) & 0xFF));
+		}
+
+		frame.append((char)FlacDecoder::Crc8((const uchar *)frame.constData(), frame.size()));
+
+		quint64 cache = 0;
+		int bits = 0;
+		flacSubframe(frame, cache, bits, mid.constData(), count, 16, order, precision);
+		flacSubframe(frame, cache, bits, side.constData(), count, 17, order, precision);
+		if (bits > 0)
+		{
+			writeBits(frame, cache, bits, 0, 8 - bits);
+		}
+
+		quint16 crc = FlacDecoder::Crc16((const uchar *)frame.constData(), frame.size());
+		frame.append((char)(crc >> 8));
+		frame.append((char)(crc & 0xFF));
+
+		minFrame = qMin(minFrame, frame.size());
+		maxFrame = qMax(maxFrame, frame.size());
+		audio.append(frame);
+	}
+
+	// STREAMINFO: block sizes, frame sizes, then 20 bits of rate, 3 of channels, 5 of bits and 36 of length
+	QByteArray info(34, 0);
+	uchar * fields = (uchar *)info.data();
+	qToBigEndian<quint16>(blockSize, fields);
+	qToBigEndian<quint16>(blockSize, fields + 2);
+	qToBigEndian<quint32>(minFrame << 8, fields + 4);
+	qToBigEndian<quint32>(maxFrame << 8, fields + 7);
+	qToBigEndian<quint64>(((quint64)sampleRate << 44) | ((quint64)1 << 41) | ((quint64)15 << 36) | (quint64)frames,
+		fields + 10);
+
+	QByteArray file("fLaC", 4);
+	file.append((char)0x80);
+	file.append((char)0);
+	file.append((char)0);
+	file.append((char)info.size());
+	file.append(info);
+	file.append(audio);
+
+	return file;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		flacSubframe
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		flacSubframe (QByteArray & bytes, quint64 & cache, int & count, const qint32 * signal, int samples,
+--						int bits, int order, int precision)
+--						QByteArray & bytes: The frame the subframe is added to.
+--						quint64 & cache: The bits not yet added to the frame.
+--						int & count: How many bits are in the cache.
+--						const qint32 * signal: The samples of the channel.
+--						int samples: The number of samples.
+--						int bits: How many bits the samples take.
+--						int order: The LPC order.
+--						int precision: How many bits the LPC coefficients take.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Writes an LPC subframe, or a verbatim one when the block is too short for the warm up. The Rice
+--					parameter is about the log of the mean of the folded residual.
+----------------------------------------------------------------------------------------------------------------------*/
+void Benchmark::flacSubframe(QByteArray & bytes, quint64 & cache, int & count, const qint32 * signal, int samples,
+	int bits, int order, int precision)
+{
+	if (samples <= order)
+	{
+		writeBits(bytes, cache, count, 1 << 1, 8);
+		for (int i = 0; i < samples; i++)
+		{
+			writeBits(bytes, cache, count, (quint32)signal[i], bits);
+		}
+		return;
+	}
+
+	qint32 coefs[32];
+	int shift = lpcCoefficients(signal, samples, order, precision, coefs);
+
+	writeBits(bytes, cache, count, (0x20 | (order - 1)) << 1, 8);
+	for (int i = 0; i < order; i++)
+	{
+		writeBits(bytes, cache, count, (quint32)signal[i], bits);
+	}
+
+	writeBits(bytes, cache, count, precision - 1, 4);
+	writeBits(bytes, cache, count, shift, 5);
+	for (int i = 0; i < order; i++)
+	{
+		writeBits(bytes, cache, count, (quint32)coefs[i], precision);
+	}
+
+	QVector<quint32> folded(samples - order);
+	quint64 sum = 0;
+	for (int i = order; i < samples; i++)
+	{
+		qint64 prediction = 0;
+		for (int j = 0; j < order; j++)
+		{
+			prediction += (qint64)coefs[j] * signal[i - 1 - j];
+		}
+
+		qint32 residual = signal[i] - (qint32)(prediction >> shift);
+		folded[i - order] = ((quint32)residual << 1) ^ (quint32)(residual >> 31);
+		sum += folded[i - order];
+	}
+
+	int parameter = 0;
+	while (parameter < 14 && ((quint64)folded.size() << (parameter + 1)) <= sum)
+	{
+		parameter++;
+	}
+
+	// Rice coding with 4 bit parameters, one partition
+	writeBits(bytes, cache, count, 0, 2);
+	writeBits(bytes, cache, count, 0, 4);
+	writeBits(bytes, cache, count, parameter, 4);
+
+	for (quint32 value : folded)
+	{
+		quint32 high = value >> parameter;
+		for (; high >= 32; high -= 32)
+		{
+			writeBits(bytes, cache, count, 0, 32);
+		}
+
+		writeBits(bytes, cache, count, 1, high + 1);
+		writeBits(bytes, cache, count, value & ((1u << parameter) - 1), parameter);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		lpcCoefficients
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		lpcCoefficients (const qint32 * signal, int samples, int order, int precision, qint32 * coefs)
+--						const qint32 * signal: The samples to predict.
+--						int samples: The number of samples.
+--						int order: How many samples back the prediction looks, at most 32.
+--						int precision: How many bits each coefficient takes.
+--						qint32 * coefs: Set to the coefficients, the one for the previous sample first.
+--
+-- RETURNS:			How far the sum of the products is shifted down.
+--
+-- NOTES:
+--					Solves for the predictor with the Levinson-Durbin recursion on the autocorrelation, then scales
+--					the coefficients up as far as the precision allows.
+----------------------------------------------------------------------------------------------------------------------*/
+int Benchmark::lpcCoefficients(const qint32 * signal, int samples, int order, int precision, qint32 * coefs)
+{
+	double autocorrelation[33];
+	for (int lag = 0; lag <= order; lag++)
+	{
+		double sum = 0;
+		for (int i = lag; i < samples; i++)
+		{
+			sum += (double)signal[i] * signal[i - lag];
+		}
+		autocorrelation[lag] = sum;
+	}
+
+	double lpc[32] = { 0 };
+	double previous[32];
+	double error = autocorrelation[0];
+
+	for (int m = 0; m < order && error > 0; m++)
+	{
+		double reflection = autocorrelation[m + 1];
+		for (int j = 0; j < m; j++)
+		{
+			reflection -= lpc[j] * autocorrelation[m - j];
+		}
+		reflection /= error;
+
+		memcpy(previous, lpc, sizeof(lpc));
+		lpc[m] = reflection;
+		for (int j = 0; j < m; j++)
+		{
+			lpc[j] = previous[j] - reflection * previous[m - 1 - j];
+		}
+
+		error *= 1 - reflection * reflection;
+	}
+
+	double largest = 0;
+	for (int j = 0; j < order; j++)
+	{
+		largest = qMax(largest, fabs(lpc[j]));
+	}
+
+	int exponent = 0;
+	frexp(largest, &exponent);
+
+	const int shift = largest > 0 ? qBound(0, precision - 1 - exponent, 15) : 0;
+	const qint32 limit = (1 << (precision - 1)) - 1;
+
+	for (int j = 0; j < order; j++)
+	{
+		coefs[j] = qBound(-limit - 1, (qint32)lround(lpc[j] * (1 << shift)), limit);
+	}
+
+	return shift;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		writeBits
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeBits (QByteArray & bytes, quint64 & cache, int & count, quint32 value, int bits)
+--						QByteArray & bytes: Where whole bytes are added.
+--						quint64 & cache: The bits not yet added.
+--						int & count: How many bits are in the cache.
+--						quint32 value: The bits to write, in its low bits.
+--						int bits: How many bits to write, 0 to 32.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void Benchmark::writeBits(QByteArray & bytes, quint64 & cache, int & count, quint32 value, int bits)
+{
+	cache = (cache << bits) | ((quint64)value & ((Q_UINT64_C(1) << bits) - 1));
+	count += bits;
+
+	while (count >= 8)
+	{
+		count -= 8;
+		bytes.append((char)(cache >> count));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		pullNs
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		pullNs (DspNode * node, const QVector<QBuffer *> & buffers, int frames)
+--						DspNode * node: The node to time.
+--						const QVector<QBuffer *> & buffers: The buffers the chain before the node reads from.
+--						int frames: How many frames to pull.
+--
+-- RETURNS:			The time of a pull divided by the frames it gave, in nanoseconds.
+--
+-- NOTES:
+--					Pulls a block at a time. The buffers are short, so they are all taken back to the start
+--					whenever a pull comes back short, and a pull that gives nothing twice in a row ends the timing.
+----------------------------------------------------------------------------------------------------------------------*/
+double Benchmark::pullNs(DspNode * node, const QVector<QBuffer *> & buffers, int frames)
+{
+	QVector<float> block(DSP_BLOCK_FRAMES * node->Channels());
+	QElapsedTimer timer;
+	int done = 0;
+	bool stalled = false;
+
+	for (QBuffer * buffer : buffers)
+	{
+		buffer->seek(0);
+	}
+
+	timer.start();
+	while (done < frames)
+	{
+		int wanted = qMin(DSP_BLOCK_FRAMES, frames - done);
+		int pulled = node->Pull(block.data(), wanted);
+		done += pulled;
+
+		if (pulled == 0 && stalled)
+		{
+			break;
+		}
+		stalled = pulled == 0;
+
+		if (pulled < wanted)
+		{
+			for (QBuffer * buffer : buffers)
+			{
+				buffer->seek(0);
+			}
+		}
+	}
+
+	return (double)timer.nsecsElapsed() / qMax(1, done);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QBuffer>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QString>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "AudioDecoder.h"
+#include "AudioKernels.h"
+#include "DspGraph.h"
+#include "globals.h"
+#include "HeadlessAudio.h"
+#include "FlacDecoder.h"
+#include "LibraryIndex.h"
+#include "LoudnessMeter.h"
+#include "MappedSong.h"
+#include "PlaybackQueue.h"
+#include "Playlist.h"
+#include "VoiceActivityDetector.h"
+#include "VoiceBridge.h"
+#include "VoiceCodec.h"
+#include "VoiceFec.h"
+#include "VoiceMixer.h"
+#include "WavParser.h"
+
+class Benchmark
+{
+public:
+	static QStringList Run();
+	static QStringList VoiceCodecReport();
+	static QStringList VoiceActivityReport();
+	static QStringList VoiceLatencyReport();
+	static QStringList AudioBackendReport();
+	static QStringList VoiceFecReport();
+	static QStringList VoiceDriftReport();
+	static QStringList VoiceBridgeReport();
+	static QStringList WavParserReport();
+	static QStringList MappedSongReport();
+	static QStringList LibraryIndexReport();
+	static QStringList FlacDecoderReport();
+	static QStringList LoudnessReport();
+	static QStringList PlaylistReport();
+	static QStringList DspReport();
+
+private:
+	static QVector<qint16> voiceSignal(int samples, int sampleRate);
+	static QVector<qint16> meetingSignal(int seconds, int sampleRate);
+	static double snr(const qint16 * reference, const qint16 * decoded, int samples);
+	static QByteArray wavFile(int layout, int frames);
+	static QByteArray flacFile(const QVector<qint16> & samples, int sampleRate, int order, int precision);
+	static void flacSubframe(QByteArray & bytes, quint64 & cache, int & count, const qint32 * signal, int samples,
+		int bits, int order, int precision);
+	static int lpcCoefficients(const qint32 * signal, int samples, int order, int precision, qint32 * coefs);
+	static void writeBits(QByteArray & bytes, quint64 & cache, int & count, quint32 value, int bits);
+	static qint64 playHeadless(QIODevice * device, const QAudioFormat & format, bool realTime, qint64 * processed);
+	static double pullNs(DspNode * node, const QVector<QBuffer *> & buffers, int frames);
+};
\ No newline at end of file
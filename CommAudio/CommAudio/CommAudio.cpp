@@ -1,1122 +1,2215 @@
-/*------------------------------------------------------------------------------------------------------------------
--- SOURCE FILE:		CommAudio.cpp - An audio player that has stream and voip capabilities.
---
--- PROGRAM:			CommAudio
---
--- FUNCTIONS:
---					QString getAddressFromUser()
---					void populateLocalSongsList()
---					void parsePacketHost(QTcpSocket * sender, const QByteArray data)
---					void parsePacketClient(QTcpSocket * sender, const QByteArray data)
---					void connectToAllOtherClients(const QByteArray data)
---					void displayClientName(const QByteArray data, QTcpSocket * sender)
---					void displaySongName(const QByteArray data, QTcpSocket * sender)
---					void requestForSongs(QTcpSocket * host)
---					void sendSongList(QTcpSocket * sender)
---					void returnSongList(QTcpSocket * sender)
---					void hostSessionHandler()
---					void joinSessionHandler()
---					void leaveSessionHandler()
---					void changeNameHandler()
---					void changeSongFolderHandler()
---					void changeDownloadFolderHandler()
---					void localSongClickedHandler(QTreeWidgetItem * item, int column)
---					void remoteSongClickedHandler(QTreeWidgetItem * item, int column)
---					void remoteMenuHandler(const QPoint & pos)
---					void downloadSong()
---					void newConnectionHandler(QString name, QTcpSocket * socket)
---					void incomingDataHandler()
---					void remoteDisconnectHandler()
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- NOTES:
---					This is the parent window class for the application.
-----------------------------------------------------------------------------------------------------------------------*/
-#include "CommAudio.h"
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		CommAudio
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		CommAudio (QWidget * parent)
---						QWidget * parent: The parent widget.
---
--- RETURNS:			N/A
---
--- NOTES:
---					The constructor for the main window of the program. This constructor also acts as the main entry 
---					point of the program in place of main(int argc, char * argv[]). All slots of objects present during 
---					the start of the program are connected here. Lastly, this is where the program also starts listening
---					for tcp connections.
-----------------------------------------------------------------------------------------------------------------------*/
-CommAudio::CommAudio(QWidget * parent)
-	: QMainWindow(parent)
-	, mIsHost(false)
-	, mName(QHostInfo::localHostName())
-	, mSessionKey()
-	, mConnections()
-	, mIpToName()
-	, mOwnerToSong()
-	, mConnectionManager(&mSessionKey, &mName, this)
-	, mVoip(this)
-	, mDownloadManager(&mSessionKey, &mSongFolder, &mDownloadFolder, this)
-	, mStreamManager(&mSessionKey, &mSongFolder, &mDownloadFolder, this)
-{
-	ui.setupUi(this);
-	setWindowTitle(TITLE_DEFAULT);
-
-	// Create the Media Player
-	mMediaPlayer = new MediaPlayer(&ui, this);
-	mStreamManager.mMediaPlayer = mMediaPlayer;
-
-	// Setting default folder to home/comm-audio
-	QDir tmp = QDir(QDir::homePath() + "/comm-audio");
-	mSongFolder = tmp;
-	mDownloadFolder = tmp;
-
-	ui.treeRemoteSongs->setContextMenuPolicy(Qt::CustomContextMenu);
-
-	// Song Lists
-	connect(ui.treeLocalSongs, &QTreeWidget::itemClicked, this, &CommAudio::localSongClickedHandler);
-	connect(ui.treeRemoteSongs, &QTreeWidget::itemClicked, this, &CommAudio::remoteSongClickedHandler);
-	connect(ui.treeRemoteSongs, &QTreeWidget::customContextMenuRequested, this, &CommAudio::remoteMenuHandler);
-
-	// Closing the application
-	connect(ui.actionExit, &QAction::triggered, this, &QWidget::close);
-
-	// Changing name
-	connect(ui.actionSetName, &QAction::triggered, this, &CommAudio::changeNameHandler);
-
-	// Host, Join, Leave session buttons
-	connect(ui.actionHostSession, &QAction::triggered, this, &CommAudio::hostSessionHandler);
-	connect(ui.actionJoinSession, &QAction::triggered, this, &CommAudio::joinSessionHandler);
-	connect(ui.actionLeaveSession, &QAction::triggered, this, &CommAudio::leaveSessionHandler);
-
-	// Changing targeted folders
-	connect(ui.actionPublicSongFolder, &QAction::triggered, this, &CommAudio::changeSongFolderHandler);
-	connect(ui.actionDownloadFolder, &QAction::triggered, this, &CommAudio::changeDownloadFolderHandler);
-
-	// Populate local song list
-	populateLocalSongsList();
-
-	// Networking set up
-	connect(&mConnectionManager, &ConnectionManager::connectionAccepted, this, &CommAudio::newConnectionHandler);
-
-	// Connect signal for VoIP module
-	connect(this, &CommAudio::connectVoip, &mVoip, &VoipModule::newClientHandler);
-
-	mConnectionManager.Init(&mConnections);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		~CommAudio
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		~CommAudio ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					Deconstructor for the main window of the program. This is where fill clean up of all resources used 
---					by the program takes place.
-----------------------------------------------------------------------------------------------------------------------*/
-CommAudio::~CommAudio()
-{
-	QList<QString> keys = mConnections.keys();
-
-	for (int i = 0; i < keys.size(); i++)
-	{
-		mConnections[keys[i]]->close();
-	}
-
-	delete mMediaPlayer;
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		populateLocalSongsList
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- INTERFACE:		populateLocalSongsList ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This function grabs all the songs in the local songs folder that are encoded in one of the supported 
---					formats and displays them in the local song list tree view.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::populateLocalSongsList()
-{
-	ui.treeLocalSongs->clear();
-
-	QStringList songs = mSongFolder.entryList(SUPPORTED_FORMATS,
-		QDir::Files | QDir::NoDotAndDotDot, QDir::Name);
-
-	// Create a list of widgets
-	for (QString song : songs)
-	{
-		items.append(new QTreeWidgetItem(ui.treeLocalSongs, QStringList(song)));
-	}
-
-	// Add the list of widgets to tree
-	ui.treeLocalSongs->insertTopLevelItems(0, items);
-	mMediaPlayer->UpdateSongList(items);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		getAddressFromUser
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		getAddressFromUser ()
---
--- RETURNS:			The string the user gives if it is a valid dotted decimal address, otherwise an empty string is returned.
---
--- NOTES:
---					Creates a pop up box that asks the user for an ip address then checks the give address against a
---					regex that checks for dotted decimal format. Values of the numbers are not checked.
-----------------------------------------------------------------------------------------------------------------------*/
-QString CommAudio::getAddressFromUser()
-{
-	bool ok;
-	QRegExp rx("(?:[0-9]{1,3}\.){3}[0-9]{1,3}");
-    QString text = QInputDialog::getText(this, tr("Enter Host Address"), "Host Address:", 
-											QLineEdit::Normal, "", &ok);
-
-	if (ok && rx.exactMatch(text))
-	{
-		return text;
-	}
-	else
-	{
-		return "";
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		hostSessionHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- INTERFACE:		hostSessionHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user selects the menu item to become a host. A SHA3 
---					256 byte array is generated and saved to be used as the current sessio key and the application is 
---					switched into host mode by setting mIsHost to true.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::hostSessionHandler()
-{
-	leaveSessionHandler();
-	ui.actionHostSession->setDisabled(true);
-	ui.actionJoinSession->setDisabled(true);
-
-	// Generate session key
-	QCryptographicHash hasher(QCryptographicHash::Sha3_256);
-
-	for (int i = 0; i < rand() % 1000; i++)
-	{
-		switch (rand() % 4)
-		{
-		case 0:
-			hasher.addData(QHostInfo::localHostName().toUtf8());
-			break;
-		case 1:
-			hasher.addData(QString::number(pos().x()).toUtf8());
-			break;
-		case 2:
-			hasher.addData(QString::number(pos().y()).toUtf8());
-			break;
-		case 3:
-			// Do Nothing
-		default:
-			break;
-		}
-	}
-
-	mSessionKey = hasher.result();
-
-	// Set host mode to true
-	mIsHost = true;
-
-	// Set the connection manager to host mode;
-	mConnectionManager.BecomeHost();
-
-	mVoip.Start();
-
-	setWindowTitle(TITLE_HOST);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		joinSessionHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- INTERFACE:		joinSessionHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user selects the menu item to become a host. A SHA3 
---					256 byte array is generated and saved to be used as the current sessio key and the application is 
---					switched into host mode by setting mIsHost to true. Lastly, a connection the the given host address
---					is made if the input was valid.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::joinSessionHandler()
-{
-	leaveSessionHandler();
-
-	mVoip.Start();
-
-	// Send Request to join session
-	QByteArray joinRequest = QByteArray(1 + 33, (char)0);
-	joinRequest[0] = (char)Headers::RequestToJoin;
-	joinRequest.replace(1, mName.size(), mName.toStdString().c_str());
-	joinRequest.resize(1 + 33);
-
-	// Create connection
-	QString address = getAddressFromUser();
-
-	if (address == "")
-	{
-		QMessageBox::warning(this, "Invalid Address", "The address you entered was invalid");
-		return;
-	}
-	
-	QHostAddress hostAddress = QHostAddress(address);
-	QTcpSocket * socket = new QTcpSocket(this);
-	socket->connectToHost(hostAddress, DEFAULT_PORT);
-
-	if (!socket->waitForConnected(CONNECT_TIMEOUT))
-	{
-		socket->deleteLater();
-		QMessageBox::warning(this, "Connetion Error", "Connection Timed Out");
-		return;
-	}
-
-	mConnections[address] = socket;
-	mIpToName[hostAddress.toIPv4Address()] = address;
-	connect(socket, &QTcpSocket::readyRead, this, &CommAudio::incomingDataHandler);
-	connect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
-
-	// Send data
-	socket->write(joinRequest);
-
-	emit connectVoip(hostAddress);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		leaveSessionHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- INTERFACE:		leaveSessionHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					Leaves the current session and sets the state of all components in the application the the default
---					state.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::leaveSessionHandler()
-{
-	ui.actionHostSession->setDisabled(false);
-	ui.actionJoinSession->setDisabled(false);
-	setWindowTitle(TITLE_DEFAULT);
-
-	mIsHost = false;
-	mConnectionManager.BecomeClient();
-	mVoip.Stop();
-
-	mSessionKey = QByteArray();
-
-	// Disconnect from all memebers
-	for (QTcpSocket * socket : mConnections)
-	{
-		disconnect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
-		socket->close();
-	}
-
-	mConnections.clear();
-	mIpToName.clear();
-
-	//clear the treeUsers
-	ui.treeUsers->clear();
-	ui.treeRemoteSongs->clear();
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		changeNameHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		changeNameHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user selects the menu item to change their name. A 
---					message box is shown to the user to enter a new name. That name is then saved and used for 
---					communication with other clients.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::changeNameHandler()
-{
-	mName = QInputDialog::getText(this, tr("Enter new name"), "Name: ", QLineEdit::Normal);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		changeSongFolderHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		changeSongFolderHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user selects the menu item to change the local song folder.
---					A file browser is shown to the user to select a new directory. Once a new directory is selected, the
---					directory is saved and the local songs tree view is populated with all the songs in that folder that 
---					are in a supported format.  This folder can be the same as the download folder.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::changeSongFolderHandler()
-{
-	QString dir = QFileDialog::getExistingDirectory(this, 
-		tr("Select Song Folder"), QDir::homePath(), 
-		QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
-
-	mSongFolder = QDir(dir);
-
-	populateLocalSongsList();
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		changeDownloadFolderHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		changeSongFolderHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user selects the menu item to change the downlaod 
---					destination folder. A file browser is shown to the user to select a new direcotry. That directory 
---					is then used as the new download location. This folder can be the same as the local song folder.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::changeDownloadFolderHandler()
-{
-	QString dir = QFileDialog::getExistingDirectory(this, 
-		tr("Select Download Folder"), QDir::homePath(), 
-		QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
-
-	mDownloadFolder = QDir(dir);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		localSongClickedHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		localSongClickedHandler (QTreeWidgetItem * item, int column)
---						QTreeWidgetItem * item: The QTreeWidgetItem that was clicked on.
---						int column: The colomn that was clicked on.
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user clicks on a song in the local songs list. This 
---					function will grab the name of the song that was clicked on and set it as the current song in the
---					MediaPlayer.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::localSongClickedHandler(QTreeWidgetItem * item, int column)
-{
-	mMediaPlayer->SetDirAndSong(mSongFolder, item);
-	mMediaPlayer->SetSong(mSongFolder.absoluteFilePath(item->text(0)));
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		remoteSongClickedHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		remoteSongCLickedHandler (QTreeWidgetItem * item, int column)
---						QTreeWidgetItem * item: The QTreeWidgetItem that was clicked on.
---						int column: The colomn that was clicked on.
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user clicks on a song in the remote songs list. A request
---					to stream that song is made to the owner of the song.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::remoteSongClickedHandler(QTreeWidgetItem * item, int column)
-{
-	QTcpSocket * socket = mConnections[item->text(1)];
-	QString songName = item->text(0);
-	mStreamManager.StreamSong(songName, socket->peerAddress().toIPv4Address());
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		remoteMenuHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		remoteMenuHandler (const QPoint & pos)
---						const QPoint & pos: The point that was clicked on.
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user right clicks on a song in the remote songs list. 
---					A menu pops up where the only option is to download the song, if the user clicks on the download
---					menu option, then a download request is triggered.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::remoteMenuHandler(const QPoint & pos)
-{
-	nd = ui.treeRemoteSongs->itemAt(pos);
-
-	QAction *newAct = new QAction(QIcon(":/Resource/warning32.ico"), tr("&Download"), this);
-	newAct->setStatusTip(tr("Download Song"));
-	connect(newAct, &QAction::triggered, this, &CommAudio::downloadSong);
-
-	QMenu menu(this);
-	menu.addAction(newAct);
-
-	QPoint pt(pos);
-	menu.exec(ui.treeRemoteSongs->mapToGlobal(pos));
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		downloadSong
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		downloadSong ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					Makes a download request for the song the user clicked on.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::downloadSong()
-{
-	QTcpSocket * socket = mConnections[nd->text(1)];
-	mDownloadManager.DownloadFile(nd->text(0), socket->peerAddress().toIPv4Address());
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		newConnectionHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		newConnectionHandler (QString name, QTcpSocket * socket)
---						QString name: The name of the client.
---						QTcpSocket * socket: The socket of the client.
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the ConnectionManager releases a new valid connection.
---					That connection is then added the the list of valid connections and they are displayed on the GUI
---					for the user.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::newConnectionHandler(QString name, QTcpSocket * socket)
-{
-	//Insert name and ip to map
-	mIpToName.insert(socket->peerAddress().toIPv4Address(), name);
-
-	// Add the new client to the map of clients
-	mConnections[name] = socket;
-	connect(socket, &QTcpSocket::readyRead, this, &CommAudio::incomingDataHandler);
-	connect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
-
-	// Add the client to the tree view
-	QStringList client;
-	client << name << "Client";
-	ui.treeUsers->insertTopLevelItem(ui.treeUsers->topLevelItemCount(), new QTreeWidgetItem(ui.treeUsers, client));
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		incomingDataHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		incomginDataHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when there is data on one of the ports. The data is handled 
---					depending on whether or not the application is currently in client mode or host mode.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::incomingDataHandler()
-{
-	QTcpSocket * sender = (QTcpSocket *)QObject::sender();
-	QByteArray data = sender->readAll();
-
-	if (mIsHost)
-	{
-		parsePacketHost(sender, data);
-	}
-	else
-	{
-		parsePacketClient(sender, data);
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		parsePacketHost
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- INTERFACE:		parsePacketHost ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					Handles the incoming packet as a host based on the protocol.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::parsePacketHost(QTcpSocket * sender, const QByteArray data)
-{
-	QHostAddress address = sender->peerAddress();
-	switch (data[0])
-	{
-	case Headers::RequestForSongs:
-		sendSongList(sender);
-		break;
-	case Headers::ReturnWithSongs:
-		displaySongName(data, sender);
-		break;
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		parsePacketClient
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- INTERFACE:		parsePacketClient ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					Handles the incoming packet as a host based on the protocol.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::parsePacketClient(QTcpSocket * sender, const QByteArray data)
-{
-	switch (data[0])
-	{
-	case Headers::RespondToJoin:
-		requestForSongs(sender);
-		connectToAllOtherClients(data);
-		break;
-	case Headers::RespondWithName:
-		displayClientName(data, sender);
-		requestForSongs(sender);
-		break;
-	case Headers::RequestForSongs:
-		sendSongList(sender);
-		break;
-	case Headers::RespondWithSongs:
-		displaySongName(data, sender);
-		returnSongList(sender);
-		break;
-	case Headers::ReturnWithSongs:
-		displaySongName(data, sender);
-		break;
-	default:
-		break;
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		requestForSongs
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- INTERFACE:		requestForSongs (QTcpSocket * socket)
---						QTcpSocket * socket: The socket to request from.
---
--- RETURNS:			void.		
---
--- NOTES:
---					Makes a request for songs to the socket.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::requestForSongs(QTcpSocket * socket)
-{
-	// Create packet
-	QByteArray packet = QByteArray(1, (char)Headers::RequestForSongs);
-	packet.append(mSessionKey);
-	packet.resize(1 + KEY_SIZE);
-
-	// Send
-	socket->write(packet);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		returnSongList
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		returnSongList (QTcpSocket * socket)
---						QTcpSocket * socket: The socket to write to.
---
--- RETURNS:			void.		
---
--- NOTES:
---					Returns the list of currently selected songs to the socket as a response to a request.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::returnSongList(QTcpSocket * socket)
-{
-	int initSize = 1 + KEY_SIZE + 4;
-	quint32 songSize = items.size();
-	// Create packet
-	QByteArray packet = QByteArray(1, (char)Headers::ReturnWithSongs);
-	packet.append(mSessionKey);
-	packet << songSize;
-
-	for (QTreeWidgetItem * item : items)
-	{
-		packet.append((item->text(0)).toUtf8());
-		initSize += SONGNAME_SIZE;
-		packet.resize(initSize);
-	}
-
-	// Send
-	socket->write(packet);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		returnSongList
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		returnSongList (QTcpSocket * socket)
---						QTcpSocket * socket: The socket to write to.
---
--- RETURNS:			void.		
---
--- NOTES:
---					Sends a list of currently selected songs to the socket.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::sendSongList(QTcpSocket * socket)
-{
-	int initSize = 1 + KEY_SIZE + 4;
-	quint32 songSize = items.size();
-	// Create packet
-	QByteArray packet = QByteArray(1, (char)Headers::RespondWithSongs);
-	packet.append(mSessionKey);
-	packet << songSize;
-
-	for (QTreeWidgetItem * item : items)
-	{
-		packet.append((item->text(0)).toUtf8());
-		initSize += SONGNAME_SIZE;
-		packet.resize(initSize);
-	}
-
-	// Send
-	socket->write(packet);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		connectToAllOtherClients
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Roger Zhang
---
--- INTERFACE:		connectToAllOtherClients (const QByteArray data)
---						const QByteArray data: The incoming data.
---
--- RETURNS:			void.		
---
--- NOTES:
---					Sends a connect request to all other clients that were sent to over in the data.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::connectToAllOtherClients(const QByteArray data)
-{
-	setWindowTitle(TITLE_CLIENT);
-	ui.actionHostSession->setDisabled(true);
-	ui.actionJoinSession->setDisabled(true);
-
-	// Grab session key
-	mSessionKey = data.mid(1, KEY_SIZE);
-
-	QStringList host;
-	host << data.mid(1 + KEY_SIZE, USER_NAME_SIZE) << "Host";
-	ui.treeUsers->insertTopLevelItem(ui.treeUsers->topLevelItemCount(), new QTreeWidgetItem(ui.treeUsers, host));
-
-	// Grab the length
-	int length = (int)data[1 + KEY_SIZE + USER_NAME_SIZE];
-
-	// Craft connect request
-	QByteArray joinRequest = QByteArray(1 + KEY_SIZE + USER_NAME_SIZE, (char)0);
-	joinRequest[0] = (char)Headers::RequestToJoin;
-	joinRequest.replace(1, mSessionKey.size(), mSessionKey);
-	joinRequest.replace(1 + 32, mName.size(), mName.toStdString().c_str());
-
-	// Send connect request to all other clients in the session
-	int offset = 1 + KEY_SIZE + 1;
-
-	for (int i = 0; i < length; i++)
-	{
-		quint32 addressInt = -1;
-		QDataStream(data.mid(offset, 4)) >> addressInt;
-		QHostAddress qHostAddress = QHostAddress(addressInt);
-		QString address = qHostAddress.toString();
-
-		emit connectVoip(qHostAddress);
-
-		QTcpSocket * socket = new QTcpSocket(this);
-		connect(socket, &QTcpSocket::readyRead, this, &CommAudio::incomingDataHandler);
-		connect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
-
-		socket->connectToHost(address, DEFAULT_PORT);
-		socket->write(joinRequest);
-		offset += 4;
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		remoteDisconnectHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Angus Lam
---
--- INTERFACE:		remoteDisconnectHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					Cleans up after a socket has disconnected.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::remoteDisconnectHandler()
-{
-	//Get the socket that sent the signal
-	QTcpSocket * sender = (QTcpSocket *)QObject::sender();
-
-	//Get the peer address as quint32
-	quint32 address = sender->peerAddress().toIPv4Address();
-	//Get the name of the client using the dictionary converter
-	QString clientName = mIpToName[address];
-
-	for (int i = 0; i < mConnections.size(); i++)
-	{
-		if (ui.treeUsers->topLevelItem(i)->text(0) == clientName)
-		{
-			delete ui.treeUsers->takeTopLevelItem(i);
-			break;
-		}
-	}
-
-	//Delete client from connections
-	mConnections.remove(clientName);
-	mIpToName.remove(address);
-
-	//Delete the client songs
-	QList<QTreeWidgetItem*>* items = mOwnerToSong.take(clientName);
-
-	for (int i = 0; i < items->size(); i++)
-	{
-		delete items->at(i);
-	}
-
-	delete items;
-
-	//delete the socket
-	sender->deleteLater();
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		displayClientName
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		displayClientName (const QByteArray data, QTcpSocket * socket)
---						cosnt QByteArray data: The data containing the name.
---						QTcpSocket * socket: The socket that sent the data.
---
--- RETURNS:			void.		
---
--- NOTES:
---					Displays the client's name on the GUI for the user.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::displayClientName(const QByteArray data, QTcpSocket * socket)
-{
-	quint32 address = socket->peerAddress().toIPv4Address();
-	mIpToName[address] = QString(data.mid(1));
-	QStringList otherClient;
-	otherClient << mIpToName[address] << "Client";
-	ui.treeUsers->insertTopLevelItem(ui.treeUsers->topLevelItemCount(), new QTreeWidgetItem(ui.treeUsers, otherClient));
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		displayClientName
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		displaySongName (const QByteArray data, QTcpSocket * socket)
---						cosnt QByteArray data: The data containing the list of songs.
---						QTcpSocket * socket: The socket that sent the data.
---
--- RETURNS:			void.		
---
--- NOTES:
---					Displays the list of incoming songs on the GUI for the user.
-----------------------------------------------------------------------------------------------------------------------*/
-void CommAudio::displaySongName(const QByteArray data, QTcpSocket * sender)
-{
-	quint32 length = -1;
-	QDataStream(data.mid(1 + KEY_SIZE, 4)) >> length;
-
-	int offset = 37;
-	QStringList songList;
-
-	QString clientName = mIpToName[sender->peerAddress().toIPv4Address()];
-
-	//If the peer doesn't have any previous entries in the mOwnerToSong
-	//then create a new QList for the owner
-	if (!mOwnerToSong.contains(clientName))
-	{
-		mOwnerToSong.insert(clientName, new QList<QTreeWidgetItem*>());
-	}
-
-	for (quint32 i = 0; i < length; i++)
-	{
-		songList << QString(data.mid(offset, SONGNAME_SIZE)) << clientName;
-		offset += SONGNAME_SIZE;
-
-		// Append song and the widget item to the owner to song map
-		mOwnerToSong.value(clientName, NULL)->append(new QTreeWidgetItem(ui.treeRemoteSongs, songList));
-		songList.clear();
-	}
-}
\ No newline at end of file
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		CommAudio.cpp - An audio player that has stream and voip capabilities.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					QString getAddressFromUser()
+--					void populateLocalSongsList()
+--					QTreeWidgetItem * songItem(const LibraryEntry & song)
+--					void parsePacketHost(QTcpSocket * sender, const QByteArray data)
+--					void parsePacketClient(QTcpSocket * sender, const QByteArray data)
+--					void connectToAllOtherClients(const QByteArray data)
+--					void displayClientName(const QByteArray data, QTcpSocket * sender)
+--					void displaySongName(const QByteArray data, QTcpSocket * sender)
+--					void requestForSongs(QTcpSocket * host)
+--					void sendSongList(QTcpSocket * sender)
+--					void returnSongList(QTcpSocket * sender)
+--					void hostSessionHandler()
+--					void joinSessionHandler()
+--					void leaveSessionHandler()
+--					void changeNameHandler()
+--					void changeSongFolderHandler()
+--					void changeDownloadFolderHandler()
+--					void localSongClickedHandler(QTreeWidgetItem * item, int column)
+--					void remoteSongClickedHandler(QTreeWidgetItem * item, int column)
+--					void localMenuHandler(const QPoint & pos)
+--					void remoteMenuHandler(const QPoint & pos)
+--					void downloadSong()
+--					void playNextHandler()
+--					void shuffleHandler(bool shuffle)
+--					void repeatHandler()
+--					void equalizerHandler()
+--					void newConnectionHandler(QString name, QTcpSocket * socket)
+--					void incomingDataHandler()
+--					void remoteDisconnectHandler()
+--					void cacheStatsHandler()
+--					void streamNeededHandler(quint32 track, bool prefetch)
+--					void streamTierHandler(quint8 tier, double throughput)
+--					QByteArray sourceList(const QList<QByteArray> & keys)
+--					void readSourceList(const QByteArray & data, int offset, quint32 address)
+--					void announceSources(const QList<QByteArray> & keys)
+--					void announceSongs(bool reset, const QStringList & removed, const QVector<int> & added)
+--					void readSongChanges(const QByteArray & data, QTcpSocket * sender)
+--					void sourceAvailableHandler(QByteArray key)
+--					void loadChangedHandler()
+--					void libraryChangedHandler()
+--					void songsChangedHandler(const QStringList & removed, const QVector<int> & added)
+--					void scanFinishedHandler()
+--					void analysisFinishedHandler(int songs, qint64 elapsed)
+--					void fetchPeaks(const PlaylistTrack & track)
+--					void addTracks(int index, const QList<QTreeWidgetItem *> & added, bool remote)
+--					void removeTracks(const QList<QTreeWidgetItem *> & removed)
+--					void songShownHandler(const QString & fileName)
+--					void streamShownHandler()
+--					void peaksReadyHandler(const QString & song, const PeakFile & peaks)
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The local songs come from a LibraryIndex that scans the song folder
+--									in the background.
+--					October 19, 2026 - agent: Songs added to or removed from the song folder are applied to the
+--									local song list and sent to everyone in the session as they happen.
+--					October 19, 2026 - agent: The seek bar shows the waveform of the song from a PeakCache.
+--					October 19, 2026 - agent: Songs can be played at the same loudness, as measured by the library
+--									index.
+--					October 19, 2026 - agent: Local and remote songs are kept in a Playlist that the player moves
+--									through, which can be shuffled, repeated and queued.
+--					October 19, 2026 - agent: Songs can crossfade into each other and have their bass or treble
+--									boosted.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- NOTES:
+--					This is the parent window class for the application.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "CommAudio.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CommAudio
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The song list is shown from the saved library index.
+--					October 19, 2026 - agent: Hands the library index to the player for the loudness of songs.
+--					October 19, 2026 - agent: Hands the playlist to the player.
+--					October 19, 2026 - agent: Hands the crossfade and equalizer settings to the player.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		CommAudio (QWidget * parent)
+--						QWidget * parent: The parent widget.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The constructor for the main window of the program. This constructor also acts as the main entry 
+--					point of the program in place of main(int argc, char * argv[]). All slots of objects present during 
+--					the start of the program are connected here. Lastly, this is where the program also starts listening
+--					for tcp connections.
+----------------------------------------------------------------------------------------------------------------------*/
+CommAudio::CommAudio(QWidget * parent)
+	: QMainWindow(parent)
+	, mIsHost(false)
+	, mName(QHostInfo::localHostName())
+	, mSessionKey()
+	, mConnections()
+	, mIpToName()
+	, mOwnerToSong()
+	, mPlaylist((quint32)QDateTime::currentMSecsSinceEpoch())
+	, mMenuTrack(0)
+	, mConnectionManager(&mSessionKey, &mName, this)
+	, mVoip(this)
+	, mDownloadManager(&mSessionKey, &mSongFolder, &mDownloadFolder, this)
+	, mStreamManager(&mSessionKey, &mSongFolder, &mDownloadFolder, this)
+	, mLibrary(QDir(QDir::homePath() + LIBRARY_INDEX_FOLDER), this)
+	, mPeakCache(&mSessionKey, &mSongFolder, QDir(QDir::homePath() + LIBRARY_INDEX_FOLDER), this)
+{
+	ui.setupUi(this);
+	setWindowTitle(TITLE_DEFAULT);
+
+	// Create the Media Player
+	mMediaPlayer = new MediaPlayer(&ui, this);
+	mStreamManager.mMediaPlayer = mMediaPlayer;
+	mMediaPlayer->SetPlaylist(&mPlaylist, &mSongFolder);
+
+	// Setting default folder to home/comm-audio
+	QDir tmp = QDir(QDir::homePath() + "/comm-audio");
+	mSongFolder = tmp;
+	mDownloadFolder = tmp;
+
+	ui.treeLocalSongs->setContextMenuPolicy(Qt::CustomContextMenu);
+	ui.treeRemoteSongs->setContextMenuPolicy(Qt::CustomContextMenu);
+
+	// Song Lists
+	connect(ui.treeLocalSongs, &QTreeWidget::itemClicked, this, &CommAudio::localSongClickedHandler);
+	connect(ui.treeLocalSongs, &QTreeWidget::customContextMenuRequested, this, &CommAudio::localMenuHandler);
+	connect(ui.treeRemoteSongs, &QTreeWidget::itemClicked, this, &CommAudio::remoteSongClickedHandler);
+	connect(ui.treeRemoteSongs, &QTreeWidget::customContextMenuRequested, this, &CommAudio::remoteMenuHandler);
+
+	// The order songs are played in
+	connect(ui.actionShuffle, &QAction::toggled, this, &CommAudio::shuffleHandler);
+	connect(ui.actionRepeatList, &QAction::toggled, this, &CommAudio::repeatHandler);
+	connect(ui.actionRepeatSong, &QAction::toggled, this, &CommAudio::repeatHandler);
+
+	// Closing the application
+	connect(ui.actionExit, &QAction::triggered, this, &QWidget::close);
+
+	// Changing name
+	connect(ui.actionSetName, &QAction::triggered, this, &CommAudio::changeNameHandler);
+
+	// Host, Join, Leave session buttons
+	connect(ui.actionHostSession, &QAction::triggered, this, &CommAudio::hostSessionHandler);
+	connect(ui.actionJoinSession, &QAction::triggered, this, &CommAudio::joinSessionHandler);
+	connect(ui.actionLeaveSession, &QAction::triggered, this, &CommAudio::leaveSessionHandler);
+
+	// Changing targeted folders
+	connect(ui.actionPublicSongFolder, &QAction::triggered, this, &CommAudio::changeSongFolderHandler);
+	connect(ui.actionDownloadFolder, &QAction::triggered, this, &CommAudio::changeDownloadFolderHandler);
+
+	// Ask the host to mix everyone into one voice stream
+	connect(ui.actionMixedVoice, &QAction::toggled, &mVoip, &VoipModule::SetMixedMode);
+
+	// Populate local song list from the index of the song folder, then keep it up to date as the folder changes
+	connect(&mLibrary, &LibraryIndex::indexChanged, this, &CommAudio::libraryChangedHandler);
+	connect(&mLibrary, &LibraryIndex::songsChanged, this, &CommAudio::songsChangedHandler);
+	connect(&mLibrary, &LibraryIndex::scanFinished, this, &CommAudio::scanFinishedHandler);
+	mLibrary.Open(mSongFolder);
+
+	// Play every local song at the same loudness, from the loudness the library index measures in the background
+	connect(&mLibrary, &LibraryIndex::analysisFinished, this, &CommAudio::analysisFinishedHandler);
+	connect(ui.actionNormalizeLoudness, &QAction::toggled, mMediaPlayer, &MediaPlayer::SetNormalized);
+	mMediaPlayer->SetLibrary(&mLibrary);
+	mMediaPlayer->SetNormalized(ui.actionNormalizeLoudness->isChecked());
+
+	// Fade songs into each other and boost the bass or treble of everything played
+	connect(ui.actionCrossfade, &QAction::toggled, mMediaPlayer, &MediaPlayer::SetCrossfade);
+	connect(ui.actionBassBoost, &QAction::toggled, this, &CommAudio::equalizerHandler);
+	connect(ui.actionTrebleBoost, &QAction::toggled, this, &CommAudio::equalizerHandler);
+	mMediaPlayer->SetCrossfade(ui.actionCrossfade->isChecked());
+	equalizerHandler();
+
+	// Draw the waveform of the song that is playing in the seek bar
+	connect(mMediaPlayer, &MediaPlayer::songShown, this, &CommAudio::songShownHandler);
+	connect(mMediaPlayer, &MediaPlayer::streamShown, this, &CommAudio::streamShownHandler);
+	connect(&mPeakCache, &PeakCache::peaksReady, this, &CommAudio::peaksReadyHandler);
+
+	// Networking set up
+	connect(&mConnectionManager, &ConnectionManager::connectionAccepted, this, &CommAudio::newConnectionHandler);
+
+	// Connect signal for VoIP module
+	connect(this, &CommAudio::connectVoip, &mVoip, &VoipModule::newClientHandler);
+
+	// Show how well the stream cache is doing
+	connect(&mStreamManager, &StreamManager::cacheStatsChanged, this, &CommAudio::cacheStatsHandler);
+
+	// Stream the remote songs the player comes to in the playlist
+	connect(mMediaPlayer, &MediaPlayer::streamNeeded, this, &CommAudio::streamNeededHandler);
+
+	// Show when the stream changes quality to keep up with the network
+	connect(&mStreamManager, &StreamManager::streamTierChanged, this, &CommAudio::streamTierHandler);
+
+	// Tell the session which songs can be streamed from here and how busy this peer is
+	connect(&mStreamManager, &StreamManager::sourceAvailable, this, &CommAudio::sourceAvailableHandler);
+	connect(&mStreamManager, &StreamManager::loadChanged, this, &CommAudio::loadChangedHandler);
+
+	mConnectionManager.Init(&mConnections);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~CommAudio
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~CommAudio ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Deconstructor for the main window of the program. This is where fill clean up of all resources used 
+--					by the program takes place.
+----------------------------------------------------------------------------------------------------------------------*/
+CommAudio::~CommAudio()
+{
+	QList<QString> keys = mConnections.keys();
+
+	for (int i = 0; i < keys.size(); i++)
+	{
+		mConnections[keys[i]]->close();
+	}
+
+	delete mMediaPlayer;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		populateLocalSongsList
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The songs come from the library index, which includes sub folders and
+--									knows the length of every song.
+--					October 19, 2026 - agent: The items are made by songItem.
+--					October 19, 2026 - agent: The local songs of the playlist are replaced along with the list.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- INTERFACE:		populateLocalSongsList ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This function grabs all the songs in the local songs folder that are encoded in one of the supported 
+--					formats and displays them in the local song list tree view. Songs in sub folders are shown by their
+--					path from the song folder. Nothing on the disk is touched, everything comes from the library index.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::populateLocalSongsList()
+{
+	removeTracks(items);
+	ui.treeLocalSongs->clear();
+	items.clear();
+
+	// Create a list of widgets
+	for (const LibraryEntry & song : mLibrary.Entries())
+	{
+		items.append(songItem(song));
+	}
+
+	// Add the list of widgets to tree
+	ui.treeLocalSongs->insertTopLevelItems(0, items);
+	addTracks(0, items, false);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		songItem
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		songItem (const LibraryEntry & song)
+--						const LibraryEntry & song: The song in the library index.
+--
+-- RETURNS:			A new item for the local song list, which is not in the tree yet.
+--
+-- NOTES:
+--					The length of the song is only shown when it is a song that can be played.
+----------------------------------------------------------------------------------------------------------------------*/
+QTreeWidgetItem * CommAudio::songItem(const LibraryEntry & song)
+{
+	QStringList columns(song.path);
+
+	if (song.sampleRate > 0)
+	{
+		qint64 seconds = song.duration / 1000000;
+		columns << QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+	}
+
+	return new QTreeWidgetItem(columns);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		getAddressFromUser
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		getAddressFromUser ()
+--
+-- RETURNS:			The string the user gives if it is a valid dotted decimal address, otherwise an empty string is returned.
+--
+-- NOTES:
+--					Creates a pop up box that asks the user for an ip address then checks the give address against a
+--					regex that checks for dotted decimal format. Values of the numbers are not checked.
+----------------------------------------------------------------------------------------------------------------------*/
+QString CommAudio::getAddressFromUser()
+{
+	bool ok;
+	QRegExp rx("(?:[0-9]{1,3}\.){3}[0-9]{1,3}");
+    QString text = QInputDialog::getText(this, tr("Enter Host Address"), "Host Address:", 
+											QLineEdit::Normal, "", &ok);
+
+	if (ok && rx.exactMatch(text))
+	{
+		return text;
+	}
+	else
+	{
+		return "";
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		hostSessionHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- INTERFACE:		hostSessionHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user selects the menu item to become a host. A SHA3 
+--					256 byte array is generated and saved to be used as the current sessio key and the application is 
+--					switched into host mode by setting mIsHost to true.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::hostSessionHandler()
+{
+	leaveSessionHandler();
+	ui.actionHostSession->setDisabled(true);
+	ui.actionJoinSession->setDisabled(true);
+
+	// Generate session key
+	QCryptographicHash hasher(QCryptographicHash::Sha3_256);
+
+	for (int i = 0; i < rand() % 1000; i++)
+	{
+		switch (rand() % 4)
+		{
+		case 0:
+			hasher.addData(QHostInfo::localHostName().toUtf8());
+			break;
+		case 1:
+			hasher.addData(QString::number(pos().x()).toUtf8());
+			break;
+		case 2:
+			hasher.addData(QString::number(pos().y()).toUtf8());
+			break;
+		case 3:
+			// Do Nothing
+		default:
+			break;
+		}
+	}
+
+	mSessionKey = hasher.result();
+
+	// Set host mode to true
+	mIsHost = true;
+
+	// Set the connection manager to host mode;
+	mConnectionManager.BecomeHost();
+
+	mVoip.Start(true);
+
+	setWindowTitle(TITLE_HOST);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		joinSessionHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- INTERFACE:		joinSessionHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user selects the menu item to become a host. A SHA3 
+--					256 byte array is generated and saved to be used as the current sessio key and the application is 
+--					switched into host mode by setting mIsHost to true. Lastly, a connection the the given host address
+--					is made if the input was valid.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::joinSessionHandler()
+{
+	leaveSessionHandler();
+
+	mVoip.Start();
+
+	// Send Request to join session
+	QByteArray joinRequest = QByteArray(1 + 33, (char)0);
+	joinRequest[0] = (char)Headers::RequestToJoin;
+	joinRequest.replace(1, mName.size(), mName.toStdString().c_str());
+	joinRequest.resize(1 + 33);
+
+	// Create connection
+	QString address = getAddressFromUser();
+
+	if (address == "")
+	{
+		QMessageBox::warning(this, "Invalid Address", "The address you entered was invalid");
+		return;
+	}
+	
+	QHostAddress hostAddress = QHostAddress(address);
+	QTcpSocket * socket = new QTcpSocket(this);
+	socket->connectToHost(hostAddress, DEFAULT_PORT);
+
+	if (!socket->waitForConnected(CONNECT_TIMEOUT))
+	{
+		socket->deleteLater();
+		QMessageBox::warning(this, "Connetion Error", "Connection Timed Out");
+		return;
+	}
+
+	mConnections[address] = socket;
+	mIpToName[hostAddress.toIPv4Address()] = address;
+	connect(socket, &QTcpSocket::readyRead, this, &CommAudio::incomingDataHandler);
+	connect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
+
+	// Send data
+	socket->write(joinRequest);
+
+	emit connectVoip(hostAddress);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		leaveSessionHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The remote songs are taken out of the playlist.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- INTERFACE:		leaveSessionHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Leaves the current session and sets the state of all components in the application the the default
+--					state.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::leaveSessionHandler()
+{
+	ui.actionHostSession->setDisabled(false);
+	ui.actionJoinSession->setDisabled(false);
+	setWindowTitle(TITLE_DEFAULT);
+
+	mIsHost = false;
+	mConnectionManager.BecomeClient();
+	mVoip.Stop();
+
+	mSessionKey = QByteArray();
+
+	// Disconnect from all memebers
+	for (QTcpSocket * socket : mConnections)
+	{
+		disconnect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
+		socket->close();
+	}
+
+	mConnections.clear();
+	mIpToName.clear();
+
+	QList<QTreeWidgetItem *> remoteSongs;
+	for (int i = 0; i < ui.treeRemoteSongs->topLevelItemCount(); i++)
+	{
+		remoteSongs.append(ui.treeRemoteSongs->topLevelItem(i));
+	}
+	removeTracks(remoteSongs);
+
+	//clear the treeUsers
+	ui.treeUsers->clear();
+	ui.treeRemoteSongs->clear();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		changeNameHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		changeNameHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user selects the menu item to change their name. A 
+--					message box is shown to the user to enter a new name. That name is then saved and used for 
+--					communication with other clients.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::changeNameHandler()
+{
+	mName = QInputDialog::getText(this, tr("Enter new name"), "Name: ", QLineEdit::Normal);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		changeSongFolderHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The folder is opened in the library index.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		changeSongFolderHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user selects the menu item to change the local song folder.
+--					A file browser is shown to the user to select a new directory. Once a new directory is selected, the
+--					directory is saved and the local songs tree view is populated with all the songs in that folder that 
+--					are in a supported format.  This folder can be the same as the download folder.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::changeSongFolderHandler()
+{
+	QString dir = QFileDialog::getExistingDirectory(this, 
+		tr("Select Song Folder"), QDir::homePath(), 
+		QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+
+	mSongFolder = QDir(dir);
+
+	mLibrary.Open(mSongFolder);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		changeDownloadFolderHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		changeSongFolderHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user selects the menu item to change the downlaod 
+--					destination folder. A file browser is shown to the user to select a new direcotry. That directory 
+--					is then used as the new download location. This folder can be the same as the local song folder.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::changeDownloadFolderHandler()
+{
+	QString dir = QFileDialog::getExistingDirectory(this, 
+		tr("Select Download Folder"), QDir::homePath(), 
+		QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+
+	mDownloadFolder = QDir(dir);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		localSongClickedHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The song is picked by its track in the playlist.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		localSongClickedHandler (QTreeWidgetItem * item, int column)
+--						QTreeWidgetItem * item: The QTreeWidgetItem that was clicked on.
+--						int column: The colomn that was clicked on.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user clicks on a song in the local songs list. This 
+--					function will grab the name of the song that was clicked on and set it as the current song in the
+--					MediaPlayer.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::localSongClickedHandler(QTreeWidgetItem * item, int column)
+{
+	mMediaPlayer->SetTrack(item->data(0, Qt::UserRole + 2).toUInt());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		remoteSongClickedHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: Its waveform is fetched.
+--					October 19, 2026 - agent: The song is played as a track of the playlist.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		remoteSongCLickedHandler (QTreeWidgetItem * item, int column)
+--						QTreeWidgetItem * item: The QTreeWidgetItem that was clicked on.
+--						int column: The colomn that was clicked on.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user clicks on a song in the remote songs list. The
+--					song becomes the current track of the player, which asks for it to be streamed through
+--					streamNeededHandler.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::remoteSongClickedHandler(QTreeWidgetItem * item, int column)
+{
+	mMediaPlayer->PlayTrack(item->data(0, Qt::UserRole + 2).toUInt());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		localMenuHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		localMenuHandler (const QPoint & pos)
+--						const QPoint & pos: The point that was clicked on.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user right clicks on a song in the local songs list. A
+--					menu pops up with the option to play the song next.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::localMenuHandler(const QPoint & pos)
+{
+	QTreeWidgetItem * item = ui.treeLocalSongs->itemAt(pos);
+	if (item == nullptr)
+	{
+		return;
+	}
+
+	mMenuTrack = item->data(0, Qt::UserRole + 2).toUInt();
+
+	QMenu menu(this);
+	QAction * playNext = menu.addAction(tr("Play &Next"));
+	connect(playNext, &QAction::triggered, this, &CommAudio::playNextHandler);
+
+	menu.exec(ui.treeLocalSongs->mapToGlobal(pos));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		remoteMenuHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The song can also be played next.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--
+-- INTERFACE:		remoteMenuHandler (const QPoint & pos)
+--						const QPoint & pos: The point that was clicked on.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user right clicks on a song in the remote songs list. 
+--					A menu pops up with the options to download the song or play it next, if the user clicks on the
+--					download menu option, then a download request is triggered.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::remoteMenuHandler(const QPoint & pos)
+{
+	nd = ui.treeRemoteSongs->itemAt(pos);
+	if (nd == nullptr)
+	{
+		return;
+	}
+
+	mMenuTrack = nd->data(0, Qt::UserRole + 2).toUInt();
+
+	QAction *newAct = new QAction(QIcon(":/Resource/warning32.ico"), tr("&Download"), this);
+	newAct->setStatusTip(tr("Download Song"));
+	connect(newAct, &QAction::triggered, this, &CommAudio::downloadSong);
+
+	QMenu menu(this);
+	menu.addAction(newAct);
+
+	QAction * playNext = menu.addAction(tr("Play &Next"));
+	connect(playNext, &QAction::triggered, this, &CommAudio::playNextHandler);
+
+	QPoint pt(pos);
+	menu.exec(ui.treeRemoteSongs->mapToGlobal(pos));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		downloadSong
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--
+-- INTERFACE:		downloadSong ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Makes a download request for the song the user clicked on.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::downloadSong()
+{
+	QTcpSocket * socket = mConnections[nd->text(1)];
+	mDownloadManager.DownloadFile(nd->text(0), socket->peerAddress().toIPv4Address());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		playNextHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		playNextHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user picks Play Next on a song in either song list.
+--					The song is queued in the playlist to play after the current song and any songs queued before it.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::playNextHandler()
+{
+	mPlaylist.Enqueue(mMenuTrack);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		shuffleHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		shuffleHandler (bool shuffle)
+--						bool shuffle: True to play the songs in a shuffled order.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user turns shuffle on or off in the settings menu.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::shuffleHandler(bool shuffle)
+{
+	mPlaylist.SetShuffle(shuffle);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		repeatHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		repeatHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user changes either repeat option in the settings menu.
+--					Repeating the song wins over repeating the list, and with neither the player stops at the end of
+--					the playlist.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::repeatHandler()
+{
+	if (ui.actionRepeatSong->isChecked())
+	{
+		mPlaylist.SetRepeat(Playlist::RepeatOne);
+	}
+	else
+	{
+		mPlaylist.SetRepeat(ui.actionRepeatList->isChecked() ? Playlist::RepeatAll : Playlist::RepeatOff);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		equalizerHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		equalizerHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user turns the bass or treble boost on or off in the
+--					settings menu. The two boosts touch different bands, so with both on the gains of each band are added.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::equalizerHandler()
+{
+	const float bass[] = EQUALIZER_BASS_BOOST;
+	const float treble[] = EQUALIZER_TREBLE_BOOST;
+	QVector<float> gains(EQUALIZER_BANDS, 0.0f);
+
+	for (int i = 0; i < EQUALIZER_BANDS; i++)
+	{
+		gains[i] += ui.actionBassBoost->isChecked() ? bass[i] : 0.0f;
+		gains[i] += ui.actionTrebleBoost->isChecked() ? treble[i] : 0.0f;
+	}
+
+	mMediaPlayer->SetEqualizer(gains);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		newConnectionHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		newConnectionHandler (QString name, QTcpSocket * socket)
+--						QString name: The name of the client.
+--						QTcpSocket * socket: The socket of the client.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the ConnectionManager releases a new valid connection.
+--					That connection is then added the the list of valid connections and they are displayed on the GUI
+--					for the user.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::newConnectionHandler(QString name, QTcpSocket * socket)
+{
+	//Insert name and ip to map
+	mIpToName.insert(socket->peerAddress().toIPv4Address(), name);
+
+	// Add the new client to the map of clients
+	mConnections[name] = socket;
+	connect(socket, &QTcpSocket::readyRead, this, &CommAudio::incomingDataHandler);
+	connect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
+
+	// Add the client to the tree view
+	QStringList client;
+	client << name << "Client";
+	ui.treeUsers->insertTopLevelItem(ui.treeUsers->topLevelItemCount(), new QTreeWidgetItem(ui.treeUsers, client));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		incomingDataHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		incomginDataHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when there is data on one of the ports. The data is handled 
+--					depending on whether or not the application is currently in client mode or host mode.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::incomingDataHandler()
+{
+	QTcpSocket * sender = (QTcpSocket *)QObject::sender();
+	QByteArray data = sender->readAll();
+
+	if (mIsHost)
+	{
+		parsePacketHost(sender, data);
+	}
+	else
+	{
+		parsePacketClient(sender, data);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		parsePacketHost
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- INTERFACE:		parsePacketHost ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Handles the incoming packet as a host based on the protocol.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::parsePacketHost(QTcpSocket * sender, const QByteArray data)
+{
+	QHostAddress address = sender->peerAddress();
+	switch (data[0])
+	{
+	case Headers::RequestForSongs:
+		sendSongList(sender);
+		break;
+	case Headers::ReturnWithSongs:
+		displaySongName(data, sender);
+		break;
+	case Headers::AnnounceSource:
+		readSourceList(data, 1 + KEY_SIZE, address.toIPv4Address());
+		break;
+	case Headers::SongsChanged:
+		readSongChanges(data, sender);
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		parsePacketClient
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- INTERFACE:		parsePacketClient ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Handles the incoming packet as a host based on the protocol.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::parsePacketClient(QTcpSocket * sender, const QByteArray data)
+{
+	switch (data[0])
+	{
+	case Headers::RespondToJoin:
+		requestForSongs(sender);
+		connectToAllOtherClients(data);
+		break;
+	case Headers::RespondWithName:
+		displayClientName(data, sender);
+		requestForSongs(sender);
+		break;
+	case Headers::RequestForSongs:
+		sendSongList(sender);
+		break;
+	case Headers::RespondWithSongs:
+		displaySongName(data, sender);
+		returnSongList(sender);
+		break;
+	case Headers::ReturnWithSongs:
+		displaySongName(data, sender);
+		break;
+	case Headers::AnnounceSource:
+		readSourceList(data, 1 + KEY_SIZE, sender->peerAddress().toIPv4Address());
+		break;
+	case Headers::SongsChanged:
+		readSongChanges(data, sender);
+		break;
+	default:
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		requestForSongs
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- INTERFACE:		requestForSongs (QTcpSocket * socket)
+--						QTcpSocket * socket: The socket to request from.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Makes a request for songs to the socket.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::requestForSongs(QTcpSocket * socket)
+{
+	// Create packet
+	QByteArray packet = QByteArray(1, (char)Headers::RequestForSongs);
+	packet.append(mSessionKey);
+	packet.resize(1 + KEY_SIZE);
+
+	// Send
+	socket->write(packet);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		returnSongList
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The size and modification time come from the library index.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--
+-- INTERFACE:		returnSongList (QTcpSocket * socket)
+--						QTcpSocket * socket: The socket to write to.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Returns the list of currently selected songs to the socket as a response to a request. Each song
+--					is followed by its file size and modification time, which are taken from the library index. The
+--					list ends with the streamed songs that can be relayed from this peer.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::returnSongList(QTcpSocket * socket)
+{
+	int initSize = 1 + KEY_SIZE + 4;
+	quint32 songSize = mLibrary.Entries().size();
+	// Create packet
+	QByteArray packet = QByteArray(1, (char)Headers::ReturnWithSongs);
+	packet.append(mSessionKey);
+	packet << songSize;
+
+	for (const LibraryEntry & song : mLibrary.Entries())
+	{
+		packet.append(song.path.toUtf8());
+		initSize += SONGNAME_SIZE;
+		packet.resize(initSize);
+		packet << (quint32)song.size << (quint32)(song.modified / 1000);
+		initSize += SONG_ENTRY_SIZE - SONGNAME_SIZE;
+	}
+
+	// The songs that can be relayed from here
+	packet.append(sourceList(mStreamManager.RelayKeys()));
+
+	// Send
+	socket->write(packet);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		returnSongList
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The size and modification time come from the library index.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--
+-- INTERFACE:		returnSongList (QTcpSocket * socket)
+--						QTcpSocket * socket: The socket to write to.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Sends a list of currently selected songs to the socket. Each song is followed by its file size and
+--					modification time, which are taken from the library index. The list ends with the streamed songs
+--					that can be relayed from this peer.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::sendSongList(QTcpSocket * socket)
+{
+	int initSize = 1 + KEY_SIZE + 4;
+	quint32 songSize = mLibrary.Entries().size();
+	// Create packet
+	QByteArray packet = QByteArray(1, (char)Headers::RespondWithSongs);
+	packet.append(mSessionKey);
+	packet << songSize;
+
+	for (const LibraryEntry & song : mLibrary.Entries())
+	{
+		packet.append(song.path.toUtf8());
+		initSize += SONGNAME_SIZE;
+		packet.resize(initSize);
+		packet << (quint32)song.size << (quint32)(song.modified / 1000);
+		initSize += SONG_ENTRY_SIZE - SONGNAME_SIZE;
+	}
+
+	// The songs that can be relayed from here
+	packet.append(sourceList(mStreamManager.RelayKeys()));
+
+	// Send
+	socket->write(packet);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		connectToAllOtherClients
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Roger Zhang
+--
+-- INTERFACE:		connectToAllOtherClients (const QByteArray data)
+--						const QByteArray data: The incoming data.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Sends a connect request to all other clients that were sent to over in the data.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::connectToAllOtherClients(const QByteArray data)
+{
+	setWindowTitle(TITLE_CLIENT);
+	ui.actionHostSession->setDisabled(true);
+	ui.actionJoinSession->setDisabled(true);
+
+	// Grab session key
+	mSessionKey = data.mid(1, KEY_SIZE);
+
+	QStringList host;
+	host << data.mid(1 + KEY_SIZE, USER_NAME_SIZE) << "Host";
+	ui.treeUsers->insertTopLevelItem(ui.treeUsers->topLevelItemCount(), new QTreeWidgetItem(ui.treeUsers, host));
+
+	// Grab the length
+	int length = (int)data[1 + KEY_SIZE + USER_NAME_SIZE];
+
+	// Craft connect request
+	QByteArray joinRequest = QByteArray(1 + KEY_SIZE + USER_NAME_SIZE, (char)0);
+	joinRequest[0] = (char)Headers::RequestToJoin;
+	joinRequest.replace(1, mSessionKey.size(), mSessionKey);
+	joinRequest.replace(1 + 32, mName.size(), mName.toStdString().c_str());
+
+	// Send connect request to all other clients in the session
+	int offset = 1 + KEY_SIZE + 1;
+
+	for (int i = 0; i < length; i++)
+	{
+		quint32 addressInt = -1;
+		QDataStream(data.mid(offset, 4)) >> addressInt;
+		QHostAddress qHostAddress = QHostAddress(addressInt);
+		QString address = qHostAddress.toString();
+
+		emit connectVoip(qHostAddress);
+
+		QTcpSocket * socket = new QTcpSocket(this);
+		connect(socket, &QTcpSocket::readyRead, this, &CommAudio::incomingDataHandler);
+		connect(socket, &QTcpSocket::disconnected, this, &CommAudio::remoteDisconnectHandler);
+
+		socket->connectToHost(address, DEFAULT_PORT);
+		socket->write(joinRequest);
+		offset += 4;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		remoteDisconnectHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The songs of the peer are taken out of the playlist.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Angus Lam
+--
+-- INTERFACE:		remoteDisconnectHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Cleans up after a socket has disconnected.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::remoteDisconnectHandler()
+{
+	//Get the socket that sent the signal
+	QTcpSocket * sender = (QTcpSocket *)QObject::sender();
+
+	//Get the peer address as quint32
+	quint32 address = sender->peerAddress().toIPv4Address();
+	//Get the name of the client using the dictionary converter
+	QString clientName = mIpToName[address];
+
+	for (int i = 0; i < mConnections.size(); i++)
+	{
+		if (ui.treeUsers->topLevelItem(i)->text(0) == clientName)
+		{
+			delete ui.treeUsers->takeTopLevelItem(i);
+			break;
+		}
+	}
+
+	//Delete client from connections
+	mConnections.remove(clientName);
+	mIpToName.remove(address);
+	mStreamManager.RemovePeer(address);
+
+	//Delete the client songs
+	QList<QTreeWidgetItem*>* items = mOwnerToSong.take(clientName);
+
+	removeTracks(*items);
+
+	for (int i = 0; i < items->size(); i++)
+	{
+		delete items->at(i);
+	}
+
+	delete items;
+
+	//delete the socket
+	sender->deleteLater();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		displayClientName
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		displayClientName (const QByteArray data, QTcpSocket * socket)
+--						cosnt QByteArray data: The data containing the name.
+--						QTcpSocket * socket: The socket that sent the data.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Displays the client's name on the GUI for the user.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::displayClientName(const QByteArray data, QTcpSocket * socket)
+{
+	quint32 address = socket->peerAddress().toIPv4Address();
+	mIpToName[address] = QString(data.mid(1));
+	QStringList otherClient;
+	otherClient << mIpToName[address] << "Client";
+	ui.treeUsers->insertTopLevelItem(ui.treeUsers->topLevelItemCount(), new QTreeWidgetItem(ui.treeUsers, otherClient));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		displayClientName
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The songs are added to the playlist.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--
+-- INTERFACE:		displaySongName (const QByteArray data, QTcpSocket * socket)
+--						cosnt QByteArray data: The data containing the list of songs.
+--						QTcpSocket * socket: The socket that sent the data.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					Displays the list of incoming songs on the GUI for the user. The size and modification time of each
+--					song are stored with its item. The songs the peer can relay are passed on to the stream manager.
+--					The songs are added to the end of the playlist.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::displaySongName(const QByteArray data, QTcpSocket * sender)
+{
+	quint32 length = -1;
+	QDataStream(data.mid(1 + KEY_SIZE, 4)) >> length;
+
+	int offset = 37;
+	QStringList songList;
+	QList<QTreeWidgetItem *> added;
+
+	QString clientName = mIpToName[sender->peerAddress().toIPv4Address()];
+
+	//If the peer doesn't have any previous entries in the mOwnerToSong
+	//then create a new QList for the owner
+	if (!mOwnerToSong.contains(clientName))
+	{
+		mOwnerToSong.insert(clientName, new QList<QTreeWidgetItem*>());
+	}
+
+	for (quint32 i = 0; i < length; i++)
+	{
+		quint32 size = 0;
+		quint32 modified = 0;
+
+		songList << QString(data.mid(offset, SONGNAME_SIZE)) << clientName;
+		QDataStream(data.mid(offset + SONGNAME_SIZE, 8)) >> size >> modified;
+		offset += SONG_ENTRY_SIZE;
+
+		// Keep the size and modification time to identify the song in the stream cache
+		QTreeWidgetItem * item = new QTreeWidgetItem(ui.treeRemoteSongs, songList);
+		item->setData(0, Qt::UserRole, size);
+		item->setData(0, Qt::UserRole + 1, modified);
+
+		// Append song and the widget item to the owner to song map
+		mOwnerToSong.value(clientName, NULL)->append(item);
+		added.append(item);
+		songList.clear();
+	}
+
+	addTracks(mPlaylist.Size(), added, true);
+
+	readSourceList(data, offset, sender->peerAddress().toIPv4Address());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		cacheStatsHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		cacheStatsHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered every time a streamed song is looked up in the stream cache.
+--					The hit rate of the cache is shown in the status bar.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::cacheStatsHandler()
+{
+	StreamCache::Stats stats = mStreamManager.CacheStats();
+
+	statusBar()->showMessage(QString("Stream cache: %1% hit rate (%2 hits, %3 partial, %4 misses)")
+		.arg(qRound(mStreamManager.CacheHitRate() * 100))
+		.arg(stats.hits)
+		.arg(stats.partialHits)
+		.arg(stats.misses));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		streamNeededHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The waveform of the next song is fetched.
+--					October 19, 2026 - agent: Streams the track the player asks for, which was renamed from
+--									nextStreamHandler.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		streamNeededHandler (quint32 track, bool prefetch)
+--						quint32 track: The remote song in the playlist to stream.
+--						bool prefetch: True to play it after the current song, false to play it now.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the player comes to a remote song in the playlist, either
+--					because it was picked or because the song before it is about to end. A request to stream the song is
+--					made to its owner, with the size and modification time of the song so that a cached copy is only
+--					used if the song has not changed. Its waveform is fetched at the same time so it is ready by the time
+--					the stream starts.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::streamNeededHandler(quint32 track, bool prefetch)
+{
+	const PlaylistTrack * song = mPlaylist.Track(track);
+	if (song == nullptr || !song->IsRemote() || !mConnections.contains(song->owner))
+	{
+		return;
+	}
+
+	quint32 address = mConnections[song->owner]->peerAddress().toIPv4Address();
+	if (prefetch)
+	{
+		mStreamManager.PrefetchSong(song->song, address, song->owner, song->size, song->modified);
+	}
+	else
+	{
+		mStreamManager.StreamSong(song->song, address, song->owner, song->size, song->modified);
+	}
+
+	fetchPeaks(*song);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		streamTierHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		streamTierHandler (quint8 tier, double throughput)
+--						quint8 tier: The tier the stream is now arriving at.
+--						double throughput: The measured throughput of the stream in bits per second.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the stream that is arriving changes quality tier. The new
+--					tier and the throughput that caused the change are shown in the status bar.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::streamTierHandler(quint8 tier, double throughput)
+{
+	statusBar()->showMessage(QString("Stream quality: %1 (%2 kbit/s)")
+		.arg(TierCodec::Name(tier))
+		.arg(qRound(throughput / 1000)));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		sourceList
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		sourceList (const QList<QByteArray> & keys)
+--						const QList<QByteArray> & keys: The cache keys of the songs that can be relayed.
+--
+-- RETURNS:			The number of streams this peer is uploading followed by the number of keys and the keys.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray CommAudio::sourceList(const QList<QByteArray> & keys)
+{
+	QByteArray list;
+	list << mStreamManager.Load();
+	list << (quint32)keys.size();
+
+	for (const QByteArray & key : keys)
+	{
+		list.append(key.left(CACHE_KEY_SIZE));
+		list.resize(list.size() + CACHE_KEY_SIZE - qMin(key.size(), CACHE_KEY_SIZE));
+	}
+
+	return list;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readSourceList
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readSourceList (const QByteArray & data, int offset, quint32 address)
+--						const QByteArray & data: The incoming packet.
+--						int offset: Where the list made by sourceList starts in the packet.
+--						quint32 address: The address of the peer that sent the packet.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Passes the load of the peer and every song it can relay to the stream manager. Peers that do not
+--					send a list are left alone.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::readSourceList(const QByteArray & data, int offset, quint32 address)
+{
+	if (data.size() < offset + 1 + 4)
+	{
+		return;
+	}
+
+	quint8 load = 0;
+	quint32 count = 0;
+	QDataStream(data.mid(offset, 5)) >> load >> count;
+	offset += 5;
+
+	mStreamManager.SetPeerLoad(address, load);
+
+	for (quint32 i = 0; i < count && data.size() >= offset + CACHE_KEY_SIZE; i++)
+	{
+		mStreamManager.AddRelay(data.mid(offset, CACHE_KEY_SIZE), address);
+		offset += CACHE_KEY_SIZE;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		announceSources
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		announceSources (const QList<QByteArray> & keys)
+--						const QList<QByteArray> & keys: The cache keys of the songs that can now be relayed.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Sends the load of this peer and the songs it can now relay to everyone in the session.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::announceSources(const QList<QByteArray> & keys)
+{
+	QByteArray packet = QByteArray(1, (char)Headers::AnnounceSource);
+	packet.append(mSessionKey);
+	packet.resize(1 + KEY_SIZE);
+	packet.append(sourceList(keys));
+
+	for (QTcpSocket * socket : mConnections)
+	{
+		socket->write(packet);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		announceSongs
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		announceSongs (bool reset, const QStringList & removed, const QVector<int> & added)
+--						bool reset: Whether the songs replace every song of this peer the others know about.
+--						const QStringList & removed: The paths of the songs that are no longer shared.
+--						const QVector<int> & added: Where the new songs are in the entries of the library index.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Sends the songs that were removed from and added to the song folder to everyone in the session,
+--					so the songs they see from this peer stay the same as the song folder without asking for the whole
+--					list again. Every added song has the same entry as in a song list.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::announceSongs(bool reset, const QStringList & removed, const QVector<int> & added)
+{
+	if (mConnections.isEmpty())
+	{
+		return;
+	}
+
+	const QVector<LibraryEntry> & entries = mLibrary.Entries();
+	int initSize = SONG_CHANGES_SIZE;
+
+	// Create packet
+	QByteArray packet = QByteArray(1, (char)Headers::SongsChanged);
+	packet.append(mSessionKey);
+	packet.resize(1 + KEY_SIZE);
+	packet << (quint8)reset << (quint32)removed.size();
+	packet.reserve(SONG_CHANGES_SIZE + 4 + removed.size() * SONGNAME_SIZE + added.size() * SONG_ENTRY_SIZE);
+
+	for (const QString & path : removed)
+	{
+		packet.append(path.toUtf8());
+		initSize += SONGNAME_SIZE;
+		packet.resize(initSize);
+	}
+
+	packet << (quint32)added.size();
+	initSize += 4;
+
+	for (int index : added)
+	{
+		const LibraryEntry & song = entries[index];
+
+		packet.append(song.path.toUtf8());
+		initSize += SONGNAME_SIZE;
+		packet.resize(initSize);
+		packet << (quint32)song.size << (quint32)(song.modified / 1000);
+		initSize += SONG_ENTRY_SIZE - SONGNAME_SIZE;
+	}
+
+	for (QTcpSocket * socket : mConnections)
+	{
+		socket->write(packet);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readSongChanges
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The songs are taken out of and added to the playlist with the list.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readSongChanges (const QByteArray & data, QTcpSocket * sender)
+--						const QByteArray & data: The incoming packet made by announceSongs.
+--						QTcpSocket * sender: The socket of the peer whose songs changed.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Removes the songs of the peer that are no longer shared from the remote song list, or all of them
+--					when the peer sent its whole list, and adds the new ones in the same way as displaySongName. The
+--					playlist follows the list. Songs that do not fit in the packet are left out.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::readSongChanges(const QByteArray & data, QTcpSocket * sender)
+{
+	if (data.size() < SONG_CHANGES_SIZE)
+	{
+		return;
+	}
+
+	quint8 reset = 0;
+	quint32 count = 0;
+	QDataStream(data.mid(1 + KEY_SIZE, 5)) >> reset >> count;
+	int offset = SONG_CHANGES_SIZE;
+
+	QString clientName = mIpToName[sender->peerAddress().toIPv4Address()];
+	if (!mOwnerToSong.contains(clientName))
+	{
+		mOwnerToSong.insert(clientName, new QList<QTreeWidgetItem*>());
+	}
+
+	QList<QTreeWidgetItem*>* songs = mOwnerToSong.value(clientName);
+	QSet<QString> gone;
+	QList<QTreeWidgetItem *> removed;
+	QList<QTreeWidgetItem *> added;
+
+	for (quint32 i = 0; i < count && data.size() >= offset + SONGNAME_SIZE; i++)
+	{
+		gone.insert(QString(data.mid(offset, SONGNAME_SIZE)));
+		offset += SONGNAME_SIZE;
+	}
+
+	// Delete the songs that are gone
+	for (int i = songs->size() - 1; i >= 0; i--)
+	{
+		if (reset || gone.contains(songs->at(i)->text(0)))
+		{
+			removed.append(songs->takeAt(i));
+		}
+	}
+
+	removeTracks(removed);
+	qDeleteAll(removed);
+
+	if (data.size() < offset + 4)
+	{
+		return;
+	}
+
+	QDataStream(data.mid(offset, 4)) >> count;
+	offset += 4;
+
+	for (quint32 i = 0; i < count && data.size() >= offset + SONG_ENTRY_SIZE; i++)
+	{
+		quint32 size = 0;
+		quint32 modified = 0;
+
+		QStringList songList;
+		songList << QString(data.mid(offset, SONGNAME_SIZE)) << clientName;
+		QDataStream(data.mid(offset + SONGNAME_SIZE, 8)) >> size >> modified;
+		offset += SONG_ENTRY_SIZE;
+
+		QTreeWidgetItem * item = new QTreeWidgetItem(ui.treeRemoteSongs, songList);
+		item->setData(0, Qt::UserRole, size);
+		item->setData(0, Qt::UserRole + 1, modified);
+		songs->append(item);
+		added.append(item);
+	}
+
+	addTracks(mPlaylist.Size(), added, true);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		sourceAvailableHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		sourceAvailableHandler (QByteArray key)
+--						QByteArray key: The cache key of the song.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a song starts arriving in the stream cache. Everyone in the
+--					session is told that they can stream it from here.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::sourceAvailableHandler(QByteArray key)
+{
+	announceSources(QList<QByteArray>() << key);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		loadChangedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		loadChangedHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when this peer starts or stops uploading a stream. Everyone in
+--					the session is told so that new listeners go to whoever is least busy.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::loadChangedHandler()
+{
+	announceSources(QList<QByteArray>());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		libraryChangedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		libraryChangedHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the library index of a song folder has been loaded. The
+--					local song list is shown again and everyone in the session is sent the new list of songs.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::libraryChangedHandler()
+{
+	populateLocalSongsList();
+
+	QVector<int> all(mLibrary.Entries().size());
+	for (int i = 0; i < all.size(); i++)
+	{
+		all[i] = i;
+	}
+
+	announceSongs(true, QStringList(), all);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		songsChangedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The playlist follows the local song list.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		songsChangedHandler (const QStringList & removed, const QVector<int> & added)
+--						const QStringList & removed: The paths of the songs that are no longer in the song folder.
+--						const QVector<int> & added: Where the new songs are in the entries of the library index, in
+--													order.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a scan of the library index found songs that were added,
+--					changed or removed. Only those items of the local song list are touched, so the rest keep their
+--					selection and the song being played is not lost. The list and the entries are both sorted by
+--					path, so once the removed items are gone every new item goes at the index of its entry. A change
+--					that big is cheaper to show by building the list again. Everyone in the session is sent the change.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::songsChangedHandler(const QStringList & removed, const QVector<int> & added)
+{
+	if (removed.size() + added.size() > LIBRARY_LIST_REBUILD_CHANGES)
+	{
+		populateLocalSongsList();
+		announceSongs(false, removed, added);
+		return;
+	}
+
+	QSet<QString> gone = QSet<QString>::fromList(removed);
+	QList<QTreeWidgetItem *> taken;
+
+	for (int i = items.size() - 1; i >= 0 && !gone.isEmpty(); i--)
+	{
+		if (gone.remove(items[i]->text(0)))
+		{
+			taken.append(items.takeAt(i));
+		}
+	}
+
+	removeTracks(taken);
+	qDeleteAll(taken);
+
+	const QVector<LibraryEntry> & entries = mLibrary.Entries();
+
+	for (int index : added)
+	{
+		QTreeWidgetItem * item = songItem(entries[index]);
+		items.insert(index, item);
+		ui.treeLocalSongs->insertTopLevelItem(index, item);
+		addTracks(index, QList<QTreeWidgetItem *>() << item, false);
+	}
+
+	announceSongs(false, removed, added);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		scanFinishedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		scanFinishedHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a scan of the library index finishes. The waveforms of
+--					the songs that do not have one yet are worked out in the background from then on.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::scanFinishedHandler()
+{
+	mPeakCache.Open(mLibrary.Entries());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		analysisFinishedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		analysisFinishedHandler (int songs, qint64 elapsed)
+--						int songs: How many songs the pass of the analysis measured.
+--						qint64 elapsed: How long the pass took in milliseconds.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a pass of the loudness analysis of the library index
+--					finishes. Shows how quickly songs are being measured in the status bar.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::analysisFinishedHandler(int songs, qint64 elapsed)
+{
+	statusBar()->showMessage(QString("Loudness analysis: %1 songs in %2 s (%3 songs/s)")
+		.arg(songs).arg(elapsed / 1000.0, 0, 'f', 1).arg(songs * 1000.0 / qMax<qint64>(1, elapsed), 0, 'f', 1));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		fetchPeaks
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Takes the track of the song instead of its item.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		fetchPeaks (const PlaylistTrack & track)
+--						const PlaylistTrack & track: A remote song in the playlist.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Asks the owner of the song for its waveform, unless it has been fetched before. The size and
+--					modification time of the song are passed along so a waveform is only used if the song has not
+--					changed.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::fetchPeaks(const PlaylistTrack & track)
+{
+	if (!mConnections.contains(track.owner))
+	{
+		return;
+	}
+
+	QTcpSocket * socket = mConnections[track.owner];
+	mPeakCache.Fetch(track.song, socket->peerAddress().toIPv4Address(), track.owner, track.size, track.modified);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		addTracks
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		addTracks (int index, const QList<QTreeWidgetItem *> & added, bool remote)
+--						int index: Where in the playlist the songs go.
+--						const QList<QTreeWidgetItem *> & added: The items of the songs, in order.
+--						bool remote: True for items of the remote songs list, false for the local one.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Adds the songs to the playlist and stores the id of its track with every item, so a song that is
+--					clicked is found in the playlist without searching it.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::addTracks(int index, const QList<QTreeWidgetItem *> & added, bool remote)
+{
+	QVector<PlaylistTrack> tracks(added.size());
+
+	for (int i = 0; i < added.size(); i++)
+	{
+		tracks[i].song = added[i]->text(0);
+		tracks[i].owner = remote ? added[i]->text(1) : QString();
+		tracks[i].size = added[i]->data(0, Qt::UserRole).toUInt();
+		tracks[i].modified = added[i]->data(0, Qt::UserRole + 1).toUInt();
+	}
+
+	quint32 first = mPlaylist.Insert(index, tracks);
+	for (int i = 0; i < added.size(); i++)
+	{
+		added[i]->setData(0, Qt::UserRole + 2, first + i);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		removeTracks
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		removeTracks (const QList<QTreeWidgetItem *> & removed)
+--						const QList<QTreeWidgetItem *> & removed: The items of the songs, which are still to be deleted.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Takes the songs out of the playlist in one pass.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::removeTracks(const QList<QTreeWidgetItem *> & removed)
+{
+	QSet<quint32> ids;
+
+	for (QTreeWidgetItem * item : removed)
+	{
+		ids.insert(item->data(0, Qt::UserRole + 2).toUInt());
+	}
+
+	mPlaylist.Remove(ids);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		songShownHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		songShownHandler (const QString & fileName)
+--						const QString & fileName: The local song that is now playing.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the media player starts showing a local song. The old
+--					waveform is taken off the seek bar and the waveform of the song is asked for, which arrives
+--					straight away if it has already been worked out.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::songShownHandler(const QString & fileName)
+{
+	mShownPeaks = fileName;
+	ui.sliderProgress->Clear();
+	mPeakCache.Request(fileName);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		streamShownHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The song is the current track of the playlist.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		streamShownHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the media player starts playing a stream, which is always
+--					the current track of the playlist. Its waveform was fetched when the song was picked or
+--					prefetched, so it is usually on disk by now.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::streamShownHandler()
+{
+	mShownPeaks.clear();
+	ui.sliderProgress->Clear();
+
+	const PlaylistTrack * track = mPlaylist.Track(mPlaylist.Current());
+	if (track == nullptr || !track->IsRemote())
+	{
+		return;
+	}
+
+	mShownPeaks = PeakCache::RemoteName(track->owner, track->song);
+	fetchPeaks(*track);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		peaksReadyHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		peaksReadyHandler (const QString & song, const PeakFile & peaks)
+--						const QString & song: The local path or RemoteName of the song.
+--						const PeakFile & peaks: The waveform of the song.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the waveform of a song is ready. Waveforms worked out in
+--					the background and for songs that are not playing yet are left on disk until they are shown.
+----------------------------------------------------------------------------------------------------------------------*/
+void CommAudio::peaksReadyHandler(const QString & song, const PeakFile & peaks)
+{
+	if (song == mShownPeaks)
+	{
+		ui.sliderProgress->SetPeaks(peaks);
+	}
+}
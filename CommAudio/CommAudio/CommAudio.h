@@ -1,112 +1,160 @@
-#pragma once
-
-#include <QAction>
-#include <QAudioFormat>
-#include <QAudioOutput>
-#include <QByteArray>
-#include <QCryptographicHash>
-#include <QDataStream>
-#include <QDir>
-#include <QFile>
-#include <QFileDialog>
-#include <QHostAddress>
-#include <QHostInfo>
-#include <QInputDialog>
-#include <QList>
-#include <QMap>
-#include <QMessageBox>
-#include <QNetworkInterface>
-#include <QPoint>
-#include <QPushButton>
-#include <QRegExp>
-#include <QSlider>
-#include <QString>
-#include <QStringList>
-#include <QTreeWidgetItem>
-#include <QTcpSocket>
-#include <QTcpServer>
-#include <QUrl>
-
-#include <QtWidgets/QMainWindow>
-#include "ui_CommAudio.h"
-
-#include "ConnectionManager.h"
-#include "globals.h"
-#include "MediaPlayer.h"
-#include "VoipModule.h"
-#include "DownloadManager.h"
-#include "StreamManager.h"
-
-class CommAudio : public QMainWindow
-{
-	Q_OBJECT
-
-public:
-	CommAudio(QWidget * parent = Q_NULLPTR);
-	~CommAudio();
-
-private:
-	// Variables
-	Ui::CommAudioClass ui;
-
-	bool mIsHost;
-	QString mName;
-	QByteArray mSessionKey;
-	QTreeWidgetItem *nd;
-
-	QDir mSongFolder;
-	QDir mDownloadFolder;
-	QList<QTreeWidgetItem *> items;
-
-	QMap<QString, QTcpSocket *> mConnections;
-	QMap<quint32, QString> mIpToName;
-	QMap<QString, QList<QTreeWidgetItem*>*> mOwnerToSong;
-
-	// Components
-	ConnectionManager mConnectionManager;
-	VoipModule mVoip;
-	MediaPlayer * mMediaPlayer;
-	DownloadManager mDownloadManager;
-	StreamManager mStreamManager;
-
-	// Functions
-	QString getAddressFromUser();
-
-	void populateLocalSongsList();
-
-	void parsePacketHost(QTcpSocket * sender, const QByteArray data);
-	void parsePacketClient(QTcpSocket * sender, const QByteArray data);
-
-	void connectToAllOtherClients(const QByteArray data);
-	void displayClientName(const QByteArray data, QTcpSocket * sender);
-	void displaySongName(const QByteArray data, QTcpSocket * sender);
-
-	void requestForSongs(QTcpSocket * host);
-	void sendSongList(QTcpSocket * sender);
-	void returnSongList(QTcpSocket * sender);
-
-private slots:
-	// Menu Bar 
-	void hostSessionHandler();
-	void joinSessionHandler();
-	void leaveSessionHandler();
-
-	void changeNameHandler();
-	void changeSongFolderHandler();
-	void changeDownloadFolderHandler();
-
-	// Song Lists
-	void localSongClickedHandler(QTreeWidgetItem * item, int column);
-	void remoteSongClickedHandler(QTreeWidgetItem * item, int column);
-	void remoteMenuHandler(const QPoint & pos);
-	void downloadSong();
-
-	// Networking
-	void newConnectionHandler(QString name, QTcpSocket * socket);
-	void incomingDataHandler();
-	void remoteDisconnectHandler();
-
-signals:
-	void connectVoip(QHostAddress address);
-
-};
+#pragma once
+
+#include <QAction>
+#include <QAudioFormat>
+#include <QAudioOutput>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QHostInfo>
+#include <QInputDialog>
+#include <QList>
+#include <QMap>
+#include <QMessageBox>
+#include <QNetworkInterface>
+#include <QPoint>
+#include <QPushButton>
+#include <QRegExp>
+#include <QSet>
+#include <QSlider>
+#include <QString>
+#include <QStringList>
+#include <QTreeWidgetItem>
+#include <QTcpSocket>
+#include <QTcpServer>
+#include <QUrl>
+#include <QVector>
+
+#include <QtWidgets/QMainWindow>
+#include "ui_CommAudio.h"
+
+#include "ConnectionManager.h"
+#include "globals.h"
+#include "MediaPlayer.h"
+#include "VoipModule.h"
+#include "DownloadManager.h"
+#include "LibraryIndex.h"
+#include "PeakCache.h"
+#include "Playlist.h"
+#include "StreamManager.h"
+
+class CommAudio : public QMainWindow
+{
+	Q_OBJECT
+
+public:
+	CommAudio(QWidget * parent = Q_NULLPTR);
+	~CommAudio();
+
+private:
+	// Variables
+	Ui::CommAudioClass ui;
+
+	bool mIsHost;
+	QString mName;
+	QByteArray mSessionKey;
+	QTreeWidgetItem *nd;
+
+	QDir mSongFolder;
+	QDir mDownloadFolder;
+	QList<QTreeWidgetItem *> items;
+
+	QMap<QString, QTcpSocket *> mConnections;
+	QMap<quint32, QString> mIpToName;
+	QMap<QString, QList<QTreeWidgetItem*>*> mOwnerToSong;
+
+	// Every local and remote song, local songs first in the order of the local song list, and the song a menu is for
+	Playlist mPlaylist;
+	quint32 mMenuTrack;
+
+	// The song whose waveform belongs in the seek bar
+	QString mShownPeaks;
+
+	// Components
+	ConnectionManager mConnectionManager;
+	VoipModule mVoip;
+	MediaPlayer * mMediaPlayer;
+	DownloadManager mDownloadManager;
+	StreamManager mStreamManager;
+	LibraryIndex mLibrary;
+	PeakCache mPeakCache;
+
+	// Functions
+	QString getAddressFromUser();
+
+	void populateLocalSongsList();
+	QTreeWidgetItem * songItem(const LibraryEntry & song);
+
+	void parsePacketHost(QTcpSocket * sender, const QByteArray data);
+	void parsePacketClient(QTcpSocket * sender, const QByteArray data);
+
+	void connectToAllOtherClients(const QByteArray data);
+	void displayClientName(const QByteArray data, QTcpSocket * sender);
+	void displaySongName(const QByteArray data, QTcpSocket * sender);
+
+	void requestForSongs(QTcpSocket * host);
+	void sendSongList(QTcpSocket * sender);
+	void returnSongList(QTcpSocket * sender);
+
+	QByteArray sourceList(const QList<QByteArray> & keys);
+	void readSourceList(const QByteArray & data, int offset, quint32 address);
+	void announceSources(const QList<QByteArray> & keys);
+	void announceSongs(bool reset, const QStringList & removed, const QVector<int> & added);
+	void readSongChanges(const QByteArray & data, QTcpSocket * sender);
+
+	void fetchPeaks(const PlaylistTrack & track);
+	void addTracks(int index, const QList<QTreeWidgetItem *> & added, bool remote);
+	void removeTracks(const QList<QTreeWidgetItem *> & removed);
+
+private slots:
+	// Menu Bar 
+	void hostSessionHandler();
+	void joinSessionHandler();
+	void leaveSessionHandler();
+
+	void changeNameHandler();
+	void changeSongFolderHandler();
+	void changeDownloadFolderHandler();
+
+	// Song Lists
+	void localSongClickedHandler(QTreeWidgetItem * item, int column);
+	void remoteSongClickedHandler(QTreeWidgetItem * item, int column);
+	void localMenuHandler(const QPoint & pos);
+	void remoteMenuHandler(const QPoint & pos);
+	void downloadSong();
+	void playNextHandler();
+	void shuffleHandler(bool shuffle);
+	void repeatHandler();
+	void equalizerHandler();
+	void libraryChangedHandler();
+	void songsChangedHandler(const QStringList & removed, const QVector<int> & added);
+	void scanFinishedHandler();
+	void analysisFinishedHandler(int songs, qint64 elapsed);
+
+	// Waveforms
+	void songShownHandler(const QString & fileName);
+	void streamShownHandler();
+	void peaksReadyHandler(const QString & song, const PeakFile & peaks);
+
+	// Networking
+	void newConnectionHandler(QString name, QTcpSocket * socket);
+	void incomingDataHandler();
+	void remoteDisconnectHandler();
+
+	// Streaming
+	void cacheStatsHandler();
+	void streamNeededHandler(quint32 track, bool prefetch);
+	void streamTierHandler(quint8 tier, double throughput);
+	void sourceAvailableHandler(QByteArray key);
+	void loadChangedHandler();
+
+signals:
+	void connectVoip(QHostAddress address);
+
+};
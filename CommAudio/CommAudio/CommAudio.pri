@@ -1,21 +1,79 @@
-# ----------------------------------------------------
-# This file is generated by the Qt Visual Studio Tools.
-# ------------------------------------------------------
-
-# This is a reminder that you are using a generated .pro file.
-# Remove it when you are finished editing this file.
-message("You are running qmake on a generated .pro file. This may not work!")
-
-
-HEADERS += ./globals.h \
-    ./CommAudio.h \
-    ./MediaPlayer.h \
-    ./ConnectionManager.h \
-    ./VoipModule.h
-SOURCES += ./CommAudio.cpp \
-    ./ConnectionManager.cpp \
-    ./main.cpp \
-    ./MediaPlayer.cpp \
-    ./VoipModule.cpp
-FORMS += ./CommAudio.ui
-RESOURCES += CommAudio.qrc
+# ----------------------------------------------------
+# This file is generated by the Qt Visual Studio Tools.
+# ------------------------------------------------------
+
+# This is a reminder that you are using a generated .pro file.
+# Remove it when you are finished editing this file.
+message("You are running qmake on a generated .pro file. This may not work!")
+
+
+HEADERS += ./globals.h \
+    ./CommAudio.h \
+    ./MediaPlayer.h \
+    ./ConnectionManager.h \
+    ./VoipModule.h \
+    ./AudioFormatConverter.h \
+    ./StreamCache.h \
+    ./PlaybackQueue.h \
+    ./PlaybackFeed.h \
+    ./AudioKernels.h \
+    ./ImaAdpcm.h \
+    ./TierCodec.h \
+    ./VoiceMixer.h \
+    ./VoiceCodec.h \
+    ./Benchmark.h \
+    ./VoiceActivityDetector.h \
+    ./RingBuffer.h \
+    ./AudioThread.h \
+    ./AudioBackend.h \
+    ./HeadlessAudio.h \
+    ./VoiceFec.h \
+    ./DriftEstimator.h \
+    ./VoiceBridge.h \
+    ./WavParser.h \
+    ./MappedSong.h \
+    ./LibraryIndex.h \
+    ./AudioDecoder.h \
+    ./FlacDecoder.h \
+    ./PeakFile.h \
+    ./PeakCache.h \
+    ./WaveformSlider.h \
+    ./LoudnessMeter.h \
+    ./Playlist.h \
+    ./DspGraph.h
+SOURCES += ./CommAudio.cpp \
+    ./ConnectionManager.cpp \
+    ./main.cpp \
+    ./MediaPlayer.cpp \
+    ./VoipModule.cpp \
+    ./AudioFormatConverter.cpp \
+    ./StreamCache.cpp \
+    ./PlaybackQueue.cpp \
+    ./PlaybackFeed.cpp \
+    ./AudioKernels.cpp \
+    ./ImaAdpcm.cpp \
+    ./TierCodec.cpp \
+    ./VoiceMixer.cpp \
+    ./VoiceCodec.cpp \
+    ./Benchmark.cpp \
+    ./VoiceActivityDetector.cpp \
+    ./RingBuffer.cpp \
+    ./AudioThread.cpp \
+    ./AudioBackend.cpp \
+    ./HeadlessAudio.cpp \
+    ./VoiceFec.cpp \
+    ./DriftEstimator.cpp \
+    ./VoiceBridge.cpp \
+    ./WavParser.cpp \
+    ./MappedSong.cpp \
+    ./LibraryIndex.cpp \
+    ./AudioDecoder.cpp \
+    ./FlacDecoder.cpp \
+    ./PeakFile.cpp \
+    ./PeakCache.cpp \
+    ./WaveformSlider.cpp \
+    ./LoudnessMeter.cpp \
+    ./Playlist.cpp \
+    ./DspGraph.cpp
+FORMS += ./CommAudio.ui
+RESOURCES += CommAudio.qrc
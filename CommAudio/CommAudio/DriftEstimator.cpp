@@ -0,0 +1,186 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		DriftEstimator.cpp - Tracks how far the clock of a peer is off from the output clock.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					DriftEstimator()
+--					void Restart(double queued)
+--					double Update(double queued, double target, double seconds)
+--					double Ratio() const
+--					int Drift() const
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					A peer captures at its own sample rate and we play at ours. They are never quite equal, so over a
+--					long call the jitter queue of the peer slowly fills up, adding delay until frames are dropped, or
+--					slowly empties until it runs dry. A difference of 100 parts per million is 0.36 seconds an hour.
+--
+--					The drift cannot be measured straight from the arrival times, since the network moves them around
+--					by far more than the drift. It shows up in how full the queue is though. When the queue starts
+--					playing its length is averaged over VOIP_DRIFT_SMOOTHING_MS to find where it sits, which depends on
+--					how the arrivals line up with the reads. From then on the length is smoothed over the same time,
+--					which evens out the bursts of the network and the frames being taken out in blocks, and how far it
+--					has moved from where it sat, as a share of the target, is the error. The drift estimate is the
+--					running total of the error and the rate the queue is read at is the drift plus a share of it:
+--
+--						ratio = 1 + drift + VOIP_DRIFT_GAIN * error
+--
+--					Once the queue holds still the error is zero and the estimate is the real drift. The gains settle
+--					in a few minutes without overshooting, slow enough not to chase the arrivals slipping past the
+--					reads, and both the estimate and the ratio are kept within VOIP_DRIFT_MAX_PPM. A sentence too
+--					short to settle in leaves the estimate as it was, which is fine since the queue is filled to the
+--					target again at the start of every sentence anyway.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "DriftEstimator.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DriftEstimator
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DriftEstimator ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The clocks are taken to agree until the queue says otherwise.
+----------------------------------------------------------------------------------------------------------------------*/
+DriftEstimator::DriftEstimator()
+	: mLevel(0)
+	, mReference(0)
+	, mElapsed(0)
+	, mDrift(0)
+	, mRatio(1)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Restart
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Restart (double queued)
+--						double queued: How many frames are queued as the peer starts playing again.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Called whenever a queue that ran dry has filled up again, which happens at the start of every
+--					sentence since peers stop sending while they are silent. The smoothed length starts over from the
+--					queue as it is and the queue is held wherever it settles, but the drift estimate is kept since the
+--					clocks have not changed.
+----------------------------------------------------------------------------------------------------------------------*/
+void DriftEstimator::Restart(double queued)
+{
+	mLevel = queued;
+	mReference = queued;
+	mElapsed = 0;
+	mRatio = 1 + mDrift;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Update
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Update (double queued, double target, double seconds)
+--						double queued: How many frames are queued now.
+--						double target: How many frames the queue was filled to, which the error is measured against.
+--						double seconds: How much audio has been played since the last update.
+--
+-- RETURNS:			How many frames of the queue to play for every frame of output.
+----------------------------------------------------------------------------------------------------------------------*/
+double DriftEstimator::Update(double queued, double target, double seconds)
+{
+	const double limit = VOIP_DRIFT_MAX_PPM / 1e6;
+	const double settle = VOIP_DRIFT_SMOOTHING_MS / 1000.0;
+
+	mElapsed += seconds;
+
+	// Take the plain average until the queue has played for long enough to know where it sits
+	if (mElapsed - seconds < settle)
+	{
+		mLevel += (queued - mLevel) * seconds / mElapsed;
+
+		if (mElapsed >= settle)
+		{
+			mReference = mLevel;
+		}
+
+		return mRatio;
+	}
+
+	mLevel += (queued - mLevel) * qMin(1.0, seconds / settle);
+
+	double error = (mLevel - mReference) / target;
+	mDrift = qBound(-limit, mDrift + VOIP_DRIFT_TRACKING / 1e6 * error * seconds, limit);
+	mRatio = 1 + qBound(-limit, mDrift + VOIP_DRIFT_GAIN / 1e6 * error, limit);
+
+	return mRatio;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Ratio
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Ratio ()
+--
+-- RETURNS:			The rate the queue was last played at, 1.0 being the rate of the output.
+----------------------------------------------------------------------------------------------------------------------*/
+double DriftEstimator::Ratio() const
+{
+	return mRatio;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Drift
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Drift ()
+--
+-- RETURNS:			How much faster the clock of the peer runs than the output clock, in parts per million.
+----------------------------------------------------------------------------------------------------------------------*/
+int DriftEstimator::Drift() const
+{
+	return qRound(mDrift * 1e6);
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include "globals.h"
+
+class DriftEstimator
+{
+public:
+	DriftEstimator();
+
+	void Restart(double queued);
+	double Update(double queued, double target, double seconds);
+	double Ratio() const;
+	int Drift() const;
+
+private:
+	double mLevel;
+	double mReference;
+	double mElapsed;
+	double mDrift;
+	double mRatio;
+};
\ No newline at end of file
@@ -0,0 +1,804 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		DspGraph.cpp - The nodes of the float chain that songs are played through.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					DspNode(int channels)
+--					int DspNode::Channels() const
+--					DspSource(QIODevice * device, const QAudioFormat & format)
+--					int DspSource::Pull(float * out, int frames)
+--					DspGain(DspNode * input, float gain = 1.0f)
+--					int DspGain::Pull(float * out, int frames)
+--					void DspGain::SetGain(float gain)
+--					DspCrossfade(int channels)
+--					int DspCrossfade::Pull(float * out, int frames)
+--					void DspCrossfade::Start(DspNode * from, DspNode * to, int frames)
+--					void DspCrossfade::Drop(DspNode * node)
+--					void DspCrossfade::Stop()
+--					bool DspCrossfade::IsFading() const
+--					DspNode * DspCrossfade::From() const
+--					int DspCrossfade::Faded() const
+--					DspEqualizer(DspNode * input, int channels, int sampleRate)
+--					int DspEqualizer::Pull(float * out, int frames)
+--					void DspEqualizer::SetGains(const QVector<float> & gains)
+--					bool DspEqualizer::IsFlat() const
+--					static void DspEqualizer::peaking(double frequency, double gain, int sampleRate, float * coefs)
+--					DspOutput(DspNode * input, const QAudioFormat & format)
+--					qint64 DspOutput::Read(char * data, qint64 maxSize)
+--					void DspOutput::Clear()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Between a song and the output there are a few steps that each change the audio a little: the gain
+--					that evens out loudness, the fade from one song into the next and the equalizer. Each step is a
+--					node that is pulled from by the node after it, the same way the output pulls from the
+--					PlaybackQueue, so a node only does work when the output needs audio and never holds more than one
+--					pull of it. A song comes in through a DspSource, which turns the bytes of the output format into
+--					float, and goes out through a DspOutput, which turns it back. In between everything is float, so
+--					the audio is only rounded once however many steps it goes through.
+--
+--					A node works on at most DSP_BLOCK_FRAMES frames a pull. The heavy lifting of every node is done
+--					by a kernel in AudioKernels, which uses SSE2 when it is there.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "DspGraph.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DspNode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DspNode (int channels)
+--						int channels: The number of channels in every frame the node hands out.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+DspNode::DspNode(int channels)
+	: mChannels(channels)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Channels
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Channels ()
+--
+-- RETURNS:			The number of channels in every frame the node hands out.
+----------------------------------------------------------------------------------------------------------------------*/
+int DspNode::Channels() const
+{
+	return mChannels;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DspSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DspSource (QIODevice * device, const QAudioFormat & format)
+--						QIODevice * device: The device to read from, which the node does not own.
+--						const QAudioFormat & format: The format of the audio in the device.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+DspSource::DspSource(QIODevice * device, const QAudioFormat & format)
+	: DspNode(format.channelCount())
+	, mDevice(device)
+	, mFormat(format)
+	, mFrameBytes(format.bytesPerFrame())
+	, mPartial(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Pull
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Pull (float * out, int frames)
+--						float * out: Where the frames are written.
+--						int frames: The most frames to hand out.
+--
+-- RETURNS:			The number of frames written, which is fewer than asked for when the device has run out.
+--
+-- NOTES:
+--					Reads as many bytes as the frames take up and converts the whole frames among them with
+--					AudioKernels::ToFloat. A device like a stream can stop part way through a frame, so the start of
+--					that frame is kept and finished by the next pull.
+----------------------------------------------------------------------------------------------------------------------*/
+int DspSource::Pull(float * out, int frames)
+{
+	if (mFrameBytes <= 0 || frames <= 0)
+	{
+		return 0;
+	}
+
+	int wanted = frames * mFrameBytes;
+	if (mBytes.size() < wanted)
+	{
+		mBytes.resize(wanted);
+	}
+
+	qint64 read = mDevice->read(mBytes.data() + mPartial, wanted - mPartial);
+	int total = mPartial + (int)qMax<qint64>(0, read);
+	int whole = total / mFrameBytes;
+
+	AudioKernels::ToFloat(mBytes.constData(), whole * mChannels, mFormat, out);
+
+	mPartial = total - whole * mFrameBytes;
+	memmove(mBytes.data(), mBytes.constData() + whole * mFrameBytes, mPartial);
+
+	return whole;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DspGain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DspGain (DspNode * input, float gain)
+--						DspNode * input: The node to pull from, which this node does not own.
+--						float gain: The gain to start with, one to leave the audio as it is.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+DspGain::DspGain(DspNode * input, float gain)
+	: DspNode(input->Channels())
+	, mInput(input)
+	, mGain(gain)
+	, mTarget(gain)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Pull
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Pull (float * out, int frames)
+--						float * out: Where the frames are written.
+--						int frames: The most frames to hand out.
+--
+-- RETURNS:			The number of frames written.
+--
+-- NOTES:
+--					Pulls from the input and scales what comes back with AudioKernels::Ramp. When the gain has been
+--					changed it ramps from the old gain to the new one over this pull. At a gain of one the frames are
+--					passed on untouched.
+----------------------------------------------------------------------------------------------------------------------*/
+int DspGain::Pull(float * out, int frames)
+{
+	int pulled = mInput->Pull(out, frames);
+	if (pulled <= 0)
+	{
+		return pulled;
+	}
+
+	if (mGain != 1.0f || mTarget != 1.0f)
+	{
+		AudioKernels::Ramp(out, pulled, mChannels, mGain, mTarget);
+	}
+	mGain = mTarget;
+
+	return pulled;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetGain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetGain (float gain)
+--						float gain: The new gain, one to leave the audio as it is.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The gain is reached by the end of the next pull.
+----------------------------------------------------------------------------------------------------------------------*/
+void DspGain::SetGain(float gain)
+{
+	mTarget = gain;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DspCrossfade
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DspCrossfade (int channels)
+--						int channels: The number of channels of the nodes that are faded.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The fade starts out stopped.
+----------------------------------------------------------------------------------------------------------------------*/
+DspCrossfade::DspCrossfade(int channels)
+	: DspNode(channels)
+	, mFrom(nullptr)
+	, mTo(nullptr)
+	, mPosition(1)
+	, mStep(0)
+	, mFaded(0)
+	, mBuffer(DSP_BLOCK_FRAMES * channels)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Pull
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Pull (float * out, int frames)
+--						float * out: Where the frames are written.
+--						int frames: The most frames to hand out.
+--
+-- RETURNS:			The number of frames written.
+--
+-- NOTES:
+--					Pulls the same number of frames from both nodes and mixes them with AudioKernels::Crossfade. A
+--					pull never goes past the end of the fade, so the caller can tell the fade is over before it pulls
+--					again. A node is pulled again after a short pull, and only when it has nothing more to give, like
+--					a stream that is still arriving, is it made up with silence so the fade keeps time with the node
+--					that is playing. Once the fade is over the node faded into is pulled from as it is.
+----------------------------------------------------------------------------------------------------------------------*/
+int DspCrossfade::Pull(float * out, int frames)
+{
+	if (!IsFading())
+	{
+		return mTo != nullptr ? mTo->Pull(out, frames) : 0;
+	}
+
+	int left = qMax(1, (int)std::ceil((1.0 - mPosition) / mStep));
+	int count = qMin(frames, left);
+	if (mBuffer.size() < count * mChannels)
+	{
+		mBuffer.resize(count * mChannels);
+	}
+
+	int rising = 0;
+	int falling = 0;
+	int pulled = 0;
+
+	while (rising < count)
+	{
+		pulled = mTo->Pull(mBuffer.data() + rising * mChannels, count - rising);
+		if (pulled <= 0)
+		{
+			break;
+		}
+		rising += pulled;
+	}
+
+	while (mFrom != nullptr && falling < count)
+	{
+		pulled = mFrom->Pull(out + falling * mChannels, count - falling);
+		if (pulled <= 0)
+		{
+			break;
+		}
+		falling += pulled;
+	}
+
+	pulled = qMax(rising, falling);
+
+	memset(mBuffer.data() + rising * mChannels, 0, (pulled - rising) * mChannels * sizeof(float));
+	memset(out + falling * mChannels, 0, (pulled - falling) * mChannels * sizeof(float));
+
+	AudioKernels::Crossfade(out, mBuffer.constData(), out, pulled, mChannels, (float)mPosition, (float)mStep);
+
+	mPosition += pulled * mStep;
+	mFaded += rising;
+
+	return pulled;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Start
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Start (DspNode * from, DspNode * to, int frames)
+--						DspNode * from: The node to fade out, which this node does not own.
+--						DspNode * to: The node to fade in, which this node does not own.
+--						int frames: How many frames the fade lasts.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Starts a new fade, replacing one that was still going.
+----------------------------------------------------------------------------------------------------------------------*/
+void DspCrossfade::Start(DspNode * from, DspNode * to, int frames)
+{
+	mFrom = from;
+	mTo = to;
+	mPosition = 0;
+	mStep = 1.0 / qMax(1, frames);
+	mFaded = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Drop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Drop (DspNode * node)
+--						DspNode * node: A node that is about to be deleted.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Lets go of a node before it is deleted. Letting go of the node fading out leaves the rest of the
+--					fade as a fade in of the other node, so a song that ends a little before its fade does not make
+--					the next song jump in loudness. Letting go of the node fading in stops the fade.
+----------------------------------------------------------------------------------------------------------------------*/
+void DspCrossfade::Drop(DspNode * node)
+{
+	if (node == nullptr)
+	{
+		return;
+	}
+
+	if (node == mFrom)
+	{
+		mFrom = nullptr;
+	}
+
+	if (node == mTo)
+	{
+		Stop();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Stop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Stop ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Ends the fade and lets go of both nodes.
+----------------------------------------------------------------------------------------------------------------------*/
+void DspCrossfade::Stop()
+{
+	mFrom = nullptr;
+	mTo = nullptr;
+	mPosition = 1;
+	mFaded = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsFading
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsFading ()
+--
+-- RETURNS:			True while there is a fade that has not reached its end.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DspCrossfade::IsFading() const
+{
+	return mTo != nullptr && mPosition < 1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		From
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		From ()
+--
+-- RETURNS:			The node fading out, or null once it has been let go.
+----------------------------------------------------------------------------------------------------------------------*/
+DspNode * DspCrossfade::From() const
+{
+	return mFrom;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Faded
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Faded ()
+--
+-- RETURNS:			How many frames have been pulled from the node fading in since the fade started.
+----------------------------------------------------------------------------------------------------------------------*/
+int DspCrossfade::Faded() const
+{
+	return mFaded;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DspEqualizer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Makes room for every band up front.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DspEqualizer (DspNode * input, int channels, int sampleRate)
+--						DspNode * input: The node to pull from, which this node does not own.
+--						int channels: The number of channels of the input.
+--						int sampleRate: The sample rate of the input.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The equalizer starts out flat, with room for the filters and delays of every band so that setting
+--					the gains never allocates. The channels are passed in instead of being asked of the input, so the
+--					input can be a node that is still being built.
+----------------------------------------------------------------------------------------------------------------------*/
+DspEqualizer::DspEqualizer(DspNode * input, int channels, int sampleRate)
+	: DspNode(channels)
+	, mInput(input)
+	, mSampleRate(sampleRate)
+	, mCoefs(EQUALIZER_BANDS * 5)
+	, mState(EQUALIZER_BANDS * channels * 2, 0.0f)
+	, mSections(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Pull
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Pull (float * out, int frames)
+--						float * out: Where the frames are written.
+--						int frames: The most frames to hand out.
+--
+-- RETURNS:			The number of frames written.
+--
+-- NOTES:
+--					Pulls from the input and runs what comes back through the bands with AudioKernels::Biquads.
+----------------------------------------------------------------------------------------------------------------------*/
+int DspEqualizer::Pull(float * out, int frames)
+{
+	int pulled = mInput->Pull(out, frames);
+
+	if (pulled > 0 && mSections > 0)
+	{
+		AudioKernels::Biquads(out, pulled, mChannels, mCoefs.constData(), mSections, mState.data());
+	}
+
+	return pulled;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetGains
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Works the filters out in place instead of building a new vector.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetGains (const QVector<float> & gains)
+--						const QVector<float> & gains: The gain in dB of each band, missing bands are left flat.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Works out the filter of every band that is not flat. Bands too close to half the sample rate to
+--					be filtered are left out. The delays are kept when the number of filters stays the same, so moving
+--					a band while a song plays does not click. The filters are written over the old ones in place, so
+--					this can be called on the audio thread.
+----------------------------------------------------------------------------------------------------------------------*/
+void DspEqualizer::SetGains(const QVector<float> & gains)
+{
+	const double frequencies[] = EQUALIZER_FREQUENCIES;
+	int sections = 0;
+
+	for (int i = 0; i < EQUALIZER_BANDS && i < gains.size(); i++)
+	{
+		if (std::fabs(gains[i]) < 0.01f || frequencies[i] >= mSampleRate * 0.45)
+		{
+			continue;
+		}
+
+		peaking(frequencies[i], gains[i], mSampleRate, mCoefs.data() + sections * 5);
+		sections++;
+	}
+
+	if (sections != mSections)
+	{
+		mState.fill(0.0f);
+	}
+
+	mSections = sections;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsFlat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsFlat ()
+--
+-- RETURNS:			True if every band is flat, so the equalizer leaves the audio as it is.
+----------------------------------------------------------------------------------------------------------------------*/
+bool DspEqualizer::IsFlat() const
+{
+	return mSections == 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		peaking
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		peaking (double frequency, double gain, int sampleRate, float * coefs)
+--						double frequency: The centre of the band in Hz.
+--						double gain: How much the band is turned up in dB, negative to turn it down.
+--						int sampleRate: The sample rate the filter runs at.
+--						float * coefs: Where b0, b1, b2, a1 and a2 are written.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Works out a peaking filter from the Audio EQ Cookbook by Robert Bristow-Johnson, with the width of
+--					the band set by EQUALIZER_Q. The coefficients are worked out in double precision and divided
+--					through by a0.
+----------------------------------------------------------------------------------------------------------------------*/
+void DspEqualizer::peaking(double frequency, double gain, int sampleRate, float * coefs)
+{
+	const double pi = 3.14159265358979323846;
+
+	double a = pow(10.0, gain / 40.0);
+	double w0 = 2 * pi * frequency / sampleRate;
+	double alpha = sin(w0) / (2 * EQUALIZER_Q);
+	double a0 = 1 + alpha / a;
+
+	coefs[0] = (float)((1 + alpha * a) / a0);
+	coefs[1] = (float)(-2 * cos(w0) / a0);
+	coefs[2] = (float)((1 - alpha * a) / a0);
+	coefs[3] = (float)(-2 * cos(w0) / a0);
+	coefs[4] = (float)((1 - alpha / a) / a0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DspOutput
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DspOutput (DspNode * input, const QAudioFormat & format)
+--						DspNode * input: The last node of the chain, which the output does not own.
+--						const QAudioFormat & format: The format of the audio output.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+DspOutput::DspOutput(DspNode * input, const QAudioFormat & format)
+	: mInput(input)
+	, mFormat(format)
+	, mFrameBytes(format.bytesPerFrame())
+	, mBlock(DSP_BLOCK_FRAMES * format.channelCount())
+	, mPendingStart(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Read
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Read (char * data, qint64 maxSize)
+--						char * data: The buffer to fill with audio in the format of the output.
+--						qint64 maxSize: The size of the buffer.
+--
+-- RETURNS:			The number of bytes written into data.
+--
+-- NOTES:
+--					Pulls from the chain a block at a time and converts the frames straight into the buffer with
+--					AudioKernels::FromFloat. When the buffer ends part way through a frame, the whole frame is
+--					converted aside and the rest of it starts the next read. A pull that comes back short means the
+--					chain has run out for now, so the read stops there.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 DspOutput::Read(char * data, qint64 maxSize)
+{
+	int channels = mFormat.channelCount();
+	qint64 total = 0;
+
+	if (mPendingStart < mPending.size())
+	{
+		int count = (int)qMin<qint64>(maxSize, mPending.size() - mPendingStart);
+		memcpy(data, mPending.constData() + mPendingStart, count);
+
+		mPendingStart += count;
+		total += count;
+	}
+
+	while (total < maxSize && mFrameBytes > 0)
+	{
+		int frames = (int)qMin<qint64>((maxSize - total + mFrameBytes - 1) / mFrameBytes, DSP_BLOCK_FRAMES);
+		int pulled = mInput->Pull(mBlock.data(), frames);
+		if (pulled <= 0)
+		{
+			break;
+		}
+
+		int whole = (int)qMin<qint64>(pulled, (maxSize - total) / mFrameBytes);
+		AudioKernels::FromFloat(mBlock.constData(), whole * channels, mFormat, data + total);
+		total += whole * mFrameBytes;
+
+		if (whole < pulled)
+		{
+			mPending.resize((pulled - whole) * mFrameBytes);
+			AudioKernels::FromFloat(mBlock.constData() + whole * channels, (pulled - whole) * channels, mFormat,
+				mPending.data());
+
+			mPendingStart = (int)(maxSize - total);
+			memcpy(data + total, mPending.constData(), mPendingStart);
+			total = maxSize;
+		}
+
+		if (pulled < frames)
+		{
+			break;
+		}
+	}
+
+	return total;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Clear
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Clear ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Throws away the rest of a frame that was partly handed out, for when what is playing is replaced.
+----------------------------------------------------------------------------------------------------------------------*/
+void DspOutput::Clear()
+{
+	mPending.clear();
+	mPendingStart = 0;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QIODevice>
+#include <QVector>
+
+#include <cmath>
+#include <cstring>
+
+#include "AudioKernels.h"
+#include "globals.h"
+
+// A step of the chain that songs are played through. Every node hands out interleaved float frames in the channel
+// count of the output, pulling what it needs from the node before it
+class DspNode
+{
+public:
+	DspNode(int channels);
+	virtual ~DspNode() = default;
+
+	virtual int Pull(float * out, int frames) = 0;
+	int Channels() const;
+
+protected:
+	int mChannels;
+};
+
+// Reads a device that is already in the format of the output and turns what it reads into float frames
+class DspSource : public DspNode
+{
+public:
+	DspSource(QIODevice * device, const QAudioFormat & format);
+
+	int Pull(float * out, int frames) override;
+
+private:
+	QIODevice * mDevice;
+	QAudioFormat mFormat;
+	int mFrameBytes;
+
+	// What was read, with the start of a frame the device had not finished yet kept at the front
+	QByteArray mBytes;
+	int mPartial;
+};
+
+// Scales what it pulls by a gain, moving to a new gain over one pull so the change does not click
+class DspGain : public DspNode
+{
+public:
+	DspGain(DspNode * input, float gain = 1.0f);
+
+	int Pull(float * out, int frames) override;
+	void SetGain(float gain);
+
+private:
+	DspNode * mInput;
+	float mGain;
+	float mTarget;
+};
+
+// Fades from one node into another. The node fading out can be let go part way through, and the rest of the fade is
+// then only the node fading in
+class DspCrossfade : public DspNode
+{
+public:
+	DspCrossfade(int channels);
+
+	int Pull(float * out, int frames) override;
+	void Start(DspNode * from, DspNode * to, int frames);
+	void Drop(DspNode * node);
+	void Stop();
+
+	bool IsFading() const;
+	DspNode * From() const;
+	int Faded() const;
+
+private:
+	DspNode * mFrom;
+	DspNode * mTo;
+	double mPosition;
+	double mStep;
+	int mFaded;
+	QVector<float> mBuffer;
+};
+
+// A bank of peaking filters an octave apart at EQUALIZER_FREQUENCIES. Bands that are left flat cost nothing
+class DspEqualizer : public DspNode
+{
+public:
+	DspEqualizer(DspNode * input, int channels, int sampleRate);
+
+	int Pull(float * out, int frames) override;
+	void SetGains(const QVector<float> & gains);
+	bool IsFlat() const;
+
+private:
+	DspNode * mInput;
+	int mSampleRate;
+
+	// b0, b1, b2, a1 and a2 of every band that is not flat, and the delays of those bands for every channel
+	QVector<float> mCoefs;
+	QVector<float> mState;
+	int mSections;
+
+	static void peaking(double frequency, double gain, int sampleRate, float * coefs);
+};
+
+// The end of the chain, which turns float frames back into the format of the output and can hand out any number of
+// bytes even though the nodes only work in whole frames
+class DspOutput
+{
+public:
+	DspOutput(DspNode * input, const QAudioFormat & format);
+
+	qint64 Read(char * data, qint64 maxSize);
+	void Clear();
+
+private:
+	DspNode * mInput;
+	QAudioFormat mFormat;
+	int mFrameBytes;
+	QVector<float> mBlock;
+
+	// The rest of a frame that was only partly handed out
+	QByteArray mPending;
+	int mPendingStart;
+};
@@ -0,0 +1,1551 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		FlacDecoder.cpp - Decodes FLAC files that are held in memory.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					FlacDecoder()
+--					bool Open(const uchar * data, qint64 size)
+--					int Decode(char * out, int frames)
+--					bool Seek(qint64 frame)
+--					QAudioFormat Format() const
+--					qint64 Frames() const
+--					bool Truncated() const
+--					QString ErrorString() const
+--					static qint64 StreamStart(const uchar * data, qint64 size)
+--					static quint8 Crc8(const uchar * data, qint64 size)
+--					static quint16 Crc16(const uchar * data, qint64 size)
+--					bool parseStreamInfo(const uchar * block, quint32 size)
+--					void parseSeekTable(const uchar * block, quint32 size)
+--					bool checkTail()
+--					qint64 audioEnd() const
+--					bool readFrameHeader(qint64 offset, FrameHeader * header) const
+--					bool findFrame(qint64 offset, qint64 limit, FrameHeader * header) const
+--					bool nextBlock()
+--					bool decodeFrame(const FrameHeader & header)
+--					bool decodeSubframe(BitReader & reader, qint32 * out, int count, int bits)
+--					bool decodeResidual(BitReader & reader, qint32 * out, int count, int order)
+--					void restoreFixed(qint32 * out, int count, int order)
+--					void decorrelate(int assignment, int count)
+--					static void refill(BitReader & reader)
+--					static quint32 readBits(BitReader & reader, int bits)
+--					static qint32 readSigned(BitReader & reader, int bits)
+--					static quint32 readUnary(BitReader & reader)
+--					bool fail(const QString & error)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					A FLAC file is "fLaC", some metadata blocks and then frames. The STREAMINFO block gives the sample
+--					rate, channels, bits per sample and length of the song, and a SEEKTABLE block, when there is one,
+--					says where some of the frames are. Each frame starts with a sync code and a header that has its
+--					own CRC-8, then holds one subframe per channel and ends with a CRC-16 of the whole frame.
+--
+--					A subframe is a constant, the samples as they are, or a fixed or LPC predictor with its warm up
+--					samples followed by the residual of the prediction, which is Rice coded. The residual is read from
+--					a 64 bit cache of the next bits, so a run of zeros is counted with a single count leading zeros.
+--					The prediction is put back by AudioKernels::RestoreLpc, eight products at a time for audio of up
+--					to 16 bits. Stereo may be coded as left and side, side and right or mid and side, which is undone
+--					once both subframes are decoded, and the channels are then interleaved by AudioKernels.
+--
+--					A frame whose CRC does not match, or that can not be decoded, is played as silence for as long as
+--					its header says it lasts, and decoding carries on from the next sync code. A seek starts from the
+--					nearest point in the seek table and halves the part of the file the frame can be in until it is
+--					FLAC_SEEK_SPAN bytes. Frames that end before the wanted frame are then skipped without decoding
+--					them. Any ID3v2 tag before the stream, and ID3v1 or APE tags after it, are stepped over.
+--
+--					Output is signed 16, 24 or 32 bit, whichever is the smallest that holds the samples, with the
+--					samples of 12 or 20 bit songs moved up to the top bits.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "FlacDecoder.h"
+
+// The CRCs of a frame: CRC-8 with the polynomial 0x07 over the header and CRC-16 with 0x8005 over everything
+struct FlacCrcTables
+{
+	quint8 crc8[256];
+	quint16 crc16[256];
+
+	FlacCrcTables();
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FlacCrcTables
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FlacCrcTables ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Works out the CRC of every byte, so a CRC is then one lookup per byte.
+----------------------------------------------------------------------------------------------------------------------*/
+FlacCrcTables::FlacCrcTables()
+{
+	for (int i = 0; i < 256; i++)
+	{
+		quint8 crc8 = (quint8)i;
+		quint16 crc16 = (quint16)(i << 8);
+
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc8 = (quint8)((crc8 & 0x80) ? (crc8 << 1) ^ 0x07 : crc8 << 1);
+			crc16 = (quint16)((crc16 & 0x8000) ? (crc16 << 1) ^ 0x8005 : crc16 << 1);
+		}
+
+		this->crc8[i] = crc8;
+		this->crc16[i] = crc16;
+	}
+}
+
+static const FlacCrcTables flacCrcTables;
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FlacDecoder
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FlacDecoder ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The decoder is not valid until a file has been opened.
+----------------------------------------------------------------------------------------------------------------------*/
+FlacDecoder::FlacDecoder()
+	: mData(nullptr)
+	, mSize(0)
+	, mFirstFrame(0)
+	, mBits(0)
+	, mShift(0)
+	, mMinBlock(0)
+	, mMaxBlock(0)
+	, mMaxFrame(0)
+	, mFrames(0)
+	, mBlockFrames(0)
+	, mBlockUsed(0)
+	, mPosition(0)
+	, mSample(0)
+	, mTruncated(false)
+	, mValid(false)
+	, mError("No file has been opened")
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Open (const uchar * data, qint64 size)
+--						const uchar * data: The whole file, which has to stay where it is while it is decoded.
+--						qint64 size: The size of the file.
+--
+-- RETURNS:			True if the file is a FLAC file that can be played, otherwise false.
+--
+-- NOTES:
+--					Reads the metadata and looks at the end of the file to see whether all of it is there. No audio
+--					is decoded, so this is cheap enough to do for every song in the library.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::Open(const uchar * data, qint64 size)
+{
+	*this = FlacDecoder();
+	mData = data;
+	mSize = size;
+
+	qint64 start = StreamStart(data, size);
+	if (start < 0)
+	{
+		return fail("Not a FLAC file");
+	}
+
+	qint64 position = start + 4;
+	bool hasInfo = false;
+	bool last = false;
+
+	while (!last)
+	{
+		if (position + 4 > size)
+		{
+			return fail("The metadata runs past the end of the file");
+		}
+
+		const uchar * block = data + position;
+		quint32 length = (block[1] << 16) | (block[2] << 8) | block[3];
+		int type = block[0] & 0x7F;
+		last = (block[0] & 0x80) != 0;
+		position += 4;
+
+		if (position + length > size)
+		{
+			return fail("The metadata runs past the end of the file");
+		}
+
+		if (type == 0)
+		{
+			if (!parseStreamInfo(data + position, length))
+			{
+				return false;
+			}
+			hasInfo = true;
+		}
+		else if (type == 3)
+		{
+			parseSeekTable(data + position, length);
+		}
+		else if (type == 127)
+		{
+			return fail("The metadata has a block of an invalid type");
+		}
+
+		position += length;
+	}
+
+	if (!hasInfo)
+	{
+		return fail("No STREAMINFO block");
+	}
+
+	mFirstFrame = position;
+	mPosition = mFirstFrame;
+	mBlock.fill(0, mMaxBlock * mFormat.channelCount());
+	mHistory.fill(0, mMaxBlock + 32);
+
+	mTruncated = !checkTail();
+	mValid = true;
+	mError.clear();
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Decode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Decode (char * out, int frames)
+--						char * out: Where the frames are written, in the format of the decoder.
+--						int frames: The most frames to write.
+--
+-- RETURNS:			The number of frames written, 0 at the end of the song.
+--
+-- NOTES:
+--					Hands out what is left of the frame that was decoded last and decodes more frames as they are
+--					needed.
+----------------------------------------------------------------------------------------------------------------------*/
+int FlacDecoder::Decode(char * out, int frames)
+{
+	if (!mValid)
+	{
+		return 0;
+	}
+
+	const int channels = mFormat.channelCount();
+	const int frameBytes = mFormat.bytesPerFrame();
+	const qint32 * planes[8];
+	int done = 0;
+
+	while (done < frames)
+	{
+		if (mBlockUsed == mBlockFrames && !nextBlock())
+		{
+			break;
+		}
+
+		int count = qMin(frames - done, mBlockFrames - mBlockUsed);
+		for (int c = 0; c < channels; c++)
+		{
+			planes[c] = mBlock.constData() + c * mMaxBlock + mBlockUsed;
+		}
+
+		AudioKernels::Interleave(planes, channels, count, mShift, mFormat.sampleSize(), out + done * frameBytes);
+
+		mBlockUsed += count;
+		mSample += count;
+		done += count;
+	}
+
+	return done;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Seek
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Seek (qint64 frame)
+--						qint64 frame: The frame to decode next.
+--
+-- RETURNS:			True if the decoder is valid, otherwise false.
+--
+-- NOTES:
+--					Finds a frame that starts no more than FLAC_SEEK_SPAN bytes before the one that holds the wanted
+--					frame. The seek table narrows the search when there is one. Each step of the search looks for the
+--					first frame after the middle of what is left: if it starts at or before the wanted frame it is the
+--					new start, otherwise the wanted frame is before the middle.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::Seek(qint64 frame)
+{
+	if (!mValid)
+	{
+		return false;
+	}
+
+	frame = qBound<qint64>(0, frame, mFrames);
+	mSample = frame;
+	mBlockFrames = 0;
+	mBlockUsed = 0;
+
+	qint64 low = mFirstFrame;
+	qint64 high = audioEnd();
+
+	for (const SeekPoint & point : mSeekPoints)
+	{
+		qint64 offset = mFirstFrame + point.offset;
+		if (offset >= high)
+		{
+			break;
+		}
+
+		if (point.sample <= frame)
+		{
+			low = qMax(low, offset);
+		}
+		else
+		{
+			high = offset;
+			break;
+		}
+	}
+
+	while (high - low > FLAC_SEEK_SPAN)
+	{
+		qint64 middle = low + (high - low) / 2;
+		FrameHeader header;
+
+		if (findFrame(middle, high, &header) && header.sample <= frame)
+		{
+			low = header.offset;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	mPosition = low;
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Format ()
+--
+-- RETURNS:			The format of the decoded frames, signed little endian of 16, 24 or 32 bits.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat FlacDecoder::Format() const
+{
+	return mFormat;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Frames
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Frames ()
+--
+-- RETURNS:			The number of frames in the song, from the STREAMINFO block.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 FlacDecoder::Frames() const
+{
+	return mFrames;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Truncated
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Truncated ()
+--
+-- RETURNS:			True if the last frame of the song is missing or cut short.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::Truncated() const
+{
+	return mTruncated;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ErrorString
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ErrorString ()
+--
+-- RETURNS:			Why the last file opened could not be played, empty if it can.
+----------------------------------------------------------------------------------------------------------------------*/
+QString FlacDecoder::ErrorString() const
+{
+	return mError;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		StreamStart
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		StreamStart (const uchar * data, qint64 size)
+--						const uchar * data: The start of the file.
+--						qint64 size: How many bytes of the file data holds.
+--
+-- RETURNS:			Where "fLaC" is in the file, -1 if the file is not a FLAC file.
+--
+-- NOTES:
+--					Some taggers put an ID3v2 tag in front of the stream. Its size is stored as four bytes of seven
+--					bits each and does not count its 10 byte header, or the footer when there is one.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 FlacDecoder::StreamStart(const uchar * data, qint64 size)
+{
+	qint64 start = 0;
+
+	if (size >= 10 && memcmp(data, "ID3", 3) == 0)
+	{
+		quint32 tagSize = ((data[6] & 0x7F) << 21) | ((data[7] & 0x7F) << 14) | ((data[8] & 0x7F) << 7)
+			| (data[9] & 0x7F);
+		start = 10 + (qint64)tagSize + ((data[5] & 0x10) ? 10 : 0);
+	}
+
+	return start + 4 <= size && memcmp(data + start, "fLaC", 4) == 0 ? start : -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Crc8
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Crc8 (const uchar * data, qint64 size)
+--						const uchar * data: The bytes to check.
+--						qint64 size: The number of bytes.
+--
+-- RETURNS:			The CRC-8 that ends a frame header.
+----------------------------------------------------------------------------------------------------------------------*/
+quint8 FlacDecoder::Crc8(const uchar * data, qint64 size)
+{
+	quint8 crc = 0;
+
+	for (qint64 i = 0; i < size; i++)
+	{
+		crc = flacCrcTables.crc8[crc ^ data[i]];
+	}
+
+	return crc;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Crc16
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Crc16 (const uchar * data, qint64 size)
+--						const uchar * data: The bytes to check.
+--						qint64 size: The number of bytes.
+--
+-- RETURNS:			The CRC-16 that ends a frame.
+----------------------------------------------------------------------------------------------------------------------*/
+quint16 FlacDecoder::Crc16(const uchar * data, qint64 size)
+{
+	quint16 crc = 0;
+
+	for (qint64 i = 0; i < size; i++)
+	{
+		crc = (quint16)((crc << 8) ^ flacCrcTables.crc16[(crc >> 8) ^ data[i]]);
+	}
+
+	return crc;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		parseStreamInfo
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		parseStreamInfo (const uchar * block, quint32 size)
+--						const uchar * block: The body of the STREAMINFO block.
+--						quint32 size: The size of the body.
+--
+-- RETURNS:			True if the song can be played, otherwise false.
+--
+-- NOTES:
+--					The block holds the smallest and largest block and frame sizes, then 20 bits of sample rate, 3 of
+--					channels less one, 5 of bits per sample less one and 36 of frames, then the MD5 of the audio.
+--					A song whose length is not known is refused, since the length of what it decodes to has to be
+--					known before it is played.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::parseStreamInfo(const uchar * block, quint32 size)
+{
+	if (size < 34)
+	{
+		return fail("The STREAMINFO block is too short");
+	}
+
+	mMinBlock = qFromBigEndian<quint16>(block);
+	mMaxBlock = qFromBigEndian<quint16>(block + 2);
+	mMaxFrame = (block[7] << 16) | (block[8] << 8) | block[9];
+
+	int sampleRate = (block[10] << 12) | (block[11] << 4) | (block[12] >> 4);
+	int channels = ((block[12] >> 1) & 7) + 1;
+	mBits = (((block[12] & 1) << 4) | (block[13] >> 4)) + 1;
+	mFrames = ((qint64)(block[13] & 0x0F) << 32) | qFromBigEndian<quint32>(block + 14);
+
+	if (sampleRate == 0)
+	{
+		return fail("The song has no sample rate");
+	}
+
+	if (mMinBlock < 16 || mMaxBlock < mMinBlock)
+	{
+		return fail("The block sizes are not valid");
+	}
+
+	if (mBits < 4)
+	{
+		return fail(QString("%1 bit samples are not supported").arg(mBits));
+	}
+
+	if (mFrames == 0)
+	{
+		return fail("The length of the song is not known");
+	}
+
+	int sampleSize = mBits <= 16 ? 16 : (mBits <= 24 ? 24 : 32);
+	mShift = sampleSize - mBits;
+
+	mFormat.setSampleRate(sampleRate);
+	mFormat.setChannelCount(channels);
+	mFormat.setSampleSize(sampleSize);
+	mFormat.setCodec("audio/pcm");
+	mFormat.setByteOrder(QAudioFormat::LittleEndian);
+	mFormat.setSampleType(QAudioFormat::SignedInt);
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		parseSeekTable
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		parseSeekTable (const uchar * block, quint32 size)
+--						const uchar * block: The body of the SEEKTABLE block.
+--						quint32 size: The size of the body.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Every point is the first frame of a frame, where that frame is from the first frame of the song
+--					and how many frames it holds. Placeholder points, which have every bit of their frame set, are
+--					left out.
+----------------------------------------------------------------------------------------------------------------------*/
+void FlacDecoder::parseSeekTable(const uchar * block, quint32 size)
+{
+	for (quint32 i = 0; i + 18 <= size; i += 18)
+	{
+		quint64 sample = qFromBigEndian<quint64>(block + i);
+		if (sample == Q_UINT64_C(0xFFFFFFFFFFFFFFFF))
+		{
+			continue;
+		}
+
+		SeekPoint point;
+		point.sample = (qint64)sample;
+		point.offset = (qint64)qFromBigEndian<quint64>(block + i + 8);
+		mSeekPoints.append(point);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		checkTail
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		checkTail ()
+--
+-- RETURNS:			True if the song ends with a whole frame that reaches its last frame, otherwise false.
+--
+-- NOTES:
+--					Looks back from the end of the audio for a frame header whose frame runs to the end with a
+--					matching CRC-16 and holds the last frame of the song. Headers are tried from the end, so a sync
+--					code that happens to be in the audio of the last frame is passed over.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::checkTail()
+{
+	qint64 end = audioEnd();
+	qint64 window = mMaxFrame > 0 ? mMaxFrame : FLAC_TAIL_SEARCH;
+	qint64 from = qMax(mFirstFrame, end - window);
+
+	if (end - 2 <= mFirstFrame)
+	{
+		return false;
+	}
+
+	quint16 crc = qFromBigEndian<quint16>(mData + end - 2);
+
+	for (qint64 p = end - 3; p >= from; p--)
+	{
+		FrameHeader header;
+		if (mData[p] != 0xFF || !readFrameHeader(p, &header))
+		{
+			continue;
+		}
+
+		if (header.sample + header.blockSize >= mFrames && Crc16(mData + p, end - 2 - p) == crc)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		audioEnd
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		audioEnd ()
+--
+-- RETURNS:			Where the last frame ends, before any tags at the end of the file.
+--
+-- NOTES:
+--					An ID3v1 tag is the last 128 bytes and starts with "TAG". An APE tag ends with a 32 byte footer
+--					that holds the size of the tag without its header, and says whether there is a header.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 FlacDecoder::audioEnd() const
+{
+	qint64 end = mSize;
+
+	if (end - 128 >= mFirstFrame && memcmp(mData + end - 128, "TAG", 3) == 0)
+	{
+		end -= 128;
+	}
+
+	if (end - 32 >= mFirstFrame && memcmp(mData + end - 32, "APETAGEX", 8) == 0)
+	{
+		quint32 tagSize = qFromLittleEndian<quint32>(mData + end - 32 + 12);
+		quint32 flags = qFromLittleEndian<quint32>(mData + end - 32 + 20);
+		qint64 total = (qint64)tagSize + ((flags & 0x80000000) ? 32 : 0);
+
+		if (end - total >= mFirstFrame)
+		{
+			end -= total;
+		}
+	}
+
+	return end;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readFrameHeader
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readFrameHeader (qint64 offset, FrameHeader * header)
+--						qint64 offset: Where the header may start.
+--						FrameHeader * header: Set to what the header says.
+--
+-- RETURNS:			True if there is a valid frame header at the offset, otherwise false.
+--
+-- NOTES:
+--					After the sync code and the blocking strategy come the codes for the block size, sample rate,
+--					channel assignment and sample size, then the number of the frame, or of its first frame when the
+--					blocks vary in size, coded like UTF-8. Some codes mean the block size or sample rate follow. The
+--					header ends with its CRC-8.
+--
+--					Since a sync code can turn up anywhere in the audio, a header is only taken when its CRC matches
+--					and it agrees with the STREAMINFO block on the channels and bits per sample and fits in the
+--					largest block.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::readFrameHeader(qint64 offset, FrameHeader * header) const
+{
+	if (offset + 6 > mSize)
+	{
+		return false;
+	}
+
+	const uchar * bytes = mData + offset;
+	if (bytes[0] != 0xFF || (bytes[1] & 0xFE) != 0xF8)
+	{
+		return false;
+	}
+
+	bool variable = (bytes[1] & 1) != 0;
+	int blockCode = bytes[2] >> 4;
+	int rateCode = bytes[2] & 0x0F;
+	int assignment = bytes[3] >> 4;
+	int sizeCode = (bytes[3] >> 1) & 7;
+
+	if (blockCode == 0 || rateCode == 15 || assignment > 10 || sizeCode == 3 || (bytes[3] & 1))
+	{
+		return false;
+	}
+
+	// The number of the frame
+	quint64 number = bytes[4];
+	int extra;
+
+	if (number < 0x80)
+	{
+		extra = 0;
+	}
+	else if ((number & 0xE0) == 0xC0)
+	{
+		extra = 1;
+		number &= 0x1F;
+	}
+	else if ((number & 0xF0) == 0xE0)
+	{
+		extra = 2;
+		number &= 0x0F;
+	}
+	else if ((number & 0xF8) == 0xF0)
+	{
+		extra = 3;
+		number &= 0x07;
+	}
+	else if ((number & 0xFC) == 0xF8)
+	{
+		extra = 4;
+		number &= 0x03;
+	}
+	else if ((number & 0xFE) == 0xFC)
+	{
+		extra = 5;
+		number &= 0x01;
+	}
+	else if (number == 0xFE && variable)
+	{
+		extra = 6;
+		number = 0;
+	}
+	else
+	{
+		return false;
+	}
+
+	int length = 5 + extra + (blockCode == 6 ? 1 : (blockCode == 7 ? 2 : 0))
+		+ (rateCode == 12 ? 1 : (rateCode == 13 || rateCode == 14 ? 2 : 0));
+	if (offset + length + 1 > mSize)
+	{
+		return false;
+	}
+
+	const uchar * position = bytes + 5;
+	for (int i = 0; i < extra; i++, position++)
+	{
+		if ((*position & 0xC0) != 0x80)
+		{
+			return false;
+		}
+		number = (number << 6) | (*position & 0x3F);
+	}
+
+	int blockSize;
+	if (blockCode == 1)
+	{
+		blockSize = 192;
+	}
+	else if (blockCode <= 5)
+	{
+		blockSize = 576 << (blockCode - 2);
+	}
+	else if (blockCode == 6)
+	{
+		blockSize = *position++ + 1;
+	}
+	else if (blockCode == 7)
+	{
+		blockSize = qFromBigEndian<quint16>(position) + 1;
+		position += 2;
+	}
+	else
+	{
+		blockSize = 256 << (blockCode - 8);
+	}
+
+	// The sample rate is taken from the STREAMINFO block, so one that follows is only stepped over
+	position += rateCode == 12 ? 1 : (rateCode == 13 || rateCode == 14 ? 2 : 0);
+
+	static const int sizes[] = { 0, 8, 12, 0, 16, 20, 24, 32 };
+	int bits = sizeCode == 0 ? mBits : sizes[sizeCode];
+	int channels = assignment < 8 ? assignment + 1 : 2;
+
+	if (bits != mBits || channels != mFormat.channelCount() || blockSize > mMaxBlock)
+	{
+		return false;
+	}
+
+	if (Crc8(bytes, length) != bytes[length])
+	{
+		return false;
+	}
+
+	header->offset = offset;
+	header->sample = variable ? (qint64)number : (qint64)number * mMinBlock;
+	header->size = length + 1;
+	header->blockSize = blockSize;
+	header->assignment = assignment;
+	header->bits = bits;
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		findFrame
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		findFrame (qint64 offset, qint64 limit, FrameHeader * header)
+--						qint64 offset: Where to start looking.
+--						qint64 limit: Where to stop looking.
+--						FrameHeader * header: Set to the header of the frame found.
+--
+-- RETURNS:			True if a frame starts between the offset and the limit, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::findFrame(qint64 offset, qint64 limit, FrameHeader * header) const
+{
+	const uchar * next = mData + offset;
+	const uchar * end = mData + qMin(limit, mSize) - 1;
+
+	while (next < end)
+	{
+		next = (const uchar *)memchr(next, 0xFF, end - next);
+		if (next == nullptr)
+		{
+			return false;
+		}
+
+		if ((next[1] & 0xFE) == 0xF8 && readFrameHeader(next - mData, header))
+		{
+			return true;
+		}
+
+		next++;
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		nextBlock
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		nextBlock ()
+--
+-- RETURNS:			True if a frame was decoded, false at the end of the song.
+--
+-- NOTES:
+--					Frames that end before the next frame to hand out, which happens after a seek, are stepped over by
+--					looking for the next sync code. A frame that can not be decoded is silence. If frames went missing
+--					the song carries on from the first one after them.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::nextBlock()
+{
+	while (mSample < mFrames)
+	{
+		FrameHeader header;
+		if (!findFrame(mPosition, mSize, &header))
+		{
+			return false;
+		}
+
+		if (header.sample + header.blockSize <= mSample)
+		{
+			mPosition = header.offset + header.size;
+			continue;
+		}
+
+		if (!decodeFrame(header))
+		{
+			for (int c = 0; c < mFormat.channelCount(); c++)
+			{
+				memset(mBlock.data() + c * mMaxBlock, 0, header.blockSize * sizeof(qint32));
+			}
+			mPosition = header.offset + header.size;
+		}
+
+		mBlockFrames = header.blockSize;
+		mBlockUsed = (int)qMax<qint64>(0, mSample - header.sample);
+		mSample = qMax(mSample, header.sample);
+
+		return true;
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		decodeFrame
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		decodeFrame (const FrameHeader & header)
+--						const FrameHeader & header: The header of the frame.
+--
+-- RETURNS:			True if the frame was decoded and its CRC-16 matches, otherwise false.
+--
+-- NOTES:
+--					The side channel of a stereo frame has one more bit than the others, since it is a difference.
+--					The subframes are followed by padding to a whole byte and then the CRC.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::decodeFrame(const FrameHeader & header)
+{
+	BitReader reader = { mData + header.offset + header.size, mData + mSize, 0, 0, false };
+
+	for (int c = 0; c < mFormat.channelCount(); c++)
+	{
+		bool side = (c == 1 && (header.assignment == 8 || header.assignment == 10))
+			|| (c == 0 && header.assignment == 9);
+
+		if (!decodeSubframe(reader, mBlock.data() + c * mMaxBlock, header.blockSize, header.bits + (side ? 1 : 0)))
+		{
+			return false;
+		}
+	}
+
+	const uchar * end = reader.next - reader.count / 8;
+	if (end + 2 > mData + mSize)
+	{
+		return false;
+	}
+
+	if (Crc16(mData + header.offset, end - (mData + header.offset)) != qFromBigEndian<quint16>(end))
+	{
+		return false;
+	}
+
+	decorrelate(header.assignment, header.blockSize);
+	mPosition = end + 2 - mData;
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		decodeSubframe
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		decodeSubframe (BitReader & reader, qint32 * out, int count, int bits)
+--						BitReader & reader: Where the subframe is.
+--						qint32 * out: Where the samples of the channel are written.
+--						int count: The number of samples in the block.
+--						int bits: How many bits the samples of the channel take.
+--
+-- RETURNS:			True if the subframe was decoded, otherwise false.
+--
+-- NOTES:
+--					A subframe starts with a zero bit, six bits of type and a flag for wasted bits. Samples whose low
+--					bits are all zero are coded without them and shifted back up at the end. The types are a
+--					constant, verbatim samples, a fixed predictor of order 0 to 4 or an LPC predictor of order 1 to
+--					32, which also gives the precision and shift of its coefficients. Samples of more than 32 bits,
+--					which only the side channel of 32 bit stereo can have, are not supported.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::decodeSubframe(BitReader & reader, qint32 * out, int count, int bits)
+{
+	if (bits > 32 || readBits(reader, 1) != 0)
+	{
+		return false;
+	}
+
+	int type = readBits(reader, 6);
+	int wasted = 0;
+
+	if (readBits(reader, 1))
+	{
+		wasted = readUnary(reader) + 1;
+		if (wasted >= bits)
+		{
+			return false;
+		}
+		bits -= wasted;
+	}
+
+	if (type == 0)
+	{
+		qint32 value = readSigned(reader, bits);
+		for (int i = 0; i < count; i++)
+		{
+			out[i] = value;
+		}
+	}
+	else if (type == 1)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			out[i] = readSigned(reader, bits);
+		}
+	}
+	else if (type >= 8 && type <= 12)
+	{
+		int order = type - 8;
+		if (order > count)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < order; i++)
+		{
+			out[i] = readSigned(reader, bits);
+		}
+
+		if (!decodeResidual(reader, out, count, order))
+		{
+			return false;
+		}
+
+		restoreFixed(out, count, order);
+	}
+	else if (type >= 32)
+	{
+		int order = type - 31;
+		if (order > count)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < order; i++)
+		{
+			out[i] = readSigned(reader, bits);
+		}
+
+		int precision = readBits(reader, 4) + 1;
+		int shift = readSigned(reader, 5);
+		if (precision == 16 || shift < 0)
+		{
+			return false;
+		}
+
+		qint32 coefs[32];
+		for (int i = 0; i < order; i++)
+		{
+			coefs[i] = readSigned(reader, precision);
+		}
+
+		if (!decodeResidual(reader, out, count, order))
+		{
+			return false;
+		}
+
+		AudioKernels::RestoreLpc(out, count, coefs, order, shift, bits, precision, mHistory.data());
+	}
+	else
+	{
+		return false;
+	}
+
+	if (wasted > 0)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			out[i] = (qint32)((quint32)out[i] << wasted);
+		}
+	}
+
+	return !reader.overrun;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		decodeResidual
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		decodeResidual (BitReader & reader, qint32 * out, int count, int order)
+--						BitReader & reader: Where the residual is.
+--						qint32 * out: The samples of the channel, the residual is written after the warm up.
+--						int count: The number of samples in the block.
+--						int order: The number of warm up samples.
+--
+-- RETURNS:			True if the residual was read, otherwise false.
+--
+-- NOTES:
+--					The residual is split into 2^order partitions, the first of which is short by the warm up. Each
+--					has its own Rice parameter of 4 or 5 bits, where the largest value means the partition is not Rice
+--					coded but is plain signed numbers of a size that follows. A Rice coded number is its high part in
+--					unary, then its low bits, and is folded so that small negative numbers are small too.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::decodeResidual(BitReader & reader, qint32 * out, int count, int order)
+{
+	int method = readBits(reader, 2);
+	if (method > 1)
+	{
+		return false;
+	}
+
+	const int parameterBits = method == 0 ? 4 : 5;
+	const int escape = method == 0 ? 15 : 31;
+	const int partitionOrder = readBits(reader, 4);
+	const int partitionSize = count >> partitionOrder;
+
+	if ((partitionSize << partitionOrder) != count || partitionSize < order)
+	{
+		return false;
+	}
+
+	int i = order;
+	for (int p = 0; p < (1 << partitionOrder); p++)
+	{
+		int parameter = readBits(reader, parameterBits);
+		int end = (p + 1) * partitionSize;
+
+		if (parameter == escape)
+		{
+			int bits = readBits(reader, 5);
+			for (; i < end; i++)
+			{
+				out[i] = readSigned(reader, bits);
+			}
+		}
+		else
+		{
+			for (; i < end; i++)
+			{
+				quint32 value = (readUnary(reader) << parameter) | readBits(reader, parameter);
+				out[i] = (qint32)(value >> 1) ^ -(qint32)(value & 1);
+			}
+		}
+
+		if (reader.overrun)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		restoreFixed
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		restoreFixed (qint32 * out, int count, int order)
+--						qint32 * out: The warm up samples followed by the residual, replaced by the signal.
+--						int count: The number of samples.
+--						int order: The order of the fixed predictor, 0 to 4.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The fixed predictors carry on the last 1 to 4 samples as a polynomial. The sum is done in 64 bits
+--					so the larger weights can not overflow on 32 bit audio.
+----------------------------------------------------------------------------------------------------------------------*/
+void FlacDecoder::restoreFixed(qint32 * out, int count, int order)
+{
+	switch (order)
+	{
+	case 1:
+		for (int i = 1; i < count; i++)
+		{
+			out[i] += out[i - 1];
+		}
+		break;
+	case 2:
+		for (int i = 2; i < count; i++)
+		{
+			out[i] += (qint32)(2 * (qint64)out[i - 1] - out[i - 2]);
+		}
+		break;
+	case 3:
+		for (int i = 3; i < count; i++)
+		{
+			out[i] += (qint32)(3 * ((qint64)out[i - 1] - out[i - 2]) + out[i - 3]);
+		}
+		break;
+	case 4:
+		for (int i = 4; i < count; i++)
+		{
+			out[i] += (qint32)(4 * ((qint64)out[i - 1] + out[i - 3]) - 6 * (qint64)out[i - 2] - out[i - 4]);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		decorrelate
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		decorrelate (int assignment, int count)
+--						int assignment: The channel assignment of the frame.
+--						int count: The number of samples in the block.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Turns left and side, side and right or mid and side back into left and right. Side is left less
+--					right and mid is their sum shifted down, which loses its lowest bit, but that bit is the same as
+--					the lowest bit of side.
+----------------------------------------------------------------------------------------------------------------------*/
+void FlacDecoder::decorrelate(int assignment, int count)
+{
+	qint32 * first = mBlock.data();
+	qint32 * second = first + mMaxBlock;
+
+	switch (assignment)
+	{
+	case 8:
+		for (int i = 0; i < count; i++)
+		{
+			second[i] = first[i] - second[i];
+		}
+		break;
+	case 9:
+		for (int i = 0; i < count; i++)
+		{
+			first[i] += second[i];
+		}
+		break;
+	case 10:
+		for (int i = 0; i < count; i++)
+		{
+			qint32 side = second[i];
+			qint32 mid = (qint32)((quint32)first[i] << 1) | (side & 1);
+			first[i] = (mid + side) >> 1;
+			second[i] = (mid - side) >> 1;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		refill
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		refill (BitReader & reader)
+--						BitReader & reader: The reader to top up.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Fills the cache with whole bytes until there is no room for another one or the data runs out. The
+--					bits below the ones in the cache are always zero.
+----------------------------------------------------------------------------------------------------------------------*/
+void FlacDecoder::refill(BitReader & reader)
+{
+	while (reader.count <= 56 && reader.next < reader.end)
+	{
+		reader.cache |= (quint64)*reader.next++ << (56 - reader.count);
+		reader.count += 8;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readBits
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readBits (BitReader & reader, int bits)
+--						BitReader & reader: Where to read from.
+--						int bits: How many bits to read, 0 to 32.
+--
+-- RETURNS:			The bits, the first one read being the highest.
+--
+-- NOTES:
+--					Reading past the end of the data gives zeros and marks the reader as overrun.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 FlacDecoder::readBits(BitReader & reader, int bits)
+{
+	if (bits == 0)
+	{
+		return 0;
+	}
+
+	if (reader.count < bits)
+	{
+		refill(reader);
+		if (reader.count < bits)
+		{
+			reader.overrun = true;
+			reader.count = bits;
+		}
+	}
+
+	quint32 value = (quint32)(reader.cache >> (64 - bits));
+	reader.cache <<= bits;
+	reader.count -= bits;
+
+	return value;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readSigned
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readSigned (BitReader & reader, int bits)
+--						BitReader & reader: Where to read from.
+--						int bits: How many bits to read, 0 to 32.
+--
+-- RETURNS:			The bits as a two's complement number.
+----------------------------------------------------------------------------------------------------------------------*/
+qint32 FlacDecoder::readSigned(BitReader & reader, int bits)
+{
+	if (bits == 0)
+	{
+		return 0;
+	}
+
+	quint32 value = readBits(reader, bits) << (32 - bits);
+
+	return (qint32)value >> (32 - bits);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readUnary
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readUnary (BitReader & reader)
+--						BitReader & reader: Where to read from.
+--
+-- RETURNS:			The number of zeros before the next one, which is read too.
+--
+-- NOTES:
+--					Since the bits below the cache are zero, a cache that is not zero holds the one, and the zeros in
+--					front of it are counted in one go.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 FlacDecoder::readUnary(BitReader & reader)
+{
+	quint32 zeros = 0;
+
+	for (;;)
+	{
+		if (reader.cache != 0)
+		{
+			int leading = qCountLeadingZeroBits(reader.cache);
+			reader.cache <<= leading;
+			reader.cache <<= 1;
+			reader.count -= leading + 1;
+
+			return zeros + leading;
+		}
+
+		zeros += reader.count;
+		reader.count = 0;
+		refill(reader);
+
+		if (reader.count == 0)
+		{
+			reader.overrun = true;
+			return zeros;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		fail
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		fail (const QString & error)
+--						const QString & error: Why the file can not be played.
+--
+-- RETURNS:			False, so that it can be returned straight away.
+----------------------------------------------------------------------------------------------------------------------*/
+bool FlacDecoder::fail(const QString & error)
+{
+	mError = error;
+	mValid = false;
+
+	return false;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QString>
+#include <QVector>
+#include <QtAlgorithms>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "AudioDecoder.h"
+#include "AudioKernels.h"
+#include "globals.h"
+
+class FlacDecoder : public AudioDecoder
+{
+public:
+	FlacDecoder();
+
+	bool Open(const uchar * data, qint64 size) override;
+	int Decode(char * out, int frames) override;
+	bool Seek(qint64 frame) override;
+
+	QAudioFormat Format() const override;
+	qint64 Frames() const override;
+	bool Truncated() const override;
+	QString ErrorString() const override;
+
+	static qint64 StreamStart(const uchar * data, qint64 size);
+	static quint8 Crc8(const uchar * data, qint64 size);
+	static quint16 Crc16(const uchar * data, qint64 size);
+
+private:
+	struct FrameHeader
+	{
+		qint64 offset;
+		qint64 sample;
+		int size;
+		int blockSize;
+		int assignment;
+		int bits;
+	};
+
+	struct SeekPoint
+	{
+		qint64 sample;
+		qint64 offset;
+	};
+
+	// Reads the bits of a frame from the top of a 64 bit cache that is topped up a byte at a time
+	struct BitReader
+	{
+		const uchar * next;
+		const uchar * end;
+		quint64 cache;
+		int count;
+		bool overrun;
+	};
+
+	const uchar * mData;
+	qint64 mSize;
+	qint64 mFirstFrame;
+	QVector<SeekPoint> mSeekPoints;
+
+	QAudioFormat mFormat;
+	int mBits;
+	int mShift;
+	int mMinBlock;
+	int mMaxBlock;
+	int mMaxFrame;
+	qint64 mFrames;
+
+	// The decoded frame, one run of samples per channel, and how much of it has been handed out
+	QVector<qint32> mBlock;
+	QVector<qint16> mHistory;
+	int mBlockFrames;
+	int mBlockUsed;
+	qint64 mPosition;
+	qint64 mSample;
+
+	bool mTruncated;
+	bool mValid;
+	QString mError;
+
+	bool parseStreamInfo(const uchar * block, quint32 size);
+	void parseSeekTable(const uchar * block, quint32 size);
+	bool checkTail();
+	qint64 audioEnd() const;
+
+	bool readFrameHeader(qint64 offset, FrameHeader * header) const;
+	bool findFrame(qint64 offset, qint64 limit, FrameHeader * header) const;
+	bool nextBlock();
+	bool decodeFrame(const FrameHeader & header);
+	bool decodeSubframe(BitReader & reader, qint32 * out, int count, int bits);
+	bool decodeResidual(BitReader & reader, qint32 * out, int count, int order);
+	void restoreFixed(qint32 * out, int count, int order);
+	void decorrelate(int assignment, int count);
+
+	static void refill(BitReader & reader);
+	static quint32 readBits(BitReader & reader, int bits);
+	static qint32 readSigned(BitReader & reader, int bits);
+	static quint32 readUnary(BitReader & reader);
+
+	bool fail(const QString & error);
+};
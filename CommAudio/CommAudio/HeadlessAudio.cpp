@@ -0,0 +1,1408 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		HeadlessAudio.cpp - Audio devices that need no sound hardware.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					CaptureDevice(int capacity, QObject * parent = nullptr)
+--					void CaptureDevice::Append(const QByteArray & data)
+--					void CaptureDevice::SetCapacity(int capacity)
+--					bool CaptureDevice::isSequential() const
+--					qint64 CaptureDevice::bytesAvailable() const
+--					qint64 CaptureDevice::readData(char * data, qint64 maxSize)
+--					qint64 CaptureDevice::writeData(const char * data, qint64 maxSize)
+--					NullSink(const QAudioFormat & format, bool realTime, QObject * parent = nullptr)
+--					QAudioFormat NullSink::format() const
+--					void NullSink::start(QIODevice * device)
+--					void NullSink::stop()
+--					void NullSink::suspend()
+--					void NullSink::resume()
+--					QAudio::State NullSink::state() const
+--					QAudio::Error NullSink::error() const
+--					qint64 NullSink::processedUSecs() const
+--					void NullSink::setBufferSize(int bytes)
+--					int NullSink::bufferSize() const
+--					int NullSink::bytesFree() const
+--					void NullSink::setNotifyInterval(int ms)
+--					void NullSink::setVolume(qreal volume)
+--					qreal NullSink::volume() const
+--					bool NullSink::open()
+--					void NullSink::consume(const char * data, int size)
+--					void NullSink::close()
+--					void NullSink::setState(QAudio::State state, QAudio::Error error)
+--					void NullSink::tickHandler()
+--					WavSink(const QAudioFormat & format, bool realTime, const QString & fileName,
+--						QObject * parent = nullptr)
+--					~WavSink()
+--					bool WavSink::open()
+--					void WavSink::consume(const char * data, int size)
+--					void WavSink::close()
+--					void WavSink::writeHeader()
+--					NullSource(const QAudioFormat & format, bool realTime, QObject * parent = nullptr)
+--					QAudioFormat NullSource::format() const
+--					QIODevice * NullSource::start()
+--					void NullSource::stop()
+--					void NullSource::setBufferSize(int bytes)
+--					void NullSource::setNotifyInterval(int ms)
+--					bool NullSource::open()
+--					void NullSource::produce(char * data, int size)
+--					void NullSource::close()
+--					void NullSource::tickHandler()
+--					WavSource(const QAudioFormat & format, bool realTime, const QString & fileName,
+--						QObject * parent = nullptr)
+--					bool WavSource::open()
+--					void WavSource::produce(char * data, int size)
+--					void WavSource::close()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					These stand in for QAudioOutput and QAudioInput on a machine without sound hardware. They are
+--					driven by a timer on the thread they live on and behave like a sound card as far as the rest of
+--					the program can tell: a sink pulls into a buffer of its own size, goes idle with an underrun
+--					error when the device runs dry, and counts what it has played.
+--
+--					Paced in real time the buffer drains at the rate of the format, so the buffering and latency seen
+--					by the program are the same as on real hardware. Run fast, a sink plays whatever is in its buffer
+--					on every tick and a source fills whatever room its reader has left, so a test runs as quickly as
+--					the code under it can go.
+--
+--					A NullSink throws the audio away and a NullSource captures silence. WavSink and WavSource add a
+--					file to them, the sink writes what it plays to a wav file and the source loops one.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "HeadlessAudio.h"
+
+#include <QDebug>
+
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CaptureDevice
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		CaptureDevice (int capacity, QObject * parent)
+--						int capacity: The most bytes held before the oldest are dropped.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+CaptureDevice::CaptureDevice(int capacity, QObject * parent)
+	: QIODevice(parent)
+	, mCapacity(capacity)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CaptureDevice::Append
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Append (const QByteArray & data)
+--						const QByteArray & data: Audio that was just captured.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Queues the audio to be read and emits readyRead.
+----------------------------------------------------------------------------------------------------------------------*/
+void CaptureDevice::Append(const QByteArray & data)
+{
+	mPending.append(data);
+
+	// A reader that has fallen behind loses the oldest audio, like a sound card overrunning its buffer
+	if (mPending.size() > mCapacity)
+	{
+		mPending.remove(0, mPending.size() - mCapacity);
+	}
+
+	emit readyRead();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CaptureDevice::SetCapacity
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetCapacity (int capacity)
+--						int capacity: The most bytes held before the oldest are dropped.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Anything already queued is thrown away.
+----------------------------------------------------------------------------------------------------------------------*/
+void CaptureDevice::SetCapacity(int capacity)
+{
+	mCapacity = capacity;
+	mPending.clear();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CaptureDevice::isSequential
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		isSequential ()
+--
+-- RETURNS:			True, captured audio can only be read in order.
+----------------------------------------------------------------------------------------------------------------------*/
+bool CaptureDevice::isSequential() const
+{
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CaptureDevice::bytesAvailable
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bytesAvailable ()
+--
+-- RETURNS:			The bytes of captured audio waiting to be read.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 CaptureDevice::bytesAvailable() const
+{
+	return mPending.size() + QIODevice::bytesAvailable();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CaptureDevice::readData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readData (char * data, qint64 maxSize)
+--						char * data: Where to copy the audio.
+--						qint64 maxSize: The most bytes to copy.
+--
+-- RETURNS:			The number of bytes copied.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 CaptureDevice::readData(char * data, qint64 maxSize)
+{
+	int size = (int)qMin<qint64>(maxSize, mPending.size());
+
+	memcpy(data, mPending.constData(), size);
+	mPending.remove(0, size);
+
+	return size;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CaptureDevice::writeData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeData (const char * data, qint64 maxSize)
+--						const char * data: Unused.
+--						qint64 maxSize: Unused.
+--
+-- RETURNS:			-1, the device is read only.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 CaptureDevice::writeData(const char * data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		NullSink (const QAudioFormat & format, bool realTime, QObject * parent)
+--						const QAudioFormat & format: The format to play.
+--						bool realTime: Whether to play at the rate of the format or as fast as the device is filled.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+NullSink::NullSink(const QAudioFormat & format, bool realTime, QObject * parent)
+	: AudioSink(parent)
+	, mFormat(format)
+	, mRealTime(realTime)
+	, mDevice(nullptr)
+	, mTimer(this)
+	, mState(QAudio::StoppedState)
+	, mError(QAudio::NoError)
+	, mBufferSize(format.bytesForDuration(HEADLESS_AUDIO_BUFFER_MS * 1000))
+	, mNotifyInterval(1000)
+	, mVolume(1)
+	, mQueued(0)
+	, mProcessed(0)
+	, mClockBytes(0)
+	, mNextNotify(0)
+{
+	mTimer.setTimerType(Qt::PreciseTimer);
+	connect(&mTimer, &QTimer::timeout, this, &NullSink::tickHandler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		format ()
+--
+-- RETURNS:			The format the sink plays.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat NullSink::format() const
+{
+	return mFormat;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::start
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		start (QIODevice * device)
+--						QIODevice * device: The device to pull audio from.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Starts pulling from the device on a timer. If the sink cannot be opened it stays stopped with an
+--					open error, as a QAudioOutput does.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::start(QIODevice * device)
+{
+	stop();
+
+	mDevice = device;
+	mQueued = 0;
+	mProcessed = 0;
+	mClockBytes = 0;
+	mNextNotify = (qint64)mNotifyInterval * 1000;
+
+	if (!open())
+	{
+		mDevice = nullptr;
+		setState(QAudio::StoppedState, QAudio::OpenError);
+		return;
+	}
+
+	// Buffer sizes from bytesForDuration are whole frames already, keep it that way if one was set by hand
+	mBufferSize -= mBufferSize % mFormat.bytesPerFrame();
+	mScratch.resize(mBufferSize);
+
+	mClock.start();
+	mTimer.start(mRealTime ? HEADLESS_AUDIO_PERIOD_MS : 0);
+	setState(QAudio::ActiveState, QAudio::NoError);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::stop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		stop ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::stop()
+{
+	if (mState == QAudio::StoppedState)
+	{
+		return;
+	}
+
+	mTimer.stop();
+	close();
+
+	mDevice = nullptr;
+	mQueued = 0;
+	setState(QAudio::StoppedState, QAudio::NoError);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::suspend
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		suspend ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::suspend()
+{
+	if (mState != QAudio::ActiveState && mState != QAudio::IdleState)
+	{
+		return;
+	}
+
+	mTimer.stop();
+	setState(QAudio::SuspendedState, QAudio::NoError);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::resume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		resume ()
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					The clock starts again from now, so the time spent suspended is not played in a burst.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::resume()
+{
+	if (mState != QAudio::SuspendedState)
+	{
+		return;
+	}
+
+	// The time spent suspended is not played
+	mClock.restart();
+	mClockBytes = 0;
+
+	mTimer.start(mRealTime ? HEADLESS_AUDIO_PERIOD_MS : 0);
+	setState(QAudio::ActiveState, QAudio::NoError);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::state
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		state ()
+--
+-- RETURNS:			The state of the sink.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudio::State NullSink::state() const
+{
+	return mState;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::error
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		error ()
+--
+-- RETURNS:			The last error of the sink.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudio::Error NullSink::error() const
+{
+	return mError;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::processedUSecs
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		processedUSecs ()
+--
+-- RETURNS:			The microseconds of audio played since the sink was started.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 NullSink::processedUSecs() const
+{
+	return mProcessed / mFormat.bytesPerFrame() * 1000000 / mFormat.sampleRate();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::setBufferSize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setBufferSize (int bytes)
+--						int bytes: The size of the pretend device buffer, used on the next start.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::setBufferSize(int bytes)
+{
+	mBufferSize = bytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::bufferSize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bufferSize ()
+--
+-- RETURNS:			The size of the pretend device buffer in bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+int NullSink::bufferSize() const
+{
+	return mBufferSize;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::bytesFree
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bytesFree ()
+--
+-- RETURNS:			The bytes of the buffer that have been played and can be filled again.
+----------------------------------------------------------------------------------------------------------------------*/
+int NullSink::bytesFree() const
+{
+	return mBufferSize - mQueued;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::setNotifyInterval
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setNotifyInterval (int ms)
+--						int ms: How much audio is played between notify signals.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::setNotifyInterval(int ms)
+{
+	mNotifyInterval = ms;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::setVolume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setVolume (qreal volume)
+--						qreal volume: The volume from 0 to 1.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::setVolume(qreal volume)
+{
+	mVolume = qBound<qreal>(0, volume, 1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::volume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		volume ()
+--
+-- RETURNS:			The volume from 0 to 1.
+----------------------------------------------------------------------------------------------------------------------*/
+qreal NullSink::volume() const
+{
+	return mVolume;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		open ()
+--
+-- RETURNS:			True if the sink is ready to play.
+--
+-- NOTES:
+--					Called on start, for a subclass that has something to open.
+----------------------------------------------------------------------------------------------------------------------*/
+bool NullSink::open()
+{
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::consume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		consume (const char * data, int size)
+--						const char * data: Audio pulled from the device, at the volume of the sink.
+--						int size: The number of bytes.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Throws the audio away. A subclass overrides this to keep it.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::consume(const char * data, int size)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(size);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::close
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		close ()
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Called on stop, for a subclass that has something to close.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::close()
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::setState
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setState (QAudio::State state, QAudio::Error error)
+--						QAudio::State state: The new state.
+--						QAudio::Error error: The error that goes with it.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Emits stateChanged if the state is different from the last one.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::setState(QAudio::State state, QAudio::Error error)
+{
+	mError = error;
+
+	if (mState != state)
+	{
+		mState = state;
+		emit stateChanged(state);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSink::tickHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		tickHandler ()
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					This is a Qt slot that is triggered by the timer of the sink. What the clock says has been
+--					played since the last tick is drained from the buffer, or the whole buffer when running fast,
+--					and the room left is filled from the device.
+--
+--					A device with nothing to give while the buffer is empty puts the sink into the idle state with
+--					an underrun error. It goes back to active as soon as the device has audio again. notify is
+--					emitted for every notify interval of audio played.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSink::tickHandler()
+{
+	// Play out of the buffer what the clock says has gone by since the last tick, or all of it when running fast
+	qint64 played = mQueued;
+
+	if (mRealTime)
+	{
+		qint64 now = mClock.nsecsElapsed() / 1000 * mFormat.sampleRate() / 1000000 * mFormat.bytesPerFrame();
+
+		played = qMin(played, now - mClockBytes);
+		mClockBytes = now;
+	}
+
+	mQueued -= (int)played;
+	mProcessed += played;
+
+	// Refill the buffer from the device
+	int space = mBufferSize - mQueued;
+	qint64 read = space > 0 ? mDevice->read(mScratch.data(), space) : 0;
+
+	if (read > 0)
+	{
+		read -= read % mFormat.bytesPerFrame();
+
+		if (mVolume < 1 && mFormat.sampleSize() == 16 && mFormat.sampleType() == QAudioFormat::SignedInt)
+		{
+			qint16 * samples = (qint16 *)mScratch.data();
+
+			for (int i = 0; i < read / 2; i++)
+			{
+				samples[i] = (qint16)(samples[i] * mVolume);
+			}
+		}
+
+		consume(mScratch.constData(), (int)read);
+		mQueued += (int)read;
+		setState(QAudio::ActiveState, QAudio::NoError);
+	}
+	else if (mQueued == 0 && mState == QAudio::ActiveState)
+	{
+		setState(QAudio::IdleState, QAudio::UnderrunError);
+	}
+
+	// Running fast with nothing to play would spin, so an idle sink waits a period between tries
+	if (!mRealTime)
+	{
+		mTimer.setInterval(mState == QAudio::IdleState ? HEADLESS_AUDIO_PERIOD_MS : 0);
+	}
+
+	if (mNotifyInterval > 0 && mState != QAudio::StoppedState)
+	{
+		qint64 processed = processedUSecs();
+
+		while (processed >= mNextNotify)
+		{
+			mNextNotify += (qint64)mNotifyInterval * 1000;
+			emit notify();
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSink
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		WavSink (const QAudioFormat & format, bool realTime, const QString & fileName, QObject * parent)
+--						const QAudioFormat & format: The format to play.
+--						bool realTime: Whether to play at the rate of the format or as fast as the device is filled.
+--						const QString & fileName: The wav file to write.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+WavSink::WavSink(const QAudioFormat & format, bool realTime, const QString & fileName, QObject * parent)
+	: NullSink(format, realTime, parent)
+	, mFile(fileName)
+	, mWritten(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~WavSink
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~WavSink ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Finishes the file if the sink is destroyed while it is playing.
+----------------------------------------------------------------------------------------------------------------------*/
+WavSink::~WavSink()
+{
+	close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSink::open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		open ()
+--
+-- RETURNS:			True if the file could be created.
+--
+-- NOTES:
+--					The file is rewritten on every start, beginning with a header for an empty file.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavSink::open()
+{
+	if (!mFile.open(QFile::WriteOnly | QFile::Truncate))
+	{
+		qWarning() << "Could not write" << mFile.fileName();
+		return false;
+	}
+
+	mWritten = 0;
+	writeHeader();
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSink::consume
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		consume (const char * data, int size)
+--						const char * data: Audio pulled from the device.
+--						int size: The number of bytes.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void WavSink::consume(const char * data, int size)
+{
+	mFile.write(data, size);
+	mWritten += size;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSink::close
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		close ()
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Rewrites the header with the length of what was played and closes the file.
+----------------------------------------------------------------------------------------------------------------------*/
+void WavSink::close()
+{
+	if (!mFile.isOpen())
+	{
+		return;
+	}
+
+	mFile.seek(0);
+	writeHeader();
+	mFile.close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSink::writeHeader
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeHeader ()
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Writes a canonical 44 byte PCM header for the format of the sink and what has been written so
+--					far.
+----------------------------------------------------------------------------------------------------------------------*/
+void WavSink::writeHeader()
+{
+	QAudioFormat audio = format();
+	WavHeader header;
+
+	memcpy(header.id, "RIFF", 4);
+	memcpy(header.wavFormat, "WAVEfmt ", 8);
+	memcpy(header.data, "data", 4);
+	header.totalLength = (int)(sizeof(WavHeader) - 8 + mWritten);
+	header.format = 16;
+	header.pcm = 1;
+	header.channels = audio.channelCount();
+	header.sampleRate = audio.sampleRate();
+	header.bytesPerSecond = audio.sampleRate() * audio.bytesPerFrame();
+	header.bytesByCapture = audio.bytesPerFrame();
+	header.bitsPerSample = audio.sampleSize();
+	header.bytesInData = (int)mWritten;
+
+	mFile.write((const char *)&header, sizeof(WavHeader));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		NullSource (const QAudioFormat & format, bool realTime, QObject * parent)
+--						const QAudioFormat & format: The format to capture.
+--						bool realTime: Whether to capture at the rate of the format or as fast as it is read.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+NullSource::NullSource(const QAudioFormat & format, bool realTime, QObject * parent)
+	: AudioSource(parent)
+	, mFormat(format)
+	, mRealTime(realTime)
+	, mDevice(format.bytesForDuration(HEADLESS_AUDIO_BUFFER_MS * 1000), this)
+	, mTimer(this)
+	, mBufferSize(format.bytesForDuration(HEADLESS_AUDIO_BUFFER_MS * 1000))
+	, mPeriod(HEADLESS_AUDIO_PERIOD_MS)
+	, mProduced(0)
+{
+	mTimer.setTimerType(Qt::PreciseTimer);
+	connect(&mTimer, &QTimer::timeout, this, &NullSource::tickHandler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		format ()
+--
+-- RETURNS:			The format the source captures.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat NullSource::format() const
+{
+	return mFormat;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::start
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		start ()
+--
+-- RETURNS:			The device the captured audio is read from, or nullptr if the source could not be opened.
+----------------------------------------------------------------------------------------------------------------------*/
+QIODevice * NullSource::start()
+{
+	stop();
+
+	if (!open())
+	{
+		return nullptr;
+	}
+
+	mBufferSize -= mBufferSize % mFormat.bytesPerFrame();
+	mDevice.SetCapacity(mBufferSize);
+	mDevice.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+	mProduced = 0;
+
+	mClock.start();
+	mTimer.start(mRealTime ? mPeriod : 0);
+
+	return &mDevice;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::stop
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		stop ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSource::stop()
+{
+	if (!mDevice.isOpen())
+	{
+		return;
+	}
+
+	mTimer.stop();
+	mDevice.close();
+	close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::setBufferSize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setBufferSize (int bytes)
+--						int bytes: The most captured audio held for the reader, used on the next start.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSource::setBufferSize(int bytes)
+{
+	mBufferSize = bytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::setNotifyInterval
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setNotifyInterval (int ms)
+--						int ms: How often audio is captured when paced in real time.
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSource::setNotifyInterval(int ms)
+{
+	mPeriod = ms > 0 ? ms : HEADLESS_AUDIO_PERIOD_MS;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		open ()
+--
+-- RETURNS:			True if the source is ready to capture.
+--
+-- NOTES:
+--					Called on start, for a subclass that has something to open.
+----------------------------------------------------------------------------------------------------------------------*/
+bool NullSource::open()
+{
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::produce
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		produce (char * data, int size)
+--						char * data: Where to put the captured audio.
+--						int size: The number of bytes to capture.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Captures silence. A subclass overrides this to capture something else.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSource::produce(char * data, int size)
+{
+	memset(data, 0, size);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::close
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		close ()
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Called on stop, for a subclass that has something to close.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSource::close()
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NullSource::tickHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		tickHandler ()
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					This is a Qt slot that is triggered by the timer of the source. It captures the audio that the
+--					clock says has gone by, or when running fast as much as the reader has room for, and hands it to
+--					the device.
+----------------------------------------------------------------------------------------------------------------------*/
+void NullSource::tickHandler()
+{
+	// Capture what the clock says has gone by since the last tick, or fill the room the reader has left when running
+	// fast. Capture that cannot fit in the buffer is lost, as it would be on a sound card
+	qint64 size = mBufferSize - mDevice.bytesAvailable();
+
+	if (mRealTime)
+	{
+		qint64 now = mClock.nsecsElapsed() / 1000 * mFormat.sampleRate() / 1000000 * mFormat.bytesPerFrame();
+
+		size = qMin<qint64>(now - mProduced, mBufferSize);
+		mProduced = now;
+	}
+
+	if (size <= 0)
+	{
+		return;
+	}
+
+	QByteArray captured((int)size, Qt::Uninitialized);
+	produce(captured.data(), captured.size());
+	mDevice.Append(captured);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		WavSource (const QAudioFormat & format, bool realTime, const QString & fileName, QObject * parent)
+--						const QAudioFormat & format: The format to capture.
+--						bool realTime: Whether to capture at the rate of the format or as fast as it is read.
+--						const QString & fileName: The wav file to loop.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+WavSource::WavSource(const QAudioFormat & format, bool realTime, const QString & fileName, QObject * parent)
+	: NullSource(format, realTime, parent)
+	, mFile(fileName)
+	, mDataStart(0)
+	, mDataSize(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSource::open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The file is read with WavParser, so recordings with more chunks
+--									loop too.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		open ()
+--
+-- RETURNS:			True if the file could be read and is in the format being captured.
+--
+-- NOTES:
+--					The file has to have the rate, channels and sample size of the format, the source does not
+--					convert.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavSource::open()
+{
+	QAudioFormat audio = format();
+	WavParser wav;
+
+	if (!mFile.open(QFile::ReadOnly) || !wav.Read(mFile))
+	{
+		qWarning() << "Could not read" << mFile.fileName() << wav.ErrorString();
+		mFile.close();
+		return false;
+	}
+
+	QAudioFormat file = wav.Format();
+	if (file.channelCount() != audio.channelCount() || file.sampleRate() != audio.sampleRate()
+		|| file.sampleSize() != audio.sampleSize())
+	{
+		qWarning() << mFile.fileName() << "is not in the format being captured.";
+		mFile.close();
+		return false;
+	}
+
+	mDataStart = wav.DataOffset();
+	mDataSize = wav.DataSize();
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSource::produce
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		produce (char * data, int size)
+--						char * data: Where to put the captured audio.
+--						int size: The number of bytes to capture.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					Reads the audio data of the file, going back to its start when it runs out.
+----------------------------------------------------------------------------------------------------------------------*/
+void WavSource::produce(char * data, int size)
+{
+	// A file without a whole frame in it plays as silence
+	if (mDataSize <= 0)
+	{
+		NullSource::produce(data, size);
+		return;
+	}
+
+	while (size > 0)
+	{
+		qint64 left = mDataStart + mDataSize - mFile.pos();
+
+		if (left <= 0)
+		{
+			mFile.seek(mDataStart);
+			continue;
+		}
+
+		qint64 read = mFile.read(data, qMin<qint64>(size, left));
+
+		if (read <= 0)
+		{
+			NullSource::produce(data, size);
+			return;
+		}
+
+		data += read;
+		size -= (int)read;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavSource::close
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		close ()
+--
+-- RETURNS:			void
+----------------------------------------------------------------------------------------------------------------------*/
+void WavSource::close()
+{
+	mFile.close();
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QIODevice>
+#include <QTimer>
+
+#include "AudioBackend.h"
+#include "globals.h"
+#include "WavParser.h"
+
+// The device a headless source hands out, holding what has been captured until it is read
+class CaptureDevice : public QIODevice
+{
+public:
+	CaptureDevice(int capacity, QObject * parent = nullptr);
+
+	void Append(const QByteArray & data);
+	void SetCapacity(int capacity);
+
+	bool isSequential() const override;
+	qint64 bytesAvailable() const override;
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+	qint64 writeData(const char * data, qint64 maxSize) override;
+
+private:
+	QByteArray mPending;
+	int mCapacity;
+};
+
+class NullSink : public AudioSink
+{
+	Q_OBJECT
+
+public:
+	NullSink(const QAudioFormat & format, bool realTime, QObject * parent = nullptr);
+
+	QAudioFormat format() const override;
+	void start(QIODevice * device) override;
+	void stop() override;
+	void suspend() override;
+	void resume() override;
+
+	QAudio::State state() const override;
+	QAudio::Error error() const override;
+	qint64 processedUSecs() const override;
+
+	void setBufferSize(int bytes) override;
+	int bufferSize() const override;
+	int bytesFree() const override;
+	void setNotifyInterval(int ms) override;
+	void setVolume(qreal volume) override;
+	qreal volume() const override;
+
+protected:
+	virtual bool open();
+	virtual void consume(const char * data, int size);
+	virtual void close();
+
+private:
+	QAudioFormat mFormat;
+	bool mRealTime;
+	QIODevice * mDevice;
+	QTimer mTimer;
+	QElapsedTimer mClock;
+	QByteArray mScratch;
+
+	QAudio::State mState;
+	QAudio::Error mError;
+	int mBufferSize;
+	int mNotifyInterval;
+	qreal mVolume;
+
+	// Bytes pulled into the pretend device buffer that have not been played yet, and bytes played since start
+	int mQueued;
+	qint64 mProcessed;
+	qint64 mClockBytes;
+	qint64 mNextNotify;
+
+	void setState(QAudio::State state, QAudio::Error error);
+
+private slots:
+	void tickHandler();
+};
+
+class WavSink : public NullSink
+{
+	Q_OBJECT
+
+public:
+	WavSink(const QAudioFormat & format, bool realTime, const QString & fileName, QObject * parent = nullptr);
+	~WavSink();
+
+protected:
+	bool open() override;
+	void consume(const char * data, int size) override;
+	void close() override;
+
+private:
+	QFile mFile;
+	qint64 mWritten;
+
+	void writeHeader();
+};
+
+class NullSource : public AudioSource
+{
+	Q_OBJECT
+
+public:
+	NullSource(const QAudioFormat & format, bool realTime, QObject * parent = nullptr);
+
+	QAudioFormat format() const override;
+	QIODevice * start() override;
+	void stop() override;
+
+	void setBufferSize(int bytes) override;
+	void setNotifyInterval(int ms) override;
+
+protected:
+	virtual bool open();
+	virtual void produce(char * data, int size);
+	virtual void close();
+
+private:
+	QAudioFormat mFormat;
+	bool mRealTime;
+	CaptureDevice mDevice;
+	QTimer mTimer;
+	QElapsedTimer mClock;
+	int mBufferSize;
+	int mPeriod;
+	qint64 mProduced;
+
+private slots:
+	void tickHandler();
+};
+
+class WavSource : public NullSource
+{
+	Q_OBJECT
+
+public:
+	WavSource(const QAudioFormat & format, bool realTime, const QString & fileName, QObject * parent = nullptr);
+
+protected:
+	bool open() override;
+	void produce(char * data, int size) override;
+	void close() override;
+
+private:
+	QFile mFile;
+	qint64 mDataStart;
+	qint64 mDataSize;
+};
\ No newline at end of file
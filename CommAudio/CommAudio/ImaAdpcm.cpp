@@ -0,0 +1,219 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		ImaAdpcm.cpp - An IMA ADPCM encoder and decoder for blocks of mono audio.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					static QByteArray Encode(const qint16 * samples, int count)
+--					static QVector<qint16> Decode(const QByteArray & block)
+--					static qint16 decodeNibble(quint8 nibble, int & predictor, int & index)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					IMA ADPCM stores every 16 bit sample in 4 bits, so audio takes a quarter of the bandwidth. Every
+--					block starts with the predictor and step index the encoder started with, which makes each block
+--					decodable on its own. A lost or skipped block never corrupts the blocks after it.
+--
+--					Block layout, all little endian:
+--						qint16 predictor, quint8 step index, quint8 reserved, quint16 sample count, then two samples
+--						per byte with the first sample in the low nibble.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "ImaAdpcm.h"
+
+const int ImaAdpcm::stepTable[89] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107,
+	118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+	1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+	6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+	32767
+};
+
+const int ImaAdpcm::indexTable[16] =
+{
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Encode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Encode (const qint16 * samples, int count)
+--						const qint16 * samples: The mono samples to encode.
+--						int count: The number of samples, at most 65535.
+--
+-- RETURNS:			The encoded block.
+--
+-- NOTES:
+--					The predictor starts at the first sample and the step index is picked from the size of the first
+--					difference so the start of the block does not have to ramp up.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray ImaAdpcm::Encode(const qint16 * samples, int count)
+{
+	QByteArray block(IMA_ADPCM_HEADER_SIZE + (count + 1) / 2, 0);
+	uchar * bytes = (uchar *)block.data();
+
+	int predictor = count > 0 ? samples[0] : 0;
+	int index = 0;
+
+	if (count > 1)
+	{
+		int difference = qAbs(samples[1] - samples[0]);
+		while (index < 88 && stepTable[index] < difference)
+		{
+			index++;
+		}
+	}
+
+	qToLittleEndian<qint16>((qint16)predictor, bytes);
+	bytes[2] = (uchar)index;
+	bytes[3] = 0;
+	qToLittleEndian<quint16>((quint16)count, bytes + 4);
+
+	uchar * out = bytes + IMA_ADPCM_HEADER_SIZE;
+
+	for (int i = 0; i < count; i++)
+	{
+		int step = stepTable[index];
+		int difference = samples[i] - predictor;
+		quint8 nibble = 0;
+
+		if (difference < 0)
+		{
+			nibble = 8;
+			difference = -difference;
+		}
+
+		if (difference >= step)
+		{
+			nibble |= 4;
+			difference -= step;
+		}
+		if (difference >= step / 2)
+		{
+			nibble |= 2;
+			difference -= step / 2;
+		}
+		if (difference >= step / 4)
+		{
+			nibble |= 1;
+		}
+
+		// Track the decoder exactly so the error does not build up
+		decodeNibble(nibble, predictor, index);
+
+		if (i & 1)
+		{
+			out[i / 2] |= nibble << 4;
+		}
+		else
+		{
+			out[i / 2] = nibble;
+		}
+	}
+
+	return block;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Decode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Decode (const QByteArray & block)
+--						const QByteArray & block: A block made by Encode.
+--
+-- RETURNS:			The decoded samples, empty if the block is malformed.
+----------------------------------------------------------------------------------------------------------------------*/
+QVector<qint16> ImaAdpcm::Decode(const QByteArray & block)
+{
+	if (block.size() < IMA_ADPCM_HEADER_SIZE)
+	{
+		return QVector<qint16>();
+	}
+
+	const uchar * bytes = (const uchar *)block.constData();
+	int predictor = qFromLittleEndian<qint16>(bytes);
+	int index = qMin((int)bytes[2], 88);
+	int count = qFromLittleEndian<quint16>(bytes + 4);
+
+	if (block.size() < IMA_ADPCM_HEADER_SIZE + (count + 1) / 2)
+	{
+		return QVector<qint16>();
+	}
+
+	QVector<qint16> samples(count);
+	const uchar * in = bytes + IMA_ADPCM_HEADER_SIZE;
+
+	for (int i = 0; i < count; i++)
+	{
+		quint8 nibble = (i & 1) ? in[i / 2] >> 4 : in[i / 2] & 0x0F;
+		samples[i] = decodeNibble(nibble, predictor, index);
+	}
+
+	return samples;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		decodeNibble
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		decodeNibble (quint8 nibble, int & predictor, int & index)
+--						quint8 nibble: The 4 bit code.
+--						int & predictor: The predictor, updated to the decoded sample.
+--						int & index: The step index, updated for the next sample.
+--
+-- RETURNS:			The decoded sample.
+----------------------------------------------------------------------------------------------------------------------*/
+qint16 ImaAdpcm::decodeNibble(quint8 nibble, int & predictor, int & index)
+{
+	int step = stepTable[index];
+	int difference = step >> 3;
+
+	if (nibble & 4)
+	{
+		difference += step;
+	}
+	if (nibble & 2)
+	{
+		difference += step >> 1;
+	}
+	if (nibble & 1)
+	{
+		difference += step >> 2;
+	}
+
+	predictor += (nibble & 8) ? -difference : difference;
+	predictor = qBound(-32768, predictor, 32767);
+	index = qBound(0, index + indexTable[nibble], 88);
+
+	return (qint16)predictor;
+}
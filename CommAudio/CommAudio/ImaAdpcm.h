@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+#include <QtEndian>
+
+// Predictor + step index + reserved byte + number of samples
+#define IMA_ADPCM_HEADER_SIZE (2 + 1 + 1 + 2)
+
+class ImaAdpcm
+{
+public:
+	static QByteArray Encode(const qint16 * samples, int count);
+	static QVector<qint16> Decode(const QByteArray & block);
+
+private:
+	static const int stepTable[89];
+	static const int indexTable[16];
+
+	static qint16 decodeNibble(quint8 nibble, int & predictor, int & index);
+};
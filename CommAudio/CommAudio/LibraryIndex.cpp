@@ -0,0 +1,1660 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		LibraryIndex.cpp - An index of the songs in a folder that is kept up to date in the background.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					LibraryScanJob(Kinds kind, const QDir & folder, const QVector<LibraryEntry> & entries,
+--						const QVector<int> & indices, QObject * parent = nullptr)
+--					void LibraryScanJob::run()
+--					void LibraryScanJob::SetRoots(const QStringList & roots, const QStringList & watched)
+--					void LibraryScanJob::Cancel()
+--					Kinds LibraryScanJob::Kind() const
+--					const QVector<LibraryEntry> & LibraryScanJob::Entries() const
+--					const QVector<int> & LibraryScanJob::Indices() const
+--					const QStringList & LibraryScanJob::Folders() const
+--					const QStringList & LibraryScanJob::Gone() const
+--					const QStringList & LibraryScanJob::Unsettled() const
+--					void LibraryScanJob::walk()
+--					void LibraryScanJob::parse()
+--					void LibraryScanJob::analyze()
+--					static bool LibraryScanJob::pathLessThan(const LibraryEntry & a, const LibraryEntry & b)
+--					static bool LibraryScanJob::IsInside(const QString & folder, const QString & root)
+--					LibraryIndex(const QDir & indexFolder, QObject * parent = nullptr)
+--					~LibraryIndex()
+--					void Open(const QDir & folder)
+--					void Scan()
+--					bool IsScanning() const
+--					bool IsAnalyzing() const
+--					QDir Folder() const
+--					const QVector<LibraryEntry> & Entries() const
+--					const LibraryEntry * Find(const QString & fileName) const
+--					bool Load(const QString & fileName)
+--					bool Save(const QString & fileName) const
+--					QString IndexFile() const
+--					void startWalk(const QStringList & roots)
+--					void watchFolders(const QStringList & folders, const QStringList & gone)
+--					void queueFolder(const QString & folder, int delay)
+--					QString relativeFolder(const QString & path) const
+--					void finishScan()
+--					void startAnalysis()
+--					void cancelAnalysis()
+--					int indexOf(const QString & path) const
+--					void jobFinishedHandler()
+--					void analysisJobFinishedHandler()
+--					void folderChangedHandler(const QString & path)
+--					void updateTimerHandler()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The folders are watched and only the ones that change are scanned
+--									again. Changes are reported as the songs that were added and removed.
+--					October 19, 2026 - agent: The loudness of every song is measured in the background and kept in
+--									the index.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The songs of a folder and every folder under it are kept in an index file along with the size and
+--					modification time of each file and the format and length of its audio. Opening a folder reads its
+--					index straight away so the song list can be shown before anything on disk has been looked at. A
+--					scan then walks the folders on a thread pool and only parses the headers of songs that are new or
+--					whose size or modification time has changed, in batches spread over the pool. When the scan is done
+--					the index is replaced and saved if anything changed.
+--
+--					While a folder is open every folder of it is watched with a QFileSystemWatcher, which uses inotify
+--					on Linux. The folders that change are gathered while changes keep arriving, so copying thousands
+--					of songs in turns into a few scans, and then only those folders are walked again. The songs that
+--					were added and removed are reported so the song list and peers can be updated without starting
+--					over.
+--
+--					Once a scan is done, the songs whose loudness has not been measured are measured on a pool of their
+--					own, LIBRARY_ANALYZE_PASS songs at a time in jobs of LIBRARY_ANALYZE_BATCH, and the index is saved
+--					after every pass. Measuring a song means decoding all of it, so this can take a while for a large
+--					folder the first time, but it is only ever done once for every song.
+--
+--					The index file is a header, a fixed size record for every song and then the paths of the songs as
+--					UTF-8, all little endian, so it can be mapped and read without a parse step:
+--						header:	"CAIX", version, number of songs, size of the paths, 4 bytes each
+--						record:	offset and length of the path, 4 bytes each, size, modification time in milliseconds
+--								and duration in microseconds, 8 bytes each, sample rate, 4 bytes, channels and sample
+--								size, 2 bytes each, then loudness and peak as 4 byte floats
+--					The records of a version 1 index stop before the loudness, so its songs are read as not measured.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "LibraryIndex.h"
+
+#define LIBRARY_INDEX_MAGIC "CAIX"
+#define LIBRARY_INDEX_VERSION 2
+#define LIBRARY_INDEX_HEADER_SIZE 16
+#define LIBRARY_INDEX_RECORD_SIZE 48
+#define LIBRARY_INDEX_V1_RECORD_SIZE 40
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		LibraryScanJob (Kinds kind, const QDir & folder, const QVector<LibraryEntry> & entries,
+--						const QVector<int> & indices, QObject * parent)
+--						Kinds kind: Whether the job walks the folder, parses songs or measures their loudness.
+--						const QDir & folder: The song folder being scanned.
+--						const QVector<LibraryEntry> & entries: For a walk, the songs that were in the index before.
+--							For a parse or an analysis, the songs to parse or measure.
+--						const QVector<int> & indices: For a parse, where each song goes in the scanned list.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The job is not deleted by the thread pool, the LibraryIndex takes its results and deletes it when
+--					it finishes.
+----------------------------------------------------------------------------------------------------------------------*/
+LibraryScanJob::LibraryScanJob(Kinds kind, const QDir & folder, const QVector<LibraryEntry> & entries,
+	const QVector<int> & indices, QObject * parent)
+	: QObject(parent)
+	, mKind(kind)
+	, mFolder(folder)
+	, mEntries(entries)
+	, mIndices(indices)
+	, mCancelled(0)
+{
+	setAutoDelete(false);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::run
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Runs loudness analyses.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		run ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs on a thread of the pool. finished is emitted from that thread and so reaches the LibraryIndex
+--					through its event loop.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryScanJob::run()
+{
+	if (mKind == Kinds::Walk)
+	{
+		walk();
+	}
+	else if (mKind == Kinds::Parse)
+	{
+		parse();
+	}
+	else
+	{
+		analyze();
+	}
+
+	emit finished();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::SetRoots
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetRoots (const QStringList & roots, const QStringList & watched)
+--						const QStringList & roots: The folders to walk, relative to the song folder.
+--						const QStringList & watched: Every folder that is being watched.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Makes a walk only look at the songs directly in the given folders rather than the whole song
+--					folder. Sub folders that are already watched are left alone, since they report their own changes,
+--					new ones are walked all the way down.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryScanJob::SetRoots(const QStringList & roots, const QStringList & watched)
+{
+	mRoots = roots;
+	mWatched = watched;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::Cancel
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Cancel ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Makes an analysis stop before the next song it would measure. It still emits finished, and the
+--					songs it did not get to are left as they were. Can be called from any thread.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryScanJob::Cancel()
+{
+	mCancelled.storeRelease(1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::Kind
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Kind ()
+--
+-- RETURNS:			Whether the job walks the folder, parses songs or measures their loudness.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+LibraryScanJob::Kinds LibraryScanJob::Kind() const
+{
+	return mKind;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::Entries
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Entries ()
+--
+-- RETURNS:			The songs of the job.
+--
+-- NOTES:
+--					Once a walk has finished these are every song in the folder. Once a parse has finished these are
+--					the songs it was given with their format filled in.
+----------------------------------------------------------------------------------------------------------------------*/
+const QVector<LibraryEntry> & LibraryScanJob::Entries() const
+{
+	return mEntries;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::Indices
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Indices ()
+--
+-- RETURNS:			Positions in the scanned list of songs.
+--
+-- NOTES:
+--					Once a walk has finished these are the songs that need to be parsed. For a parse they are where
+--					each of its songs goes.
+----------------------------------------------------------------------------------------------------------------------*/
+const QVector<int> & LibraryScanJob::Indices() const
+{
+	return mIndices;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::Folders
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Folders ()
+--
+-- RETURNS:			The folders a walk looked in, relative to the song folder.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const QStringList & LibraryScanJob::Folders() const
+{
+	return mFolders;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::Gone
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Gone ()
+--
+-- RETURNS:			The folders a walk was asked to look in that no longer exist.
+--
+-- NOTES:
+--					Every song that was in one of them or under one of them has been removed.
+----------------------------------------------------------------------------------------------------------------------*/
+const QStringList & LibraryScanJob::Gone() const
+{
+	return mGone;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::Unsettled
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Unsettled ()
+--
+-- RETURNS:			The folders that have songs that were written to in the last LIBRARY_WATCH_SETTLE_MS.
+--
+-- NOTES:
+--					A song that is still being copied in has been indexed as it was part way through, so its folder
+--					needs to be looked at again once it has settled.
+----------------------------------------------------------------------------------------------------------------------*/
+const QStringList & LibraryScanJob::Unsettled() const
+{
+	return mUnsettled;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::walk
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Can walk only the folders that changed. Notes the folders it saw.
+--					October 19, 2026 - agent: New songs start out with their loudness not measured.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		walk ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Lists every song under the folder, sorted by path. A song whose path, size and modification time
+--					match the old index keeps what was known about it, every other song is noted as needing a parse.
+--					Only the directory entries are read here, no song is opened. When the walk has roots, only the
+--					songs of the folders it looks in are matched and the rest of the old index is kept as it was.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryScanJob::walk()
+{
+	bool full = mRoots.isEmpty();
+	QSet<QString> watched = QSet<QString>::fromList(mWatched);
+	QStringList pending = full ? QStringList(QString()) : mRoots;
+	QSet<QString> walked;
+	qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+	QVector<LibraryEntry> found;
+	while (!pending.isEmpty())
+	{
+		QString folder = pending.takeLast();
+		QFileInfo folderInfo(mFolder.absoluteFilePath(folder));
+
+		if (!folderInfo.isDir())
+		{
+			mGone.append(folder);
+			continue;
+		}
+
+		if (walked.contains(folder))
+		{
+			continue;
+		}
+
+		walked.insert(folder);
+		mFolders.append(folder);
+
+		QDirIterator it(folderInfo.absoluteFilePath(), SUPPORTED_FORMATS,
+			QDir::Files | QDir::AllDirs | QDir::NoDotAndDotDot);
+		while (it.hasNext())
+		{
+			it.next();
+			QFileInfo info = it.fileInfo();
+			QString path = mFolder.relativeFilePath(info.filePath());
+
+			// Links are not followed so a link back up the tree can not make the walk go round forever
+			if (info.isDir())
+			{
+				if (!info.isSymLink() && (full || !watched.contains(path)))
+				{
+					pending.append(path);
+				}
+				continue;
+			}
+
+			LibraryEntry entry;
+			entry.path = path;
+			entry.size = info.size();
+			entry.modified = info.lastModified().toMSecsSinceEpoch();
+			entry.duration = 0;
+			entry.sampleRate = 0;
+			entry.channels = 0;
+			entry.sampleSize = 0;
+			entry.loudness = std::numeric_limits<float>::quiet_NaN();
+			entry.peak = std::numeric_limits<float>::quiet_NaN();
+
+			qint64 age = now - entry.modified;
+			if (age >= 0 && age < LIBRARY_WATCH_SETTLE_MS && !mUnsettled.contains(folder))
+			{
+				mUnsettled.append(folder);
+			}
+
+			found.append(entry);
+		}
+	}
+
+	// The old songs in the folders that were looked at are matched against what was found, the rest are kept
+	QHash<QString, int> known;
+	QVector<LibraryEntry> songs;
+	songs.reserve(mEntries.size() + found.size());
+
+	for (int i = 0; i < mEntries.size(); i++)
+	{
+		QString folder = mEntries[i].path.section('/', 0, -2);
+		bool seen = full || walked.contains(folder);
+
+		for (int g = 0; g < mGone.size() && !seen; g++)
+		{
+			seen = IsInside(folder, mGone[g]);
+		}
+
+		if (seen)
+		{
+			known.insert(mEntries[i].path, i);
+		}
+		else
+		{
+			songs.append(mEntries[i]);
+		}
+	}
+
+	QSet<QString> changed;
+	for (int i = 0; i < found.size(); i++)
+	{
+		QHash<QString, int>::const_iterator old = known.constFind(found[i].path);
+		if (old != known.constEnd() && mEntries[*old].size == found[i].size
+			&& mEntries[*old].modified == found[i].modified)
+		{
+			songs.append(mEntries[*old]);
+		}
+		else
+		{
+			changed.insert(found[i].path);
+			songs.append(found[i]);
+		}
+	}
+
+	std::sort(songs.begin(), songs.end(), pathLessThan);
+
+	mIndices.clear();
+	for (int i = 0; i < songs.size() && !changed.isEmpty(); i++)
+	{
+		if (changed.contains(songs[i].path))
+		{
+			mIndices.append(i);
+		}
+	}
+
+	mEntries = songs;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::parse
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Songs that are not wav files are opened with an AudioDecoder.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		parse ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Reads the header of every song of the job with WavParser, or the metadata of a compressed song
+--					with its AudioDecoder, which does not decode any audio. A song that can not be read keeps a zero
+--					format so it is not parsed again until it changes.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryScanJob::parse()
+{
+	for (int i = 0; i < mEntries.size(); i++)
+	{
+		LibraryEntry & entry = mEntries[i];
+		QFile file(mFolder.absoluteFilePath(entry.path));
+		QAudioFormat format;
+		WavParser wav;
+
+		if (!file.open(QFile::ReadOnly))
+		{
+			continue;
+		}
+
+		if (wav.Read(file))
+		{
+			format = wav.Format();
+			entry.duration = wav.Duration();
+		}
+		else
+		{
+			uchar * view = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+			AudioDecoder * decoder = view ? AudioDecoder::Create(view, file.size()) : nullptr;
+
+			if (decoder && decoder->Open(view, file.size()))
+			{
+				format = decoder->Format();
+				entry.duration = decoder->Duration();
+			}
+
+			delete decoder;
+			if (view)
+			{
+				file.unmap(view);
+			}
+		}
+
+		if (format.sampleRate() <= 0)
+		{
+			continue;
+		}
+
+		entry.sampleRate = format.sampleRate();
+		entry.channels = format.channelCount();
+		entry.sampleSize = format.sampleSize();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::analyze
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		analyze ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Measures the loudness and peak of every song of the job with LoudnessMeter. A song that can not
+--					be read is marked with a loudness of minus infinity so it is not tried again until it changes,
+--					and is played as it is.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryScanJob::analyze()
+{
+	for (int i = 0; i < mEntries.size() && !mCancelled.loadAcquire(); i++)
+	{
+		LibraryEntry & entry = mEntries[i];
+
+		if (!LoudnessMeter::Measure(mFolder.absoluteFilePath(entry.path), &entry.loudness, &entry.peak))
+		{
+			entry.loudness = -std::numeric_limits<float>::infinity();
+			entry.peak = 0;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::pathLessThan
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		pathLessThan (const LibraryEntry & a, const LibraryEntry & b)
+--						const LibraryEntry & a: A song.
+--						const LibraryEntry & b: Another song.
+--
+-- RETURNS:			True if the path of a sorts before the path of b.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+bool LibraryScanJob::pathLessThan(const LibraryEntry & a, const LibraryEntry & b)
+{
+	return a.path < b.path;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryScanJob::IsInside
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsInside (const QString & folder, const QString & root)
+--						const QString & folder: A folder relative to the song folder.
+--						const QString & root: Another folder relative to the song folder.
+--
+-- RETURNS:			True if folder is root or is somewhere under it.
+--
+-- NOTES:
+--					The song folder itself is the empty path, which every folder is under.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LibraryScanJob::IsInside(const QString & folder, const QString & root)
+{
+	return root.isEmpty() || folder == root || folder.startsWith(root + '/');
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LibraryIndex
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Listens for changes to the watched folders.
+--					October 19, 2026 - agent: Sets up the pool of the loudness analysis.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		LibraryIndex (const QDir & indexFolder, QObject * parent)
+--						const QDir & indexFolder: The folder the index files are kept in.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The pool has a thread for every core. Scans spend most of their time waiting on the disk, so they
+--					do not hold up anything else that runs on the global pool. The loudness analysis keeps a core
+--					free, since it decodes songs flat out and the song that is playing has to be decoded too.
+----------------------------------------------------------------------------------------------------------------------*/
+LibraryIndex::LibraryIndex(const QDir & indexFolder, QObject * parent)
+	: QObject(parent)
+	, mIndexFolder(indexFolder)
+	, mParsed(0)
+	, mFullScan(false)
+	, mAnalyzed(0)
+{
+	mIndexFolder.mkpath(".");
+	mAnalysisPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+	// Changes on disk
+	mUpdateTimer.setSingleShot(true);
+	connect(&mWatcher, &QFileSystemWatcher::directoryChanged, this, &LibraryIndex::folderChangedHandler);
+	connect(&mUpdateTimer, &QTimer::timeout, this, &LibraryIndex::updateTimerHandler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~LibraryIndex
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Stops the loudness analysis.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~LibraryIndex ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Drops the jobs that have not started and waits for the running ones, since the jobs are children
+--					of the index. An unfinished scan is not saved, the next one picks up where the old index was. The
+--					analyses that are running stop after the song they are on, and whatever they measured is thrown
+--					away along with the rest of their pass.
+----------------------------------------------------------------------------------------------------------------------*/
+LibraryIndex::~LibraryIndex()
+{
+	cancelAnalysis();
+
+	mPool.clear();
+	mAnalysisPool.clear();
+	mPool.waitForDone();
+	mAnalysisPool.waitForDone();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Stops watching the folder that was open before.
+--					October 19, 2026 - agent: Abandons the loudness analysis of the folder that was open before.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Open (const QDir & folder)
+--						const QDir & folder: The song folder.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Shows the songs that were in the index of the folder the last time it was scanned, then scans it
+--					again in the background. indexChanged is emitted for the saved index before this returns, and
+--					songsChanged when the scan finds that something changed.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::Open(const QDir & folder)
+{
+	mFolder = folder;
+	mJobs.clear();
+	mEntries.clear();
+	cancelAnalysis();
+
+	// Changes to the old folder no longer matter
+	mUpdateTimer.stop();
+	mBurstTimer.invalidate();
+	mChangedFolders.clear();
+	if (!mWatcher.directories().isEmpty())
+	{
+		mWatcher.removePaths(mWatcher.directories());
+	}
+
+	Load(IndexFile());
+	emit indexChanged();
+
+	Scan();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Scan
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Walks from the top of the folder with startWalk.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Scan ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Starts walking the whole folder on the pool. A scan that is still running is abandoned, its jobs
+--					finish on their own and their results are thrown away.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::Scan()
+{
+	startWalk(QStringList());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsScanning
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsScanning ()
+--
+-- RETURNS:			True if a scan has not finished yet.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+bool LibraryIndex::IsScanning() const
+{
+	return !mJobs.isEmpty();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsAnalyzing
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsAnalyzing ()
+--
+-- RETURNS:			True if a pass of the loudness analysis has not finished yet.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+bool LibraryIndex::IsAnalyzing() const
+{
+	return !mAnalyses.isEmpty();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Folder
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Folder ()
+--
+-- RETURNS:			The song folder that is open.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+QDir LibraryIndex::Folder() const
+{
+	return mFolder;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Entries
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Entries ()
+--
+-- RETURNS:			The songs of the folder sorted by their path relative to it.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const QVector<LibraryEntry> & LibraryIndex::Entries() const
+{
+	return mEntries;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Find
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Find (const QString & fileName)
+--						const QString & fileName: The absolute path of a song.
+--
+-- RETURNS:			The song in the index, or nullptr if it is not in the open folder or not in the index yet.
+--
+-- NOTES:
+--					The pointer is only good until the entries next change.
+----------------------------------------------------------------------------------------------------------------------*/
+const LibraryEntry * LibraryIndex::Find(const QString & fileName) const
+{
+	int index = indexOf(mFolder.relativeFilePath(fileName));
+
+	return index >= 0 ? &mEntries[index] : nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Load
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Reads the loudness of every song, and version 1 indexes without it.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Load (const QString & fileName)
+--						const QString & fileName: The index file.
+--
+-- RETURNS:			True if the index was read.
+--
+-- NOTES:
+--					Maps the index file and reads the songs out of the mapping. A file that is missing, of another
+--					version or cut short is ignored as a whole and the entries are left empty, the scan that follows
+--					rebuilds it.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LibraryIndex::Load(const QString & fileName)
+{
+	mEntries.clear();
+
+	QFile file(fileName);
+	if (!file.open(QFile::ReadOnly) || file.size() < LIBRARY_INDEX_HEADER_SIZE)
+	{
+		return false;
+	}
+
+	const uchar * data = file.map(0, file.size());
+	if (data == nullptr)
+	{
+		return false;
+	}
+
+	quint32 version = qFromLittleEndian<quint32>(data + 4);
+	qint64 count = qFromLittleEndian<quint32>(data + 8);
+	qint64 pathsSize = qFromLittleEndian<quint32>(data + 12);
+	qint64 recordSize = version == 1 ? LIBRARY_INDEX_V1_RECORD_SIZE : LIBRARY_INDEX_RECORD_SIZE;
+	qint64 pathsOffset = LIBRARY_INDEX_HEADER_SIZE + count * recordSize;
+
+	if (memcmp(data, LIBRARY_INDEX_MAGIC, 4) != 0 || (version != 1 && version != LIBRARY_INDEX_VERSION)
+		|| pathsOffset + pathsSize != file.size())
+	{
+		file.unmap((uchar *)data);
+		return false;
+	}
+
+	const char * paths = (const char *)data + pathsOffset;
+	QVector<LibraryEntry> entries(count);
+
+	for (qint64 i = 0; i < count; i++)
+	{
+		const uchar * record = data + LIBRARY_INDEX_HEADER_SIZE + i * recordSize;
+		quint32 pathOffset = qFromLittleEndian<quint32>(record);
+		quint32 pathLength = qFromLittleEndian<quint32>(record + 4);
+
+		if ((qint64)pathOffset + pathLength > pathsSize)
+		{
+			file.unmap((uchar *)data);
+			return false;
+		}
+
+		LibraryEntry & entry = entries[i];
+		entry.path = QString::fromUtf8(paths + pathOffset, pathLength);
+		entry.size = qFromLittleEndian<qint64>(record + 8);
+		entry.modified = qFromLittleEndian<qint64>(record + 16);
+		entry.duration = qFromLittleEndian<qint64>(record + 24);
+		entry.sampleRate = qFromLittleEndian<quint32>(record + 32);
+		entry.channels = qFromLittleEndian<quint16>(record + 36);
+		entry.sampleSize = qFromLittleEndian<quint16>(record + 38);
+		entry.loudness = std::numeric_limits<float>::quiet_NaN();
+		entry.peak = std::numeric_limits<float>::quiet_NaN();
+
+		if (version != 1)
+		{
+			quint32 loudness = qFromLittleEndian<quint32>(record + 40);
+			quint32 peak = qFromLittleEndian<quint32>(record + 44);
+			memcpy(&entry.loudness, &loudness, sizeof(entry.loudness));
+			memcpy(&entry.peak, &peak, sizeof(entry.peak));
+		}
+	}
+
+	file.unmap((uchar *)data);
+	mEntries = entries;
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Save
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Writes the loudness of every song.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Save (const QString & fileName)
+--						const QString & fileName: The index file.
+--
+-- RETURNS:			True if the index was written.
+--
+-- NOTES:
+--					Builds the whole file in memory and writes it through a QSaveFile, so a crash part way through
+--					leaves the old index in place rather than a broken one.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LibraryIndex::Save(const QString & fileName) const
+{
+	QByteArray records;
+	QByteArray paths;
+	QDataStream out(&records, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+	out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+	for (const LibraryEntry & entry : mEntries)
+	{
+		QByteArray path = entry.path.toUtf8();
+
+		out << (quint32)paths.size() << (quint32)path.size() << entry.size << entry.modified << entry.duration
+			<< entry.sampleRate << entry.channels << entry.sampleSize << entry.loudness << entry.peak;
+		paths.append(path);
+	}
+
+	QByteArray header(LIBRARY_INDEX_HEADER_SIZE, 0);
+	memcpy(header.data(), LIBRARY_INDEX_MAGIC, 4);
+	qToLittleEndian<quint32>(LIBRARY_INDEX_VERSION, (uchar *)header.data() + 4);
+	qToLittleEndian<quint32>(mEntries.size(), (uchar *)header.data() + 8);
+	qToLittleEndian<quint32>(paths.size(), (uchar *)header.data() + 12);
+
+	QSaveFile file(fileName);
+	if (!file.open(QFile::WriteOnly))
+	{
+		qWarning() << "Could not write the library index" << fileName << file.errorString();
+		return false;
+	}
+
+	file.write(header);
+	file.write(records);
+	file.write(paths);
+
+	return file.commit();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IndexFile
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IndexFile ()
+--
+-- RETURNS:			The path of the index file of the open folder.
+--
+-- NOTES:
+--					Every song folder has its own index file, named after a hash of its absolute path.
+----------------------------------------------------------------------------------------------------------------------*/
+QString LibraryIndex::IndexFile() const
+{
+	QByteArray hash = QCryptographicHash::hash(mFolder.absolutePath().toUtf8(), QCryptographicHash::Sha1);
+
+	return mIndexFolder.absoluteFilePath(QString(hash.toHex()) + ".idx");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		startWalk
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		startWalk (const QStringList & roots)
+--						const QStringList & roots: The folders to walk relative to the song folder, none for all of it.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Starts a walk on the pool. A scan that is still running is abandoned, its jobs finish on their own
+--					and their results are thrown away.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::startWalk(const QStringList & roots)
+{
+	mJobs.clear();
+	mScanned.clear();
+	mParsed = 0;
+	mFullScan = roots.isEmpty();
+
+	QStringList watched;
+	if (!mFullScan)
+	{
+		for (const QString & folder : mWatcher.directories())
+		{
+			watched.append(relativeFolder(folder));
+		}
+	}
+
+	LibraryScanJob * job = new LibraryScanJob(LibraryScanJob::Walk, mFolder, mEntries, QVector<int>(), this);
+	job->SetRoots(roots, watched);
+	connect(job, &LibraryScanJob::finished, this, &LibraryIndex::jobFinishedHandler);
+
+	mJobs.append(job);
+	mPool.start(job);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		watchFolders
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		watchFolders (const QStringList & folders, const QStringList & gone)
+--						const QStringList & folders: Folders that a walk looked in.
+--						const QStringList & gone: Folders that a walk found had been removed.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Watches every folder a walk looked in. After a walk of the whole song folder, only those folders are
+--					watched. QFileSystemWatcher stops watching a folder that is removed by itself, gone folders are
+--					let go of in case it did not.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::watchFolders(const QStringList & folders, const QStringList & gone)
+{
+	QStringList watched = mWatcher.directories();
+	QSet<QString> seen = QSet<QString>::fromList(folders);
+	QStringList stale;
+	QStringList added;
+
+	for (const QString & folder : watched)
+	{
+		QString relative = relativeFolder(folder);
+		bool removed = mFullScan && !seen.contains(relative);
+
+		for (int g = 0; g < gone.size() && !removed; g++)
+		{
+			removed = LibraryScanJob::IsInside(relative, gone[g]);
+		}
+
+		if (removed)
+		{
+			stale.append(folder);
+		}
+	}
+
+	QSet<QString> watching = QSet<QString>::fromList(watched);
+	for (const QString & folder : folders)
+	{
+		QString path = mFolder.absoluteFilePath(folder);
+		if (!watching.contains(path))
+		{
+			added.append(path);
+		}
+	}
+
+	if (!stale.isEmpty())
+	{
+		mWatcher.removePaths(stale);
+	}
+
+	if (!added.isEmpty())
+	{
+		mWatcher.addPaths(added);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		queueFolder
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		queueFolder (const QString & folder, int delay)
+--						const QString & folder: A folder that needs to be walked again, relative to the song folder.
+--						int delay: How long to wait for more changes in milliseconds.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Adds the folder to the ones that changed and puts the update off by the delay. The update keeps
+--					being put off while changes keep coming, but not past LIBRARY_WATCH_MAX_DELAY_MS from the first
+--					change, so a long copy still shows up in the song list as it goes.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::queueFolder(const QString & folder, int delay)
+{
+	if (!mChangedFolders.contains(folder))
+	{
+		mChangedFolders.append(folder);
+	}
+
+	if (!mBurstTimer.isValid())
+	{
+		mBurstTimer.start();
+	}
+
+	if (!mUpdateTimer.isActive() || mBurstTimer.elapsed() + delay < LIBRARY_WATCH_MAX_DELAY_MS)
+	{
+		mUpdateTimer.start(delay);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		relativeFolder
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		relativeFolder (const QString & path)
+--						const QString & path: The absolute path of a folder in the song folder.
+--
+-- RETURNS:			The path of the folder relative to the song folder, empty for the song folder itself.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+QString LibraryIndex::relativeFolder(const QString & path) const
+{
+	QString relative = mFolder.relativeFilePath(path);
+
+	return relative == "." ? QString() : relative;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		finishScan
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Reports the songs that were added and removed.
+--					October 19, 2026 - agent: Keeps loudness measured while the scan ran and starts measuring the
+--									songs that have not been.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		finishScan ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Replaces the entries with what the scan found and works out which songs were removed and which were
+--					added by going through the old and new lists side by side, both being sorted by path. A song that
+--					changed is both. Nothing is saved or reported when no song was added, changed or removed, which
+--					is the usual case at start up. A change that came in while the scan ran is picked up now.
+--					A song that did not change takes its loudness from the old entry, since the walk copied the entries
+--					before an analysis that finished while the scan ran had measured it.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::finishScan()
+{
+	QStringList removed;
+	QVector<int> added;
+	int o = 0;
+	int n = 0;
+
+	while (o < mEntries.size() || n < mScanned.size())
+	{
+		if (n == mScanned.size() || (o < mEntries.size() && mEntries[o].path < mScanned[n].path))
+		{
+			removed.append(mEntries[o++].path);
+		}
+		else if (o == mEntries.size() || mScanned[n].path < mEntries[o].path)
+		{
+			added.append(n++);
+		}
+		else
+		{
+			if (mEntries[o].size != mScanned[n].size || mEntries[o].modified != mScanned[n].modified)
+			{
+				removed.append(mEntries[o].path);
+				added.append(n);
+			}
+			else if (std::isnan(mScanned[n].loudness))
+			{
+				mScanned[n].loudness = mEntries[o].loudness;
+				mScanned[n].peak = mEntries[o].peak;
+			}
+			o++;
+			n++;
+		}
+	}
+
+	bool changed = !removed.isEmpty() || !added.isEmpty();
+	if (changed)
+	{
+		mEntries = mScanned;
+		Save(IndexFile());
+	}
+
+	mScanned.clear();
+
+	if (changed)
+	{
+		emit songsChanged(removed, added);
+	}
+
+	emit scanFinished(mParsed);
+
+	if (!mChangedFolders.isEmpty() && !mUpdateTimer.isActive())
+	{
+		mUpdateTimer.start(LIBRARY_WATCH_DEBOUNCE_MS);
+	}
+
+	startAnalysis();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		startAnalysis
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		startAnalysis ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Starts a pass over the next LIBRARY_ANALYZE_PASS songs that have a format and have not been
+--					measured, in jobs of LIBRARY_ANALYZE_BATCH so the pool can spread them over its threads. Nothing
+--					is started while a pass is still running, the pass starts the next one when it is done.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::startAnalysis()
+{
+	if (IsAnalyzing())
+	{
+		return;
+	}
+
+	QVector<LibraryEntry> pending;
+	for (int i = 0; i < mEntries.size() && pending.size() < LIBRARY_ANALYZE_PASS; i++)
+	{
+		if (mEntries[i].sampleRate > 0 && std::isnan(mEntries[i].loudness))
+		{
+			pending.append(mEntries[i]);
+		}
+	}
+
+	if (pending.isEmpty())
+	{
+		return;
+	}
+
+	mAnalyzed = 0;
+	mAnalysisTimer.start();
+
+	for (int first = 0; first < pending.size(); first += LIBRARY_ANALYZE_BATCH)
+	{
+		LibraryScanJob * job = new LibraryScanJob(LibraryScanJob::Analyze, mFolder,
+			pending.mid(first, LIBRARY_ANALYZE_BATCH), QVector<int>(), this);
+		connect(job, &LibraryScanJob::finished, this, &LibraryIndex::analysisJobFinishedHandler);
+
+		mAnalyses.append(job);
+		mAnalysisPool.start(job);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		cancelAnalysis
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		cancelAnalysis ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Abandons the pass that is running. Jobs that have not started are taken off the pool and the running
+--					ones stop after the song they are on. Their results are thrown away when they finish.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::cancelAnalysis()
+{
+	for (LibraryScanJob * job : mAnalyses)
+	{
+		job->Cancel();
+	}
+
+	mAnalyses.clear();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		indexOf
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		indexOf (const QString & path)
+--						const QString & path: The path of a song relative to the song folder.
+--
+-- RETURNS:			Where the song is in the entries, or -1 if it is not there.
+--
+-- NOTES:
+--					A binary search, since the entries are sorted by path.
+----------------------------------------------------------------------------------------------------------------------*/
+int LibraryIndex::indexOf(const QString & path) const
+{
+	int low = 0;
+	int high = mEntries.size();
+
+	while (low < high)
+	{
+		int middle = low + (high - low) / 2;
+		if (mEntries[middle].path < path)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return low < mEntries.size() && mEntries[low].path == path ? low : -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		jobFinishedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Watches the folders the walk looked in.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		jobFinishedHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a job of a scan finishes. When the walk finishes, the songs
+--					that need to be parsed are split into batches of LIBRARY_PARSE_BATCH and handed to the pool. When a
+--					parse finishes, its songs are put into the scanned list. The scan is done when no job is left.
+--					Folders with songs that are still being written are queued to be walked again.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::jobFinishedHandler()
+{
+	LibraryScanJob * job = (LibraryScanJob *)QObject::sender();
+	job->deleteLater();
+
+	// A job of a scan that has been abandoned
+	if (!mJobs.removeOne(job))
+	{
+		return;
+	}
+
+	if (job->Kind() == LibraryScanJob::Walk)
+	{
+		mScanned = job->Entries();
+		const QVector<int> & changed = job->Indices();
+
+		watchFolders(job->Folders(), job->Gone());
+		for (const QString & folder : job->Unsettled())
+		{
+			queueFolder(folder, LIBRARY_WATCH_SETTLE_MS);
+		}
+
+		for (int first = 0; first < changed.size(); first += LIBRARY_PARSE_BATCH)
+		{
+			QVector<int> indices = changed.mid(first, LIBRARY_PARSE_BATCH);
+			QVector<LibraryEntry> entries;
+			entries.reserve(indices.size());
+			for (int index : indices)
+			{
+				entries.append(mScanned[index]);
+			}
+
+			LibraryScanJob * parse = new LibraryScanJob(LibraryScanJob::Parse, mFolder, entries, indices, this);
+			connect(parse, &LibraryScanJob::finished, this, &LibraryIndex::jobFinishedHandler);
+
+			mJobs.append(parse);
+			mPool.start(parse);
+		}
+	}
+	else
+	{
+		const QVector<LibraryEntry> & entries = job->Entries();
+		const QVector<int> & indices = job->Indices();
+
+		for (int i = 0; i < indices.size(); i++)
+		{
+			mScanned[indices[i]] = entries[i];
+		}
+
+		mParsed += entries.size();
+	}
+
+	if (mJobs.isEmpty())
+	{
+		finishScan();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		analysisJobFinishedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		analysisJobFinishedHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a job of the loudness analysis finishes. The songs it
+--					measured are put into the entries, unless they have changed or gone since. When the last job of
+--					the pass is done the index is saved, analysisFinished is emitted with how many songs the pass
+--					measured and how long it took, and the next pass is started.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::analysisJobFinishedHandler()
+{
+	LibraryScanJob * job = (LibraryScanJob *)QObject::sender();
+	job->deleteLater();
+
+	// A job of an analysis that has been abandoned
+	if (!mAnalyses.removeOne(job))
+	{
+		return;
+	}
+
+	for (const LibraryEntry & measured : job->Entries())
+	{
+		int index = indexOf(measured.path);
+		if (index >= 0 && mEntries[index].size == measured.size && mEntries[index].modified == measured.modified)
+		{
+			mEntries[index].loudness = measured.loudness;
+			mEntries[index].peak = measured.peak;
+		}
+	}
+
+	mAnalyzed += job->Entries().size();
+
+	if (mAnalyses.isEmpty())
+	{
+		Save(IndexFile());
+		emit analysisFinished(mAnalyzed, mAnalysisTimer.elapsed());
+
+		startAnalysis();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		folderChangedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		folderChangedHandler (const QString & path)
+--						const QString & path: The folder that changed.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a song or folder is added to, removed from or renamed in a
+--					watched folder, or the folder itself is removed. The folder is queued to be walked again once the
+--					changes have been quiet for LIBRARY_WATCH_DEBOUNCE_MS.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::folderChangedHandler(const QString & path)
+{
+	queueFolder(relativeFolder(path), LIBRARY_WATCH_DEBOUNCE_MS);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		updateTimerHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		updateTimerHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the changes to the song folder have been quiet for long
+--					enough. Every folder that changed is walked in one scan. When a scan is already running this waits
+--					for it, finishScan starts the timer again.
+----------------------------------------------------------------------------------------------------------------------*/
+void LibraryIndex::updateTimerHandler()
+{
+	if (IsScanning() || mChangedFolders.isEmpty())
+	{
+		return;
+	}
+
+	QStringList folders = mChangedFolders;
+	mChangedFolders.clear();
+	mBurstTimer.invalidate();
+
+	startWalk(folders);
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "AudioDecoder.h"
+#include "globals.h"
+#include "LoudnessMeter.h"
+#include "WavParser.h"
+
+// A song in the library. The format is left at zero when the file is not a song that can be played
+struct LibraryEntry
+{
+	QString path;
+	qint64 size;
+	qint64 modified;
+	qint64 duration;
+	quint32 sampleRate;
+	quint16 channels;
+	quint16 sampleSize;
+
+	// The loudness of the song in LUFS and its loudest sample, NaN until it has been measured and minus infinity when
+	// it could not be read or is silent
+	float loudness;
+	float peak;
+};
+
+// One piece of a scan that runs on the thread pool of a LibraryIndex
+class LibraryScanJob : public QObject, public QRunnable
+{
+	Q_OBJECT
+
+public:
+	enum Kinds
+	{
+		Walk,
+		Parse,
+		Analyze
+	};
+
+	LibraryScanJob(Kinds kind, const QDir & folder, const QVector<LibraryEntry> & entries,
+		const QVector<int> & indices = QVector<int>(), QObject * parent = nullptr);
+
+	void run() override;
+	void SetRoots(const QStringList & roots, const QStringList & watched);
+	void Cancel();
+	static bool IsInside(const QString & folder, const QString & root);
+
+	Kinds Kind() const;
+	const QVector<LibraryEntry> & Entries() const;
+	const QVector<int> & Indices() const;
+	const QStringList & Folders() const;
+	const QStringList & Gone() const;
+	const QStringList & Unsettled() const;
+
+private:
+	Kinds mKind;
+	QDir mFolder;
+	QVector<LibraryEntry> mEntries;
+	QVector<int> mIndices;
+
+	// The folders a walk starts from, none for the whole song folder, and what it found out about folders
+	QStringList mRoots;
+	QStringList mWatched;
+	QStringList mFolders;
+	QStringList mGone;
+	QStringList mUnsettled;
+
+	// Set when the results of an analysis are no longer wanted, so it stops before its next song
+	QAtomicInt mCancelled;
+
+	void walk();
+	void parse();
+	void analyze();
+	static bool pathLessThan(const LibraryEntry & a, const LibraryEntry & b);
+
+signals:
+	void finished();
+};
+
+class LibraryIndex : public QObject
+{
+	Q_OBJECT
+
+public:
+	LibraryIndex(const QDir & indexFolder, QObject * parent = nullptr);
+	~LibraryIndex();
+
+	void Open(const QDir & folder);
+	void Scan();
+	bool IsScanning() const;
+	bool IsAnalyzing() const;
+
+	QDir Folder() const;
+	const QVector<LibraryEntry> & Entries() const;
+	const LibraryEntry * Find(const QString & fileName) const;
+
+	bool Load(const QString & fileName);
+	bool Save(const QString & fileName) const;
+	QString IndexFile() const;
+
+private:
+	QDir mIndexFolder;
+	QDir mFolder;
+	QVector<LibraryEntry> mEntries;
+
+	// The scan in progress, which replaces the entries once every job of it has finished
+	QThreadPool mPool;
+	QList<LibraryScanJob *> mJobs;
+	QVector<LibraryEntry> mScanned;
+	int mParsed;
+	bool mFullScan;
+
+	// The loudness analysis, which measures the songs that have not been measured a pass at a time on a pool of its
+	// own, so it never holds up a scan
+	QThreadPool mAnalysisPool;
+	QList<LibraryScanJob *> mAnalyses;
+	QElapsedTimer mAnalysisTimer;
+	int mAnalyzed;
+
+	// Folders that changed on disk since the last scan, gathered until the changes stop coming
+	QFileSystemWatcher mWatcher;
+	QTimer mUpdateTimer;
+	QElapsedTimer mBurstTimer;
+	QStringList mChangedFolders;
+
+	void startWalk(const QStringList & roots);
+	void watchFolders(const QStringList & folders, const QStringList & gone);
+	void queueFolder(const QString & folder, int delay);
+	QString relativeFolder(const QString & path) const;
+	void finishScan();
+	void startAnalysis();
+	void cancelAnalysis();
+	int indexOf(const QString & path) const;
+
+private slots:
+	void jobFinishedHandler();
+	void analysisJobFinishedHandler();
+	void folderChangedHandler(const QString & path);
+	void updateTimerHandler();
+
+signals:
+	void indexChanged();
+	void songsChanged(const QStringList & removed, const QVector<int> & added);
+	void scanFinished(int parsed);
+	void analysisFinished(int songs, qint64 elapsed);
+};
\ No newline at end of file
@@ -0,0 +1,369 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		LoudnessMeter.cpp - Measures the loudness of songs so they can all be played as loud.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					LoudnessMeter(int sampleRate, int channels)
+--					void Add(const qint16 * in, int frames)
+--					double Loudness() const
+--					double Peak() const
+--					static bool Measure(const QString & fileName, float * loudness, float * peak)
+--					static int Gain(float loudness, float peak)
+--					static void kWeighting(int sampleRate, double * coefs)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The loudness of a song is measured the way ITU-R BS.1770 does it, which is what EBU R 128 and
+--					ReplayGain 2 are built on. Every channel goes through the K-weighting filters, a shelf that
+--					stands in for the head and a high pass that leaves out the lowest bass, and the mean square of
+--					what comes out is kept for every LOUDNESS_STEP_MS step. Overlapping blocks of LOUDNESS_BLOCK_STEPS
+--					steps are then gated, first against LOUDNESS_ABSOLUTE_GATE to leave out silence and then against
+--					the loudness of the blocks that are left to leave out quiet passages, and the loudness is that of
+--					the blocks that pass both. The surround channels of a 5.1 or 7.1 song count for 1.41 times as
+--					much and the LFE channel not at all.
+--
+--					Only the mean square of every step is kept, 80 bytes a second of audio, so a whole song can be
+--					gated once it has been read.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "LoudnessMeter.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		LoudnessMeter
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		LoudnessMeter (int sampleRate, int channels)
+--						int sampleRate: The sample rate of the song.
+--						int channels: The number of channels of the song.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Works out the K-weighting filters for the sample rate of the song, since they are only given for
+--					48 kHz.
+----------------------------------------------------------------------------------------------------------------------*/
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels)
+	: mChannels(channels)
+	, mStepFrames(qMax(1, sampleRate * LOUDNESS_STEP_MS / 1000))
+	, mState(channels * 4, 0)
+	, mWeights(channels, 1.0)
+	, mSquares(channels, 0)
+	, mFilled(0)
+	, mMinimum(0)
+	, mMaximum(0)
+{
+	kWeighting(sampleRate, mCoefs);
+
+	// Channels in the order of a wav file: front left and right, centre, LFE, then the surrounds
+	if (channels >= 6)
+	{
+		mWeights[3] = 0;
+		for (int c = 4; c < channels; c++)
+		{
+			mWeights[c] = 1.41;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Add
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Add (const qint16 * in, int frames)
+--						const qint16 * in: The next frames of the song.
+--						int frames: The number of frames.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Filters the frames with AudioKernels::KWeight a step at a time and finds the loudest sample with
+--					AudioKernels::Peaks. A step can be split across two calls. A step that is not full when the song
+--					ends is left out, just like a block would be.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoudnessMeter::Add(const qint16 * in, int frames)
+{
+	quint64 unused = 0;
+	AudioKernels::Peaks(in, frames * mChannels, &mMinimum, &mMaximum, &unused);
+
+	for (int first = 0; first < frames;)
+	{
+		int length = qMin(mStepFrames - mFilled, frames - first);
+		AudioKernels::KWeight(in + first * mChannels, length, mChannels, mCoefs, mState.data(), mSquares.data());
+
+		first += length;
+		mFilled += length;
+		if (mFilled == mStepFrames)
+		{
+			double energy = 0;
+			for (int c = 0; c < mChannels; c++)
+			{
+				energy += mWeights[c] * mSquares[c] / mStepFrames;
+				mSquares[c] = 0;
+			}
+
+			mSteps.append(energy);
+			mFilled = 0;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Loudness
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Loudness ()
+--
+-- RETURNS:			The integrated loudness of what has been added in LUFS, or minus infinity if it was too short or
+--					too quiet to have a block that passes the gates.
+--
+-- NOTES:
+--					The energy of a block is the mean of the energies of its steps, which are in 16 bit units and
+--					scaled down to full scale only at the end.
+----------------------------------------------------------------------------------------------------------------------*/
+double LoudnessMeter::Loudness() const
+{
+	const double fullScale = 32768.0 * 32768.0;
+	int blocks = mSteps.size() - LOUDNESS_BLOCK_STEPS + 1;
+
+	if (blocks <= 0)
+	{
+		return -std::numeric_limits<double>::infinity();
+	}
+
+	QVector<double> energies(blocks);
+	double window = 0;
+	for (int i = 0; i < mSteps.size(); i++)
+	{
+		window += mSteps[i];
+		if (i >= LOUDNESS_BLOCK_STEPS)
+		{
+			window -= mSteps[i - LOUDNESS_BLOCK_STEPS];
+		}
+
+		if (i >= LOUDNESS_BLOCK_STEPS - 1)
+		{
+			energies[i - LOUDNESS_BLOCK_STEPS + 1] = window / LOUDNESS_BLOCK_STEPS;
+		}
+	}
+
+	double gate = std::pow(10.0, (LOUDNESS_ABSOLUTE_GATE + 0.691) / 10.0) * fullScale;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		double sum = 0;
+		int count = 0;
+
+		for (double energy : energies)
+		{
+			if (energy > gate)
+			{
+				sum += energy;
+				count++;
+			}
+		}
+
+		if (count == 0)
+		{
+			return -std::numeric_limits<double>::infinity();
+		}
+
+		if (pass == 1)
+		{
+			return -0.691 + 10.0 * std::log10(sum / count / fullScale);
+		}
+
+		gate = qMax(gate, sum / count * std::pow(10.0, -LOUDNESS_RELATIVE_GATE / 10.0));
+	}
+
+	return -std::numeric_limits<double>::infinity();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Peak
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Peak ()
+--
+-- RETURNS:			The loudest sample that has been added, where 1 is full scale.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+double LoudnessMeter::Peak() const
+{
+	return qMax(-(int)mMinimum, (int)mMaximum) / 32768.0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Measure
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Measure (const QString & fileName, float * loudness, float * peak)
+--						const QString & fileName: The song to measure.
+--						float * loudness: Set to the loudness of the song in LUFS.
+--						float * peak: Set to the loudest sample of the song.
+--
+-- RETURNS:			True if the song could be read.
+--
+-- NOTES:
+--					Reads through the whole song once with a SongReader. This runs on a thread of a pool and touches
+--					nothing but the song.
+----------------------------------------------------------------------------------------------------------------------*/
+bool LoudnessMeter::Measure(const QString & fileName, float * loudness, float * peak)
+{
+	SongReader reader;
+	if (!reader.Open(fileName))
+	{
+		return false;
+	}
+
+	LoudnessMeter meter(reader.Format().sampleRate(), reader.Format().channelCount());
+	QVector<qint16> samples(LOUDNESS_CHUNK_FRAMES * reader.Format().channelCount());
+
+	for (;;)
+	{
+		int count = reader.Read(samples.data(), LOUDNESS_CHUNK_FRAMES);
+		if (count <= 0)
+		{
+			break;
+		}
+
+		meter.Add(samples.constData(), count);
+	}
+
+	*loudness = (float)meter.Loudness();
+	*peak = (float)meter.Peak();
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Gain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Gain (float loudness, float peak)
+--						float loudness: The loudness of a song in LUFS.
+--						float peak: The loudest sample of the song.
+--
+-- RETURNS:			The gain to play the song with in 8.8 fixed point, 256 to play it as it is.
+--
+-- NOTES:
+--					Turns the song up or down to LOUDNESS_TARGET_LUFS. A song is turned up by no more than
+--					LOUDNESS_MAX_BOOST_DB and only as far as its loudest sample can go without clipping. A song whose
+--					loudness is not known, because it has not been measured yet, could not be read or is silent, is
+--					played as it is.
+----------------------------------------------------------------------------------------------------------------------*/
+int LoudnessMeter::Gain(float loudness, float peak)
+{
+	if (!std::isfinite(loudness))
+	{
+		return 256;
+	}
+
+	double gain = qMin(LOUDNESS_TARGET_LUFS - loudness, LOUDNESS_MAX_BOOST_DB);
+	if (peak > 0)
+	{
+		gain = qMin(gain, qMax(0.0, -20.0 * std::log10((double)peak)));
+	}
+
+	return qBound(1, qRound(256 * std::pow(10.0, gain / 20.0)), 32767);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		kWeighting
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		kWeighting (int sampleRate, double * coefs)
+--						int sampleRate: The sample rate of the song.
+--						double * coefs: Set to b0, b1, b2, a1 and a2 of the shelf, then of the high pass.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Both filters are designed from their analog prototypes with the bilinear transform. The centre
+--					frequencies, gain and Q are the ones that give the coefficients BS.1770 lists for 48 kHz, so the
+--					filters match it exactly there and have the same response at every other rate.
+----------------------------------------------------------------------------------------------------------------------*/
+void LoudnessMeter::kWeighting(int sampleRate, double * coefs)
+{
+	const double pi = 3.14159265358979323846;
+
+	// The shelf, +4 dB above about 1.5 kHz
+	double k = std::tan(pi * 1681.974450955533 / sampleRate);
+	double q = 0.7071752369554196;
+	double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+	double vb = std::pow(vh, 0.4996667741545416);
+	double a0 = 1.0 + k / q + k * k;
+
+	coefs[0] = (vh + vb * k / q + k * k) / a0;
+	coefs[1] = 2.0 * (k * k - vh) / a0;
+	coefs[2] = (vh - vb * k / q + k * k) / a0;
+	coefs[3] = 2.0 * (k * k - 1.0) / a0;
+	coefs[4] = (1.0 - k / q + k * k) / a0;
+
+	// The high pass, at about 38 Hz
+	k = std::tan(pi * 38.13547087602444 / sampleRate);
+	q = 0.5003270373238773;
+	a0 = 1.0 + k / q + k * k;
+
+	coefs[5] = 1.0;
+	coefs[6] = -2.0;
+	coefs[7] = 1.0;
+	coefs[8] = 2.0 * (k * k - 1.0) / a0;
+	coefs[9] = (1.0 - k / q + k * k) / a0;
+}
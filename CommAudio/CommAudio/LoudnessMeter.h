@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include <cmath>
+#include <limits>
+
+#include "AudioDecoder.h"
+#include "AudioKernels.h"
+#include "globals.h"
+
+// Measures how loud a song is as a whole, as ITU-R BS.1770 and EBU R 128 do, and how loud its loudest sample is
+class LoudnessMeter
+{
+public:
+	LoudnessMeter(int sampleRate, int channels);
+
+	void Add(const qint16 * in, int frames);
+	double Loudness() const;
+	double Peak() const;
+
+	static bool Measure(const QString & fileName, float * loudness, float * peak);
+	static int Gain(float loudness, float peak);
+
+private:
+	int mChannels;
+	int mStepFrames;
+	double mCoefs[10];
+	QVector<double> mState;
+	QVector<double> mWeights;
+
+	// The squares of the step being filled, and the weighted mean square of every step that has been filled
+	QVector<double> mSquares;
+	int mFilled;
+	QVector<double> mSteps;
+
+	qint16 mMinimum;
+	qint16 mMaximum;
+
+	static void kWeighting(int sampleRate, double * coefs);
+};
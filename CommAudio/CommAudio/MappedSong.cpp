@@ -0,0 +1,515 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		MappedSong.cpp - A read only QIODevice that plays a local song straight out of a mapping of it.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					MappedSong(const QString & fileName, QObject * parent = nullptr)
+--					~MappedSong()
+--					bool open(OpenMode mode)
+--					void close()
+--					bool isSequential() const
+--					qint64 size() const
+--					bool seek(qint64 pos)
+--					bool atEnd() const
+--					qint64 bytesAvailable() const
+--					QString fileName() const
+--					const uchar * Data() const
+--					void SetAudio(qint64 start, qint64 end, int frameBytes)
+--					void Prefetch(qint64 bytes)
+--					qint64 readData(char * data, qint64 maxSize)
+--					qint64 writeData(const char * data, qint64 maxSize)
+--					void willNeed(qint64 position, qint64 bytes)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Playing a song from a QFile costs a read call and a copy out of the buffer of the file every time
+--					the audio output pulls, and every seek throws that buffer away. This device maps the whole file
+--					once instead. A read is a copy out of the mapping and a seek only moves the position, which is
+--					kept to whole frames inside the audio so a seek never lands between the bytes of a sample.
+--
+--					The mapping is marked as read in order, and the system is asked to load the next
+--					MAPPED_SONG_READ_AHEAD bytes whenever the position comes within half of that of the end of what
+--					was asked for last, so the pages are in memory before the output gets to them. A seek asks for the
+--					pages at its new position straight away. This is madvise on Unix and PrefetchVirtualMemory on
+--					Windows 8 and later; without either the mapping still works, the pages are just loaded as they are
+--					first touched.
+--
+--					A file that can not be mapped, such as one too big for the address space of a 32 bit build, is
+--					read through the QFile instead.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "MappedSong.h"
+
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		MappedSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		MappedSong (const QString & fileName, QObject * parent)
+--						const QString & fileName: The song to play.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+MappedSong::MappedSong(const QString & fileName, QObject * parent)
+	: QIODevice(parent)
+	, mFile(fileName)
+	, mView(nullptr)
+	, mStart(0)
+	, mEnd(0)
+	, mFrameBytes(1)
+	, mAdvised(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~MappedSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~MappedSong ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Unmaps the song if it is still open.
+----------------------------------------------------------------------------------------------------------------------*/
+MappedSong::~MappedSong()
+{
+	close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		open (OpenMode mode)
+--						OpenMode mode: Has to be ReadOnly.
+--
+-- RETURNS:			True if the song could be opened, otherwise false.
+--
+-- NOTES:
+--					Opens and maps the song. Until SetAudio is called the whole file counts as audio, so the chunks at
+--					the start can be read to find where the audio really is. The device is unbuffered since the
+--					mapping already is a buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MappedSong::open(OpenMode mode)
+{
+	if ((mode & WriteOnly) || !mFile.open(QFile::ReadOnly))
+	{
+		return false;
+	}
+
+	mStart = 0;
+	mEnd = mFile.size();
+	mFrameBytes = 1;
+	mAdvised = 0;
+	mView = mEnd > 0 ? mFile.map(0, mEnd) : nullptr;
+
+#if defined(Q_OS_UNIX)
+	if (mView)
+	{
+		madvise((void *)mView, mEnd, MADV_SEQUENTIAL);
+	}
+#endif
+
+	return QIODevice::open(ReadOnly | Unbuffered);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		close
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		close ()
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void MappedSong::close()
+{
+	if (mView)
+	{
+		mFile.unmap(mView);
+		mView = nullptr;
+	}
+
+	mFile.close();
+	QIODevice::close();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		isSequential
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		isSequential ()
+--
+-- RETURNS:			False, the song can be seeked.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MappedSong::isSequential() const
+{
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		size
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		size ()
+--
+-- RETURNS:			The size of the whole file.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 MappedSong::size() const
+{
+	return mFile.size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		seek
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		seek (qint64 pos)
+--						qint64 pos: The position to move to.
+--
+-- RETURNS:			True if the position is in the file, otherwise false.
+--
+-- NOTES:
+--					A position inside the audio is moved back to the start of its frame. The pages at the new position
+--					are asked for before the output reads them.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MappedSong::seek(qint64 pos)
+{
+	if (pos > mStart && pos < mEnd)
+	{
+		pos -= (pos - mStart) % mFrameBytes;
+	}
+
+	if (!QIODevice::seek(pos))
+	{
+		return false;
+	}
+
+	willNeed(pos, MAPPED_SONG_READ_AHEAD);
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		atEnd
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		atEnd ()
+--
+-- RETURNS:			True once the position has reached the end of the audio.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MappedSong::atEnd() const
+{
+	return pos() >= mEnd;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		bytesAvailable
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bytesAvailable ()
+--
+-- RETURNS:			The number of bytes of audio left to read.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 MappedSong::bytesAvailable() const
+{
+	return qMax<qint64>(0, mEnd - pos()) + QIODevice::bytesAvailable();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		fileName
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		fileName ()
+--
+-- RETURNS:			The file name of the song.
+----------------------------------------------------------------------------------------------------------------------*/
+QString MappedSong::fileName() const
+{
+	return mFile.fileName();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Data
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Data ()
+--
+-- RETURNS:			The mapping of the whole file, or nullptr if the file is not open or could not be mapped.
+--
+-- NOTES:
+--					Songs that are decoded as they are read return nullptr too, since what they read is not what is
+--					in the file.
+----------------------------------------------------------------------------------------------------------------------*/
+const uchar * MappedSong::Data() const
+{
+	return mView;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetAudio
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetAudio (qint64 start, qint64 end, int frameBytes)
+--						qint64 start: Where the audio starts in the file.
+--						qint64 end: Where the audio ends in the file.
+--						int frameBytes: The size of one frame of the audio.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Reads stop at the end of the audio, so chunks after it are never played, and seeks inside it keep
+--					to whole frames.
+----------------------------------------------------------------------------------------------------------------------*/
+void MappedSong::SetAudio(qint64 start, qint64 end, int frameBytes)
+{
+	mStart = qBound<qint64>(0, start, size());
+	mEnd = qBound<qint64>(mStart, end, size());
+	mFrameBytes = qMax(1, frameBytes);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Prefetch
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Prefetch (qint64 bytes)
+--						qint64 bytes: How much to load from the position.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Asks for the pages ahead of the position without waiting for them, so a song that is queued to
+--					play next starts without touching the disk.
+----------------------------------------------------------------------------------------------------------------------*/
+void MappedSong::Prefetch(qint64 bytes)
+{
+	willNeed(pos(), bytes);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readData (char * data, qint64 maxSize)
+--						char * data: The buffer to fill.
+--						qint64 maxSize: The size of the buffer.
+--
+-- RETURNS:			The number of bytes read, 0 at the end of the audio.
+--
+-- NOTES:
+--					Copies out of the mapping and keeps the read ahead going. A file that is not mapped is read
+--					through the QFile.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 MappedSong::readData(char * data, qint64 maxSize)
+{
+	qint64 position = pos();
+	qint64 count = qMin(maxSize, mEnd - position);
+
+	if (count <= 0)
+	{
+		return 0;
+	}
+
+	if (!mView)
+	{
+		if (mFile.pos() != position)
+		{
+			mFile.seek(position);
+		}
+
+		return mFile.read(data, count);
+	}
+
+	memcpy(data, mView + position, count);
+
+	if (position + count + MAPPED_SONG_READ_AHEAD / 2 > mAdvised)
+	{
+		willNeed(position + count, MAPPED_SONG_READ_AHEAD);
+	}
+
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		writeData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeData (const char * data, qint64 maxSize)
+--						const char * data: Unused.
+--						qint64 maxSize: Unused.
+--
+-- RETURNS:			-1, the song can not be written to.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 MappedSong::writeData(const char * data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		willNeed
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		willNeed (qint64 position, qint64 bytes)
+--						qint64 position: The start of the part of the file that is about to be read.
+--						qint64 bytes: The size of that part.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The start is moved back to a multiple of MAPPED_SONG_ALIGN, which is a multiple of the page size
+--					everywhere, since the system only takes whole pages. Neither call waits for the disk.
+----------------------------------------------------------------------------------------------------------------------*/
+void MappedSong::willNeed(qint64 position, qint64 bytes)
+{
+	if (!mView)
+	{
+		return;
+	}
+
+	qint64 start = position - position % MAPPED_SONG_ALIGN;
+	qint64 end = qMin(position + bytes, size());
+
+	if (end <= start)
+	{
+		return;
+	}
+
+	mAdvised = end;
+
+#if defined(Q_OS_UNIX)
+	madvise((void *)(mView + start), end - start, MADV_WILLNEED);
+#elif defined(Q_OS_WIN) && _WIN32_WINNT >= 0x0602
+	WIN32_MEMORY_RANGE_ENTRY range = { mView + start, (SIZE_T)(end - start) };
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QFile>
+#include <QIODevice>
+#include <QString>
+#include <QtGlobal>
+
+#include "globals.h"
+
+class MappedSong : public QIODevice
+{
+	Q_OBJECT
+
+public:
+	MappedSong(const QString & fileName, QObject * parent = nullptr);
+	~MappedSong();
+
+	bool open(OpenMode mode) override;
+	void close() override;
+	bool isSequential() const override;
+	qint64 size() const override;
+	bool seek(qint64 pos) override;
+	bool atEnd() const override;
+	qint64 bytesAvailable() const override;
+
+	QString fileName() const;
+	virtual const uchar * Data() const;
+	void SetAudio(qint64 start, qint64 end, int frameBytes);
+	void Prefetch(qint64 bytes);
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+	qint64 writeData(const char * data, qint64 maxSize) override;
+
+private:
+	QFile mFile;
+	uchar * mView;
+	qint64 mStart;
+	qint64 mEnd;
+	int mFrameBytes;
+	qint64 mAdvised;
+
+	void willNeed(qint64 position, qint64 bytes);
+};
\ No newline at end of file
@@ -1,673 +1,1565 @@
-/*------------------------------------------------------------------------------------------------------------------
--- SOURCE FILE:		MediaPlayer.cpp - An wrapper for QAudioOutput that adds common audio player functionality.
---
--- PROGRAM:			CommAudio
---
--- FUNCTIONS:
---					MediaPlayer(Ui::CommAudioClass * ui, QWidget * parent = nullptr)
---					~MediaPlayer()
---					void SetSong(QString absoluteFileName)
---					void StartStream(QIODevice * stream)
---					void SetDirAndSong(QDir songDir, QTreeWidgetItem *currSong)
---					void UpdateSongList(QList<QTreeWidgetItem *> songList)
---					void Play()
---					void Pause()
---					void Stop()
---					PlayerState State()
---					int GetDuration()
---					void playSongButtonHandler()
---					void prevSongButtonHandler()
---					void nextSongButtonHandler()
---					void changeVolumeHandler(int volume)
---					void seekPositionHandler(int position)
---					void songStateChangeHandler(QAudio::State state)
---					void songProgressHandler()
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- NOTES:
---					This is a class that encapsulates the QAudioInput with other media player functions.
-----------------------------------------------------------------------------------------------------------------------*/
-#include "MediaPlayer.h"
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		MediaPlayer
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---					Angus Lam
---					Benny Wang
---
--- INTERFACE:		MediaPlayer (Ui::CommAudioClass * ui, QWidget * parent)
---						Ui::CommAudioClass * ui: A reference Qt ui object.
---						QWidget * parent: A reference to the QWidget parent.
---
--- RETURNS:			N/A
---
--- NOTES:
---					This is the cosntructor for the MediaPlayer. The default audio format and UI buttons are set here.
-----------------------------------------------------------------------------------------------------------------------*/
-MediaPlayer::MediaPlayer(Ui::CommAudioClass * ui, QWidget * parent)
-	: ui(ui)
-	, mSongHeader(new WavHeader)
-	, mSongFormat(new QAudioFormat())
-	, mSong(new QFile())
-	, mState(PlayerState::StoppedState)
-	, mStream(nullptr)
-{
-	memset(mSongHeader, 0, sizeof(WavHeader));
-
-	mSongFormat->setSampleRate(44100);
-	mSongFormat->setSampleSize(16);
-	mSongFormat->setChannelCount(2);
-	mSongFormat->setCodec("audio/pcm");
-	mSongFormat->setByteOrder(QAudioFormat::LittleEndian);
-	mSongFormat->setSampleType(QAudioFormat::SignedInt);
-
-	QAudioDeviceInfo info(QAudioDeviceInfo::defaultOutputDevice());
-	if (!info.isFormatSupported(*mSongFormat)) {
-		qWarning() << "Raw audio format not supported by backend, cannot play audio.";
-		return;
-	}
-
-	mPlayer = new QAudioOutput(*mSongFormat, this);
-	mPlayer->setNotifyInterval(1000);
-	mPlayer->setVolume(1);
-
-	// Configure the media player
-	// Set volume
-	connect(ui->sliderVolume, &QSlider::sliderMoved, this, &MediaPlayer::changeVolumeHandler);
-	// Song state changed
-	connect(mPlayer, &QAudioOutput::stateChanged, this, &MediaPlayer::songStateChangeHandler);
-	// Song progress
-	connect(mPlayer, &QAudioOutput::notify, this, &MediaPlayer::songProgressHandler);
-
-	// Audio Control Buttons
-	connect(ui->btnPlaySong, &QPushButton::pressed, this, &MediaPlayer::playSongButtonHandler);
-	connect(ui->btnPrevSong, &QPushButton::pressed, this, &MediaPlayer::prevSongButtonHandler);
-	connect(ui->btnNextSong, &QPushButton::pressed, this, &MediaPlayer::nextSongButtonHandler);
-
-	// Seeking
-	connect(ui->sliderProgress, &QSlider::sliderMoved, this, &MediaPlayer::seekPositionHandler);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		SetDirAndSong
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		SetDirAndSong (QDir songDir, QTreeWidgetItem *currSong)
---						QDir songDir: The directory where the local songs are.
---						QTreeWidgetItem *currSong: The current song that is selected.
---
--- RETURNS:			N/A
---
--- NOTES:
---					A setter method that sets both the current directory and current song.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::SetDirAndSong(QDir songDir, QTreeWidgetItem *currSong)
-{
-	mCurrentDir = songDir;
-	mCurrentSong = currSong;
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		SetSong
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		SetSong (QString absoluteFilename)
---						QString absoluteFilename: The absolte file name for the song.
---
--- RETURNS:			N/A
---
--- NOTES:
---					Loads the song for the MediaPlayer to play when the play button is pressed.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::SetSong(QString absoluteFilename)
-{
-	Stop();
-
-	mSong->close();
-	delete mSong;
-
-	mSong = new QFile(absoluteFilename);
-	mSong->open(QFile::ReadOnly);
-
-	// Grab song header
-	mSong->read((char *)mSongHeader, sizeof(WavHeader));
-	mSong->seek(0);
-
-	// Grab song format
-	mSongFormat->setSampleRate(mSongHeader->sampleRate);
-	mSongFormat->setChannelCount(mSongHeader->channels);
-	mSongFormat->setSampleSize(mSongHeader->bitsPerSample);
-	if (mSongHeader->pcm)
-	{
-		mSongFormat->setCodec("audio/pcm");
-	}
-	mSongFormat->setByteOrder(QAudioFormat::LittleEndian);
-	mSongFormat->setSampleType(QAudioFormat::UnSignedInt);
-
-	// Change the label
-	qint64 totalSeconds = GetDuration();
-	qint64 seconds = totalSeconds % 60;;
-	qint64 minutes = (totalSeconds - (totalSeconds % 60)) / 60;
-	QString totalTimeText = QString("%1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
-
-	ui->labelCurrentSong->setText("Currently Playing: " + mSong->fileName());
-	ui->labelCurrentTime->setText("00:00");
-	ui->labelTotalTime->setText(totalTimeText);
-
-	// Change slider max
-	ui->sliderProgress->setMaximum(totalSeconds);
-	ui->sliderProgress->setSliderPosition(0);
-
-	mSourceType = SourceType::Song;
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		StartStream
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		StartStream (QIODevice * stream)
---						QIODevice * stream: The stream of the song.
---
--- RETURNS:			N/A
---
--- NOTES:
---					Starts playing the stream of the song that was requested by the user.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::StartStream(QIODevice * stream)
-{
-	mStream = stream;
-	mPlayer->stop();
-	mPlayer->start(mStream);
-	mState = PlayerState::PlayingState;
-	mSourceType = SourceType::Stream;
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		Play
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		Play ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					Starts playing the song that is loading by SetSong().
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::Play()
-{
-	if (mSong->isOpen())
-	{
-		mPlayer->start(mSong);
-		mState = PlayerState::PlayingState;
-		mSourceType = SourceType::Song;
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		Pause
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		Pause ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					If a song is being played, the song is pause in its current position. If a stream is being played,
---					the stream is stopped.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::Pause()
-{
-	if (mSourceType == SourceType::Song)
-	{
-		mPlayer->suspend();
-		mState = PlayerState::StoppedState;
-	}
-	else 
-	{
-		mPlayer->stop();
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		Stop
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		Stop ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					If a song is being played, the song is stopped and the position is set back at 0. If a stream is
---					being played, the stream is closed and its memory is cleaned up.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::Stop()
-{
-	mPlayer->stop();
-	mState = PlayerState::StoppedState;
-
-	if (mSourceType == SourceType::Song)
-	{
-		mSong->seek(0);
-	}
-	else
-	{
-		if (mStream != nullptr)
-		{
-			mStream->close();
-			delete mStream;
-		}
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		State
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		State ()
---
--- RETURNS:			The state of the MediaPlayer as a Media::PlayerState enum.
---
--- NOTES:
---					Returns the current state of the MediaPlayer.
-----------------------------------------------------------------------------------------------------------------------*/
-MediaPlayer::PlayerState MediaPlayer::State()
-{
-	return mState;
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		GetDuration
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		GetDuration ()
---
--- RETURNS:			The duration of the current song.
---
--- NOTES:
---					If a song is being played, gets the duration of the current song, otherwise 1.
-----------------------------------------------------------------------------------------------------------------------*/
-int MediaPlayer::GetDuration()
-{
-	if (mSourceType == SourceType::Stream)
-	{
-		return 1;
-	}
-
-	return mSongHeader->totalLength / mSongHeader->bytesPerSecond;
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		changeVolumeHandler
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		changeVolumeHandler ()
---
--- RETURN:			void
---
--- NOTES:
---					This is a Qt slot that is triggered when the user drags the volume slider. The volume is set to
---					the position of the volume slider.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::changeVolumeHandler(int position)
-{
-	double volume = (double)position / (double)100;
-	mPlayer->setVolume(volume);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		playSongButtonHandler
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		playSongButtonHandler ()
---
--- RETURN:			void
---
--- NOTES:
---					This is a Qt slot that is triggerd when the user pressed the play button. If the player is stopped
---					the player is then started. Likewise, if the player is playing then the player is stopped.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::playSongButtonHandler()
-{
-	switch (mPlayer->state())
-	{
-	case QAudio::ActiveState:
-		Pause();
-		break;
-	case QAudio::StoppedState:
-	case QAudio::SuspendedState:
-		Play();
-		break;
-	default:
-		break;
-	}
-}
-
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		prevSongButtonHandler
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		prevSongButtonHandler ()
---
--- RETURN:			void
---
--- NOTES:
---					This is a Qt slot that is triggered when the user pressed the previous song button. If there is a
---					previous song to the currently loaded source it would be set as the current source, otherwise this
---					function does nothing.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::prevSongButtonHandler()
-{
-	if (songList.size() == 0)
-	{
-		return;
-	}
-
-	int index = songList.indexOf(mCurrentSong);
-	index -= 1;
-	if (index < 0) { index = songList.size() - 1; }
-	mCurrentSong = songList[index];
-	SetSong(mCurrentDir.absoluteFilePath(mCurrentSong->text(0)));
-	Play();
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		nextSongButtonHandler
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		nextSongButtonHandler ()
---
--- RETURN:			void
---
--- NOTES:
---					This is a Qt slot that is trigged when the user pressed the nextSongButtonHandler. If there is a next
---					song to the currently loaded source it would be st as the current source, otherwise this function
---					does nothing.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::nextSongButtonHandler()
-{
-	if (songList.size() == 0)
-	{
-		return;
-	}
-	
-	int index = songList.indexOf(mCurrentSong);
-	index += 1;
-	if (index > songList.size() - 1) { index = 0; }
-	mCurrentSong = songList[index];
-	SetSong(mCurrentDir.absoluteFilePath(mCurrentSong->text(0)));
-	Play();
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		UodateSongList
---
--- DATE:			April 14, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Roger Zhang
---
--- INTERFACE:		UpdateSongList (QList<QTreeWidgetItem *> items)
---						QList<QTreeWidgetItem *> items: The list of songs.
---
--- RETURN:			void
---
--- NOTES:
---					Updates the list of songs the user sees.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::UpdateSongList(QList<QTreeWidgetItem *> items)
-{
-	songList = items;
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		seekPositionHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		seekPositionHandler (int position)
---						int position: The new position in the song.
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the user moves the position slider for the song. This 
---					function will cause the QMediaPlayer to seek to the new position in the song.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::seekPositionHandler(int position)
-{
-	if (mSourceType == SourceType::Song)
-	{
-		mSong->seek(position * mSongHeader->bytesPerSecond);
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		songStateChangedHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		songStateChangedHandler (QMediaPLayer::State state)
---						QMediaPlayer::State state: The state of the media player.
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggered when the state of the media player changes. Elements of the
---					GUI that are tied to the state of the media player will be updated to the new state.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::songStateChangeHandler(QAudio::State state)
-{
-	switch (state)
-	{
-	case QAudio::ActiveState:
-		ui->btnPlaySong->setText("Pause");
-		break;
-	case QAudio::IdleState:
-		SetSong(mSong->fileName());
-		Play();
-		break;
-	default:
-		ui->btnPlaySong->setText("Play");
-		break;
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		:songStateChangedHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		songProgressHandler ()
---
--- RETURNS:			void.		
---
--- NOTES:
---					This is a Qt slot that is triggerd when the song's progress changes. The slider that displays the
---					song's progress is updated as well as the text beside it that shows the current timestamp of the
---					song.
-----------------------------------------------------------------------------------------------------------------------*/
-void MediaPlayer::songProgressHandler()
-{
-	if (mSourceType == SourceType::Stream)
-	{
-		ui->sliderProgress->setValue(0);
-		ui->labelCurrentTime->setText("");
-		return;
-	}
-
-	int progress = ui->sliderProgress->value() + 1;
-	int maxDuration = GetDuration();
-
-	if (progress > maxDuration)
-	{
-		progress = maxDuration;
-	}
-
-	// Set label text
-	qint64 seconds = progress % 60;
-	qint64 minutes = (progress - (progress % 60)) / 60;
-
-	QString labelText = QString("%1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
-	ui->labelCurrentTime->setText(labelText);
-
-	// Update slider
-	ui->sliderProgress->setValue(progress);
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		MediaPlayer.cpp - An wrapper for QAudioOutput that adds common audio player functionality.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					MediaPlayer(Ui::CommAudioClass * ui, QWidget * parent = nullptr)
+--					~MediaPlayer()
+--					bool SetSong(QString absoluteFileName)
+--					void StartStream(QIODevice * stream, const QAudioFormat & format, qint64 length)
+--					void QueueStream(QIODevice * stream, const QAudioFormat & format, qint64 length)
+--					void StartSkipTimer()
+--					void openPlayer(const QAudioFormat & format)
+--					void startOutput()
+--					QAudioFormat outputFormat(const QAudioFormat & format) const
+--					bool openSong(MappedSong * song, WavParser * wav, QAudioFormat * format)
+--					void showSong()
+--					void clearNext()
+--					qint64 position() const
+--					qint64 songTime(qint64 offset) const
+--					int songGain(const QString & fileName) const
+--					void SetPlaylist(Playlist * playlist, const QDir * songFolder)
+--					void SetTrack(quint32 id)
+--					void PlayTrack(quint32 id)
+--					void SetLibrary(const LibraryIndex * library)
+--					void SetNormalized(bool normalized)
+--					void SetCrossfade(bool crossfade)
+--					void SetEqualizer(const QVector<float> & gains)
+--					void Play()
+--					void Pause()
+--					void Stop()
+--					PlayerState State()
+--					int GetDuration()
+--					void playSongButtonHandler()
+--					void prevSongButtonHandler()
+--					void nextSongButtonHandler()
+--					void changeVolumeHandler(int volume)
+--					void seekPositionHandler(int position)
+--					void songStateChangeHandler(QAudio::State state)
+--					void songProgressHandler()
+--					void prefetchHandler()
+--					void transitionHandler(QIODevice * previous, qint64 gap)
+--					void firstSampleHandler()
+--					void queueHandler()
+--					void releasedHandler(QIODevice * source)
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: Audio is played through a PlaybackQueue so that the next song is
+--									opened ahead of time and starts without a gap.
+--					October 19, 2026 - agent: Plays on a sink from the AudioBackend, so the player works on a
+--									machine without a sound card.
+--					October 19, 2026 - agent: Songs are opened with WavParser, which finds the audio of files with
+--									more chunks than the plain 44 byte header.
+--					October 19, 2026 - agent: Songs are played out of a mapping of the file with MappedSong.
+--					October 19, 2026 - agent: The position shown comes from how much audio the output has played.
+--					October 19, 2026 - agent: FLAC songs are decoded as they play with DecodedSong.
+--					October 19, 2026 - agent: Tells the window which song is shown so it can draw its waveform.
+--					October 19, 2026 - agent: Local songs can be played at the same loudness, from the loudness
+--									measured by the LibraryIndex.
+--					October 19, 2026 - agent: Songs are picked from a Playlist instead of the items of the song
+--									list, which lets local and remote songs follow each other.
+--					October 19, 2026 - agent: Songs can crossfade into each other and be played through an
+--									equalizer.
+--					October 19, 2026 - agent: The queue is played on an AudioThread, and what it has to say is
+--									polled from the GUI thread.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- NOTES:
+--					This is a class that encapsulates the QAudioInput with other media player functions.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "MediaPlayer.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		MediaPlayer
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The player is always opened, in the nearest format the backend has.
+--					October 19, 2026 - agent: Starts without a playlist.
+--					October 19, 2026 - agent: The queue has no parent so it can move to the audio thread, and a
+--									timer polls it and shows the position.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--					Angus Lam
+--					Benny Wang
+--
+-- INTERFACE:		MediaPlayer (Ui::CommAudioClass * ui, QWidget * parent)
+--						Ui::CommAudioClass * ui: A reference Qt ui object.
+--						QWidget * parent: A reference to the QWidget parent.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the cosntructor for the MediaPlayer. The default audio format and UI buttons are set here.
+----------------------------------------------------------------------------------------------------------------------*/
+MediaPlayer::MediaPlayer(Ui::CommAudioClass * ui, QWidget * parent)
+	: ui(ui)
+	, mSongFormat(new QAudioFormat())
+	, mSong(new MappedSong(QString(), this))
+	, mSeekBase(0)
+	, mProcessedBase(0)
+	, mState(PlayerState::StoppedState)
+	, mStream(nullptr)
+	, mNextSong(nullptr)
+	, mNextStream(nullptr)
+	, mNextType(SourceType::Song)
+	, mNextTrack(0)
+	, mAudio(nullptr)
+	, mQueue(new PlaybackQueue())
+	, mPlaylist(nullptr)
+	, mSongFolder(nullptr)
+	, mLibrary(nullptr)
+	, mNormalized(false)
+{
+	// Gapless playback
+	connect(mQueue, &PlaybackQueue::prefetchNeeded, this, &MediaPlayer::prefetchHandler);
+	connect(mQueue, &PlaybackQueue::transitioned, this, &MediaPlayer::transitionHandler);
+	connect(mQueue, &PlaybackQueue::currentStarted, this, &MediaPlayer::firstSampleHandler);
+	connect(mQueue, &PlaybackQueue::released, this, &MediaPlayer::releasedHandler);
+
+	mSongFormat->setSampleRate(44100);
+	mSongFormat->setSampleSize(16);
+	mSongFormat->setChannelCount(2);
+	mSongFormat->setCodec("audio/pcm");
+	mSongFormat->setByteOrder(QAudioFormat::LittleEndian);
+	mSongFormat->setSampleType(QAudioFormat::SignedInt);
+
+	// Songs in other formats are converted by the queue, so the player is never left unopened
+	openPlayer(outputFormat(*mSongFormat));
+
+	// Song progress, and what the queue has to say from the audio thread
+	mProgressTimer.setInterval(MEDIA_PLAYER_NOTIFY_MS);
+	connect(&mProgressTimer, &QTimer::timeout, this, &MediaPlayer::queueHandler);
+	connect(&mProgressTimer, &QTimer::timeout, this, &MediaPlayer::songProgressHandler);
+	mProgressTimer.start();
+
+	// Configure the media player
+	// Set volume
+	connect(ui->sliderVolume, &QSlider::sliderMoved, this, &MediaPlayer::changeVolumeHandler);
+
+	// Audio Control Buttons
+	connect(ui->btnPlaySong, &QPushButton::pressed, this, &MediaPlayer::playSongButtonHandler);
+	connect(ui->btnPrevSong, &QPushButton::pressed, this, &MediaPlayer::prevSongButtonHandler);
+	connect(ui->btnNextSong, &QPushButton::pressed, this, &MediaPlayer::nextSongButtonHandler);
+
+	// Seeking
+	connect(ui->sliderProgress, &QSlider::sliderMoved, this, &MediaPlayer::seekPositionHandler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~MediaPlayer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~MediaPlayer ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The audio thread is stopped before the queue it plays is deleted, the same way the VoipModule lets
+--					go of its mixer. The queue releases its sources as it goes, so any that were retired are deleted.
+----------------------------------------------------------------------------------------------------------------------*/
+MediaPlayer::~MediaPlayer()
+{
+	mAudio->Stop();
+	delete mQueue;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetPlaylist
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Takes the playlist and the song folder instead of the item of the
+--									current song, and was renamed from SetDirAndSong.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetPlaylist (Playlist * playlist, const QDir * songFolder)
+--						Playlist * playlist: The songs to move between with the previous and next buttons.
+--						const QDir * songFolder: The folder the paths of local songs in the playlist are from.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The playlist and the folder are kept up to date by their owner, so the player always follows them.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::SetPlaylist(Playlist * playlist, const QDir * songFolder)
+{
+	mPlaylist = playlist;
+	mSongFolder = songFolder;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetTrack
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetTrack (quint32 id)
+--						quint32 id: The local song in the playlist that was picked.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Makes the song the current track and loads it with SetSong, ready for the play button.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::SetTrack(quint32 id)
+{
+	const PlaylistTrack * track = mPlaylist != nullptr ? mPlaylist->Track(id) : nullptr;
+	if (track == nullptr || track->IsRemote())
+	{
+		return;
+	}
+
+	mPlaylist->SetCurrent(id);
+	SetSong(mSongFolder->absoluteFilePath(track->song));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PlayTrack
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PlayTrack (quint32 id)
+--						quint32 id: The song in the playlist to play.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Makes the song the current track and starts it. A local song is opened and played straight away.
+--					A remote song can only be started by the StreamManager, so streamNeeded is emitted and the
+--					stream arrives through StartStream.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::PlayTrack(quint32 id)
+{
+	const PlaylistTrack * track = mPlaylist != nullptr ? mPlaylist->Track(id) : nullptr;
+	if (track == nullptr)
+	{
+		return;
+	}
+
+	StartSkipTimer();
+	mPlaylist->SetCurrent(id);
+
+	if (track->IsRemote())
+	{
+		mNextTrack = 0;
+		emit streamNeeded(id, false);
+		return;
+	}
+
+	if (SetSong(mSongFolder->absoluteFilePath(track->song)))
+	{
+		Play();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetSong
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: A song that was already opened ahead of time is reused.
+--					October 19, 2026 - agent: Compressed songs are opened as a DecodedSong.
+--					October 19, 2026 - agent: Forgets which track was going to play next.
+--					October 19, 2026 - agent: Tells whether the song could be opened.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		SetSong (QString absoluteFilename)
+--						QString absoluteFilename: The absolte file name for the song.
+--
+-- RETURNS:			True if the song could be opened, otherwise false.
+--
+-- NOTES:
+--					Loads the song for the MediaPlayer to play when the play button is pressed. A stream that was
+--					asked for to play next and has not arrived yet is no longer wanted. A song that can not be opened,
+--					such as a file that is not a wav file, is shown as such and Play does nothing until another song
+--					is loaded.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MediaPlayer::SetSong(QString absoluteFilename)
+{
+	Stop();
+	mNextTrack = 0;
+
+	mSong->close();
+	delete mSong;
+
+	if (mNextSong != nullptr && mNextSong->fileName() == absoluteFilename)
+	{
+		mSong = mNextSong;
+		mSongWav = mNextWav;
+		*mSongFormat = mNextFormat;
+		mNextSong = nullptr;
+	}
+	else
+	{
+		mSong = DecodedSong::Create(absoluteFilename, this);
+		if (!openSong(mSong, &mSongWav, mSongFormat))
+		{
+			mSongWav = WavParser();
+			mSourceType = SourceType::Song;
+
+			ui->labelCurrentSong->setText("Could not play: " + absoluteFilename);
+			ui->labelCurrentTime->setText("00:00");
+			ui->labelTotalTime->setText("00:00");
+			ui->sliderProgress->setMaximum(0);
+			return false;
+		}
+	}
+
+	showSong();
+
+	mSourceType = SourceType::Song;
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		openSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The chunks of the song are walked by a WavParser instead of reading a
+--									fixed header.
+--					October 19, 2026 - agent: The song is a MappedSong and its chunks are parsed in the mapping.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		openSong (MappedSong * song, WavParser * wav, QAudioFormat * format)
+--						MappedSong * song: The song to open.
+--						WavParser * wav: Set to where the audio of the song is.
+--						QAudioFormat * format: Set to the format of the song.
+--
+-- RETURNS:			True if the song could be opened, otherwise false.
+--
+-- NOTES:
+--					Opens the song and finds its audio. The song is left at the start of its audio and is told where
+--					that audio ends, so the chunks around it are never played. A song whose audio can not be found is
+--					closed again, so it is never played from its first byte in some other format.
+----------------------------------------------------------------------------------------------------------------------*/
+bool MediaPlayer::openSong(MappedSong * song, WavParser * wav, QAudioFormat * format)
+{
+	if (!song->open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	// A mapped song is parsed where it is, without reading its chunks out first
+	bool valid = song->Data() ? wav->Parse(song->Data(), song->size(), song->size()) : wav->Read(*song);
+
+	if (!valid)
+	{
+		qWarning() << song->fileName() << wav->ErrorString();
+		song->close();
+		return false;
+	}
+
+	*format = wav->Format();
+	song->SetAudio(wav->DataOffset(), wav->DataEnd(), format->bytesPerFrame());
+	song->seek(wav->DataOffset());
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		showSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The slider counts milliseconds.
+--					October 19, 2026 - agent: Emits songShown so the waveform of the song can be drawn.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		showSong ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Shows the name and length of the current song on the GUI and resets the progress slider. The
+--					slider counts milliseconds so that it moves smoothly and seeks land close to where it is dropped.
+--					songShown is emitted with the file name of the song.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::showSong()
+{
+	// Change the label
+	qint64 totalSeconds = GetDuration();
+	qint64 seconds = totalSeconds % 60;;
+	qint64 minutes = (totalSeconds - (totalSeconds % 60)) / 60;
+	QString totalTimeText = QString("%1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+
+	ui->labelCurrentSong->setText("Currently Playing: " + mSong->fileName());
+	ui->labelCurrentTime->setText("00:00");
+	ui->labelTotalTime->setText(totalTimeText);
+
+	// Change slider max
+	ui->sliderProgress->setMaximum((int)(mSongWav.Duration() / 1000));
+	ui->sliderProgress->setSliderPosition(0);
+
+	emit songShown(mSong->fileName());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		StartStream
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The output is opened in the format of the stream.
+--					October 19, 2026 - agent: The stream is played through the PlaybackQueue.
+--					October 19, 2026 - agent: Emits streamShown so the waveform of the song can be drawn.
+--					October 19, 2026 - agent: Forgets which track was going to play next.
+--					October 19, 2026 - agent: The stream is played on the AudioThread.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		StartStream (QIODevice * stream, const QAudioFormat & format, qint64 length)
+--						QIODevice * stream: The stream of the song.
+--						const QAudioFormat & format: The format of the audio in the stream.
+--						qint64 length: The number of bytes of audio in the whole stream.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Starts playing the stream of the song that was requested by the user. If the audio device can not
+--					play the format of the stream, the stream is converted to the closest format the device supports.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::StartStream(QIODevice * stream, const QAudioFormat & format, qint64 length)
+{
+	mAudio->Stop();
+	clearNext();
+
+	mStream = stream;
+	mSourceType = SourceType::Stream;
+	mNextTrack = 0;
+
+	openPlayer(outputFormat(format));
+	mQueue->SetFormat(mAudio->Format());
+	mQueue->SetCurrent(mStream, format, length);
+	startOutput();
+
+	mState = PlayerState::PlayingState;
+
+	emit streamShown();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QueueStream
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: A stream can follow a local song.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		QueueStream (QIODevice * stream, const QAudioFormat & format, qint64 length)
+--						QIODevice * stream: The stream of the next song.
+--						const QAudioFormat & format: The format of the audio in the stream.
+--						qint64 length: The number of bytes of audio in the whole stream.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Queues a stream to play as soon as the current song or stream ends. If nothing is playing by the
+--					time the next one arrives, or the user has picked another song since it was asked for, it is
+--					thrown away.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::QueueStream(QIODevice * stream, const QAudioFormat & format, qint64 length)
+{
+	if (mState != PlayerState::PlayingState || mNextType != SourceType::Stream || mNextTrack == 0)
+	{
+		stream->deleteLater();
+		return;
+	}
+
+	clearNext();
+
+	mNextStream = stream;
+	mQueue->SetNext(mNextStream, format, length);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		StartSkipTimer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		StartSkipTimer ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Starts timing how long it takes for the first sample of a new song to reach the audio device. This
+--					is called whenever the user picks a new song.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::StartSkipTimer()
+{
+	mSkipTimer.start();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		openPlayer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The output is a sink from the AudioBackend.
+--					October 19, 2026 - agent: Notifies often enough to show the position of the song smoothly.
+--					October 19, 2026 - agent: The output is an AudioThread that is made once and told the new
+--									format.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		openPlayer (const QAudioFormat & format)
+--						const QAudioFormat & format: The format the audio output needs to play.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The queue is played on an AudioThread, which is made the first time and moves the queue to itself
+--					for good. After that the thread is only told the format, which takes effect the next time it is
+--					started, so this is only called while it is stopped. The volume is kept by the thread.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::openPlayer(const QAudioFormat & format)
+{
+	if (mAudio != nullptr)
+	{
+		mAudio->SetFormat(format);
+		return;
+	}
+
+	mAudio = new AudioThread(format, mQueue, "music", this);
+
+	// Song state changed
+	connect(mAudio, &AudioThread::stateChanged, this, &MediaPlayer::songStateChangeHandler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		startOutput
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		startOutput ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Starts the audio thread playing the queue with MEDIA_PLAYER_BUFFER_MS of buffer in the device.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::startOutput()
+{
+	mAudio->Start(mAudio->Format().bytesForDuration(MEDIA_PLAYER_BUFFER_MS * 1000));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		outputFormat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Asks the AudioBackend, which takes any format when headless.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		outputFormat (const QAudioFormat & format)
+--						const QAudioFormat & format: The format of the audio that will be played.
+--
+-- RETURNS:			The format to open the audio output in.
+--
+-- NOTES:
+--					Returns the format itself if the audio device can play it, otherwise the closest format that the
+--					device does support.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat MediaPlayer::outputFormat(const QAudioFormat & format) const
+{
+	return AudioBackend::NearestFormat(format, QAudio::AudioOutput);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Play
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The song stops at the end of its data chunk rather than the end of
+--									the file.
+--					October 19, 2026 - agent: The position of the song is counted from where playing starts.
+--					October 19, 2026 - agent: The song is played with the gain that evens out its loudness.
+--					October 19, 2026 - agent: Only a song that SetSong could open is played.
+--					October 19, 2026 - agent: The output is always started over, from where Pause left the song.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		Play ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Starts playing the song that is loading by SetSong(). A paused song is resumed where it left off,
+--					since Pause leaves the song at what was played. The queue is built again every time, because a
+--					stream may have left the output in a different format, so a stream that was queued next is
+--					dropped and asked for again when it is needed.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::Play()
+{
+	if (mSong->isOpen() && mSongWav.IsValid())
+	{
+		mAudio->Stop();
+		clearNext();
+
+		openPlayer(outputFormat(*mSongFormat));
+		mQueue->SetFormat(mAudio->Format());
+		mQueue->SetCurrent(mSong, *mSongFormat, mSongWav.DataEnd(), songGain(mSong->fileName()));
+		startOutput();
+
+		mSeekBase = songTime(mSong->pos());
+		mProcessedBase = mAudio->ProcessedUSecs();
+
+		mState = PlayerState::PlayingState;
+		mSourceType = SourceType::Song;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Pause
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: Stops the AudioThread and moves the song back to what was played.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		Pause ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					If a song is being played, the song is pause in its current position. If a stream is being played,
+--					the stream is stopped. The output throws away what it had buffered when it stops, so the song is
+--					seeked back to the position the output had played to, after anything the queue did up to then has
+--					been polled.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::Pause()
+{
+	mAudio->Stop();
+	mQueue->Poll();
+
+	if (mSourceType == SourceType::Song)
+	{
+		qint64 frame = position() * mSongFormat->sampleRate() / 1000000;
+		mSong->seek(mSongWav.DataOffset() + frame * mSongFormat->bytesPerFrame());
+		mState = PlayerState::StoppedState;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Stop
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The song goes back to where its audio starts rather than after a
+--									fixed header.
+--					October 19, 2026 - agent: The position shown goes back to the start of the song.
+--					October 19, 2026 - agent: Stops the AudioThread, and drops the next stream before the queue
+--									releases it.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		Stop ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					If a song is being played, the song is stopped and the position is set back at the start of its
+--					audio. If a stream is being played, the stream is closed and its memory is cleaned up. Anything
+--					queued to play next is dropped.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::Stop()
+{
+	mAudio->Stop();
+	mState = PlayerState::StoppedState;
+
+	clearNext();
+	mQueue->Clear();
+
+	if (mSourceType == SourceType::Song)
+	{
+		mSong->seek(mSongWav.DataOffset());
+		mSeekBase = 0;
+		mProcessedBase = mAudio->ProcessedUSecs();
+	}
+	else
+	{
+		if (mStream != nullptr)
+		{
+			mStream->close();
+			delete mStream;
+			mStream = nullptr;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		clearNext
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The stream is deleted once the queue releases it.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		clearNext ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Throws away a stream that was queued to play next. The audio thread may still be reading it, so it
+--					is only deleted by releasedHandler once the queue hands it back. A song that was opened ahead of
+--					time is kept open since SetSong can still use it.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::clearNext()
+{
+	if (mNextStream != nullptr)
+	{
+		mRetired.append(mNextStream);
+		mNextStream = nullptr;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		position
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		position ()
+--
+-- RETURNS:			Where the current song is in microseconds.
+--
+-- NOTES:
+--					The position is where the song was last seeked to plus how much audio the output has played since.
+--					The output stops counting while it is stopped, so a paused song does not move on, and it counts
+--					in time rather than bytes, so the answer is the same when the queue converts the song to another
+--					format. It is kept within the length of the song.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 MediaPlayer::position() const
+{
+	if (mSourceType == SourceType::Stream)
+	{
+		return 0;
+	}
+
+	qint64 played = mSeekBase + mAudio->ProcessedUSecs() - mProcessedBase;
+
+	return qBound<qint64>(0, played, mSongWav.Duration());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		songTime
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		songTime (qint64 offset)
+--						qint64 offset: An offset into the file of the current song.
+--
+-- RETURNS:			How far into the audio of the song the offset is in microseconds.
+--
+-- NOTES:
+--					Counts whole frames from the start of the data chunk. This is worked out in 64 bits rather than
+--					with QAudioFormat::durationForBytes, which takes a 32 bit count and overflows past 2 GB.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 MediaPlayer::songTime(qint64 offset) const
+{
+	qint64 frames = (offset - mSongWav.DataOffset()) / mSongFormat->bytesPerFrame();
+
+	return frames * 1000000 / mSongFormat->sampleRate();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		songGain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		songGain (const QString & fileName)
+--						const QString & fileName: The absolute path of a local song.
+--
+-- RETURNS:			The gain to play the song with in 8.8 fixed point, 256 to play it as it is.
+--
+-- NOTES:
+--					Looks the song up in the library index and works the gain out from its loudness with
+--					LoudnessMeter::Gain. Songs are played as they are when normalizing is off, and so are songs that
+--					are not in the index or have not been measured yet.
+----------------------------------------------------------------------------------------------------------------------*/
+int MediaPlayer::songGain(const QString & fileName) const
+{
+	if (!mNormalized || mLibrary == nullptr)
+	{
+		return 256;
+	}
+
+	const LibraryEntry * entry = mLibrary->Find(fileName);
+
+	return entry ? LoudnessMeter::Gain(entry->loudness, entry->peak) : 256;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		State
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		State ()
+--
+-- RETURNS:			The state of the MediaPlayer as a Media::PlayerState enum.
+--
+-- NOTES:
+--					Returns the current state of the MediaPlayer.
+----------------------------------------------------------------------------------------------------------------------*/
+MediaPlayer::PlayerState MediaPlayer::State()
+{
+	return mState;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		GetDuration
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The duration comes from the size of the data chunk instead of the
+--									size of the file.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		GetDuration ()
+--
+-- RETURNS:			The duration of the current song.
+--
+-- NOTES:
+--					If a song is being played, gets the duration of the current song, otherwise 1.
+----------------------------------------------------------------------------------------------------------------------*/
+int MediaPlayer::GetDuration()
+{
+	if (mSourceType == SourceType::Stream)
+	{
+		return 1;
+	}
+
+	return (int)(mSongWav.Duration() / 1000000);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		changeVolumeHandler
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		changeVolumeHandler ()
+--
+-- RETURN:			void
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user drags the volume slider. The volume is set to
+--					the position of the volume slider.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::changeVolumeHandler(int position)
+{
+	double volume = (double)position / (double)100;
+	mAudio->SetVolume(volume);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		playSongButtonHandler
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		playSongButtonHandler ()
+--
+-- RETURN:			void
+--
+-- NOTES:
+--					This is a Qt slot that is triggerd when the user pressed the play button. If the player is stopped
+--					the player is then started. Likewise, if the player is playing then the player is stopped.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::playSongButtonHandler()
+{
+	if (mAudio->isRunning())
+	{
+		Pause();
+	}
+	else
+	{
+		StartSkipTimer();
+		Play();
+	}
+}
+
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		prevSongButtonHandler
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The previous song comes from the playlist.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--
+-- INTERFACE:		prevSongButtonHandler ()
+--
+-- RETURN:			void
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user pressed the previous song button. If there is a
+--					previous song to the currently loaded source it would be set as the current source, otherwise this
+--					function does nothing.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::prevSongButtonHandler()
+{
+	if (mPlaylist == nullptr)
+	{
+		return;
+	}
+
+	PlayTrack(mPlaylist->Previous());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		nextSongButtonHandler
+--
+-- DATE:			April 14, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The next song comes from the playlist.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Roger Zhang
+--
+-- INTERFACE:		nextSongButtonHandler ()
+--
+-- RETURN:			void
+--
+-- NOTES:
+--					This is a Qt slot that is trigged when the user pressed the nextSongButtonHandler. If there is a next
+--					song to the currently loaded source it would be st as the current source, otherwise this function
+--					does nothing.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::nextSongButtonHandler()
+{
+	if (mPlaylist == nullptr)
+	{
+		return;
+	}
+
+	PlayTrack(mPlaylist->Next(true));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetLibrary
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetLibrary (const LibraryIndex * library)
+--						const LibraryIndex * library: The index of the song folder.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The loudness of local songs is looked up in the index whenever a song is queued.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::SetLibrary(const LibraryIndex * library)
+{
+	mLibrary = library;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetNormalized
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetNormalized (bool normalized)
+--						bool normalized: True to play every song at the same loudness.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Turns normalizing on or off. The song that is playing and the one queued after it change gain from
+--					the next read on, so the change is heard straight away. Streams are always played as they are.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::SetNormalized(bool normalized)
+{
+	mNormalized = normalized;
+
+	mQueue->SetGain(mSong, songGain(mSong->fileName()));
+	if (mNextSong != nullptr)
+	{
+		mQueue->SetGain(mNextSong, songGain(mNextSong->fileName()));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetCrossfade
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetCrossfade (bool crossfade)
+--						bool crossfade: True to fade each song into the next one, false to play them back to back.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Turns crossfading on or off. Songs fade over CROSSFADE_MS, and a song that is skipped to still starts
+--					straight away.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::SetCrossfade(bool crossfade)
+{
+	mQueue->SetCrossfade(crossfade ? CROSSFADE_MS : 0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetEqualizer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetEqualizer (const QVector<float> & gains)
+--						const QVector<float> & gains: The gain in dB of every band at EQUALIZER_FREQUENCIES.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Sets the bands of the equalizer that everything played goes through, from the next read on.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::SetEqualizer(const QVector<float> & gains)
+{
+	mQueue->SetEqualizer(gains);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		seekPositionHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: Seeks from where the audio of the song starts.
+--					October 19, 2026 - agent: A seek only moves the position in the mapping of the song.
+--					October 19, 2026 - agent: The position is in milliseconds and lands on a whole frame.
+--					October 19, 2026 - agent: The song is only seeked while the AudioThread is stopped.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		seekPositionHandler (int position)
+--						int position: The new position in the song in milliseconds.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user moves the position slider for the song. This 
+--					function will cause the QMediaPlayer to seek to the new position in the song. The position is
+--					turned into a whole number of frames from the start of the audio, so a seek never lands in the
+--					middle of a sample or in the chunks before the audio. What the output has played so far is noted so
+--					that the position shown afterwards counts on from where the seek landed. The audio thread reads the
+--					song, so it is stopped for the seek and started again if it was playing.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::seekPositionHandler(int position)
+{
+	if (mSourceType == SourceType::Song)
+	{
+		bool playing = mAudio->isRunning();
+		mAudio->Stop();
+
+		qint64 frame = (qint64)position * mSongFormat->sampleRate() / 1000;
+		mSong->seek(mSongWav.DataOffset() + frame * mSongFormat->bytesPerFrame());
+
+		if (playing)
+		{
+			startOutput();
+		}
+
+		mSeekBase = songTime(mSong->pos());
+		mProcessedBase = mAudio->ProcessedUSecs();
+
+		songProgressHandler();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		songStateChangedHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: A finished song is no longer reopened here, the queue has
+--									already moved on to the next song.
+--					October 19, 2026 - agent: Connected to the AudioThread the queue plays on.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		songStateChangedHandler (QMediaPLayer::State state)
+--						QMediaPlayer::State state: The state of the media player.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the state of the media player changes. Elements of the
+--					GUI that are tied to the state of the media player will be updated to the new state. The state
+--					comes from the output on the audio thread through the event loop.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::songStateChangeHandler(QAudio::State state)
+{
+	switch (state)
+	{
+	case QAudio::ActiveState:
+		ui->btnPlaySong->setText("Pause");
+		break;
+	case QAudio::IdleState:
+		// The queue moves on to the next song by itself, going idle only means it has run out of audio
+		break;
+	default:
+		ui->btnPlaySong->setText("Play");
+		break;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		:songStateChangedHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: Shows the position the output has really played to instead of
+--									counting notifies.
+--					October 19, 2026 - agent: Triggered by a timer on the GUI thread.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		songProgressHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggerd every MEDIA_PLAYER_NOTIFY_MS. The slider that displays the
+--					song's progress is updated as well as the text beside it that shows the current timestamp of the
+--					song. The slider is left alone while the user is dragging it.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::songProgressHandler()
+{
+	if (mSourceType == SourceType::Stream)
+	{
+		ui->sliderProgress->setValue(0);
+		ui->labelCurrentTime->setText("");
+		return;
+	}
+
+	qint64 current = position();
+	qint64 progress = current / 1000000;
+
+	// Set label text
+	qint64 seconds = progress % 60;
+	qint64 minutes = (progress - (progress % 60)) / 60;
+
+	QString labelText = QString("%1:%2").arg(minutes, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+	ui->labelCurrentTime->setText(labelText);
+
+	// Update slider
+	if (!ui->sliderProgress->isSliderDown())
+	{
+		ui->sliderProgress->setValue((int)(current / 1000));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		prefetchHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The next song stops at the end of its data chunk.
+--					October 19, 2026 - agent: The start of the next song is loaded into its mapping.
+--					October 19, 2026 - agent: Compressed songs are opened as a DecodedSong.
+--					October 19, 2026 - agent: The next song is queued with the gain that evens out its loudness.
+--					October 19, 2026 - agent: The next song comes from the playlist, and a local song and a stream
+--									can follow each other.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		prefetchHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered a few seconds before the current song or stream ends. The
+--					next track comes from the playlist. A local song is opened and the start of it is read into
+--					memory. For a remote song the stream is asked for with streamNeeded since only the StreamManager
+--					can start it, and it arrives through QueueStream. When the current song is not in the playlist
+--					it is played again, and when the playlist has come to its end nothing is queued.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::prefetchHandler()
+{
+	if (mQueue->HasNext())
+	{
+		return;
+	}
+
+	quint32 id = mPlaylist != nullptr ? mPlaylist->Next(false) : 0;
+	const PlaylistTrack * track = mPlaylist != nullptr ? mPlaylist->Track(id) : nullptr;
+	QString fileName = mSong->fileName();
+
+	if (track != nullptr && track->IsRemote())
+	{
+		mNextType = SourceType::Stream;
+		mNextTrack = id;
+		emit streamNeeded(id, true);
+		return;
+	}
+
+	if (track != nullptr)
+	{
+		fileName = mSongFolder->absoluteFilePath(track->song);
+	}
+	else if (mSourceType == SourceType::Stream || (mPlaylist != nullptr && mPlaylist->Current() != 0))
+	{
+		return;
+	}
+
+	if (mNextSong != nullptr)
+	{
+		mNextSong->close();
+		delete mNextSong;
+	}
+
+	mNextSong = DecodedSong::Create(fileName, this);
+	if (!openSong(mNextSong, &mNextWav, &mNextFormat))
+	{
+		delete mNextSong;
+		mNextSong = nullptr;
+		return;
+	}
+
+	// Loading the start of the song now means its first reads do not touch the disk
+	mNextSong->Prefetch(mNextFormat.bytesForDuration(PREFETCH_SECONDS * 1000000));
+	mNextType = SourceType::Song;
+	mNextTrack = id;
+
+	mQueue->SetNext(mNextSong, mNextFormat, mNextWav.DataEnd(), songGain(fileName));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		transitionHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The position of the next song is counted from the transition.
+--					October 19, 2026 - agent: Emits streamShown when the next stream starts.
+--					October 19, 2026 - agent: The next track becomes the current track of the playlist, and a song
+--									can follow a stream and the other way round.
+--					October 19, 2026 - agent: The position of a song that was faded into counts the fade.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		transitionHandler (QIODevice * previous, qint64 gap)
+--						QIODevice * previous: The song or stream that just ended.
+--						qint64 gap: How long the audio device was left without audio in milliseconds.
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the PlaybackQueue moves on to the next song. The song that
+--					ended is cleaned up, the next song becomes the current song and the gap is shown in the status bar.
+--					A song is shown with showSong, and streamShown is emitted for a stream. A stream that ended is
+--					let go of as soon as anything follows it, while a local song that ended is kept until the next
+--					local song replaces it.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::transitionHandler(QIODevice * previous, qint64 gap)
+{
+	if (previous != mSong && previous != mStream)
+	{
+		return;
+	}
+
+	bool toSong = mNextType == SourceType::Song && mNextSong != nullptr;
+	bool toStream = mNextType == SourceType::Stream && mNextStream != nullptr;
+
+	if (previous == mStream && (toSong || toStream))
+	{
+		mStream->close();
+		mStream->deleteLater();
+		mStream = nullptr;
+	}
+
+	if (toSong)
+	{
+		mSong->close();
+		mSong->deleteLater();
+
+		mSong = mNextSong;
+		mSongWav = mNextWav;
+		*mSongFormat = mNextFormat;
+		mNextSong = nullptr;
+		mSourceType = SourceType::Song;
+
+		mSeekBase = mQueue->Overlap();
+		mProcessedBase = mAudio->ProcessedUSecs();
+	}
+	else if (toStream)
+	{
+		mStream = mNextStream;
+		mNextStream = nullptr;
+		mSourceType = SourceType::Stream;
+	}
+
+	if ((toSong || toStream) && mPlaylist != nullptr)
+	{
+		mPlaylist->SetCurrent(mNextTrack);
+	}
+	mNextTrack = 0;
+
+	if (toSong)
+	{
+		showSong();
+	}
+	else if (toStream)
+	{
+		emit streamShown();
+	}
+
+	ui->statusBar->showMessage(QString("Transition gap: %1 ms").arg(gap));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		firstSampleHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		firstSampleHandler ()
+--
+-- RETURNS:			void.		
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the first audio of a song is handed to the audio device.
+--					If the user picked the song, the time since they picked it is shown in the status bar.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::firstSampleHandler()
+{
+	if (!mSkipTimer.isValid())
+	{
+		return;
+	}
+
+	ui->statusBar->showMessage(QString("Time to first sample: %1 ms").arg(mSkipTimer.elapsed()));
+	mSkipTimer.invalidate();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		queueHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		queueHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered every MEDIA_PLAYER_NOTIFY_MS. The queue cannot signal from the
+--					audio thread without taking a lock there, so what it has to say is polled, which emits the signals
+--					of the queue on the GUI thread.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::queueHandler()
+{
+	mQueue->Poll();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		releasedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		releasedHandler (QIODevice * source)
+--						QIODevice * source: A song or stream the queue no longer reads.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the queue lets go of a source. A source that was retired
+--					while the queue could still be reading it is deleted now.
+----------------------------------------------------------------------------------------------------------------------*/
+void MediaPlayer::releasedHandler(QIODevice * source)
+{
+	if (mRetired.removeOne(source))
+	{
+		source->close();
+		source->deleteLater();
+	}
 }
\ No newline at end of file
@@ -1,73 +1,138 @@
-#pragma once
-
-#include <QAudioFormat>
-#include <QAudioOutput>
-#include <QFile>
-#include <QDir>
-#include <QTcpSocket>
-#include <QWidget>
-
-#include "globals.h"
-#include "ui_CommAudio.h"
-
-class MediaPlayer : public QWidget
-{
-	Q_OBJECT
-
-public:
-	enum PlayerState
-	{
-		PlayingState,
-		StoppedState
-	};
-
-	MediaPlayer(Ui::CommAudioClass * ui, QWidget * parent = nullptr);
-	~MediaPlayer() = default;
-
-	void SetSong(QString absoluteFileName);
-	void StartStream(QIODevice * stream);
-	void SetDirAndSong(QDir songDir, QTreeWidgetItem *currSong);
-	void UpdateSongList(QList<QTreeWidgetItem *> songList);
-
-	void Play();
-	void Pause();
-	void Stop();
-	PlayerState State();
-
-	int GetDuration();
-
-private:
-	enum SourceType
-	{
-		Song,
-		Stream
-	};
-
-	Ui::CommAudioClass * ui;
-
-	PlayerState mState;
-	SourceType mSourceType;
-
-	// Song variables
-	WavHeader * mSongHeader;
-	QAudioFormat * mSongFormat;
-	QFile * mSong;
-	QIODevice * mStream;
-	QTreeWidgetItem * mCurrentSong = NULL;
-
-	QAudioOutput * mPlayer;
-	QList<QTreeWidgetItem *> songList;
-	QDir mCurrentDir = NULL;
-
-private slots:
-	void playSongButtonHandler();
-	void prevSongButtonHandler();
-	void nextSongButtonHandler();
-
-	void changeVolumeHandler(int volume);
-
-	void seekPositionHandler(int position);
-
-	void songStateChangeHandler(QAudio::State state);
-	void songProgressHandler();
-};
+#pragma once
+
+#include <QAudioFormat>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDir>
+#include <QList>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+#include "AudioBackend.h"
+#include "AudioDecoder.h"
+#include "AudioThread.h"
+#include "globals.h"
+#include "LibraryIndex.h"
+#include "LoudnessMeter.h"
+#include "MappedSong.h"
+#include "PlaybackQueue.h"
+#include "Playlist.h"
+#include "WavParser.h"
+#include "ui_CommAudio.h"
+
+class MediaPlayer : public QWidget
+{
+	Q_OBJECT
+
+public:
+	enum PlayerState
+	{
+		PlayingState,
+		StoppedState
+	};
+
+	MediaPlayer(Ui::CommAudioClass * ui, QWidget * parent = nullptr);
+	~MediaPlayer();
+
+	bool SetSong(QString absoluteFileName);
+	void StartStream(QIODevice * stream, const QAudioFormat & format, qint64 length);
+	void QueueStream(QIODevice * stream, const QAudioFormat & format, qint64 length);
+	void StartSkipTimer();
+	void SetPlaylist(Playlist * playlist, const QDir * songFolder);
+	void SetTrack(quint32 id);
+	void PlayTrack(quint32 id);
+	void SetLibrary(const LibraryIndex * library);
+	void SetNormalized(bool normalized);
+	void SetCrossfade(bool crossfade);
+	void SetEqualizer(const QVector<float> & gains);
+
+	void Play();
+	void Pause();
+	void Stop();
+	PlayerState State();
+
+	int GetDuration();
+
+private:
+	enum SourceType
+	{
+		Song,
+		Stream
+	};
+
+	Ui::CommAudioClass * ui;
+
+	PlayerState mState;
+	SourceType mSourceType;
+
+	// Song variables
+	WavParser mSongWav;
+	QAudioFormat * mSongFormat;
+	MappedSong * mSong;
+	QIODevice * mStream;
+
+	// Where in the song the player was last seeked to, and how much the output had played by then, in microseconds
+	qint64 mSeekBase;
+	qint64 mProcessedBase;
+
+	// The song or stream that has been opened ahead of time to play next, and the track it is
+	WavParser mNextWav;
+	QAudioFormat mNextFormat;
+	MappedSong * mNextSong;
+	QIODevice * mNextStream;
+	SourceType mNextType;
+	quint32 mNextTrack;
+
+	// The queue is played on the audio thread, and polled along with the position every MEDIA_PLAYER_NOTIFY_MS
+	AudioThread * mAudio;
+	PlaybackQueue * mQueue;
+	QTimer mProgressTimer;
+	QElapsedTimer mSkipTimer;
+
+	// Sources that are no longer wanted but that the queue may still be reading, deleted once it releases them
+	QList<QIODevice *> mRetired;
+
+	// What is played after what, and where the local songs in it are
+	Playlist * mPlaylist;
+	const QDir * mSongFolder;
+
+	// Where the loudness of local songs comes from, and whether songs are played at the same loudness
+	const LibraryIndex * mLibrary;
+	bool mNormalized;
+
+	void openPlayer(const QAudioFormat & format);
+	void startOutput();
+	QAudioFormat outputFormat(const QAudioFormat & format) const;
+	bool openSong(MappedSong * song, WavParser * wav, QAudioFormat * format);
+	void showSong();
+	void clearNext();
+	qint64 position() const;
+	qint64 songTime(qint64 offset) const;
+	int songGain(const QString & fileName) const;
+
+private slots:
+	void playSongButtonHandler();
+	void prevSongButtonHandler();
+	void nextSongButtonHandler();
+
+	void changeVolumeHandler(int volume);
+
+	void seekPositionHandler(int position);
+
+	void songStateChangeHandler(QAudio::State state);
+	void songProgressHandler();
+
+	void prefetchHandler();
+	void transitionHandler(QIODevice * previous, qint64 gap);
+	void firstSampleHandler();
+	void queueHandler();
+	void releasedHandler(QIODevice * source);
+
+signals:
+	void streamNeeded(quint32 track, bool prefetch);
+	void songShown(const QString & fileName);
+	void streamShown();
+};
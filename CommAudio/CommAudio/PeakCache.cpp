@@ -0,0 +1,982 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		PeakCache.cpp - Keeps the waveforms of songs on disk, for local songs and remote ones.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					PeakJob(const QString & fileName, const QString & peakFile, bool background,
+--						QObject * parent = nullptr)
+--					void PeakJob::run()
+--					const QString & PeakJob::FileName() const
+--					const PeakFile & PeakJob::Peaks() const
+--					bool PeakJob::IsBackground() const
+--					PeakCache(const QByteArray * key, QDir * source, const QDir & indexFolder,
+--						QObject * parent = nullptr)
+--					~PeakCache()
+--					void Open(const QVector<LibraryEntry> & entries)
+--					void Request(const QString & fileName)
+--					void Fetch(const QString & songName, quint32 address, const QString & owner, quint32 size,
+--						quint32 modified)
+--					static QString RemoteName(const QString & owner, const QString & songName)
+--					QString localFolder() const
+--					QString localFile(const QString & fileName) const
+--					QString localFile(const QString & path, qint64 size, qint64 modified) const
+--					QString remoteFile(const QString & song, quint32 size, quint32 modified) const
+--					void pruneRemote()
+--					void startJob(const QString & fileName, bool background)
+--					void startBackground()
+--					void reply(QTcpSocket * socket, const PeakFile & peaks)
+--					void finishFetch(QTcpSocket * socket)
+--					void jobFinishedHandler()
+--					void newConnectionHandler()
+--					void requestHandler()
+--					void peerDisconnectHandler()
+--					void replyHandler()
+--					void fetchDisconnectHandler()
+--					void fetchTimeoutHandler()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The waveforms of the songs in the song folder are kept next to the library index, in a folder
+--					named after the same hash of the song folder as its index file. Each waveform is named after a
+--					hash of the path of its song and the size and modification time it had, so a song that changes
+--					gets a new waveform and the old one is removed the next time the library has been scanned.
+--
+--					Once a scan finishes, every song without a waveform is worked out on a thread pool, one song at a
+--					time so that playing and scanning are not held up. A song that is played jumps ahead of the rest.
+--
+--					Peers ask for the waveform of a song on PEAK_PORT. The owner sends it from disk, or works it out
+--					first if it has not been done yet, leaving out the levels that are finer than a seek bar needs so
+--					it stays small. Waveforms of remote songs are kept in a folder of their own, named after the owner,
+--					path, size and modification time of the song, and only the newest PEAK_REMOTE_FILES are kept.
+--						request:	RequestPeaks, key, song name
+--						response:	RespondPeaks, length of the waveform file, then the file, or a length of 0 if
+--									the owner can not read the song
+----------------------------------------------------------------------------------------------------------------------*/
+#include "PeakCache.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeakJob
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PeakJob (const QString & fileName, const QString & peakFile, bool background, QObject * parent)
+--						const QString & fileName: The song.
+--						const QString & peakFile: Where the waveform is saved.
+--						bool background: Whether the job works through the song folder rather than for a song
+--							that is wanted now.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The job is not deleted by the thread pool, the PeakCache takes its waveform and deletes it when it
+--					finishes.
+----------------------------------------------------------------------------------------------------------------------*/
+PeakJob::PeakJob(const QString & fileName, const QString & peakFile, bool background, QObject * parent)
+	: QObject(parent)
+	, mFileName(fileName)
+	, mPeakFile(peakFile)
+	, mBackground(background)
+{
+	setAutoDelete(false);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeakJob::run
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		run ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs on a thread of the pool. The waveform is saved from there too, so the PeakCache only has to
+--					hand it on. finished is emitted whether or not the song could be read.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakJob::run()
+{
+	if (mPeaks.Compute(mFileName))
+	{
+		mPeaks.Save(mPeakFile);
+	}
+
+	emit finished();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeakJob::FileName
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FileName ()
+--
+-- RETURNS:			The song.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const QString & PeakJob::FileName() const
+{
+	return mFileName;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeakJob::Peaks
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Peaks ()
+--
+-- RETURNS:			The waveform of the song, which is not valid if the song could not be read.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const PeakFile & PeakJob::Peaks() const
+{
+	return mPeaks;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeakJob::IsBackground
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsBackground ()
+--
+-- RETURNS:			True if the job works through the song folder rather than for a song that is wanted now.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+bool PeakJob::IsBackground() const
+{
+	return mBackground;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeakCache
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PeakCache (const QByteArray * key, QDir * source, const QDir & indexFolder, QObject * parent)
+--						const QByteArray * key: A reference to the session key.
+--						QDir * source: A reference to the location of local songs.
+--						const QDir & indexFolder: The folder the library index files are kept in.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates the folder for the waveforms of remote songs, throws out the oldest ones and starts
+--					listening on the port reserved for waveforms.
+----------------------------------------------------------------------------------------------------------------------*/
+PeakCache::PeakCache(const QByteArray * key, QDir * source, const QDir & indexFolder, QObject * parent)
+	: QObject(parent)
+	, mKey(key)
+	, mSource(source)
+	, mIndexFolder(indexFolder)
+	, mBackgroundJobs(0)
+	, mServer(this)
+{
+	mIndexFolder.mkpath("remote.peaks");
+	pruneRemote();
+
+	connect(&mServer, &QTcpServer::newConnection, this, &PeakCache::newConnectionHandler);
+	mServer.listen(QHostAddress::AnyIPv4, PEAK_PORT);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~PeakCache
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~PeakCache ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Drops the jobs that have not started and waits for the running ones, since the jobs are children
+--					of the cache.
+----------------------------------------------------------------------------------------------------------------------*/
+PeakCache::~PeakCache()
+{
+	mPool.clear();
+	mPool.waitForDone();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Open (const QVector<LibraryEntry> & entries)
+--						const QVector<LibraryEntry> & entries: Every song in the song folder.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Called whenever a scan of the song folder finishes. The waveform folder is listed once and
+--					compared with the songs, rather than looking for every waveform on its own. Songs without a
+--					waveform are queued to be worked out in the background, and waveforms without a song, which
+--					belong to songs that have changed or gone, are removed.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::Open(const QVector<LibraryEntry> & entries)
+{
+	QDir folder(localFolder());
+	folder.mkpath(".");
+
+	QSet<QString> saved = QSet<QString>::fromList(folder.entryList(QStringList("*.pk"), QDir::Files));
+	mPending.clear();
+
+	for (const LibraryEntry & entry : entries)
+	{
+		if (entry.sampleRate == 0)
+		{
+			continue;
+		}
+
+		QString file = QFileInfo(localFile(entry.path, entry.size, entry.modified)).fileName();
+		if (!saved.remove(file))
+		{
+			mPending.append(mSource->absoluteFilePath(entry.path));
+		}
+	}
+
+	for (const QString & file : saved)
+	{
+		folder.remove(file);
+	}
+
+	startBackground();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Request
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Request (const QString & fileName)
+--						const QString & fileName: The absolute path of a local song.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Emits peaksReady for the song before this returns if its waveform is on disk. Otherwise it is
+--					worked out ahead of the songs waiting in the background, and peaksReady is emitted once it is done.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::Request(const QString & fileName)
+{
+	PeakFile peaks;
+	if (peaks.Load(localFile(fileName)))
+	{
+		emit peaksReady(fileName, peaks);
+		return;
+	}
+
+	if (!mJobs.contains(fileName))
+	{
+		startJob(fileName, false);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Fetch
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Fetch (const QString & songName, quint32 address, const QString & owner, quint32 size,
+--						quint32 modified)
+--						const QString & songName: The path of the song in the owner's song folder.
+--						quint32 address: The address of the owner.
+--						const QString & owner: The name of the owner.
+--						quint32 size: The file size the owner listed for the song.
+--						quint32 modified: The modification time the owner listed for the song.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Emits peaksReady for RemoteName of the song before this returns if its waveform was fetched before.
+--					Otherwise it is asked for from the owner, unless it already has been, and peaksReady is emitted
+--					once it arrives. Nothing is emitted if the owner does not answer in PEAK_FETCH_TIMEOUT.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::Fetch(const QString & songName, quint32 address, const QString & owner, quint32 size, quint32 modified)
+{
+	QString song = RemoteName(owner, songName);
+	QString file = remoteFile(song, size, modified);
+
+	PeakFile peaks;
+	if (peaks.Load(file))
+	{
+		emit peaksReady(song, peaks);
+		return;
+	}
+
+	for (const PeakFetch & fetch : mFetches)
+	{
+		if (fetch.song == song)
+		{
+			return;
+		}
+	}
+
+	QTcpSocket * socket = new QTcpSocket(this);
+
+	PeakFetch & fetch = mFetches[socket];
+	fetch.song = song;
+	fetch.file = file;
+
+	connect(socket, &QTcpSocket::readyRead, this, &PeakCache::replyHandler);
+	connect(socket, &QTcpSocket::disconnected, this, &PeakCache::fetchDisconnectHandler);
+	socket->connectToHost(QHostAddress(address), PEAK_PORT);
+
+	QByteArray request = QByteArray(1, (char)Headers::RequestPeaks);
+	request.append(*mKey);
+	request.append(songName);
+	request.resize(PEAK_REQUEST_SIZE);
+
+	socket->write(request);
+
+	// The timer belongs to the socket, so it goes away with it
+	QTimer * timer = new QTimer(socket);
+	timer->setSingleShot(true);
+	connect(timer, &QTimer::timeout, this, &PeakCache::fetchTimeoutHandler);
+	timer->start(PEAK_FETCH_TIMEOUT);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RemoteName
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RemoteName (const QString & owner, const QString & songName)
+--						const QString & owner: The name of the owner of the song.
+--						const QString & songName: The path of the song in the owner's song folder.
+--
+-- RETURNS:			The name peaksReady gives the song.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+QString PeakCache::RemoteName(const QString & owner, const QString & songName)
+{
+	return owner + ':' + songName;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		localFolder
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		localFolder ()
+--
+-- RETURNS:			The folder the waveforms of the song folder are kept in.
+--
+-- NOTES:
+--					Named after the same hash of the song folder as its index file, so it sits beside it.
+----------------------------------------------------------------------------------------------------------------------*/
+QString PeakCache::localFolder() const
+{
+	QByteArray hash = QCryptographicHash::hash(mSource->absolutePath().toUtf8(), QCryptographicHash::Sha1);
+
+	return mIndexFolder.absoluteFilePath(QString(hash.toHex()) + ".peaks");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		localFile
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		localFile (const QString & fileName)
+--						const QString & fileName: The absolute path of a local song.
+--
+-- RETURNS:			Where the waveform of the song is kept.
+--
+-- NOTES:
+--					Looks up the size and modification time of the song as it is on disk now.
+----------------------------------------------------------------------------------------------------------------------*/
+QString PeakCache::localFile(const QString & fileName) const
+{
+	QFileInfo info(fileName);
+
+	return localFile(mSource->relativeFilePath(info.absoluteFilePath()), info.size(),
+		info.lastModified().toMSecsSinceEpoch());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		localFile
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		localFile (const QString & path, qint64 size, qint64 modified)
+--						const QString & path: The path of the song relative to the song folder.
+--						qint64 size: The size of the song.
+--						qint64 modified: The modification time of the song in milliseconds, as the library index
+--							has it.
+--
+-- RETURNS:			Where the waveform of the song is kept.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+QString PeakCache::localFile(const QString & path, qint64 size, qint64 modified) const
+{
+	QByteArray name = path.toUtf8() + '\n' + QByteArray::number(size) + '\n' + QByteArray::number(modified);
+	QByteArray hash = QCryptographicHash::hash(name, QCryptographicHash::Sha1);
+
+	return QDir(localFolder()).absoluteFilePath(QString(hash.toHex()) + ".pk");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		remoteFile
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		remoteFile (const QString & song, quint32 size, quint32 modified)
+--						const QString & song: RemoteName of the song.
+--						quint32 size: The file size the owner listed for the song.
+--						quint32 modified: The modification time the owner listed for the song.
+--
+-- RETURNS:			Where the waveform of the remote song is kept.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+QString PeakCache::remoteFile(const QString & song, quint32 size, quint32 modified) const
+{
+	QByteArray name = song.toUtf8() + '\n' + QByteArray::number(size) + '\n' + QByteArray::number(modified);
+	QByteArray hash = QCryptographicHash::hash(name, QCryptographicHash::Sha1);
+
+	return mIndexFolder.absoluteFilePath("remote.peaks/" + QString(hash.toHex()) + ".pk");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		pruneRemote
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		pruneRemote ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Removes all but the newest PEAK_REMOTE_FILES waveforms of remote songs. Remote songs come and go
+--					with the session, so there is no list to compare them against like there is for local ones.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::pruneRemote()
+{
+	QDir folder(mIndexFolder.absoluteFilePath("remote.peaks"));
+	QStringList files = folder.entryList(QStringList("*.pk"), QDir::Files, QDir::Time);
+
+	for (int i = PEAK_REMOTE_FILES; i < files.size(); i++)
+	{
+		folder.remove(files[i]);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		startJob
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		startJob (const QString & fileName, bool background)
+--						const QString & fileName: The absolute path of a local song.
+--						bool background: Whether the song is one of the song folder waiting for its waveform rather
+--							than one that is wanted now.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Songs that are wanted now are given a higher priority on the pool, so they start ahead of any
+--					background job that is still queued.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::startJob(const QString & fileName, bool background)
+{
+	PeakJob * job = new PeakJob(fileName, localFile(fileName), background, this);
+	connect(job, &PeakJob::finished, this, &PeakCache::jobFinishedHandler);
+
+	mJobs[fileName] = job;
+	if (background)
+	{
+		mBackgroundJobs++;
+	}
+
+	mPool.start(job, background ? 0 : 1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		startBackground
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		startBackground ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Starts the next songs of the song folder that are waiting for their waveform, so that no more than
+--					PEAK_BACKGROUND_JOBS are worked out at once. Songs that already have a job are skipped.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::startBackground()
+{
+	while (mBackgroundJobs < PEAK_BACKGROUND_JOBS && !mPending.isEmpty())
+	{
+		QString fileName = mPending.takeFirst();
+		if (!mJobs.contains(fileName))
+		{
+			startJob(fileName, true);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		reply
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		reply (QTcpSocket * socket, const PeakFile & peaks)
+--						QTcpSocket * socket: The peer that asked for the waveform.
+--						const PeakFile & peaks: The waveform, which is not valid if the song could not be read.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Sends the levels of the waveform that have no more than PEAK_SHARE_COLUMNS columns and closes the
+--					connection once they are written.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::reply(QTcpSocket * socket, const PeakFile & peaks)
+{
+	QByteArray file = peaks.IsValid() ? peaks.Serialize(PEAK_SHARE_COLUMNS) : QByteArray();
+
+	QByteArray packet = QByteArray(1, (char)Headers::RespondPeaks);
+	packet << (quint32)file.size();
+	packet.append(file);
+
+	socket->write(packet);
+	socket->disconnectFromHost();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		finishFetch
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		finishFetch (QTcpSocket * socket)
+--						QTcpSocket * socket: The connection to the owner of the song.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Forgets the fetch and closes its connection. The socket is disconnected from the cache first, so
+--					closing it does not come back here.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::finishFetch(QTcpSocket * socket)
+{
+	if (!mFetches.remove(socket))
+	{
+		return;
+	}
+
+	socket->disconnect(this);
+	socket->abort();
+	socket->deleteLater();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		jobFinishedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		jobFinishedHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a job has worked out the waveform of a song. peaksReady
+--					is emitted for it, the peers that were waiting for it are sent it and the next song of the song
+--					folder is started.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::jobFinishedHandler()
+{
+	PeakJob * job = (PeakJob *)QObject::sender();
+	job->deleteLater();
+
+	if (mJobs.value(job->FileName()) == job)
+	{
+		mJobs.remove(job->FileName());
+	}
+
+	if (job->IsBackground())
+	{
+		mBackgroundJobs--;
+	}
+
+	if (job->Peaks().IsValid())
+	{
+		emit peaksReady(job->FileName(), job->Peaks());
+	}
+
+	for (QTcpSocket * socket : mWaiting.keys(job->FileName()))
+	{
+		mWaiting.remove(socket);
+		reply(socket, job->Peaks());
+	}
+
+	startBackground();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		newConnectionHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		newConnectionHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a peer connects to ask for a waveform.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::newConnectionHandler()
+{
+	QTcpSocket * socket = mServer.nextPendingConnection();
+
+	connect(socket, &QTcpSocket::readyRead, this, &PeakCache::requestHandler);
+	connect(socket, &QTcpSocket::disconnected, this, &PeakCache::peerDisconnectHandler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		requestHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		requestHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a peer sends part of a request. Once the whole request
+--					has arrived it is checked against the session key. A song that is not a file inside the song
+--					folder is answered with an empty waveform. The waveform is sent straight from disk if it is there,
+--					otherwise the peer waits until it has been worked out.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::requestHandler()
+{
+	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
+
+	if (mWaiting.contains(socket) || socket->bytesAvailable() < PEAK_REQUEST_SIZE)
+	{
+		return;
+	}
+
+	QByteArray data = socket->read(PEAK_REQUEST_SIZE);
+	if (data[0] != (char)Headers::RequestPeaks || data.mid(1, KEY_SIZE) != *mKey)
+	{
+		socket->disconnectFromHost();
+		return;
+	}
+
+	QString fileName = mSource->absoluteFilePath(QString::fromUtf8(data.constData() + 1 + KEY_SIZE));
+	QFileInfo info(fileName);
+	PeakFile peaks;
+
+	if (!info.isFile() || !LibraryScanJob::IsInside(info.canonicalPath(), mSource->canonicalPath()))
+	{
+		reply(socket, peaks);
+		return;
+	}
+
+	if (peaks.Load(localFile(fileName)))
+	{
+		reply(socket, peaks);
+		return;
+	}
+
+	mWaiting[socket] = fileName;
+	Request(fileName);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		peerDisconnectHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		peerDisconnectHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a peer that asked for a waveform disconnects, either
+--					because it has been sent or because it gave up waiting.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::peerDisconnectHandler()
+{
+	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
+
+	mWaiting.remove(socket);
+	socket->deleteLater();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		replyHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		replyHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when part of a waveform arrives from the owner of a song. Once
+--					all of it has arrived it is parsed, saved with the waveforms of other remote songs and peaksReady
+--					is emitted for it.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::replyHandler()
+{
+	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
+
+	if (!mFetches.contains(socket))
+	{
+		return;
+	}
+
+	PeakFetch & fetch = mFetches[socket];
+	fetch.reply.append(socket->readAll());
+
+	if (fetch.reply.size() < PEAK_RESPONSE_SIZE)
+	{
+		return;
+	}
+
+	quint32 length = qFromBigEndian<quint32>((const uchar *)fetch.reply.constData() + 1);
+	if (fetch.reply[0] != (char)Headers::RespondPeaks || length == 0)
+	{
+		finishFetch(socket);
+		return;
+	}
+
+	if (fetch.reply.size() < PEAK_RESPONSE_SIZE + (qint64)length)
+	{
+		return;
+	}
+
+	QString song = fetch.song;
+	PeakFile peaks;
+	bool parsed = peaks.Parse(fetch.reply.mid(PEAK_RESPONSE_SIZE, length)) && peaks.Save(fetch.file);
+
+	finishFetch(socket);
+
+	if (parsed)
+	{
+		emit peaksReady(song, peaks);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		fetchDisconnectHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		fetchDisconnectHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the owner of a song closes the connection before all of
+--					its waveform has arrived.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::fetchDisconnectHandler()
+{
+	finishFetch((QTcpSocket *)QObject::sender());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		fetchTimeoutHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		fetchTimeoutHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a waveform has not arrived in PEAK_FETCH_TIMEOUT. It is
+--					given up on, and can be asked for again the next time the song is picked.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakCache::fetchTimeoutHandler()
+{
+	QTimer * timer = (QTimer *)QObject::sender();
+
+	finishFetch((QTcpSocket *)timer->parent());
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHostAddress>
+#include <QMap>
+#include <QObject>
+#include <QRunnable>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <QtEndian>
+
+#include "globals.h"
+#include "LibraryIndex.h"
+#include "PeakFile.h"
+
+// Works out the waveform of one song on the thread pool of a PeakCache and saves it
+class PeakJob : public QObject, public QRunnable
+{
+	Q_OBJECT
+
+public:
+	PeakJob(const QString & fileName, const QString & peakFile, bool background, QObject * parent = nullptr);
+
+	void run() override;
+
+	const QString & FileName() const;
+	const PeakFile & Peaks() const;
+	bool IsBackground() const;
+
+private:
+	QString mFileName;
+	QString mPeakFile;
+	bool mBackground;
+	PeakFile mPeaks;
+
+signals:
+	void finished();
+};
+
+class PeakCache : public QObject
+{
+	Q_OBJECT
+
+public:
+	PeakCache(const QByteArray * key, QDir * source, const QDir & indexFolder, QObject * parent = nullptr);
+	~PeakCache();
+
+	void Open(const QVector<LibraryEntry> & entries);
+	void Request(const QString & fileName);
+	void Fetch(const QString & songName, quint32 address, const QString & owner, quint32 size, quint32 modified);
+
+	static QString RemoteName(const QString & owner, const QString & songName);
+
+private:
+	// A waveform being fetched from the owner of a remote song
+	struct PeakFetch
+	{
+		QString song;
+		QString file;
+		QByteArray reply;
+	};
+
+	const QByteArray * mKey;
+	QDir * mSource;
+	QDir mIndexFolder;
+
+	// Songs whose waveform is being worked out, and the songs of the folder still waiting for theirs
+	QThreadPool mPool;
+	QMap<QString, PeakJob *> mJobs;
+	QStringList mPending;
+	int mBackgroundJobs;
+
+	// Peers waiting for the waveform of a song to be worked out, and the waveforms being fetched from peers
+	QTcpServer mServer;
+	QMap<QTcpSocket *, QString> mWaiting;
+	QMap<QTcpSocket *, PeakFetch> mFetches;
+
+	QString localFolder() const;
+	QString localFile(const QString & fileName) const;
+	QString localFile(const QString & path, qint64 size, qint64 modified) const;
+	QString remoteFile(const QString & song, quint32 size, quint32 modified) const;
+	void pruneRemote();
+
+	void startJob(const QString & fileName, bool background);
+	void startBackground();
+	void reply(QTcpSocket * socket, const PeakFile & peaks);
+	void finishFetch(QTcpSocket * socket);
+
+private slots:
+	void jobFinishedHandler();
+
+	void newConnectionHandler();
+	void requestHandler();
+	void peerDisconnectHandler();
+
+	void replyHandler();
+	void fetchDisconnectHandler();
+	void fetchTimeoutHandler();
+
+signals:
+	void peaksReady(const QString & song, const PeakFile & peaks);
+};
@@ -0,0 +1,646 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		PeakFile.cpp - The waveform of a song at several resolutions, for drawing it in the seek bar.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					PeakFile()
+--					bool Compute(const QString & fileName)
+--					bool Parse(const QByteArray & data)
+--					QByteArray Serialize(int maxColumns = 0) const
+--					bool Load(const QString & fileName)
+--					bool Save(const QString & fileName) const
+--					bool IsValid() const
+--					qint64 Frames() const
+--					int SampleRate() const
+--					int Levels() const
+--					qint64 BucketFrames(int level) const
+--					const QVector<Peak> & Level(int level) const
+--					const QVector<Peak> & Columns(int width) const
+--					void addLevels(QVector<quint64> squares, int channels)
+--					static quint16 rms(quint64 squares, qint64 samples)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The finest level of a waveform has a column for every PEAK_BASE_FRAMES frames of the song, with the
+--					lowest and highest sample of every channel in them and their RMS. Each level above it merges every
+--					PEAK_LEVEL_FACTOR columns of the one below into one, up to a level that is about as wide as a seek
+--					bar can be. Drawing a waveform picks the level that is just wide enough, so it never has to look at
+--					more than a few columns for every pixel no matter how long the song is.
+--
+--					The file is a header followed by every level from the finest, all little endian:
+--						header:	"CAPK", version, 4 bytes each, frames in the song, 8 bytes, sample rate, frames in a
+--								column of the first level, factor between levels and number of levels, 4 bytes each
+--						level:	number of columns, 4 bytes, then the lowest and highest sample and the RMS of every
+--								column, 2 bytes each
+--					A file sent to a peer leaves out the levels that are finer than it needs, so its first level may
+--					have more frames in a column than PEAK_BASE_FRAMES.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "PeakFile.h"
+
+#define PEAK_FILE_MAGIC "CAPK"
+#define PEAK_FILE_VERSION 1
+#define PEAK_FILE_HEADER_SIZE 32
+#define PEAK_FILE_COLUMN_SIZE 6
+#define PEAK_FILE_MAX_LEVELS 32
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeakFile
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PeakFile ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates an empty waveform, which is not valid until it is computed, parsed or loaded.
+----------------------------------------------------------------------------------------------------------------------*/
+PeakFile::PeakFile()
+	: mFrames(0)
+	, mSampleRate(0)
+	, mBucketFrames(PEAK_BASE_FRAMES)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Compute
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The song is read through a SongReader.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Compute (const QString & fileName)
+--						const QString & fileName: The song.
+--
+-- RETURNS:			True if the song could be read.
+--
+-- NOTES:
+--					Reads through all of the song once with a SongReader, PEAK_CHUNK_FRAMES frames at a time, and hands
+--					the samples to AudioKernels::Peaks a column at a time. A column can be split across two chunks
+--					when a decoder gives back less than was asked for, so it is only finished once it is full or the
+--					song ends.
+--
+--					A wav file that is cut short is read up to where it ends. This runs on a thread of the pool and
+--					touches nothing but the waveform itself.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PeakFile::Compute(const QString & fileName)
+{
+	mFrames = 0;
+	mBucketFrames = PEAK_BASE_FRAMES;
+	mLevels.clear();
+
+	SongReader reader;
+	if (!reader.Open(fileName))
+	{
+		return false;
+	}
+
+	int channels = reader.Format().channelCount();
+	QVector<qint16> samples(PEAK_CHUNK_FRAMES * channels);
+	QVector<Peak> base;
+	QVector<quint64> squares;
+
+	// The column being filled
+	Peak peak = { 32767, -32768, 0 };
+	quint64 sum = 0;
+	int filled = 0;
+
+	for (;;)
+	{
+		int count = reader.Read(samples.data(), PEAK_CHUNK_FRAMES);
+		if (count <= 0)
+		{
+			break;
+		}
+
+		for (int first = 0; first < count;)
+		{
+			int length = qMin(PEAK_BASE_FRAMES - filled, count - first);
+			AudioKernels::Peaks(samples.constData() + first * channels, length * channels, &peak.minimum,
+				&peak.maximum, &sum);
+
+			first += length;
+			filled += length;
+			if (filled == PEAK_BASE_FRAMES)
+			{
+				peak.rms = rms(sum, (qint64)filled * channels);
+				base.append(peak);
+				squares.append(sum);
+
+				peak.minimum = 32767;
+				peak.maximum = -32768;
+				sum = 0;
+				filled = 0;
+			}
+		}
+
+		mFrames += count;
+	}
+
+	if (filled > 0)
+	{
+		peak.rms = rms(sum, (qint64)filled * channels);
+		base.append(peak);
+		squares.append(sum);
+	}
+
+	if (mFrames == 0)
+	{
+		return false;
+	}
+
+	mSampleRate = reader.Format().sampleRate();
+	mLevels.append(base);
+	addLevels(squares, channels);
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Parse
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Parse (const QByteArray & data)
+--						const QByteArray & data: A whole waveform file.
+--
+-- RETURNS:			True if the data is a waveform file.
+--
+-- NOTES:
+--					The data may have come from a peer, so every size in it is checked against how much data there is
+--					before anything is read. Data that is of another version, cut short or has anything after its last
+--					level is ignored as a whole and the waveform is left empty.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PeakFile::Parse(const QByteArray & data)
+{
+	mFrames = 0;
+	mLevels.clear();
+
+	if (data.size() < PEAK_FILE_HEADER_SIZE)
+	{
+		return false;
+	}
+
+	const uchar * header = (const uchar *)data.constData();
+	quint32 version = qFromLittleEndian<quint32>(header + 4);
+	qint64 frames = qFromLittleEndian<qint64>(header + 8);
+	quint32 sampleRate = qFromLittleEndian<quint32>(header + 16);
+	quint32 bucketFrames = qFromLittleEndian<quint32>(header + 20);
+	quint32 factor = qFromLittleEndian<quint32>(header + 24);
+	quint32 count = qFromLittleEndian<quint32>(header + 28);
+
+	if (memcmp(header, PEAK_FILE_MAGIC, 4) != 0 || version != PEAK_FILE_VERSION || frames <= 0 || sampleRate == 0
+		|| bucketFrames == 0 || factor != PEAK_LEVEL_FACTOR || count == 0 || count > PEAK_FILE_MAX_LEVELS)
+	{
+		return false;
+	}
+
+	QVector<QVector<Peak>> levels(count);
+	qint64 offset = PEAK_FILE_HEADER_SIZE;
+
+	for (QVector<Peak> & level : levels)
+	{
+		if (offset + 4 > data.size())
+		{
+			return false;
+		}
+
+		qint64 columns = qFromLittleEndian<quint32>(header + offset);
+		offset += 4;
+
+		if (columns == 0 || offset + columns * PEAK_FILE_COLUMN_SIZE > data.size())
+		{
+			return false;
+		}
+
+		level.resize(columns);
+		for (Peak & peak : level)
+		{
+			peak.minimum = qFromLittleEndian<qint16>(header + offset);
+			peak.maximum = qFromLittleEndian<qint16>(header + offset + 2);
+			peak.rms = qFromLittleEndian<quint16>(header + offset + 4);
+			offset += PEAK_FILE_COLUMN_SIZE;
+		}
+	}
+
+	if (offset != data.size())
+	{
+		return false;
+	}
+
+	mFrames = frames;
+	mSampleRate = sampleRate;
+	mBucketFrames = bucketFrames;
+	mLevels = levels;
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Serialize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Serialize (int maxColumns)
+--						int maxColumns: The most columns a level that is written may have, or 0 to write them all.
+--
+-- RETURNS:			The waveform file.
+--
+-- NOTES:
+--					Levels with more than maxColumns columns are left out, apart from the coarsest, which is always
+--					written. The first level written then has as many frames in a column as it had here.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray PeakFile::Serialize(int maxColumns) const
+{
+	int first = 0;
+	while (maxColumns > 0 && first + 1 < mLevels.size() && mLevels[first].size() > maxColumns)
+	{
+		first++;
+	}
+
+	QByteArray levels;
+	QDataStream out(&levels, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+
+	for (int level = first; level < mLevels.size(); level++)
+	{
+		out << (quint32)mLevels[level].size();
+		for (const Peak & peak : mLevels[level])
+		{
+			out << peak.minimum << peak.maximum << peak.rms;
+		}
+	}
+
+	QByteArray header(PEAK_FILE_HEADER_SIZE, 0);
+	memcpy(header.data(), PEAK_FILE_MAGIC, 4);
+	qToLittleEndian<quint32>(PEAK_FILE_VERSION, (uchar *)header.data() + 4);
+	qToLittleEndian<qint64>(mFrames, (uchar *)header.data() + 8);
+	qToLittleEndian<quint32>(mSampleRate, (uchar *)header.data() + 16);
+	qToLittleEndian<quint32>((quint32)BucketFrames(first), (uchar *)header.data() + 20);
+	qToLittleEndian<quint32>(PEAK_LEVEL_FACTOR, (uchar *)header.data() + 24);
+	qToLittleEndian<quint32>(mLevels.size() - first, (uchar *)header.data() + 28);
+
+	return header + levels;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Load
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Load (const QString & fileName)
+--						const QString & fileName: The waveform file.
+--
+-- RETURNS:			True if the waveform was read.
+--
+-- NOTES:
+--					Waveform files are small enough to be read whole and parsed.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PeakFile::Load(const QString & fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QFile::ReadOnly))
+	{
+		mFrames = 0;
+		mLevels.clear();
+		return false;
+	}
+
+	return Parse(file.readAll());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Save
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Save (const QString & fileName)
+--						const QString & fileName: The waveform file.
+--
+-- RETURNS:			True if the waveform was written.
+--
+-- NOTES:
+--					Writes every level through a QSaveFile, so a waveform that is being read while it is written is
+--					never seen half done.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PeakFile::Save(const QString & fileName) const
+{
+	QSaveFile file(fileName);
+	if (!file.open(QFile::WriteOnly))
+	{
+		qWarning() << "Could not write the waveform" << fileName << file.errorString();
+		return false;
+	}
+
+	file.write(Serialize());
+
+	return file.commit();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsValid
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsValid ()
+--
+-- RETURNS:			True if there is a waveform. The levels must not be looked at otherwise.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+bool PeakFile::IsValid() const
+{
+	return !mLevels.isEmpty();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Frames
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Frames ()
+--
+-- RETURNS:			The number of frames in the song.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PeakFile::Frames() const
+{
+	return mFrames;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SampleRate
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SampleRate ()
+--
+-- RETURNS:			The sample rate of the song.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+int PeakFile::SampleRate() const
+{
+	return mSampleRate;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Levels
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Levels ()
+--
+-- RETURNS:			The number of levels, the finest being 0.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+int PeakFile::Levels() const
+{
+	return mLevels.size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		BucketFrames
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		BucketFrames (int level)
+--						int level: The level.
+--
+-- RETURNS:			How many frames of the song each column of the level covers. The last column may cover fewer.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PeakFile::BucketFrames(int level) const
+{
+	qint64 frames = mBucketFrames;
+	for (int i = 0; i < level; i++)
+	{
+		frames *= PEAK_LEVEL_FACTOR;
+	}
+
+	return frames;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Level
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Level (int level)
+--						int level: The level, from 0 up to Levels.
+--
+-- RETURNS:			The columns of the level.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const QVector<Peak> & PeakFile::Level(int level) const
+{
+	return mLevels[level];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Columns
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Columns (int width)
+--						int width: The number of pixels the waveform is drawn across.
+--
+-- RETURNS:			The coarsest level with at least as many columns as there are pixels, or the finest level if
+--					none has that many.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const QVector<Peak> & PeakFile::Columns(int width) const
+{
+	for (int level = mLevels.size() - 1; level > 0; level--)
+	{
+		if (mLevels[level].size() >= width)
+		{
+			return mLevels[level];
+		}
+	}
+
+	return mLevels[0];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		addLevels
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		addLevels (QVector<quint64> squares, int channels)
+--						QVector<quint64> squares: The sum of the squares of every column of the finest level.
+--						int channels: The number of channels in the song.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Builds every level above the finest one out of the level below it. The sums of the squares are
+--					carried up along with the columns so the RMS of every level is exact, rather than an average of
+--					the RMS below it. Only the last column of a level can cover fewer frames than the others.
+----------------------------------------------------------------------------------------------------------------------*/
+void PeakFile::addLevels(QVector<quint64> squares, int channels)
+{
+	qint64 bucketFrames = mBucketFrames;
+
+	while (mLevels.last().size() > PEAK_TOP_COLUMNS)
+	{
+		QVector<Peak> below = mLevels.last();
+		QVector<Peak> level((below.size() + PEAK_LEVEL_FACTOR - 1) / PEAK_LEVEL_FACTOR);
+		QVector<quint64> sums(level.size(), 0);
+
+		bucketFrames *= PEAK_LEVEL_FACTOR;
+
+		for (int i = 0; i < level.size(); i++)
+		{
+			int first = i * PEAK_LEVEL_FACTOR;
+			int last = qMin(first + PEAK_LEVEL_FACTOR, below.size());
+			Peak & peak = level[i];
+
+			peak = below[first];
+			for (int j = first; j < last; j++)
+			{
+				peak.minimum = qMin(peak.minimum, below[j].minimum);
+				peak.maximum = qMax(peak.maximum, below[j].maximum);
+				sums[i] += squares[j];
+			}
+
+			qint64 frames = qMin(bucketFrames, mFrames - i * bucketFrames);
+			peak.rms = rms(sums[i], frames * channels);
+		}
+
+		squares = sums;
+		mLevels.append(level);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		rms
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		rms (quint64 squares, qint64 samples)
+--						quint64 squares: The sum of the squares of the samples.
+--						qint64 samples: The number of samples, counting every channel.
+--
+-- RETURNS:			The RMS of the samples, which is never more than 32768.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+quint16 PeakFile::rms(quint64 squares, qint64 samples)
+{
+	if (samples <= 0)
+	{
+		return 0;
+	}
+
+	return (quint16)qMin(32768, (int)std::lround(std::sqrt((double)squares / samples)));
+}
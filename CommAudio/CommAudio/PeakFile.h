@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+
+#include "AudioDecoder.h"
+#include "AudioKernels.h"
+#include "globals.h"
+
+// One column of a waveform: the lowest and highest sample and the RMS of the frames it covers
+struct Peak
+{
+	qint16 minimum;
+	qint16 maximum;
+	quint16 rms;
+};
+
+// The waveform of a song at several resolutions, from the finest level to the coarsest
+class PeakFile
+{
+public:
+	PeakFile();
+
+	bool Compute(const QString & fileName);
+	bool Parse(const QByteArray & data);
+	QByteArray Serialize(int maxColumns = 0) const;
+	bool Load(const QString & fileName);
+	bool Save(const QString & fileName) const;
+
+	bool IsValid() const;
+	qint64 Frames() const;
+	int SampleRate() const;
+	int Levels() const;
+	qint64 BucketFrames(int level) const;
+	const QVector<Peak> & Level(int level) const;
+	const QVector<Peak> & Columns(int width) const;
+
+private:
+	qint64 mFrames;
+	quint32 mSampleRate;
+	qint64 mBucketFrames;
+	QVector<QVector<Peak>> mLevels;
+
+	void addLevels(QVector<quint64> squares, int channels);
+	static quint16 rms(quint64 squares, qint64 samples);
+};
@@ -0,0 +1,281 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		PlaybackFeed.cpp - A QIODevice that carries a stream from the network to the audio thread.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					PlaybackFeed(QObject * parent = nullptr)
+--					void Write(const QByteArray & audio)
+--					qint64 Buffered() const
+--					bool isSequential() const
+--					qint64 pos() const
+--					qint64 bytesAvailable() const
+--					qint64 readData(char * data, qint64 maxSize)
+--					qint64 writeData(const char * data, qint64 maxSize)
+--					void flush()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The StreamManager writes the audio of a stream into the feed as it arrives and the PlaybackQueue
+--					reads it on the audio thread. The two only meet in a RingBuffer, so a read never waits on the
+--					GUI thread.
+--
+--					A song can arrive much faster than it plays, and a cached one arrives all at once, so what does
+--					not fit in the ring is kept on the GUI thread and moved into the ring every PLAYBACK_FEED_MS as
+--					the audio thread makes room for it.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "PlaybackFeed.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PlaybackFeed
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PlaybackFeed (QObject * parent)
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates an empty feed and opens it for reading. The feed is unbuffered so that QIODevice does not
+--					copy what is read out of the ring a second time.
+----------------------------------------------------------------------------------------------------------------------*/
+PlaybackFeed::PlaybackFeed(QObject * parent)
+	: QIODevice(parent)
+	, mRing(PLAYBACK_FEED_BYTES)
+	, mBacklogStart(0)
+	, mRead(0)
+{
+	mFlushTimer.setInterval(PLAYBACK_FEED_MS);
+	connect(&mFlushTimer, &QTimer::timeout, this, &PlaybackFeed::flush);
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Write
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Write (const QByteArray & audio)
+--						const QByteArray & audio: The next bytes of the stream.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Called on the GUI thread. The audio goes behind anything that is still waiting for room, and as
+--					much of it as fits goes into the ring straight away.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackFeed::Write(const QByteArray & audio)
+{
+	mBacklog.append(audio);
+	flush();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Buffered
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Buffered ()
+--
+-- RETURNS:			How many bytes have arrived and not been played yet, in the ring and waiting for room in it.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackFeed::Buffered() const
+{
+	return mBacklog.size() - mBacklogStart + mRing.Available();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		isSequential
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		isSequential ()
+--
+-- RETURNS:			Always true.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PlaybackFeed::isSequential() const
+{
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		pos
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		pos ()
+--
+-- RETURNS:			How many bytes of the stream have been read.
+--
+-- NOTES:
+--					QIODevice does not count the position of a sequential device, but the queue needs it to tell how
+--					much of the stream is left. Only the reading thread may ask.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackFeed::pos() const
+{
+	return mRead;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		bytesAvailable
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bytesAvailable ()
+--
+-- RETURNS:			The number of bytes that can be read from the ring.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackFeed::bytesAvailable() const
+{
+	return mRing.Available() + QIODevice::bytesAvailable();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readData (char * data, qint64 maxSize)
+--						char * data: The buffer to fill.
+--						qint64 maxSize: The size of the buffer.
+--
+-- RETURNS:			The number of bytes read, 0 if nothing has arrived yet.
+--
+-- NOTES:
+--					Runs on the audio thread and only reads what is already in the ring.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackFeed::readData(char * data, qint64 maxSize)
+{
+	int count = mRing.Read(data, (int)qMin<qint64>(maxSize, mRing.Available()));
+	mRead += count;
+
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		writeData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeData (const char * data, qint64 maxSize)
+--						const char * data: Unused.
+--						qint64 maxSize: Unused.
+--
+-- RETURNS:			Always -1.
+--
+-- NOTES:
+--					The feed is read only through QIODevice, the stream is written with Write.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackFeed::writeData(const char * data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		flush
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		flush ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is the Qt slot that is triggered every PLAYBACK_FEED_MS while some of the stream is waiting
+--					for room. It moves as much of it into the ring as fits. The part that has been moved is only cut
+--					off the backlog once it is more than half of it, so the backlog is not copied on every write.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackFeed::flush()
+{
+	int count = qMin(mBacklog.size() - mBacklogStart, mRing.Free());
+	if (count > 0)
+	{
+		mRing.Write(mBacklog.constData() + mBacklogStart, count);
+		mBacklogStart += count;
+	}
+
+	if (mBacklogStart == mBacklog.size())
+	{
+		mBacklog.clear();
+		mBacklogStart = 0;
+		mFlushTimer.stop();
+		return;
+	}
+
+	if (mBacklogStart > mBacklog.size() / 2)
+	{
+		mBacklog.remove(0, mBacklogStart);
+		mBacklogStart = 0;
+	}
+
+	if (!mFlushTimer.isActive())
+	{
+		mFlushTimer.start();
+	}
+}
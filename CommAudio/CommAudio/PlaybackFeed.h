@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QTimer>
+
+#include "globals.h"
+#include "RingBuffer.h"
+
+// A stream as it arrives, written on the GUI thread and read by the PlaybackQueue on the audio thread
+class PlaybackFeed : public QIODevice
+{
+	Q_OBJECT
+
+public:
+	PlaybackFeed(QObject * parent = nullptr);
+	~PlaybackFeed() = default;
+
+	void Write(const QByteArray & audio);
+	qint64 Buffered() const;
+
+	bool isSequential() const override;
+	qint64 pos() const override;
+	qint64 bytesAvailable() const override;
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+	qint64 writeData(const char * data, qint64 maxSize) override;
+
+private:
+	RingBuffer mRing;
+
+	// What has arrived but did not fit in the ring yet, from mBacklogStart on. Only touched on the GUI thread
+	QByteArray mBacklog;
+	int mBacklogStart;
+	QTimer mFlushTimer;
+
+	// How much has been read, only touched on the audio thread
+	qint64 mRead;
+
+private slots:
+	void flush();
+};
@@ -0,0 +1,1052 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		PlaybackQueue.cpp - A QIODevice that plays one audio source after another without a gap.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					PlaybackQueue(QObject * parent = nullptr)
+--					~PlaybackQueue()
+--					void SetFormat(const QAudioFormat & format)
+--					void SetCurrent(QIODevice * source, const QAudioFormat & format, qint64 length, int gain = 256)
+--					void SetNext(QIODevice * source, const QAudioFormat & format, qint64 length, int gain = 256)
+--					void SetGain(QIODevice * source, int gain)
+--					void SetCrossfade(int ms)
+--					void SetEqualizer(const QVector<float> & gains)
+--					void Clear()
+--					void Poll()
+--					bool HasNext() const
+--					qint64 Overlap() const
+--					int Pull(float * out, int frames)
+--					bool isSequential() const
+--					qint64 readData(char * data, qint64 maxSize)
+--					qint64 writeData(const char * data, qint64 maxSize)
+--					Item makeItem(QIODevice * source, const QAudioFormat & format, qint64 length, int gain)
+--					void adopt()
+--					void applyLevel(Item & item)
+--					void applyBands()
+--					void retire(Item & item)
+--					void destroy(Item & item)
+--					void post(int type, const Item & item, qint64 gap = 0, qint64 overlap = 0)
+--					void buildChain()
+--					static Item emptyItem()
+--					static qint64 itemBytes(const Item & item, qint64 us)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Every source can be played with a gain of its own.
+--					October 19, 2026 - agent: Sources are played through a float chain with a crossfade and an
+--									equalizer.
+--					October 19, 2026 - agent: The queue is read on an AudioThread and only meets the GUI thread in
+--									ring buffers and atomics.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The output always pulls from this device. It holds the source that is playing and the source that
+--					plays after it. When the current source runs out, the rest of the same read is filled from the
+--					next source so the switch happens on a sample boundary and the output never runs dry. A few
+--					seconds before the current source ends the queue asks for the next source so that it can be
+--					opened or streamed ahead of time. Sources that are not in the format of the output are converted.
+--
+--					The queue does not own the sources, the previous source is handed back when a transition happens
+--					along with how long the output was left waiting for it.
+--
+--					Each source has a gain that is applied after it has been converted to the format of the output,
+--					so songs can be evened out in loudness. A new gain is ramped to over one block so it does not
+--					click, and switches with the source when a transition happens part way through a read.
+--
+--					The sources are not copied straight into the output. Each one is read through a DspSource and a
+--					DspGain, and the queue itself is the first DspNode of a chain that goes on through a DspEqualizer
+--					to a DspOutput, which the output reads from. When crossfading is on, the current source fades
+--					into the next one over its last stretch instead of stopping dead. The transition then happens
+--					when the current source runs out or the fade is over, whichever comes first, and the rest of
+--					the fade is only the next source fading in.
+--
+--					The queue is read by the output on an AudioThread, the same way the VoiceMixer is, so a read
+--					never takes a lock, allocates or waits. The GUI thread builds a source into an item and hands it
+--					over through a RingBuffer, and the audio thread picks it up at its next read. Gains, the crossfade
+--					and the equalizer bands are atomics the audio thread looks at every read. What the audio thread
+--					has to say, like a transition, comes back as an event through a second RingBuffer, which the GUI
+--					thread drains with Poll and turns into signals. An item the audio thread is done with comes back
+--					the same way and is deleted on the GUI thread, which then emits released so that the owner of
+--					the source knows it can be deleted too. SetFormat, SetCurrent and Clear change what is playing
+--					outright, so they are only called while the thread is stopped.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "PlaybackQueue.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PlaybackQueue
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Makes the ring buffers to and from the audio thread.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PlaybackQueue (QObject * parent)
+--						QObject * parent: The parent object, which must be null for the queue to be played on an
+--							AudioThread.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates an empty queue and opens it for reading. The queue is unbuffered so that QIODevice does not
+--					read ahead past the end of the current source. The chain after the queue is built once the format
+--					of the output is set.
+----------------------------------------------------------------------------------------------------------------------*/
+PlaybackQueue::PlaybackQueue(QObject * parent)
+	: QIODevice(parent)
+	, DspNode(0)
+	, mFrameBytes(0)
+	, mCurrent(emptyItem())
+	, mNext(emptyItem())
+	, mItems(PLAYBACK_QUEUE_MESSAGES * sizeof(Item))
+	, mEvents(PLAYBACK_QUEUE_MESSAGES * sizeof(Event))
+	, mFade(nullptr)
+	, mEqualizer(nullptr)
+	, mOutput(nullptr)
+	, mCrossfadeMs(0)
+	, mBandsVersion(0)
+	, mBandsApplied(0)
+	, mBandGains(EQUALIZER_BANDS, 0.0f)
+	, mAdopted(0)
+	, mStarted(false)
+	, mPrefetchRequested(false)
+	, mDry(false)
+	, mSent(0)
+	, mHasNext(false)
+	, mOverlap(0)
+{
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~PlaybackQueue
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~PlaybackQueue ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Lets go of the sources and deletes the chain. The thread playing the queue must be stopped first.
+----------------------------------------------------------------------------------------------------------------------*/
+PlaybackQueue::~PlaybackQueue()
+{
+	Clear();
+
+	delete mOutput;
+	delete mEqualizer;
+	delete mFade;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetFormat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Builds the chain after the queue for the format.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetFormat (const QAudioFormat & format)
+--						const QAudioFormat & format: The format of the audio output.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Sets the format every source will be converted to. This clears the queue since the sources that
+--					are in it were set up for the old format. Only called while the queue is not being played.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::SetFormat(const QAudioFormat & format)
+{
+	Clear();
+	mFormat = format;
+	mChannels = format.channelCount();
+	mFrameBytes = format.bytesPerFrame();
+
+	buildChain();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetCurrent
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetCurrent (QIODevice * source, const QAudioFormat & format, qint64 length, int gain)
+--						QIODevice * source: The source to play now.
+--						const QAudioFormat & format: The format of the audio in the source.
+--						qint64 length: The position in the source where its audio ends.
+--						int gain: The gain to play the source with in 8.8 fixed point, 256 to play it as it is.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Replaces whatever is playing with the source. Anything that was queued after the old source is
+--					dropped. Only called while the queue is not being played.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::SetCurrent(QIODevice * source, const QAudioFormat & format, qint64 length, int gain)
+{
+	Clear();
+
+	mCurrent = makeItem(source, format, length, gain);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetNext
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The item is sent to the audio thread through a ring buffer.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetNext (QIODevice * source, const QAudioFormat & format, qint64 length, int gain)
+--						QIODevice * source: The source to play once the current one ends.
+--						const QAudioFormat & format: The format of the audio in the source.
+--						qint64 length: The position in the source where its audio ends.
+--						int gain: The gain to play the source with in 8.8 fixed point, 256 to play it as it is.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Queues the source after the current one, replacing anything that was already queued. The item
+--					for the source is built here and taken up by the audio thread at its next read, which hands the
+--					item it replaces back to be released. The source may still be read until it has been released.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::SetNext(QIODevice * source, const QAudioFormat & format, qint64 length, int gain)
+{
+	Item item = makeItem(source, format, length, gain);
+
+	if (mItems.Write((const char *)&item, sizeof(Item)) == 0)
+	{
+		destroy(item);
+		return;
+	}
+
+	mSent++;
+	mHasNext = source != nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetGain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The gain is handed to the audio thread through the level of the item.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetGain (QIODevice * source, int gain)
+--						QIODevice * source: The current or next source.
+--						int gain: The gain to play the source with in 8.8 fixed point, 256 to play it as it is.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Changes the gain of a source that is already in the queue, from the next read on. A source that
+--					is not in the queue is ignored.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::SetGain(QIODevice * source, int gain)
+{
+	QAtomicInt * level = mLevels.value(source);
+
+	if (level != nullptr)
+	{
+		level->store(gain);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetCrossfade
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetCrossfade (int ms)
+--						int ms: How long a source fades into the next one, 0 to switch straight from one to the next.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Turns crossfading on or off. A fade that has already started is played to the end.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::SetCrossfade(int ms)
+{
+	mCrossfadeMs.store(qMax(0, ms));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetEqualizer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The bands are handed to the audio thread through atomics.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetEqualizer (const QVector<float> & gains)
+--						const QVector<float> & gains: The gain in dB of every band at EQUALIZER_FREQUENCIES.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Sets the bands of the equalizer, which are kept when the chain is built again for a new format.
+--					The version is moved on after the bands are stored, so the audio thread sees all of them at its
+--					next read.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::SetEqualizer(const QVector<float> & gains)
+{
+	for (int i = 0; i < EQUALIZER_BANDS; i++)
+	{
+		mBands[i].store(i < gains.size() ? qRound(gains[i] * 100) : 0);
+	}
+
+	mBandsVersion.fetchAndAddRelease(1);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Clear
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Stops a fade and drops what the output had not been handed yet.
+--					October 19, 2026 - agent: Empties the ring buffers to and from the audio thread.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Clear ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Empties the queue. Only called while the queue is not being played. Items that were on their way
+--					in either direction are released along with the current and next items, and any other event that
+--					had not been polled yet is dropped since it is about what was playing. The sources themselves are
+--					left alone.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::Clear()
+{
+	Item item;
+	while (mItems.Available() >= (int)sizeof(Item))
+	{
+		mItems.Read((char *)&item, sizeof(Item));
+		destroy(item);
+	}
+
+	Event event;
+	while (mEvents.Available() >= (int)sizeof(Event))
+	{
+		mEvents.Read((char *)&event, sizeof(Event));
+		if (event.type == ReleasedEvent)
+		{
+			destroy(event.item);
+		}
+	}
+
+	if (mFade != nullptr)
+	{
+		mFade->Stop();
+	}
+
+	destroy(mCurrent);
+	destroy(mNext);
+
+	if (mOutput != nullptr)
+	{
+		mOutput->Clear();
+	}
+
+	mSent = 0;
+	mAdopted = 0;
+	mHasNext = false;
+	mOverlap = 0;
+	mStarted = false;
+	mPrefetchRequested = false;
+	mDry = false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Poll
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Poll ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Called on the GUI thread every so often. Drains the events the audio thread has posted in the
+--					order they happened and emits currentStarted, prefetchNeeded and transitioned for them. Items that
+--					were handed back are deleted, which emits released. After a transition the queue only still has
+--					a next source if one was sent after the one that just started.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::Poll()
+{
+	Event event;
+
+	while (mEvents.Available() >= (int)sizeof(Event))
+	{
+		mEvents.Read((char *)&event, sizeof(Event));
+
+		switch (event.type)
+		{
+		case StartedEvent:
+			emit currentStarted();
+			break;
+		case PrefetchEvent:
+			emit prefetchNeeded();
+			break;
+		case TransitionEvent:
+			mHasNext = mSent > event.adopted;
+			mOverlap = event.overlap;
+			emit transitioned(event.item.source, event.gap);
+			break;
+		case ReleasedEvent:
+			destroy(event.item);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		HasNext
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Answers from what the GUI thread has sent and polled.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		HasNext ()
+--
+-- RETURNS:			True if there is a source queued after the current one.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PlaybackQueue::HasNext() const
+{
+	return mHasNext;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Overlap
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Overlap ()
+--
+-- RETURNS:			How much of the current source, in microseconds, had already been played when the source before
+--					it ended.
+--
+-- NOTES:
+--					This is zero unless the current source was faded into, and lets the player show where in the source
+--					it really is. It is as of the last transition that was polled.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackQueue::Overlap() const
+{
+	return mOverlap;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		isSequential
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		isSequential ()
+--
+-- RETURNS:			Always true.
+----------------------------------------------------------------------------------------------------------------------*/
+bool PlaybackQueue::isSequential() const
+{
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Applies the gain of the source to what is read from it.
+--					October 19, 2026 - agent: Reads through the chain after the queue, the sources are switched
+--									in Pull.
+--					October 19, 2026 - agent: Takes up what the GUI thread sent first, and always fills whole frames.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readData (char * data, qint64 maxSize)
+--						char * data: The buffer to fill with audio.
+--						qint64 maxSize: The size of the buffer.
+--
+-- RETURNS:			The number of bytes written into data, which is maxSize rounded down to whole frames.
+--
+-- NOTES:
+--					Runs on the audio thread. Takes up the next item, gains and bands the GUI thread has set, then
+--					fills the buffer from the DspOutput at the end of the chain, which pulls through the equalizer
+--					from the queue. Whatever the sources could not fill is silence, so the output keeps running while
+--					a stream catches up. Nothing can be read before the format has been set.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackQueue::readData(char * data, qint64 maxSize)
+{
+	if (mOutput == nullptr || mFrameBytes <= 0)
+	{
+		return 0;
+	}
+
+	qint64 size = maxSize - maxSize % mFrameBytes;
+
+	adopt();
+
+	qint64 read = mOutput->Read(data, size);
+	memset(data + read, 0, size - read);
+
+	return size;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Pull
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Posts events for the GUI thread instead of emitting signals, and hands
+--									the items it is done with back to be released.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Pull (float * out, int frames)
+--						float * out: Where the frames are written.
+--						int frames: The most frames to hand out.
+--
+-- RETURNS:			The number of frames written.
+--
+-- NOTES:
+--					Fills the frames from the current source. If the current source ends part way through, the next
+--					source becomes the current one and the frames are filled from it. A source that has simply run
+--					out of buffered audio, like a stream that is still arriving, is not treated as ended.
+--
+--					When crossfading is on and the next source is queued, the fade starts once what is left of the
+--					current source is no longer than the fade, and lasts for exactly what is left. The next source
+--					is asked for that much earlier as well, so it is ready by then.
+--
+--					The gap of a transition is zero when the next source was ready in time. Otherwise it is the time
+--					from when the current source ended to when the next one was queued.
+----------------------------------------------------------------------------------------------------------------------*/
+int PlaybackQueue::Pull(float * out, int frames)
+{
+	int total = 0;
+	int crossfadeMs = mCrossfadeMs.load();
+
+	while (total < frames && mCurrent.source != nullptr)
+	{
+		float * at = out + total * mChannels;
+		int pulled = mFade->IsFading() ? mFade->Pull(at, frames - total) : mCurrent.gain->Pull(at, frames - total);
+		if (pulled > 0)
+		{
+			total += pulled;
+
+			if (!mStarted)
+			{
+				mStarted = true;
+				post(StartedEvent, mCurrent);
+			}
+		}
+
+		qint64 remaining = mCurrent.length - mCurrent.source->pos();
+		qint64 ahead = (PREFETCH_SECONDS * 1000 + crossfadeMs) * 1000LL;
+		if (!mPrefetchRequested && remaining <= itemBytes(mCurrent, ahead))
+		{
+			mPrefetchRequested = true;
+			post(PrefetchEvent, mCurrent);
+		}
+
+		if (crossfadeMs > 0 && mNext.source != nullptr && !mFade->IsFading() && remaining > 0
+			&& remaining <= itemBytes(mCurrent, crossfadeMs * 1000LL))
+		{
+			qint64 left = remaining / mCurrent.frameBytes * 1000000 / mCurrent.sampleRate;
+			mFade->Start(mCurrent.gain, mNext.gain, mFormat.framesForDuration(left));
+			continue;
+		}
+
+		// The fade can be over while the current source still has a few frames left, which are dropped
+		bool faded = mFade->From() == mCurrent.gain && !mFade->IsFading();
+		if (!faded && (total >= frames || remaining > 0))
+		{
+			break;
+		}
+
+		if (mNext.source == nullptr)
+		{
+			if (!mDry)
+			{
+				mDry = true;
+				mGapTimer.start();
+			}
+			break;
+		}
+
+		qint64 gap = mDry ? mGapTimer.elapsed() : 0;
+		qint64 overlap = mFade->From() == mCurrent.gain ? mFormat.durationForFrames(mFade->Faded()) : 0;
+		Item previous = mCurrent;
+
+		retire(mCurrent);
+		mCurrent = mNext;
+		mNext = emptyItem();
+
+		mStarted = false;
+		mPrefetchRequested = false;
+		mDry = false;
+
+		post(TransitionEvent, previous, gap, overlap);
+	}
+
+	return total;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		writeData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeData (const char * data, qint64 maxSize)
+--						const char * data: Unused.
+--						qint64 maxSize: Unused.
+--
+-- RETURNS:			Always -1.
+--
+-- NOTES:
+--					The queue is read only.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackQueue::writeData(const char * data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		makeItem
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Items have a gain.
+--					October 19, 2026 - agent: Items are read through a DspSource and a DspGain.
+--					October 19, 2026 - agent: Items have a level the GUI thread can change, and keep the size and
+--									rate of their frames instead of their whole format.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		makeItem (QIODevice * source, const QAudioFormat & format, qint64 length, int gain)
+--						QIODevice * source: The source of the item, may be null for an empty item.
+--						const QAudioFormat & format: The format of the audio in the source.
+--						qint64 length: The position in the source where its audio ends.
+--						int gain: The gain to play the source with in 8.8 fixed point, 256 to play it as it is.
+--
+-- RETURNS:			The new item.
+--
+-- NOTES:
+--					Runs on the GUI thread, so everything the audio thread needs to play the item is allocated here.
+--					If the source is not in the format of the output it is read through an AudioFormatConverter.
+--					Whatever is read is then turned into float frames and scaled by the gain.
+----------------------------------------------------------------------------------------------------------------------*/
+PlaybackQueue::Item PlaybackQueue::makeItem(QIODevice * source, const QAudioFormat & format, qint64 length, int gain)
+{
+	Item item = emptyItem();
+
+	if (source == nullptr)
+	{
+		return item;
+	}
+
+	item.source = source;
+	item.reader = source;
+	item.length = length;
+	item.frameBytes = format.bytesPerFrame();
+	item.sampleRate = format.sampleRate();
+
+	if (format != mFormat)
+	{
+		item.reader = new AudioFormatConverter(source, format, mFormat);
+	}
+
+	item.input = new DspSource(item.reader, mFormat);
+	item.gain = new DspGain(item.input, gain / 256.0f);
+	item.level = new QAtomicInt(gain);
+	item.applied = gain;
+
+	mLevels.insert(source, item.level);
+
+	return item;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		adopt
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		adopt ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs on the audio thread at the start of every read. Every item the GUI thread has sent replaces
+--					the next item, which is handed back. Then any new bands and gains are applied.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::adopt()
+{
+	Item item;
+	while (mItems.Available() >= (int)sizeof(Item))
+	{
+		mItems.Read((char *)&item, sizeof(Item));
+		mAdopted++;
+
+		retire(mNext);
+		mNext = item;
+	}
+
+	int version = mBandsVersion.loadAcquire();
+	if (version != mBandsApplied)
+	{
+		mBandsApplied = version;
+		applyBands();
+	}
+
+	applyLevel(mCurrent);
+	applyLevel(mNext);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		applyLevel
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		applyLevel (Item & item)
+--						Item & item: The current or next item.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Ramps the gain of the item to its level if the GUI thread has changed it.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::applyLevel(Item & item)
+{
+	if (item.level == nullptr)
+	{
+		return;
+	}
+
+	int level = item.level->load();
+	if (level != item.applied)
+	{
+		item.gain->SetGain(level / 256.0f);
+		item.applied = level;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		applyBands
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		applyBands ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Sets the equalizer to the bands the GUI thread last stored, in dB.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::applyBands()
+{
+	for (int i = 0; i < EQUALIZER_BANDS; i++)
+	{
+		mBandGains[i] = mBands[i].load() / 100.0f;
+	}
+
+	mEqualizer->SetGains(mBandGains);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		retire
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		retire (Item & item)
+--						Item & item: The item the audio thread is done with.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The fade lets go of the item, which is then handed back to the GUI thread to be deleted and
+--					emptied here.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::retire(Item & item)
+{
+	if (item.source == nullptr)
+	{
+		return;
+	}
+
+	mFade->Drop(item.gain);
+	post(ReleasedEvent, item);
+
+	item = emptyItem();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		destroy
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		destroy (Item & item)
+--						Item & item: An item the audio thread is not using.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs on the GUI thread. Deletes the converter and nodes of the item, empties it and emits released
+--					with its source, which the queue no longer reads.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::destroy(Item & item)
+{
+	QIODevice * source = item.source;
+
+	if (source == nullptr)
+	{
+		return;
+	}
+
+	if (item.reader != source)
+	{
+		delete item.reader;
+	}
+
+	delete item.gain;
+	delete item.input;
+
+	if (mLevels.value(source) == item.level)
+	{
+		mLevels.remove(source);
+	}
+	delete item.level;
+
+	item = emptyItem();
+
+	emit released(source);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		post
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		post (int type, const Item & item, qint64 gap, qint64 overlap)
+--						int type: What happened, from EventType.
+--						const Item & item: The item it happened to.
+--						qint64 gap: How long a transition was waited for in milliseconds.
+--						qint64 overlap: How much of the item after a transition had been faded in, in microseconds.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Runs on the audio thread. Posts the event for Poll to pick up on the GUI thread.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::post(int type, const Item & item, qint64 gap, qint64 overlap)
+{
+	Event event;
+	event.type = type;
+	event.adopted = mAdopted;
+	event.item = item;
+	event.gap = gap;
+	event.overlap = overlap;
+
+	mEvents.Write((const char *)&event, sizeof(Event));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		buildChain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		buildChain ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Builds the crossfade, equalizer and output for the format of the output, replacing the old ones.
+--					The bands of the equalizer are carried over.
+----------------------------------------------------------------------------------------------------------------------*/
+void PlaybackQueue::buildChain()
+{
+	delete mOutput;
+	delete mEqualizer;
+	delete mFade;
+
+	mFade = new DspCrossfade(mChannels);
+	mEqualizer = new DspEqualizer(this, mChannels, mFormat.sampleRate());
+	mOutput = new DspOutput(mEqualizer, mFormat);
+
+	mBandsApplied = mBandsVersion.loadAcquire();
+	applyBands();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		emptyItem
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		emptyItem ()
+--
+-- RETURNS:			An item with no source.
+----------------------------------------------------------------------------------------------------------------------*/
+PlaybackQueue::Item PlaybackQueue::emptyItem()
+{
+	Item item;
+	item.source = nullptr;
+	item.reader = nullptr;
+	item.length = 0;
+	item.frameBytes = 0;
+	item.sampleRate = 0;
+	item.input = nullptr;
+	item.gain = nullptr;
+	item.level = nullptr;
+	item.applied = 0;
+
+	return item;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		itemBytes
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		itemBytes (const Item & item, qint64 us)
+--						const Item & item: The item whose source is measured.
+--						qint64 us: A length of time in microseconds.
+--
+-- RETURNS:			How many bytes of whole frames of the source play for that long.
+--
+-- NOTES:
+--					Worked out in 64 bits since QAudioFormat::bytesForDuration gives a 32 bit count.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 PlaybackQueue::itemBytes(const Item & item, qint64 us)
+{
+	return (qint64)item.sampleRate * us / 1000000 * item.frameBytes;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QAudioFormat>
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QMap>
+#include <QVector>
+
+#include "AudioFormatConverter.h"
+#include "AudioKernels.h"
+#include "DspGraph.h"
+#include "globals.h"
+#include "RingBuffer.h"
+
+// The output pulls from the queue through a DspOutput on an AudioThread, and the queue is the first node of the chain
+// before it. What the GUI thread changes while it plays reaches the audio thread through a RingBuffer or an atomic
+class PlaybackQueue : public QIODevice, public DspNode
+{
+	Q_OBJECT
+
+public:
+	PlaybackQueue(QObject * parent = nullptr);
+	~PlaybackQueue();
+
+	void SetFormat(const QAudioFormat & format);
+	void SetCurrent(QIODevice * source, const QAudioFormat & format, qint64 length, int gain = 256);
+	void SetNext(QIODevice * source, const QAudioFormat & format, qint64 length, int gain = 256);
+	void SetGain(QIODevice * source, int gain);
+	void SetCrossfade(int ms);
+	void SetEqualizer(const QVector<float> & gains);
+	void Clear();
+	void Poll();
+	bool HasNext() const;
+	qint64 Overlap() const;
+
+	int Pull(float * out, int frames) override;
+
+	bool isSequential() const override;
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+	qint64 writeData(const char * data, qint64 maxSize) override;
+
+private:
+	enum EventType
+	{
+		StartedEvent,
+		PrefetchEvent,
+		TransitionEvent,
+		ReleasedEvent
+	};
+
+	// Items are copied byte for byte through the ring buffers, so they only hold plain values and pointers
+	struct Item
+	{
+		QIODevice * source;
+		QIODevice * reader;
+		qint64 length;
+		int frameBytes;
+		int sampleRate;
+
+		// The reader turned into float frames and the gain the item is played with. The level is the gain the GUI
+		// thread last asked for in 8.8 fixed point, and applied is the one the audio thread is playing with
+		DspSource * input;
+		DspGain * gain;
+		QAtomicInt * level;
+		int applied;
+	};
+
+	// What the audio thread tells the GUI thread, along with how many items it had taken by then
+	struct Event
+	{
+		int type;
+		int adopted;
+		Item item;
+		qint64 gap;
+		qint64 overlap;
+	};
+
+	QAudioFormat mFormat;
+	int mFrameBytes;
+	Item mCurrent;
+	Item mNext;
+
+	// Items on their way to the audio thread, and events on their way back
+	RingBuffer mItems;
+	RingBuffer mEvents;
+
+	// The fade between the current and next items, and the nodes after the queue
+	DspCrossfade * mFade;
+	DspEqualizer * mEqualizer;
+	DspOutput * mOutput;
+
+	// Set by the GUI thread at any time. The bands are in hundredths of a dB and are taken up by the audio thread
+	// whenever their version moves on
+	QAtomicInt mCrossfadeMs;
+	QAtomicInt mBands[EQUALIZER_BANDS];
+	QAtomicInt mBandsVersion;
+
+	// Only touched on the audio thread while it plays
+	int mBandsApplied;
+	QVector<float> mBandGains;
+	int mAdopted;
+	bool mStarted;
+	bool mPrefetchRequested;
+
+	// Set when the current item has ended before there was anything queued after it
+	bool mDry;
+	QElapsedTimer mGapTimer;
+
+	// Only touched on the GUI thread. The level of every item that has not been released yet, how many items have
+	// been sent to the audio thread, and what the last transition it heard of left behind
+	QMap<QIODevice *, QAtomicInt *> mLevels;
+	int mSent;
+	bool mHasNext;
+	qint64 mOverlap;
+
+	Item makeItem(QIODevice * source, const QAudioFormat & format, qint64 length, int gain);
+	void adopt();
+	void applyLevel(Item & item);
+	void applyBands();
+	void retire(Item & item);
+	void destroy(Item & item);
+	void post(int type, const Item & item, qint64 gap = 0, qint64 overlap = 0);
+	void buildChain();
+
+	static Item emptyItem();
+	static qint64 itemBytes(const Item & item, qint64 us);
+
+signals:
+	void prefetchNeeded();
+	void currentStarted();
+	void transitioned(QIODevice * previous, qint64 gap);
+	void released(QIODevice * source);
+};
@@ -0,0 +1,730 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		Playlist.cpp - The songs that can be played and the order they are played in.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					Playlist(quint32 seed = 0)
+--					quint32 Insert(int index, const PlaylistTrack & track)
+--					quint32 Insert(int index, const QVector<PlaylistTrack> & tracks)
+--					void Remove(quint32 id)
+--					void Remove(const QSet<quint32> & ids)
+--					void Clear()
+--					int Size() const
+--					const PlaylistTrack * Track(quint32 id) const
+--					quint32 Current() const
+--					void SetCurrent(quint32 id)
+--					quint32 Next(bool skip) const
+--					quint32 Previous() const
+--					void Enqueue(quint32 id)
+--					void SetShuffle(bool shuffle)
+--					void SetRepeat(RepeatMode repeat)
+--					bool IsShuffled() const
+--					RepeatMode Repeat() const
+--					void shuffle(int from)
+--					void rebuild()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Every track is given an id when it is added that stays the same for as long as it is in the
+--					playlist, so the player and the song lists can refer to a track without holding on to the item
+--					that shows it. Local songs and songs of people in the session are tracks alike, the player only
+--					looks at IsRemote to know whether to open or stream one.
+--
+--					The order tracks are played in is worked out when the playlist changes or shuffle is turned on,
+--					not when a song ends: it is the tracks in list order, or a shuffle of them, together with where
+--					every track is in that order. Finding the next or previous track, or moving to a track that was
+--					picked, is then a lookup. Changing the playlist costs a pass over it, which only happens when the
+--					song folder or a peer's songs change.
+--
+--					Tracks asked to be played next are played before the rest of the order carries on from where it
+--					was left.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "Playlist.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Playlist
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Playlist (quint32 seed)
+--						quint32 seed: Where the shuffles start from, so the same seed shuffles the same way.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The playlist starts empty, in list order and repeating the whole list, which is how the player
+--					has always moved between songs.
+----------------------------------------------------------------------------------------------------------------------*/
+Playlist::Playlist(quint32 seed)
+	: mNextId(1)
+	, mCurrent(0)
+	, mPosition(-1)
+	, mShuffle(false)
+	, mRepeat(RepeatAll)
+	, mSeed(seed)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Insert
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Insert (int index, const PlaylistTrack & track)
+--						int index: Where in the list to put the track.
+--						const PlaylistTrack & track: The track, whose id is ignored.
+--
+-- RETURNS:			The id given to the track.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 Playlist::Insert(int index, const PlaylistTrack & track)
+{
+	return Insert(index, QVector<PlaylistTrack>(1, track));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Insert
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Insert (int index, const QVector<PlaylistTrack> & tracks)
+--						int index: Where in the list to put the tracks.
+--						const QVector<PlaylistTrack> & tracks: The tracks in order, whose ids are ignored.
+--
+-- RETURNS:			The id given to the first track. The rest are given the ids that follow it, in order.
+--
+-- NOTES:
+--					In list order the tracks go into the order where they go into the list. When shuffled they are
+--					added to the end of the order and shuffled in among the tracks that have not been played yet, so
+--					they are still played in this pass through the order.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 Playlist::Insert(int index, const QVector<PlaylistTrack> & tracks)
+{
+	quint32 first = mNextId;
+	int count = tracks.size();
+	index = qBound(0, index, mTracks.size());
+
+	if (count == 0)
+	{
+		return first;
+	}
+
+	mTracks.insert(index, count, PlaylistTrack());
+	for (int i = 0; i < count; i++)
+	{
+		mTracks[index + i] = tracks[i];
+		mTracks[index + i].id = mNextId++;
+	}
+
+	if (mShuffle)
+	{
+		for (int & track : mOrder)
+		{
+			track += track >= index ? count : 0;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			mOrder.append(index + i);
+		}
+
+		shuffle(mPosition + 1);
+	}
+	else
+	{
+		mOrder.resize(mTracks.size());
+		for (int i = 0; i < mOrder.size(); i++)
+		{
+			mOrder[i] = i;
+		}
+
+		mPosition += mPosition >= index ? count : 0;
+	}
+
+	rebuild();
+
+	return first;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Remove
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Remove (quint32 id)
+--						quint32 id: The track to take out.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::Remove(quint32 id)
+{
+	QSet<quint32> ids;
+	ids.insert(id);
+	Remove(ids);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Remove
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Remove (const QSet<quint32> & ids)
+--						const QSet<quint32> & ids: The tracks to take out.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Takes the tracks out in one pass over the playlist. The order of the tracks that are left is not
+--					changed, and the order carries on after the last track that was played from it and is still
+--					there. When the current track is taken out there is no current track until another is picked,
+--					but the one after it is still played next.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::Remove(const QSet<quint32> & ids)
+{
+	QVector<int> moved(mTracks.size(), -1);
+	int kept = 0;
+
+	for (int i = 0; i < mTracks.size(); i++)
+	{
+		if (!ids.contains(mTracks[i].id))
+		{
+			moved[i] = kept;
+			mTracks[kept++] = mTracks[i];
+		}
+	}
+
+	if (kept == mTracks.size())
+	{
+		return;
+	}
+
+	mTracks.resize(kept);
+
+	int position = -1;
+	kept = 0;
+	for (int i = 0; i < mOrder.size(); i++)
+	{
+		if (moved[mOrder[i]] >= 0)
+		{
+			mOrder[kept++] = moved[mOrder[i]];
+		}
+
+		if (i == mPosition)
+		{
+			position = kept - 1;
+		}
+	}
+
+	mOrder.resize(kept);
+	mPosition = position;
+
+	for (int i = mQueue.size() - 1; i >= 0; i--)
+	{
+		if (ids.contains(mQueue[i]))
+		{
+			mQueue.removeAt(i);
+		}
+	}
+
+	if (ids.contains(mCurrent))
+	{
+		mCurrent = 0;
+	}
+
+	rebuild();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Clear
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Clear ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Ids are not given out again, so an id kept from before the playlist was cleared finds nothing.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::Clear()
+{
+	mTracks.clear();
+	mIndexes.clear();
+	mOrder.clear();
+	mPositions.clear();
+	mQueue.clear();
+	mCurrent = 0;
+	mPosition = -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Size
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Size ()
+--
+-- RETURNS:			The number of tracks.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+int Playlist::Size() const
+{
+	return mTracks.size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Track
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Track (quint32 id)
+--						quint32 id: The track to find.
+--
+-- RETURNS:			The track, or a null pointer when it is not in the playlist. The pointer is only good until the
+--					playlist next changes.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+const PlaylistTrack * Playlist::Track(quint32 id) const
+{
+	int index = mIndexes.value(id, -1);
+
+	return index >= 0 ? &mTracks[index] : nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Current
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Current ()
+--
+-- RETURNS:			The id of the track playing, or 0 when there is none.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 Playlist::Current() const
+{
+	return mCurrent;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetCurrent
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetCurrent (quint32 id)
+--						quint32 id: The track that is now playing.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					A track played from the queue is taken off it and leaves the place in the order alone, so the
+--					order carries on where it was once the queue is empty. Any other track moves the place in the
+--					order to where that track is.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::SetCurrent(quint32 id)
+{
+	int index = mIndexes.value(id, -1);
+	if (index < 0)
+	{
+		return;
+	}
+
+	mCurrent = id;
+
+	if (!mQueue.isEmpty() && mQueue.first() == id)
+	{
+		mQueue.removeFirst();
+		return;
+	}
+
+	mPosition = mPositions[index];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Next
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Next (bool skip)
+--						bool skip: True when the user skips the song, false when it plays to the end.
+--
+-- RETURNS:			The id of the track to play after the current one, or 0 when there is none.
+--
+-- NOTES:
+--					Nothing is moved, the track becomes current when SetCurrent is called as it starts. Repeating
+--					one song plays the current song again when it ends, but still lets the user skip to the next.
+--					Without repeat the end of the order is the end of the playlist.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 Playlist::Next(bool skip) const
+{
+	if (mRepeat == RepeatOne && !skip && mCurrent != 0)
+	{
+		return mCurrent;
+	}
+
+	if (!mQueue.isEmpty())
+	{
+		return mQueue.first();
+	}
+
+	if (mOrder.isEmpty())
+	{
+		return 0;
+	}
+
+	int position = mPosition + 1;
+	if (position >= mOrder.size())
+	{
+		if (mRepeat == RepeatOff)
+		{
+			return 0;
+		}
+
+		position = 0;
+	}
+
+	return mTracks[mOrder[position]].id;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Previous
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Previous ()
+--
+-- RETURNS:			The id of the track before the current one, or 0 when there is none.
+--
+-- NOTES:
+--					While a track from the queue or one that was taken out is current, the previous track is the last
+--					one played from the order.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 Playlist::Previous() const
+{
+	if (mOrder.isEmpty())
+	{
+		return 0;
+	}
+
+	int position = mPosition;
+	if (position < 0 || (mCurrent != 0 && mTracks[mOrder[position]].id == mCurrent))
+	{
+		position--;
+	}
+
+	if (position < 0)
+	{
+		if (mRepeat == RepeatOff)
+		{
+			return 0;
+		}
+
+		position = mOrder.size() - 1;
+	}
+
+	return mTracks[mOrder[position]].id;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Enqueue
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Enqueue (quint32 id)
+--						quint32 id: The track to play next.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The track is played after the tracks already queued.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::Enqueue(quint32 id)
+{
+	if (mIndexes.contains(id))
+	{
+		mQueue.append(id);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetShuffle
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetShuffle (bool shuffle)
+--						bool shuffle: True to play the tracks in a shuffled order, false for list order.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Shuffling puts the current track first and shuffles the rest after it, so every other track is
+--					played once before any is played again. Going back to list order carries on from the current
+--					track.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::SetShuffle(bool shuffle)
+{
+	mShuffle = shuffle;
+
+	mOrder.resize(mTracks.size());
+	for (int i = 0; i < mOrder.size(); i++)
+	{
+		mOrder[i] = i;
+	}
+
+	int current = mIndexes.value(mCurrent, -1);
+
+	if (mShuffle)
+	{
+		if (current >= 0)
+		{
+			qSwap(mOrder[0], mOrder[current]);
+		}
+
+		mPosition = current >= 0 ? 0 : -1;
+		this->shuffle(mPosition + 1);
+	}
+	else
+	{
+		mPosition = current;
+	}
+
+	rebuild();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetRepeat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetRepeat (RepeatMode repeat)
+--						RepeatMode repeat: Whether to stop at the end, go round again, or play the same song again.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					A shuffled playlist goes round the same shuffle again when it repeats.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::SetRepeat(RepeatMode repeat)
+{
+	mRepeat = repeat;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsShuffled
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsShuffled ()
+--
+-- RETURNS:			True if the tracks are played in a shuffled order.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+bool Playlist::IsShuffled() const
+{
+	return mShuffle;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Repeat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Repeat ()
+--
+-- RETURNS:			What happens when the end of the order or of a song is reached.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+Playlist::RepeatMode Playlist::Repeat() const
+{
+	return mRepeat;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		shuffle
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		shuffle (int from)
+--						int from: The first place in the order to shuffle, everything before it is left alone.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					A Fisher-Yates shuffle from a linear congruential generator, so it takes one pass and every order
+--					is as likely. The high bits of the generator are used since the low bits repeat quickly.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::shuffle(int from)
+{
+	for (int i = mOrder.size() - 1; i > from; i--)
+	{
+		mSeed = mSeed * 1664525 + 1013904223;
+		int j = from + (int)(((quint64)(mSeed >> 8) * (i - from + 1)) >> 24);
+
+		qSwap(mOrder[i], mOrder[j]);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		rebuild
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		rebuild ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Works out where every track is in the list and in the order again after either has changed.
+----------------------------------------------------------------------------------------------------------------------*/
+void Playlist::rebuild()
+{
+	mIndexes.clear();
+	mIndexes.reserve(mTracks.size());
+	for (int i = 0; i < mTracks.size(); i++)
+	{
+		mIndexes.insert(mTracks[i].id, i);
+	}
+
+	mPositions.resize(mTracks.size());
+	for (int i = 0; i < mOrder.size(); i++)
+	{
+		mPositions[mOrder[i]] = i;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include "globals.h"
+
+// A song in a playlist, either a local song by its path from the song folder or a song of someone in the session
+struct PlaylistTrack
+{
+	quint32 id;
+	QString song;
+	QString owner;
+	quint32 size;
+	quint32 modified;
+
+	bool IsRemote() const { return !owner.isEmpty(); }
+};
+
+// The songs that can be played and the order they are played in, kept apart from the lists that show them
+class Playlist
+{
+public:
+	enum RepeatMode
+	{
+		RepeatOff,
+		RepeatAll,
+		RepeatOne
+	};
+
+	Playlist(quint32 seed = 0);
+
+	quint32 Insert(int index, const PlaylistTrack & track);
+	quint32 Insert(int index, const QVector<PlaylistTrack> & tracks);
+	void Remove(quint32 id);
+	void Remove(const QSet<quint32> & ids);
+	void Clear();
+
+	int Size() const;
+	const PlaylistTrack * Track(quint32 id) const;
+
+	quint32 Current() const;
+	void SetCurrent(quint32 id);
+	quint32 Next(bool skip) const;
+	quint32 Previous() const;
+	void Enqueue(quint32 id);
+
+	void SetShuffle(bool shuffle);
+	void SetRepeat(RepeatMode repeat);
+	bool IsShuffled() const;
+	RepeatMode Repeat() const;
+
+private:
+	QVector<PlaylistTrack> mTracks;
+	QHash<quint32, int> mIndexes;
+	quint32 mNextId;
+
+	// The order the tracks are played in, as indexes into the tracks, and where in that order every track is
+	QVector<int> mOrder;
+	QVector<int> mPositions;
+
+	// The track playing, where the last track played from the order is, and the tracks asked to be played next
+	quint32 mCurrent;
+	int mPosition;
+	QList<quint32> mQueue;
+
+	bool mShuffle;
+	RepeatMode mRepeat;
+	quint32 mSeed;
+
+	void shuffle(int from);
+	void rebuild();
+};
@@ -0,0 +1,342 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		RingBuffer.cpp - A wait free single producer, single consumer queue of bytes.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					RingBuffer(int capacity)
+--					~RingBuffer()
+--					int Write(const char * data, int size)
+--					int Read(char * data, int size)
+--					int Skip(int size)
+--					void Clear()
+--					int Available() const
+--					int Free() const
+--					int Capacity() const
+--					int Underruns() const
+--					int Overruns() const
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Hands audio from one thread to another without locks. One thread writes and one thread reads, and
+--					neither ever waits for the other or allocates memory, so the reading side can be an audio device
+--					that must never be held up.
+--
+--					The read and write positions count up forever and are only masked when the buffer is indexed, so
+--					a full buffer and an empty one can be told apart without wasting a byte. The writer publishes its
+--					position with a release store after copying the data in, and the reader loads it with an acquire,
+--					so the reader never sees a position before the bytes behind it. The same goes the other way for
+--					space freed by the reader.
+--
+--					A write that does not fit is dropped whole and counted as an overrun, so a block of audio is never
+--					cut in the middle of a sample. A read that finds less than it asked for is counted as an underrun.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "RingBuffer.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RingBuffer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RingBuffer (int capacity)
+--						int capacity: The least number of bytes the buffer must hold.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The capacity is rounded up to a power of two so positions can be masked instead of divided.
+----------------------------------------------------------------------------------------------------------------------*/
+RingBuffer::RingBuffer(int capacity)
+	: mCapacity(1)
+	, mWrite(0)
+	, mRead(0)
+	, mUnderruns(0)
+	, mOverruns(0)
+{
+	while (mCapacity < capacity)
+	{
+		mCapacity <<= 1;
+	}
+
+	mMask = mCapacity - 1;
+	mData = new char[mCapacity];
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~RingBuffer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~RingBuffer ()
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+RingBuffer::~RingBuffer()
+{
+	delete[] mData;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Write
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Write (const char * data, int size)
+--						const char * data: The bytes to add.
+--						int size: The number of bytes.
+--
+-- RETURNS:			size if the bytes were added, 0 if they did not fit.
+--
+-- NOTES:
+--					Only the producer may call this.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Write(const char * data, int size)
+{
+	if (size <= 0)
+	{
+		return 0;
+	}
+
+	quint32 write = (quint32)mWrite.load();
+	quint32 read = (quint32)mRead.loadAcquire();
+
+	if (size > mCapacity - (int)(write - read))
+	{
+		mOverruns.fetchAndAddRelaxed(1);
+		return 0;
+	}
+
+	int start = (int)(write & mMask);
+	int first = qMin(size, mCapacity - start);
+	memcpy(mData + start, data, first);
+	memcpy(mData, data + first, size - first);
+
+	mWrite.storeRelease((int)(write + size));
+	return size;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Read
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Read (char * data, int size)
+--						char * data: Where the bytes are copied to.
+--						int size: The most bytes to take.
+--
+-- RETURNS:			The number of bytes taken.
+--
+-- NOTES:
+--					Only the consumer may call this.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Read(char * data, int size)
+{
+	if (size <= 0)
+	{
+		return 0;
+	}
+
+	quint32 read = (quint32)mRead.load();
+	quint32 write = (quint32)mWrite.loadAcquire();
+
+	int count = qMin(size, (int)(write - read));
+	if (count < size)
+	{
+		mUnderruns.fetchAndAddRelaxed(1);
+	}
+
+	int start = (int)(read & mMask);
+	int first = qMin(count, mCapacity - start);
+	memcpy(data, mData + start, first);
+	memcpy(data + first, mData, count - first);
+
+	mRead.storeRelease((int)(read + count));
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Skip
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Skip (int size)
+--						int size: The most bytes to drop.
+--
+-- RETURNS:			The number of bytes dropped.
+--
+-- NOTES:
+--					Drops the oldest bytes without copying them. Only the consumer may call this.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Skip(int size)
+{
+	quint32 read = (quint32)mRead.load();
+	quint32 write = (quint32)mWrite.loadAcquire();
+
+	int count = qBound(0, size, (int)(write - read));
+	mRead.storeRelease((int)(read + count));
+
+	return count;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Clear
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Clear ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Empties the buffer and resets the counters. Only safe while nothing else is using the buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+void RingBuffer::Clear()
+{
+	mWrite.store(0);
+	mRead.store(0);
+	mUnderruns.store(0);
+	mOverruns.store(0);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Available
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Available ()
+--
+-- RETURNS:			The number of bytes waiting to be read. From the producer it may be more than there really are.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Available() const
+{
+	return (int)((quint32)mWrite.loadAcquire() - (quint32)mRead.loadAcquire());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Free
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Free ()
+--
+-- RETURNS:			The number of bytes that can be written. From the consumer it may be more than there really are.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Free() const
+{
+	return mCapacity - Available();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Capacity
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Capacity ()
+--
+-- RETURNS:			The size of the buffer in bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Capacity() const
+{
+	return mCapacity;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Underruns
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Underruns ()
+--
+-- RETURNS:			How many reads found less than they asked for.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Underruns() const
+{
+	return mUnderruns.load();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Overruns
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Overruns ()
+--
+-- RETURNS:			How many writes were dropped because the buffer was full.
+----------------------------------------------------------------------------------------------------------------------*/
+int RingBuffer::Overruns() const
+{
+	return mOverruns.load();
+}
\ No newline at end of file
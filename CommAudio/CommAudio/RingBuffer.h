@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QAtomicInt>
+
+#include <cstring>
+
+class RingBuffer
+{
+public:
+	RingBuffer(int capacity);
+	~RingBuffer();
+
+	int Write(const char * data, int size);
+	int Read(char * data, int size);
+	int Skip(int size);
+	void Clear();
+
+	int Available() const;
+	int Free() const;
+	int Capacity() const;
+
+	int Underruns() const;
+	int Overruns() const;
+
+private:
+	char * mData;
+	int mCapacity;
+	int mMask;
+
+	// Free running positions, only the producer stores mWrite and only the consumer stores mRead
+	QAtomicInt mWrite;
+	QAtomicInt mRead;
+
+	QAtomicInt mUnderruns;
+	QAtomicInt mOverruns;
+
+	RingBuffer(const RingBuffer &) = delete;
+	RingBuffer & operator=(const RingBuffer &) = delete;
+};
\ No newline at end of file
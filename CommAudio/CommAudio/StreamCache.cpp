@@ -0,0 +1,639 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		StreamCache.cpp - A size bounded disk cache for songs that have been streamed.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					StreamCache(const QDir & directory, qint64 maxSize)
+--					~StreamCache()
+--					static QByteArray Key(const QString & owner, const QString & song, quint32 size, quint32 modified)
+--					Result Lookup(const QByteArray & key, QByteArray & formatPacket, QByteArray & audio)
+--					void Begin(const QByteArray & key, const QByteArray & formatPacket)
+--					void Append(const QByteArray & key, const QByteArray & audio)
+--					void Finish(const QByteArray & key, bool complete)
+--					QFile * Open(const QByteArray & key)
+--					bool IsWriting(const QByteArray & key) const
+--					QList<QByteArray> Keys() const
+--					Stats GetStats() const
+--					double HitRate() const
+--					QString entryPath(const QByteArray & key) const
+--					void remove(const QByteArray & key)
+--					void evict()
+--					void loadIndex()
+--					void saveIndex()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Cached songs can be opened for reading so they can be relayed.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Every song that is streamed is written through to a file in the cache directory. The file is named
+--					after a hash of the owner, song name, file size and modification time of the song so a song that
+--					changes on the owner's side is never served stale. Each file holds the format packet of the stream
+--					followed by the audio that has been received so far, which lets a partially streamed song be played
+--					from disk while the rest is fetched. When the cache grows past its limit the least recently used
+--					songs are removed. The index of the cache is saved so that it survives restarts.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "StreamCache.h"
+
+#define CACHE_INDEX_FILE "index.dat"
+#define CACHE_INDEX_VERSION 1
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		StreamCache
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		StreamCache (const QDir & directory, qint64 maxSize)
+--						const QDir & directory: The directory to keep the cached songs in.
+--						qint64 maxSize: The maximum number of bytes the cache may use.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates the cache directory if needed and loads the index of previously cached songs.
+----------------------------------------------------------------------------------------------------------------------*/
+StreamCache::StreamCache(const QDir & directory, qint64 maxSize)
+	: mDirectory(directory)
+	, mMaxSize(maxSize)
+	, mTotalSize(0)
+	, mStats()
+{
+	mDirectory.mkpath(".");
+	loadIndex();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~StreamCache
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~StreamCache ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Closes every song that is still being written as a partial song and saves the index.
+----------------------------------------------------------------------------------------------------------------------*/
+StreamCache::~StreamCache()
+{
+	QList<QByteArray> keys = mWriters.keys();
+
+	for (int i = 0; i < keys.size(); i++)
+	{
+		Finish(keys[i], false);
+	}
+
+	saveIndex();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Key
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Key (const QString & owner, const QString & song, quint32 size, quint32 modified)
+--						const QString & owner: The name of the owner of the song.
+--						const QString & song: The name of the song.
+--						quint32 size: The size of the song file on the owner's machine.
+--						quint32 modified: The modification time of the song file on the owner's machine.
+--
+-- RETURNS:			The key of the song in the cache.
+--
+-- NOTES:
+--					Hashes everything that identifies the contents of the song into a key.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray StreamCache::Key(const QString & owner, const QString & song, quint32 size, quint32 modified)
+{
+	QCryptographicHash hasher(QCryptographicHash::Sha1);
+
+	QByteArray sizes;
+	sizes << size << modified;
+
+	hasher.addData(owner.toUtf8());
+	hasher.addData(QByteArray(1, 0));
+	hasher.addData(song.toUtf8());
+	hasher.addData(QByteArray(1, 0));
+	hasher.addData(sizes);
+
+	return hasher.result().toHex();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Lookup
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Lookup (const QByteArray & key, QByteArray & formatPacket, QByteArray & audio)
+--						const QByteArray & key: The key of the song.
+--						QByteArray & formatPacket: Set to the format packet of the cached stream.
+--						QByteArray & audio: Set to the audio that is cached.
+--
+-- RETURNS:			Hit if the whole song is cached, Partial if only the start of the song is cached, otherwise Miss.
+--
+-- NOTES:
+--					Reads the cached song and marks it as the most recently used. The hit counters are updated here.
+----------------------------------------------------------------------------------------------------------------------*/
+StreamCache::Result StreamCache::Lookup(const QByteArray & key, QByteArray & formatPacket, QByteArray & audio)
+{
+	if (!mEntries.contains(key) || mWriters.contains(key))
+	{
+		mStats.misses++;
+		return Result::Miss;
+	}
+
+	QFile file(entryPath(key));
+	if (!file.open(QFile::ReadOnly) || file.size() < STREAM_FORMAT_SIZE)
+	{
+		remove(key);
+		mStats.misses++;
+		return Result::Miss;
+	}
+
+	formatPacket = file.read(STREAM_FORMAT_SIZE);
+	audio = file.readAll();
+	file.close();
+
+	mEntries[key].lastUsed = QDateTime::currentMSecsSinceEpoch();
+	mStats.bytesFromCache += audio.size();
+
+	if (mEntries[key].complete)
+	{
+		mStats.hits++;
+		return Result::Hit;
+	}
+
+	mStats.partialHits++;
+	return Result::Partial;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Begin
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Begin (const QByteArray & key, const QByteArray & formatPacket)
+--						const QByteArray & key: The key of the song.
+--						const QByteArray & formatPacket: The format packet of the stream.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Opens the song for writing. A partial song is appended to, otherwise a new file is started with
+--					the format packet of the stream.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamCache::Begin(const QByteArray & key, const QByteArray & formatPacket)
+{
+	if (mWriters.contains(key) || (mEntries.contains(key) && mEntries[key].complete))
+	{
+		return;
+	}
+
+	QFile * file = new QFile(entryPath(key));
+
+	if (mEntries.contains(key))
+	{
+		file->open(QFile::WriteOnly | QFile::Append);
+	}
+	else
+	{
+		file->open(QFile::WriteOnly | QFile::Truncate);
+		file->write(formatPacket);
+
+		Entry entry;
+		entry.size = formatPacket.size();
+		entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+		entry.complete = false;
+
+		mEntries[key] = entry;
+		mTotalSize += entry.size;
+	}
+
+	mWriters[key] = file;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Append
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Append (const QByteArray & key, const QByteArray & audio)
+--						const QByteArray & key: The key of the song.
+--						const QByteArray & audio: The audio that was just received.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Writes the audio through to the end of the cached song and evicts old songs if the cache is full.
+--					The file is flushed so that a song that is being relayed can be read while it is still arriving.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamCache::Append(const QByteArray & key, const QByteArray & audio)
+{
+	if (!mWriters.contains(key))
+	{
+		return;
+	}
+
+	mWriters[key]->write(audio);
+	mWriters[key]->flush();
+	mEntries[key].size += audio.size();
+	mTotalSize += audio.size();
+	mStats.bytesFromNetwork += audio.size();
+
+	if (mTotalSize > mMaxSize)
+	{
+		evict();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Finish
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Finish (const QByteArray & key, bool complete)
+--						const QByteArray & key: The key of the song.
+--						bool complete: Whether the whole song has been received.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Closes the song. Songs that were not completed are kept so that they can be resumed later.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamCache::Finish(const QByteArray & key, bool complete)
+{
+	if (!mWriters.contains(key))
+	{
+		return;
+	}
+
+	QFile * file = mWriters.take(key);
+	file->close();
+	delete file;
+
+	mEntries[key].complete = complete;
+	saveIndex();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Open
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Open (const QByteArray & key)
+--						const QByteArray & key: The key of the song.
+--
+-- RETURNS:			The cached song opened for reading at its format packet, or nullptr if the song is not cached.
+--
+-- NOTES:
+--					Unlike Lookup, the song may still be being written and nothing is read into memory. The caller
+--					owns the file. The song is marked as the most recently used but the hit counters are not touched
+--					because the song is being read for someone else.
+----------------------------------------------------------------------------------------------------------------------*/
+QFile * StreamCache::Open(const QByteArray & key)
+{
+	if (!mEntries.contains(key))
+	{
+		return nullptr;
+	}
+
+	QFile * file = new QFile(entryPath(key));
+	if (!file->open(QFile::ReadOnly) || file->size() < STREAM_FORMAT_SIZE)
+	{
+		delete file;
+		return nullptr;
+	}
+
+	mEntries[key].lastUsed = QDateTime::currentMSecsSinceEpoch();
+	return file;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsWriting
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsWriting (const QByteArray & key)
+--						const QByteArray & key: The key of the song.
+--
+-- RETURNS:			True if more of the song is still being received, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool StreamCache::IsWriting(const QByteArray & key) const
+{
+	return mWriters.contains(key);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Keys
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Keys ()
+--
+-- RETURNS:			The keys of every song in the cache, whole or partial.
+----------------------------------------------------------------------------------------------------------------------*/
+QList<QByteArray> StreamCache::Keys() const
+{
+	return mEntries.keys();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		GetStats
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		GetStats ()
+--
+-- RETURNS:			The hit counters of the cache.
+--
+-- NOTES:
+--					Returns the number of lookups that hit, partially hit and missed along with the bytes served.
+----------------------------------------------------------------------------------------------------------------------*/
+StreamCache::Stats StreamCache::GetStats() const
+{
+	return mStats;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		HitRate
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		HitRate ()
+--
+-- RETURNS:			The fraction of lookups that were served without any network traffic.
+--
+-- NOTES:
+--					Partial hits are not counted as hits because the rest of the song still had to be fetched.
+----------------------------------------------------------------------------------------------------------------------*/
+double StreamCache::HitRate() const
+{
+	quint64 lookups = mStats.hits + mStats.partialHits + mStats.misses;
+
+	if (lookups == 0)
+	{
+		return 0;
+	}
+
+	return (double)mStats.hits / (double)lookups;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		entryPath
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		entryPath (const QByteArray & key)
+--						const QByteArray & key: The key of the song.
+--
+-- RETURNS:			The path of the file that holds the song.
+----------------------------------------------------------------------------------------------------------------------*/
+QString StreamCache::entryPath(const QByteArray & key) const
+{
+	return mDirectory.absoluteFilePath(QString(key) + ".pcm");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		remove
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		remove (const QByteArray & key)
+--						const QByteArray & key: The key of the song.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Deletes the song from the disk and from the index.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamCache::remove(const QByteArray & key)
+{
+	mTotalSize -= mEntries.take(key).size;
+	QFile::remove(entryPath(key));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		evict
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		evict ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Removes the least recently used songs until the cache is back under its size limit. Songs that
+--					are still being written are never evicted.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamCache::evict()
+{
+	while (mTotalSize > mMaxSize)
+	{
+		QByteArray oldest;
+		qint64 oldestTime = 0;
+
+		for (QMap<QByteArray, Entry>::const_iterator it = mEntries.constBegin(); it != mEntries.constEnd(); ++it)
+		{
+			if (!mWriters.contains(it.key()) && (oldest.isEmpty() || it.value().lastUsed < oldestTime))
+			{
+				oldest = it.key();
+				oldestTime = it.value().lastUsed;
+			}
+		}
+
+		if (oldest.isEmpty())
+		{
+			break;
+		}
+
+		remove(oldest);
+	}
+
+	saveIndex();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		loadIndex
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		loadIndex ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Reads the index of the cache from disk. Entries whose file is gone are dropped and the size of
+--					every entry is taken from its file in case the application was closed mid write.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamCache::loadIndex()
+{
+	QFile index(mDirectory.absoluteFilePath(CACHE_INDEX_FILE));
+	if (!index.open(QFile::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&index);
+
+	quint32 version = 0;
+	quint32 count = 0;
+	stream >> version >> count;
+
+	if (version != CACHE_INDEX_VERSION)
+	{
+		return;
+	}
+
+	for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++)
+	{
+		QByteArray key;
+		Entry entry;
+
+		stream >> key >> entry.lastUsed >> entry.complete;
+
+		QFile file(entryPath(key));
+		if (!file.exists())
+		{
+			continue;
+		}
+
+		entry.size = file.size();
+		mEntries[key] = entry;
+		mTotalSize += entry.size;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		saveIndex
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		saveIndex ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Writes the key, last use time and completeness of every cached song to the index file.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamCache::saveIndex()
+{
+	QFile index(mDirectory.absoluteFilePath(CACHE_INDEX_FILE));
+	if (!index.open(QFile::WriteOnly | QFile::Truncate))
+	{
+		return;
+	}
+
+	QDataStream stream(&index);
+	stream << (quint32)CACHE_INDEX_VERSION << (quint32)mEntries.size();
+
+	for (QMap<QByteArray, Entry>::const_iterator it = mEntries.constBegin(); it != mEntries.constEnd(); ++it)
+	{
+		stream << it.key() << it.value().lastUsed << it.value().complete;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include "globals.h"
+
+class StreamCache
+{
+public:
+	enum Result
+	{
+		Miss,
+		Partial,
+		Hit
+	};
+
+	struct Stats
+	{
+		quint64 hits;
+		quint64 partialHits;
+		quint64 misses;
+		quint64 bytesFromCache;
+		quint64 bytesFromNetwork;
+	};
+
+	StreamCache(const QDir & directory, qint64 maxSize);
+	~StreamCache();
+
+	static QByteArray Key(const QString & owner, const QString & song, quint32 size, quint32 modified);
+
+	Result Lookup(const QByteArray & key, QByteArray & formatPacket, QByteArray & audio);
+	void Begin(const QByteArray & key, const QByteArray & formatPacket);
+	void Append(const QByteArray & key, const QByteArray & audio);
+	void Finish(const QByteArray & key, bool complete);
+
+	QFile * Open(const QByteArray & key);
+	bool IsWriting(const QByteArray & key) const;
+	QList<QByteArray> Keys() const;
+
+	Stats GetStats() const;
+	double HitRate() const;
+
+private:
+	struct Entry
+	{
+		qint64 size;
+		qint64 lastUsed;
+		bool complete;
+	};
+
+	QDir mDirectory;
+	qint64 mMaxSize;
+	qint64 mTotalSize;
+
+	QMap<QByteArray, Entry> mEntries;
+	QMap<QByteArray, QFile *> mWriters;
+
+	Stats mStats;
+
+	QString entryPath(const QByteArray & key) const;
+	void remove(const QByteArray & key);
+	void evict();
+	void loadIndex();
+	void saveIndex();
+};
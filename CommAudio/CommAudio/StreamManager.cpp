@@ -7,14 +7,43 @@
 --					StreamManager(const QByteArray * key, QDir * source, QDir * downloads, QWidget * parent = nullptr)
 --					~StreamManager()
 --					void uploadSong(QByteArray data, QTcpSocket * socket)
+--					void uploadCachedSong(QByteArray data, QTcpSocket * socket)
+--					void startUpload(QTcpSocket * socket, QIODevice * file, const QAudioFormat & format, qint64 remaining,
+--						const QByteArray & cacheKey)
+--					void feedRelays(const QByteArray & key)
+--					void sendFrames(QTcpSocket * socket)
+--					void finishUpload(QTcpSocket * socket)
+--					bool receiveFrames(QTcpSocket * socket)
+--					void adaptTier(QTcpSocket * socket)
+--					bool parseStreamFormat(const QByteArray & packet, QAudioFormat & format, quint32 & dataLength)
 --					void newConnectionHandler()
 --					void incomingDataHandler()
 --					void disconnectHandler()
---					void StreamSong(QString songName, quint32 address)
+--					void uploadHandler()
+--					void songReadyHandler()
+--					void stopStream()
+--					void requestSong(const SongRequest & song, bool prefetch)
+--					quint32 pickSource(const SongRequest & song, const QByteArray & key)
+--					void openSource(quint32 address, PlaybackFeed * feed)
+--					void StreamSong(QString songName, quint32 address, QString owner, quint32 size, quint32 modified)
+--					void PrefetchSong(QString songName, quint32 address, QString owner, quint32 size, quint32 modified)
+--					StreamCache::Stats CacheStats() const
+--					double CacheHitRate() const
+--					void AddRelay(const QByteArray & key, quint32 address)
+--					void SetPeerLoad(quint32 address, quint8 load)
+--					void RemovePeer(quint32 address)
+--					quint8 Load() const
+--					QList<QByteArray> RelayKeys() const
 --
 -- DATE:			April 14, 2018
 --
--- REVISIONS:		N/A
+-- REVISIONS:		October 19, 2026 - agent: Streamed songs are written through to a disk cache.
+--					October 19, 2026 - agent: The next song can be streamed ahead of time for gapless playback.
+--					October 19, 2026 - agent: Songs are streamed in frames at a quality tier picked by the receiver.
+--					October 19, 2026 - agent: Peers relay the songs they have cached to other listeners.
+--					October 19, 2026 - agent: The format of an uploaded song is found by WavParser.
+--					October 19, 2026 - agent: Streams are received into a PlaybackFeed, which the audio thread reads
+--									without waiting on the GUI thread.
 --
 -- DESIGNER:		Benny Wang
 --					Angus Lam
@@ -25,10 +54,24 @@
 --					Roger Zhang
 --
 -- NOTES:
---					This is a class that encapsulates all the audio streaming for the application.
+--					This is a class that encapsulates all the audio streaming for the application. Every song that
+--					is streamed is kept in a StreamCache so that playing it again does not touch the network.
+--
+--					After the format of the song, the audio is sent in frames of STREAM_FRAME_SIZE sample frames:
+--						quint8 tier, quint32 bytes of the song the frame covers, quint32 payload size, payload.
+--					The uploader only keeps STREAM_UPLOAD_WINDOW bytes in flight, so the rate the receiver measures is
+--					the rate of the network. The receiver watches that rate and how many seconds of audio it has
+--					buffered, and asks the uploader for a lower or higher tier with a RequestStreamTier packet.
+--
+--					Any peer that is receiving or has cached a song can serve it to others from its cache, which is
+--					announced to the session by CommAudio. A listener asks the least loaded of the owner and the relays
+--					for the song, so the owner only uploads to a few peers that pass the song on. If a relay cannot
+--					finish a song, the rest of it is requested from the owner without interrupting playback.
 ----------------------------------------------------------------------------------------------------------------------*/
 #include <StreamManager.h>
 
+#include <QtEndian>
+
 /*------------------------------------------------------------------------------------------------------------------
 -- FUNCTION:		StreamManager
 --
@@ -61,7 +104,19 @@ StreamManager::StreamManager(const QByteArray * key, QDir * source, QDir * downl
 	, mSource(source)
 	, mDownloads(downloads)
 	, mServer(this)
+	, mCache(QDir(QDir::homePath() + STREAM_CACHE_FOLDER), STREAM_CACHE_SIZE)
 	, mSongSource(0)
+	, mStreamLength(0)
+	, mReceived(0)
+	, mStreamStarted(false)
+	, mPrefetching(false)
+	, mHasPendingPrefetch(false)
+	, mTier(StreamTiers::FullTier)
+	, mReceivedTier(StreamTiers::FullTier)
+	, mDecoder(TierCodec::DecodeState())
+	, mWindowBytes(0)
+	, mThroughput(0)
+	, mFromRelay(false)
 {
 	connect(&mServer, &QTcpServer::newConnection, this, &StreamManager::newConnectionHandler);
 	mServer.listen(QHostAddress::AnyIPv4, STREAM_PORT);
@@ -72,7 +127,7 @@ StreamManager::StreamManager(const QByteArray * key, QDir * source, QDir * downl
 --
 -- DATE:			April 14, 2018
 --
--- REVISIONS:		N/A	
+-- REVISIONS:		October 19, 2026 - agent: Closes the connections peers opened to us as well.
 --
 -- DESIGNER:		Benny Wang
 --					Angus Lam
@@ -86,16 +141,34 @@ StreamManager::StreamManager(const QByteArray * key, QDir * source, QDir * downl
 -- RETURNS:			N/A
 --
 -- NOTES:
---					The deconstructor of the StreamManger. This is where all the remain connections are closed.
+--					The deconstructor of the StreamManger. This is where all the remain connections are closed. A song
+--					that is still being streamed is kept in the cache as a partial song.
 ----------------------------------------------------------------------------------------------------------------------*/
 StreamManager::~StreamManager()
 {
+	if (!mCacheKey.isEmpty())
+	{
+		mCache.Finish(mCacheKey, false);
+	}
+
+	QList<QTcpSocket *> uploads = mUploads.keys();
+
+	for (int i = 0; i < uploads.size(); i++)
+	{
+		finishUpload(uploads[i]);
+	}
+
 	QList<quint32> keys = mConnections.keys();
 
 	for (int i = 0; i < keys.size(); i++)
 	{
 		mConnections[keys[i]]->close();
 	}
+
+	for (int i = 0; i < mIncoming.size(); i++)
+	{
+		mIncoming[i]->close();
+	}
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -103,7 +176,7 @@ StreamManager::~StreamManager()
 --
 -- DATE:			April 14, 2018
 --
--- REVISIONS:		N/A	
+-- REVISIONS:		October 19, 2026 - agent: Connections peers open to us are kept apart from the ones we open.
 --
 -- DESIGNER:		Benny Wang
 --					Angus Lam
@@ -118,15 +191,15 @@ StreamManager::~StreamManager()
 --
 -- NOTES:
 --					This is a Qt slot that is triggered when a new connection has been accepted. The connection is 
---					stored in a map of connections. In addition the socket is connected with the related qt slots of this
---					class for handling new data and disconnections.
+--					stored apart from the connections we open so a peer that streams from us can still be streamed
+--					from. In addition the socket is connected with the related qt slots of this class for handling new
+--					data and disconnections.
 ----------------------------------------------------------------------------------------------------------------------*/
 void StreamManager::newConnectionHandler()
 {
 	QTcpSocket * socket = mServer.nextPendingConnection();
-	quint32 address = socket->peerAddress().toIPv4Address();
 
-	mConnections[address] = socket;
+	mIncoming.append(socket);
 	connect(socket, &QTcpSocket::readyRead, this, &StreamManager::incomingDataHandler);
 	connect(socket, &QTcpSocket::disconnected, this, &StreamManager::disconnectHandler);
 }
@@ -136,7 +209,8 @@ void StreamManager::newConnectionHandler()
 --
 -- DATE:			April 14, 2018
 --
--- REVISIONS:		N/A	
+-- REVISIONS:		October 19, 2026 - agent: A connection a peer opened to us never ends the song we are streaming.
+--					October 19, 2026 - agent: The song is received into a PlaybackFeed.
 --
 -- DESIGNER:		Benny Wang
 --					Angus Lam
@@ -151,20 +225,98 @@ void StreamManager::newConnectionHandler()
 --
 -- NOTES:
 --					This is a Qt slot that is triggered when a socket has disconnected. The socket is removed from the
---					map of connections along with its associated buffer.
+--					map of connections along with its associated feed. If the song was cut off before all of it was
+--					received, what did arrive stays in the cache so the rest can be fetched the next time. A song that
+--					was waiting to be prefetched is started once the song before it is done. A song that was being
+--					uploaded on the socket is closed. If a relay stopped before the whole song was received, the rest
+--					of the song is requested from the owner into the same feed so playback carries on.
 ----------------------------------------------------------------------------------------------------------------------*/
 void StreamManager::disconnectHandler()
 {
 	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
 	quint32 address = socket->peerAddress().toIPv4Address();
+	bool wasSource = mSongSource == address;
+	bool resume = false;
+	QByteArray cacheKey = mCacheKey;
+
+	finishUpload(socket);
+
+	if (mIncoming.removeOne(socket))
+	{
+		socket->deleteLater();
+		return;
+	}
 
-	if (mSongSource == address)
+	if (wasSource)
 	{
 		mSongSource = 0;
+		resume = mFromRelay && (mFormatPacket.size() < STREAM_FORMAT_SIZE || mReceived < mStreamLength);
+
+		if (!mCacheKey.isEmpty())
+		{
+			mCache.Finish(mCacheKey, false);
+			mCacheKey.clear();
+			feedRelays(cacheKey);
+		}
 	}
 
 	mConnections.take(address)->deleteLater();
-	mBuffers.remove(address);
+	QPointer<PlaybackFeed> feed = mBuffers.take(address);
+
+	if (resume && !feed.isNull() && !mConnections.contains(mSong.address))
+	{
+		mRelays[StreamCache::Key(mSong.owner, mSong.songName, mSong.size, mSong.modified)].removeAll(address);
+		mCacheKey = cacheKey;
+		openSource(mSong.address, feed);
+		return;
+	}
+
+	if (wasSource && mHasPendingPrefetch)
+	{
+		mHasPendingPrefetch = false;
+		requestSong(mPendingPrefetch, true);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		stopStream
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		stopStream ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Drops the song that is currently being streamed. The part of the song that has been received is
+--					kept in the cache as a partial song.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::stopStream()
+{
+	if (!mCacheKey.isEmpty())
+	{
+		QByteArray cacheKey = mCacheKey;
+		mCache.Finish(mCacheKey, false);
+		mCacheKey.clear();
+		feedRelays(cacheKey);
+	}
+
+	if (mSongSource != 0 && mConnections.contains(mSongSource))
+	{
+		QTcpSocket * socket = mConnections.take(mSongSource);
+		disconnect(socket, nullptr, this, nullptr);
+		socket->abort();
+		socket->deleteLater();
+		mBuffers.remove(mSongSource);
+	}
+
+	mSongSource = 0;
 }
 
 /*------------------------------------------------------------------------------------------------------------------
@@ -172,7 +324,7 @@ void StreamManager::disconnectHandler()
 --
 -- DATE:			April 14, 2018
 --
--- REVISIONS:		N/A	
+-- REVISIONS:		October 19, 2026 - agent: The song is looked up in the cache before it is requested.
 --
 -- DESIGNER:		Benny Wang
 --					Angus Lam
@@ -181,24 +333,232 @@ void StreamManager::disconnectHandler()
 -- PROGRAMMER:		Roger Zhang
 --					Benny Wang
 --
--- INTERFACE:		StreamSong (QString songName, quint32 address)
+-- INTERFACE:		StreamSong (QString songName, quint32 address, QString owner, quint32 size, quint32 modified)
+--						QString songName: The name of the song to stream.
+--						quint32 address: The address of the person who owns the song.
+--						QString owner: The name of the person who owns the song.
+--						quint32 size: The size of the song file as listed by the owner.
+--						quint32 modified: The modification time of the song file as listed by the owner.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when the user clicks on a remote song. Any song that is
+--					already being streamed or prefetched is stopped and the song is played as soon as it is available.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::StreamSong(QString songName, quint32 address, QString owner, quint32 size, quint32 modified)
+{
+	mMediaPlayer->StartSkipTimer();
+	mHasPendingPrefetch = false;
+	stopStream();
+
+	if (mMediaPlayer->State() == MediaPlayer::PlayingState)
+	{
+		mMediaPlayer->Stop();
+	}
+
+	SongRequest song = { songName, address, owner, size, modified };
+	requestSong(song, false);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PrefetchSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PrefetchSong (QString songName, quint32 address, QString owner, quint32 size, quint32 modified)
 --						QString songName: The name of the song to stream.
 --						quint32 address: The address of the person who owns the song.
+--						QString owner: The name of the person who owns the song.
+--						quint32 size: The size of the song file as listed by the owner.
+--						quint32 modified: The modification time of the song file as listed by the owner.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered a few seconds before the stream that is playing ends. The song
+--					is streamed and queued in the media player to play right after the current one. Only one song is
+--					streamed at a time, so if the current song is still arriving the request waits for it to finish.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::PrefetchSong(QString songName, quint32 address, QString owner, quint32 size, quint32 modified)
+{
+	SongRequest song = { songName, address, owner, size, modified };
+
+	if (mSongSource != 0)
+	{
+		mPendingPrefetch = song;
+		mHasPendingPrefetch = true;
+		return;
+	}
+
+	requestSong(song, true);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		requestSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The song is requested from the least loaded peer that has it.
+--					October 19, 2026 - agent: The song is received into a PlaybackFeed.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		requestSong (const SongRequest & song, bool prefetch)
+--						const SongRequest & song: The song to stream.
+--						bool prefetch: Whether the song plays after the current one instead of right away.
 --
 -- RETURNS:			void.
 --
 -- NOTES:
---					This is a Qt slot that is triggered when the user presses a button to download a new song.
---					If there is already a request to that address in progress this request is ignored. Otherwise. A new
---					request and buffer are created.
+--					If the whole song is in the cache it is played straight from the cache and nothing is sent over
+--					the network. If only the start of the song is cached, that part is handed to the media player right
+--					away and the rest of the song is requested. Otherwise a new request and feed are created. A
+--					warning is logged if every peer that has the song is already streaming to us, and nothing is
+--					played unless part of the song is cached.
 ----------------------------------------------------------------------------------------------------------------------*/
-void StreamManager::StreamSong(QString songName, quint32 address)
+void StreamManager::requestSong(const SongRequest & song, bool prefetch)
 {
-	if (mConnections.contains(address))
+	QByteArray formatPacket;
+	QByteArray audio;
+	QByteArray key = StreamCache::Key(song.owner, song.songName, song.size, song.modified);
+	StreamCache::Result result = mCache.Lookup(key, formatPacket, audio);
+	emit cacheStatsChanged();
+
+	if (result != StreamCache::Result::Miss && !parseStreamFormat(formatPacket, mFormat, mStreamLength))
+	{
+		result = StreamCache::Result::Miss;
+		audio.clear();
+	}
+
+	quint32 source = result == StreamCache::Result::Hit ? 0 : pickSource(song, key);
+	if (result != StreamCache::Result::Hit && source == 0)
+	{
+		qWarning() << "No peer is free to stream" << song.songName;
+		if (result == StreamCache::Result::Miss)
+		{
+			return;
+		}
+	}
+
+	PlaybackFeed * feed = new PlaybackFeed(this);
+	feed->Write(audio);
+
+	mStreamStarted = false;
+	mPrefetching = prefetch;
+	if (result != StreamCache::Result::Miss)
+	{
+		if (prefetch)
+		{
+			mMediaPlayer->QueueStream(feed, mFormat, mStreamLength);
+		}
+		else
+		{
+			mMediaPlayer->StartStream(feed, mFormat, mStreamLength);
+		}
+		mStreamStarted = true;
+	}
+
+	if (source == 0)
 	{
 		return;
 	}
 
+	mSong = song;
+	mCacheKey = key;
+	mReceived = audio.size();
+
+	openSource(source, feed);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		pickSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		pickSource (const SongRequest & song, const QByteArray & key)
+--						const SongRequest & song: The song to stream.
+--						const QByteArray & key: The cache key of the song.
+--
+-- RETURNS:			The address to stream the song from, or 0 if every peer that has it is busy.
+--
+-- NOTES:
+--					Picks whichever of the owner and the peers relaying the song is uploading the fewest streams. Ties
+--					go to a relay so the owner's upload is saved for peers that have nowhere else to go. The pick is
+--					counted against the peer right away so that songs requested before its next announcement spread
+--					out as well. A peer that is already streaming to us is skipped, but one that is only streaming
+--					from us is not.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 StreamManager::pickSource(const SongRequest & song, const QByteArray & key)
+{
+	quint32 best = 0;
+	int bestLoad = 256;
+
+	if (!mConnections.contains(song.address))
+	{
+		best = song.address;
+		bestLoad = mPeerLoads.value(song.address);
+	}
+
+	QList<quint32> relays = mRelays.value(key);
+
+	for (int i = 0; i < relays.size(); i++)
+	{
+		if (mConnections.contains(relays[i]) || mPeerLoads.value(relays[i]) > bestLoad)
+		{
+			continue;
+		}
+
+		best = relays[i];
+		bestLoad = mPeerLoads.value(relays[i]);
+	}
+
+	if (best != 0 && bestLoad < 255)
+	{
+		mPeerLoads[best] = bestLoad + 1;
+	}
+
+	return best;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		openSource
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The song is received into a PlaybackFeed.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		openSource (quint32 address, PlaybackFeed * feed)
+--						quint32 address: The address of the owner or a relay of mSong.
+--						PlaybackFeed * feed: The feed the song is received into.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Connects to the peer and requests mSong from mReceived bytes into its audio. The owner is asked for
+--					the song by name while a relay is asked for it by its cache key. The decoder starts over, since a
+--					new source encodes the song afresh.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::openSource(quint32 address, PlaybackFeed * feed)
+{
 	QTcpSocket * socket = new QTcpSocket(this);
 	connect(socket, &QTcpSocket::readyRead, this, &StreamManager::incomingDataHandler);
 	connect(socket, &QTcpSocket::disconnected, this, &StreamManager::disconnectHandler);
@@ -206,14 +566,41 @@ void StreamManager::StreamSong(QString songName, quint32 address)
 	socket->connectToHost(QHostAddress(address), STREAM_PORT);
 	mConnections[address] = socket;
 	mSongSource = address;
+	mFromRelay = address != mSong.address;
+	mFormatPacket.clear();
+	mPendingFrames.clear();
+	mReceivedTier = mTier;
+	mDecoder = TierCodec::DecodeState();
+
+	mBuffers[address] = feed;
+
+	// The offset lets the source skip the part of the song that is already cached
+	QByteArray request;
+	if (mFromRelay)
+	{
+		request = QByteArray(1, (char)Headers::RequestRelayStream);
+		request.append(*mKey);
+		request.resize(1 + KEY_SIZE);
+		request.append(StreamCache::Key(mSong.owner, mSong.songName, mSong.size, mSong.modified));
+	}
+	else
+	{
+		QByteArray name = mSong.songName.toUtf8();
+		name.resize(SONGNAME_SIZE);
 
-	mBuffers[address] = new QBuffer(this);
-	mBuffers[address]->open(QIODevice::ReadWrite);
+		request = QByteArray(1, (char)Headers::RequestAudioStream);
+		request.append(*mKey);
+		request.resize(1 + KEY_SIZE);
+		request.append(name);
+	}
+	request << mReceived;
 
-	QByteArray request = QByteArray(1, (char)Headers::RequestAudioStream);
-	request.append(*mKey);
-	request.append(songName);
-	request.resize(1 + KEY_SIZE + SONGNAME_SIZE);
+	// Start at the tier the last song ended on, the network has not changed since then
+	if (mTier != StreamTiers::FullTier)
+	{
+		request.append((char)Headers::RequestStreamTier);
+		request << mTier;
+	}
 
 	socket->write(request);
 }
@@ -223,7 +610,8 @@ void StreamManager::StreamSong(QString songName, quint32 address)
 --
 -- DATE:			April 14, 2018
 --
--- REVISIONS:		N/A	
+-- REVISIONS:		October 19, 2026 - agent: Audio arrives in frames that may be at a lower tier.
+--					October 19, 2026 - agent: Only the connection we opened to the source carries the stream.
 --
 -- DESIGNER:		Benny Wang
 --					Angus Lam
@@ -239,28 +627,104 @@ void StreamManager::StreamSong(QString songName, quint32 address)
 -- NOTES:
 --					This is a Qt slot that is triggered when there is new data on the port. If the data is coming from
 --					the address that we have requested a song to be streamed form, the data is read off the socket and
---					stored in a buffer. If the buffer is not already being played then the buffer is passed to the
---					media player to be played. Otherwise, if a valid stream request is made, a song upload is initiated.
+--					stored in a buffer. The first bytes of every stream are the format of the song which are parsed
+--					before any audio is buffered. The frames after it are decoded by receiveFrames and about once a
+--					second the tier of the stream is reconsidered. The connection is closed once the whole song has
+--					arrived. Otherwise, if a valid stream or relay request is made, a song upload is initiated and any
+--					tier changes for that upload are applied.
 ----------------------------------------------------------------------------------------------------------------------*/
 void StreamManager::incomingDataHandler()
 {
 	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
 	quint32 address = socket->peerAddress().toIPv4Address();
 
-	if (address == mSongSource)
+	if (address == mSongSource && mConnections.value(address) == socket)
 	{
-		mBuffers[address]->buffer().append(socket->readAll());
-		if (mMediaPlayer->State() == MediaPlayer::StoppedState)
+		QByteArray data = socket->readAll();
+
+		// Every stream starts with the format of the song, nothing can be played until it has arrived
+		if (mFormatPacket.size() < STREAM_FORMAT_SIZE)
+		{
+			int needed = STREAM_FORMAT_SIZE - mFormatPacket.size();
+			mFormatPacket.append(data.left(needed));
+			data = data.mid(needed);
+
+			if (mFormatPacket.size() < STREAM_FORMAT_SIZE)
+			{
+				return;
+			}
+
+			if (!parseStreamFormat(mFormatPacket, mFormat, mStreamLength))
+			{
+				socket->close();
+				return;
+			}
+
+			// The song can be relayed to other listeners as soon as it starts arriving
+			if (!mCacheKey.isEmpty())
+			{
+				mCache.Begin(mCacheKey, mFormatPacket);
+				emit sourceAvailable(mCacheKey);
+			}
+			mWindowBytes = 0;
+			mThroughputTimer.start();
+		}
+
+		mPendingFrames.append(data);
+		mWindowBytes += data.size();
+
+		if (!receiveFrames(socket))
+		{
+			socket->close();
+			return;
+		}
+
+		if (mThroughputTimer.elapsed() >= 1000)
+		{
+			adaptTier(socket);
+		}
+
+		if (mReceived >= mStreamLength)
 		{
-			mMediaPlayer->StartStream(mBuffers[address]);
+			if (!mCacheKey.isEmpty())
+			{
+				QByteArray cacheKey = mCacheKey;
+				mCache.Finish(mCacheKey, true);
+				mCacheKey.clear();
+				feedRelays(cacheKey);
+			}
+			socket->disconnectFromHost();
 		}
 	}
 	else
 	{
 		QByteArray data = socket->readAll();
-		if (data[0] == (char)Headers::RequestAudioStream)
+
+		// A tier change can arrive in the same read as the request
+		while (!data.isEmpty())
 		{
-			uploadSong(data.mid(1), socket);
+			if (data[0] == (char)Headers::RequestAudioStream && data.size() >= STREAM_REQUEST_SIZE)
+			{
+				uploadSong(data.mid(1, STREAM_REQUEST_SIZE - 1), socket);
+				data.remove(0, STREAM_REQUEST_SIZE);
+			}
+			else if (data[0] == (char)Headers::RequestRelayStream && data.size() >= STREAM_RELAY_REQUEST_SIZE)
+			{
+				uploadCachedSong(data.mid(1, STREAM_RELAY_REQUEST_SIZE - 1), socket);
+				data.remove(0, STREAM_RELAY_REQUEST_SIZE);
+			}
+			else if (data[0] == (char)Headers::RequestStreamTier && data.size() >= 2)
+			{
+				if (mUploads.contains(socket) && (quint8)data[1] < STREAM_TIER_COUNT)
+				{
+					mUploads[socket].tier = (quint8)data[1];
+				}
+				data.remove(0, 2);
+			}
+			else
+			{
+				break;
+			}
 		}
 	}
 }
@@ -270,7 +734,10 @@ void StreamManager::incomingDataHandler()
 --
 -- DATE:			April 14, 2018
 --
--- REVISIONS:		N/A	
+-- REVISIONS:		October 19, 2026 - agent: The song is sent in frames as the socket drains instead of all at once.
+--					October 19, 2026 - agent: The format and audio of the song are found by a WavParser.
+--					October 19, 2026 - agent: The song is read out of a mapping, and FLAC songs are decoded as
+--									they are sent.
 --
 -- DESIGNER:		Benny Wang
 --					Angus Lam
@@ -286,20 +753,725 @@ void StreamManager::incomingDataHandler()
 -- RETURNS:			void.
 --
 -- NOTES:
---					The file name for the song is read here and the the is openned and written to the socket that
---					request the song in chunks.
+--					The file name for the song is read here and the the is openned. The format of the song is sent
+--					first followed by the audio data of the song in frames. The receiver may already have the start
+--					of the song cached, in which case the audio is sent from the offset in the request. The format
+--					always holds the length of the whole song.
 ----------------------------------------------------------------------------------------------------------------------*/
 void StreamManager::uploadSong(QByteArray data, QTcpSocket * socket)
 {
-	QFile file(mSource->absoluteFilePath(data.mid(KEY_SIZE)));
-	file.open(QFile::ReadOnly);
+	finishUpload(socket);
+
+	MappedSong * file = DecodedSong::Create(mSource->absoluteFilePath(data.mid(KEY_SIZE, SONGNAME_SIZE)), this);
+	file->open(QIODevice::ReadOnly);
+
+	WavParser wav;
+	quint32 offset = 0;
+
+	if (!(file->Data() ? wav.Parse(file->Data(), file->size(), file->size()) : wav.Read(*file)))
+	{
+		qWarning() << file->fileName() << wav.ErrorString();
+		delete file;
+		socket->close();
+		return;
+	}
+
+	QAudioFormat format = wav.Format();
+	quint32 dataLength = (quint32)wav.DataSize();
+
+	QDataStream(data.mid(KEY_SIZE + SONGNAME_SIZE, 4)) >> offset;
+	offset = qMin(offset, dataLength);
+	file->seek(wav.DataOffset() + offset);
+
+	// Tell the receiver what it is about to play
+	QByteArray formatPacket = QByteArray(1, (char)Headers::RespondAudioStream);
+	formatPacket << (quint32)format.sampleRate();
+	formatPacket << (quint16)format.channelCount();
+	formatPacket << (quint16)format.sampleSize();
+	formatPacket << (quint8)format.sampleType();
+	formatPacket << dataLength;
+	socket->write(formatPacket);
+
+	// Only the audio data is sent, the rest of the wav file would be played as noise
+	startUpload(socket, file, format, dataLength - offset, QByteArray());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		uploadCachedSong
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		uploadCachedSong (QByteArray data, QTcpSocket * socket)
+--						QByteArray data: The data of the incoming relay request.
+--						QTcpSocket * socket: The socket of the sender.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Relays a song from the stream cache to another listener. The cached format packet is sent as it is
+--					followed by the cached audio from the offset in the request. The song may still be arriving, in
+--					which case sendFrames waits for more of it. If the song is no longer cached the socket is closed
+--					and the listener goes to the owner instead.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::uploadCachedSong(QByteArray data, QTcpSocket * socket)
+{
+	finishUpload(socket);
+
+	QByteArray key = data.mid(KEY_SIZE, CACHE_KEY_SIZE);
+	QFile * file = mCache.Open(key);
+
+	QAudioFormat format;
+	quint32 dataLength = 0;
+	quint32 offset = 0;
+
+	if (file == nullptr)
+	{
+		socket->close();
+		return;
+	}
+
+	QByteArray formatPacket = file->read(STREAM_FORMAT_SIZE);
+	if (!parseStreamFormat(formatPacket, format, dataLength))
+	{
+		delete file;
+		socket->close();
+		return;
+	}
+
+	QDataStream(data.mid(KEY_SIZE + CACHE_KEY_SIZE, 4)) >> offset;
+	offset = qMin(offset, dataLength);
+	file->seek(STREAM_FORMAT_SIZE + offset);
+
+	socket->write(formatPacket);
+	startUpload(socket, file, format, dataLength - offset, key);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		startUpload
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Takes any device, so a song can be decoded as it is sent.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		startUpload (QTcpSocket * socket, QIODevice * file, const QAudioFormat & format, qint64 remaining,
+--						const QByteArray & cacheKey)
+--						QTcpSocket * socket: The socket to upload on.
+--						QIODevice * file: The song, at the first byte of audio to send.
+--						const QAudioFormat & format: The format of the song.
+--						qint64 remaining: The number of bytes of audio to send.
+--						const QByteArray & cacheKey: The cache key if the song is relayed from the cache, otherwise empty.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The send buffer of the socket is kept small so that sendFrames can tell how fast the receiver is
+--					taking the song, and every frame is encoded at whatever tier the receiver last asked for. A song
+--					that is decoded as it is sent carries the upload on with readyRead when it has more ready.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::startUpload(QTcpSocket * socket, QIODevice * file, const QAudioFormat & format, qint64 remaining,
+	const QByteArray & cacheKey)
+{
+	Upload upload = { file, format, remaining, StreamTiers::FullTier, cacheKey, TierCodec::EncodeState() };
+	mUploads[socket] = upload;
+	emit loadChanged();
+
+	socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, STREAM_UPLOAD_WINDOW);
+	connect(socket, &QTcpSocket::bytesWritten, this, &StreamManager::uploadHandler, Qt::UniqueConnection);
+	connect(file, &QIODevice::readyRead, this, &StreamManager::songReadyHandler);
+
+	sendFrames(socket);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		uploadHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		uploadHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a socket has written data to the network. If a song is
+--					being uploaded on the socket, more of it is sent.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::uploadHandler()
+{
+	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
 
-	while (!file.atEnd())
+	if (mUploads.contains(socket))
 	{
-		QByteArray packet = QByteArray(file.read(DOWNLOAD_CHUNCK_SIZE));
-		socket->write(packet);
-		socket->flush();
+		sendFrames(socket);
 	}
+}
 
-	file.close();
-}
\ No newline at end of file
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		songReadyHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		songReadyHandler ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a song being uploaded has more audio ready to read, which
+--					is when a decoded song has decoded more of itself. The upload the song belongs to sends what it
+--					can.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::songReadyHandler()
+{
+	QIODevice * file = (QIODevice *)QObject::sender();
+	QList<QTcpSocket *> sockets = mUploads.keys();
+
+	for (int i = 0; i < sockets.size(); i++)
+	{
+		if (mUploads.contains(sockets[i]) && mUploads[sockets[i]].file == file)
+		{
+			sendFrames(sockets[i]);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		sendFrames
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Stops at a frame a decoded song has not got ready yet.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		sendFrames (QTcpSocket * socket)
+--						QTcpSocket * socket: The socket the song is being uploaded on.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Reads, encodes and writes frames of the song until STREAM_UPLOAD_WINDOW bytes are waiting to be
+--					sent. Keeping so little in flight means a tier change reaches the receiver within a second or two
+--					instead of after everything that was queued before it. The upload is done once the whole song has
+--					been written. A song relayed from the cache is sent only as far as it has arrived, feedRelays
+--					calls back in when there is more of it. A song decoded as it is sent is likewise sent only as far
+--					as it has been decoded, since reading past that would hold up the event loop waiting on the
+--					decoder, and songReadyHandler calls back in when more is ready.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::sendFrames(QTcpSocket * socket)
+{
+	Upload & upload = mUploads[socket];
+	qint64 frameBytes = STREAM_FRAME_SIZE * upload.format.bytesPerFrame();
+
+	while (upload.remaining > 0 && socket->bytesToWrite() < STREAM_UPLOAD_WINDOW)
+	{
+		qint64 length = qMin(frameBytes, upload.remaining);
+
+		// A relayed song may still be arriving, only whole frames of it are sent
+		if (!upload.cacheKey.isEmpty() && upload.file->size() - upload.file->pos() < length)
+		{
+			if (!mCache.IsWriting(upload.cacheKey))
+			{
+				// The rest of the song will never arrive here, the listener gets it from the owner instead
+				finishUpload(socket);
+				socket->disconnectFromHost();
+			}
+			return;
+		}
+
+		// A song that is decoded as it is sent may not have the next frame ready yet
+		qint64 available = upload.file->bytesAvailable();
+		if (available < length && available < upload.file->size() - upload.file->pos())
+		{
+			return;
+		}
+
+		QByteArray audio = upload.file->read(length);
+		if (audio.isEmpty())
+		{
+			upload.remaining = 0;
+			break;
+		}
+		upload.remaining -= audio.size();
+
+		QByteArray payload = TierCodec::Encode(upload.tier, audio, upload.format, upload.encoder);
+		QByteArray frame = QByteArray(1, (char)upload.tier);
+		frame << (quint32)audio.size();
+		frame << (quint32)payload.size();
+		frame.append(payload);
+
+		socket->write(frame);
+	}
+
+	if (upload.remaining <= 0)
+	{
+		finishUpload(socket);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		finishUpload
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		finishUpload (QTcpSocket * socket)
+--						QTcpSocket * socket: The socket the song was being uploaded on.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Closes the song that was being uploaded on the socket, if there is one. The socket stays open
+--					until the receiver has read the rest of the song and disconnects.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::finishUpload(QTcpSocket * socket)
+{
+	if (!mUploads.contains(socket))
+	{
+		return;
+	}
+
+	Upload upload = mUploads.take(socket);
+	upload.file->close();
+	upload.file->deleteLater();
+	emit loadChanged();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		feedRelays
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		feedRelays (const QByteArray & key)
+--						const QByteArray & key: The cache key of the song that changed.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Called when more of a cached song has arrived or when it stops arriving. Every upload that relays
+--					the song sends what it can of the new audio, or gives up if the song will not grow any more.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::feedRelays(const QByteArray & key)
+{
+	QList<QTcpSocket *> sockets = mUploads.keys();
+
+	for (int i = 0; i < sockets.size(); i++)
+	{
+		if (mUploads.contains(sockets[i]) && mUploads[sockets[i]].cacheKey == key)
+		{
+			sendFrames(sockets[i]);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		receiveFrames
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The audio is written into the PlaybackFeed of the stream.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		receiveFrames (QTcpSocket * socket)
+--						QTcpSocket * socket: The socket the song is being streamed from.
+--
+-- RETURNS:			False if the socket sent something that is not a valid frame, otherwise true.
+--
+-- NOTES:
+--					Decodes every complete frame that has arrived back into the format of the song and writes it to
+--					the PlaybackFeed of the stream, which the audio thread plays from. If the feed is not already being
+--					played then the feed is passed to the media player to be played. Only full tier audio is written to
+--					the cache. Once a lower tier arrives the song is left in the cache as a partial song, so the rest of
+--					it is fetched at full quality the next time it is played. Listeners that this song is relayed to
+--					are sent the new audio.
+----------------------------------------------------------------------------------------------------------------------*/
+bool StreamManager::receiveFrames(QTcpSocket * socket)
+{
+	quint32 address = socket->peerAddress().toIPv4Address();
+	quint32 maxFrameBytes = STREAM_FRAME_SIZE * mFormat.bytesPerFrame();
+
+	while (mPendingFrames.size() >= STREAM_FRAME_HEADER_SIZE)
+	{
+		quint8 tier;
+		quint32 sourceBytes;
+		quint32 payloadSize;
+
+		QDataStream(mPendingFrames.left(STREAM_FRAME_HEADER_SIZE)) >> tier >> sourceBytes >> payloadSize;
+
+		if (tier >= STREAM_TIER_COUNT || sourceBytes == 0 || sourceBytes > maxFrameBytes || payloadSize > maxFrameBytes)
+		{
+			return false;
+		}
+
+		if ((quint32)mPendingFrames.size() < STREAM_FRAME_HEADER_SIZE + payloadSize)
+		{
+			break;
+		}
+
+		QByteArray audio = TierCodec::Decode(tier, mPendingFrames.mid(STREAM_FRAME_HEADER_SIZE, payloadSize),
+			sourceBytes, mFormat, mDecoder);
+		mPendingFrames.remove(0, STREAM_FRAME_HEADER_SIZE + payloadSize);
+
+		if ((quint32)audio.size() != sourceBytes)
+		{
+			return false;
+		}
+
+		if (tier != mReceivedTier)
+		{
+			mReceivedTier = tier;
+			emit streamTierChanged(tier, mThroughput);
+		}
+
+		if (tier != StreamTiers::FullTier && !mCacheKey.isEmpty())
+		{
+			QByteArray cacheKey = mCacheKey;
+			mCache.Finish(mCacheKey, false);
+			mCacheKey.clear();
+			feedRelays(cacheKey);
+		}
+		else if (!mCacheKey.isEmpty())
+		{
+			mCache.Append(mCacheKey, audio);
+			feedRelays(mCacheKey);
+		}
+		mReceived += audio.size();
+
+		// The feed is gone if the user stopped the song, the rest of it is still cached
+		if (!mBuffers[address].isNull())
+		{
+			mBuffers[address]->Write(audio);
+			if (!mStreamStarted && mPrefetching)
+			{
+				mMediaPlayer->QueueStream(mBuffers[address], mFormat, mStreamLength);
+				mStreamStarted = true;
+			}
+			else if (!mStreamStarted)
+			{
+				mMediaPlayer->StartStream(mBuffers[address], mFormat, mStreamLength);
+				mStreamStarted = true;
+			}
+		}
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		adaptTier
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: What is buffered is counted by the PlaybackFeed of the stream.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		adaptTier (QTcpSocket * socket)
+--						QTcpSocket * socket: The socket the song is being streamed from.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Folds the bytes received since the last call into a moving average of the throughput, then picks
+--					the tier for the rest of the song:
+--						The stream drops a tier if the network cannot keep up with the current tier, or if less than
+--						STREAM_LOW_BUFFER seconds are buffered and the network is only just keeping up.
+--						The stream goes up a tier if more than STREAM_HIGH_BUFFER seconds are buffered and the network
+--						is well ahead of the tier above.
+--					A tier is kept for at least STREAM_TIER_HOLD ms so the quality does not flip back and forth.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::adaptTier(QTcpSocket * socket)
+{
+	double rate = mWindowBytes * 8 * 1000.0 / mThroughputTimer.restart();
+	mThroughput = mThroughput == 0 ? rate : mThroughput * 0.7 + rate * 0.3;
+	mWindowBytes = 0;
+
+	if (mTierTimer.isValid() && mTierTimer.elapsed() < STREAM_TIER_HOLD)
+	{
+		return;
+	}
+
+	PlaybackFeed * feed = mBuffers.value(socket->peerAddress().toIPv4Address());
+	double buffered = STREAM_HIGH_BUFFER;
+	if (feed != nullptr)
+	{
+		buffered = feed->Buffered() / (double)mFormat.bytesForDuration(1000000);
+	}
+
+	quint8 tier = mTier;
+	double current = TierCodec::Bitrate(mTier, mFormat);
+
+	if (mTier + 1 < STREAM_TIER_COUNT
+		&& (mThroughput < current * 1.1 || (buffered < STREAM_LOW_BUFFER && mThroughput < current * 1.5)))
+	{
+		tier++;
+	}
+	else if (mTier > StreamTiers::FullTier && buffered > STREAM_HIGH_BUFFER
+		&& mThroughput > TierCodec::Bitrate(mTier - 1, mFormat) * 1.5)
+	{
+		tier--;
+	}
+
+	if (tier == mTier)
+	{
+		return;
+	}
+
+	mTier = tier;
+	mTierTimer.start();
+
+	QByteArray packet = QByteArray(1, (char)Headers::RequestStreamTier);
+	packet << mTier;
+	socket->write(packet);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		parseStreamFormat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The format is returned so cached songs can be relayed.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		parseStreamFormat (const QByteArray & packet, QAudioFormat & format, quint32 & dataLength)
+--						const QByteArray & packet: The format packet sent at the start of the stream.
+--						QAudioFormat & format: Set to the format of the stream.
+--						quint32 & dataLength: Set to the number of bytes of audio in the song.
+--
+-- RETURNS:			True if the packet held a playable format, otherwise false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool StreamManager::parseStreamFormat(const QByteArray & packet, QAudioFormat & format, quint32 & dataLength)
+{
+	if (packet[0] != (char)Headers::RespondAudioStream)
+	{
+		return false;
+	}
+
+	quint32 sampleRate;
+	quint16 channels;
+	quint16 sampleSize;
+	quint8 sampleType;
+
+	QDataStream stream(packet.mid(1));
+	stream >> sampleRate >> channels >> sampleSize >> sampleType >> dataLength;
+
+	if (sampleRate == 0 || channels == 0 || sampleSize == 0 || sampleSize % 8 != 0)
+	{
+		return false;
+	}
+
+	format.setSampleRate(sampleRate);
+	format.setChannelCount(channels);
+	format.setSampleSize(sampleSize);
+	format.setSampleType((QAudioFormat::SampleType)sampleType);
+	format.setCodec("audio/pcm");
+	format.setByteOrder(QAudioFormat::LittleEndian);
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CacheStats
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		CacheStats ()
+--
+-- RETURNS:			The hit counters of the stream cache.
+----------------------------------------------------------------------------------------------------------------------*/
+StreamCache::Stats StreamManager::CacheStats() const
+{
+	return mCache.GetStats();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CacheHitRate
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		CacheHitRate ()
+--
+-- RETURNS:			The fraction of streamed songs that were played entirely from the cache.
+----------------------------------------------------------------------------------------------------------------------*/
+double StreamManager::CacheHitRate() const
+{
+	return mCache.HitRate();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AddRelay
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		AddRelay (const QByteArray & key, quint32 address)
+--						const QByteArray & key: The cache key of the song the peer can relay.
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Remembers that a peer has announced that it can relay a song.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::AddRelay(const QByteArray & key, quint32 address)
+{
+	if (!mRelays[key].contains(address))
+	{
+		mRelays[key].append(address);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetPeerLoad
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetPeerLoad (quint32 address, quint8 load)
+--						quint32 address: The address of the peer.
+--						quint8 load: The number of streams the peer is uploading.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::SetPeerLoad(quint32 address, quint8 load)
+{
+	mPeerLoads[address] = load;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RemovePeer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RemovePeer (quint32 address)
+--						quint32 address: The address of the peer that left the session.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Forgets every song the peer could relay.
+----------------------------------------------------------------------------------------------------------------------*/
+void StreamManager::RemovePeer(quint32 address)
+{
+	QList<QByteArray> keys = mRelays.keys();
+
+	for (int i = 0; i < keys.size(); i++)
+	{
+		mRelays[keys[i]].removeAll(address);
+		if (mRelays[keys[i]].isEmpty())
+		{
+			mRelays.remove(keys[i]);
+		}
+	}
+
+	mPeerLoads.remove(address);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Load
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Load ()
+--
+-- RETURNS:			The number of streams this peer is uploading.
+----------------------------------------------------------------------------------------------------------------------*/
+quint8 StreamManager::Load() const
+{
+	return (quint8)qMin(mUploads.size(), 255);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RelayKeys
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RelayKeys ()
+--
+-- RETURNS:			The cache keys of every song this peer can relay.
+----------------------------------------------------------------------------------------------------------------------*/
+QList<QByteArray> StreamManager::RelayKeys() const
+{
+	return mCache.Keys();
+}
@@ -1,15 +1,22 @@
+#include <QDataStream>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QHostAddress>
 #include <QMap>
+#include <QPointer>
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QWidget>
-#include <Qbuffer.h>
 
+#include "AudioDecoder.h"
 #include "globals.h"
 #include "SocketTimer.h"
 #include "MediaPlayer.h"
+#include "PlaybackFeed.h"
+#include "StreamCache.h"
+#include "TierCodec.h"
+#include "WavParser.h"
 
 class StreamManager : public QWidget
 {
@@ -21,7 +28,35 @@ public:
 
 	MediaPlayer * mMediaPlayer;
 
+	StreamCache::Stats CacheStats() const;
+	double CacheHitRate() const;
+
+	void AddRelay(const QByteArray & key, quint32 address);
+	void SetPeerLoad(quint32 address, quint8 load);
+	void RemovePeer(quint32 address);
+	quint8 Load() const;
+	QList<QByteArray> RelayKeys() const;
+
 private:
+	struct SongRequest
+	{
+		QString songName;
+		quint32 address;
+		QString owner;
+		quint32 size;
+		quint32 modified;
+	};
+
+	struct Upload
+	{
+		QIODevice * file;
+		QAudioFormat format;
+		qint64 remaining;
+		quint8 tier;
+		QByteArray cacheKey;
+		TierCodec::EncodeState encoder;
+	};
+
 	const QByteArray * mKey;
 
 	QDir * mSource;
@@ -29,20 +64,65 @@ private:
 	QAudioFormat mFormat;
 
 	quint32 mSongSource;
-	QMap<quint32, QBuffer *> mBuffers;
+	quint32 mStreamLength;
+	quint32 mReceived;
+	bool mStreamStarted;
+	bool mPrefetching;
+	bool mHasPendingPrefetch;
+	SongRequest mPendingPrefetch;
+	QByteArray mFormatPacket;
+	QByteArray mCacheKey;
+	QByteArray mPendingFrames;
+	quint8 mTier;
+	quint8 mReceivedTier;
+	TierCodec::DecodeState mDecoder;
+	qint64 mWindowBytes;
+	double mThroughput;
+	QElapsedTimer mThroughputTimer;
+	QElapsedTimer mTierTimer;
+	QMap<QTcpSocket *, Upload> mUploads;
+	SongRequest mSong;
+	bool mFromRelay;
+	QMap<QByteArray, QList<quint32>> mRelays;
+	QMap<quint32, quint8> mPeerLoads;
+	QMap<quint32, QPointer<PlaybackFeed>> mBuffers;
 	QMap<quint32, QTcpSocket *> mConnections;
+	QList<QTcpSocket *> mIncoming;
 
 	QTcpServer mServer;
+	StreamCache mCache;
 
 	void uploadSong(QByteArray data, QTcpSocket * socket);
+	void uploadCachedSong(QByteArray data, QTcpSocket * socket);
+	void startUpload(QTcpSocket * socket, QIODevice * file, const QAudioFormat & format, qint64 remaining,
+		const QByteArray & cacheKey);
+	void feedRelays(const QByteArray & key);
+	void sendFrames(QTcpSocket * socket);
+	void finishUpload(QTcpSocket * socket);
+	bool receiveFrames(QTcpSocket * socket);
+	void adaptTier(QTcpSocket * socket);
+	bool parseStreamFormat(const QByteArray & packet, QAudioFormat & format, quint32 & dataLength);
+	void stopStream();
+	void requestSong(const SongRequest & song, bool prefetch);
+	quint32 pickSource(const SongRequest & song, const QByteArray & key);
+	void openSource(quint32 address, PlaybackFeed * feed);
 
 private slots:
 	void newConnectionHandler();
 	void incomingDataHandler();
 	void disconnectHandler();
+	void uploadHandler();
+	void songReadyHandler();
 
 public slots:
-	void StreamSong(QString songName, quint32 address);
+	void StreamSong(QString songName, quint32 address, QString owner, quint32 size, quint32 modified);
+	void PrefetchSong(QString songName, quint32 address, QString owner, quint32 size, quint32 modified);
+
+signals:
+	void cacheStatsChanged();
+	void streamTierChanged(quint8 tier, double throughput);
+	void sourceAvailable(QByteArray key);
+	void loadChanged();
 
 };
 
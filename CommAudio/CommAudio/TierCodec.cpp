@@ -0,0 +1,451 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		TierCodec.cpp - Converts frames of a song to and from the quality tiers it can be streamed at.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					static QAudioFormat Format(quint8 tier, const QAudioFormat & source)
+--					static qint64 Bitrate(quint8 tier, const QAudioFormat & source)
+--					static QString Name(quint8 tier)
+--					static QByteArray Encode(quint8 tier, const QByteArray & audio, const QAudioFormat & source,
+--						EncodeState & state)
+--					static QByteArray Decode(quint8 tier, const QByteArray & payload, int sourceBytes,
+--						const QAudioFormat & source, DecodeState & state)
+--					static void restart(quint8 tier, const QAudioFormat & source, EncodeState & state)
+--					static void restart(quint8 tier, const QAudioFormat & source, DecodeState & state)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					A song can be streamed at one of these tiers:
+--						FullTier:		The song exactly as it is stored.
+--						StereoTier:		16 bit stereo at 22.05 kHz.
+--						MonoTier:		16 bit mono at 16 kHz.
+--						CompressedTier:	IMA ADPCM mono at 16 kHz, a quarter of the size of MonoTier.
+--					A tier never has a higher rate or more channels than the song.
+--
+--					Decoding always turns a frame back into the format of the song, using exactly as many bytes as the
+--					frame covered in the song. The receiver therefore has one continuous stream no matter how often
+--					the tier changes. A tier change only changes how the audio sounds and never its timing.
+--
+--					Encoding to a lower rate low-passes the song first so nothing above half the new rate folds back
+--					into what is heard. The filter and the resampler carry on from one frame to the next through the
+--					EncodeState of the upload, so there is no seam at the edges of the frames. Decoding mirrors this
+--					through the DecodeState of the stream, and low-passes after the resampler to take out the images
+--					it leaves above half the rate of the tier.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "TierCodec.h"
+
+#include <cmath>
+
+static const int tierRates[STREAM_TIER_COUNT] = { 0, 22050, 16000, 16000 };
+static const int tierChannels[STREAM_TIER_COUNT] = { 0, 2, 1, 1 };
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Format (quint8 tier, const QAudioFormat & source)
+--						quint8 tier: The tier.
+--						const QAudioFormat & source: The format of the song.
+--
+-- RETURNS:			The format of the audio in a frame of the tier before it is compressed.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat TierCodec::Format(quint8 tier, const QAudioFormat & source)
+{
+	if (tier == StreamTiers::FullTier || tier >= STREAM_TIER_COUNT)
+	{
+		return source;
+	}
+
+	QAudioFormat format;
+	format.setSampleRate(qMin(tierRates[tier], source.sampleRate()));
+	format.setChannelCount(qMin(tierChannels[tier], source.channelCount()));
+	format.setSampleSize(16);
+	format.setSampleType(QAudioFormat::SignedInt);
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setCodec("audio/pcm");
+
+	return format;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Bitrate
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Bitrate (quint8 tier, const QAudioFormat & source)
+--						quint8 tier: The tier.
+--						const QAudioFormat & source: The format of the song.
+--
+-- RETURNS:			The number of bits per second it takes to stream the song at the tier.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 TierCodec::Bitrate(quint8 tier, const QAudioFormat & source)
+{
+	QAudioFormat format = Format(tier, source);
+	qint64 bitrate = (qint64)format.sampleRate() * format.channelCount() * format.sampleSize();
+
+	if (tier == StreamTiers::CompressedTier)
+	{
+		bitrate /= 4;
+	}
+
+	return bitrate;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Name
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Name (quint8 tier)
+--						quint8 tier: The tier.
+--
+-- RETURNS:			A name for the tier that can be shown to the user.
+----------------------------------------------------------------------------------------------------------------------*/
+QString TierCodec::Name(quint8 tier)
+{
+	switch (tier)
+	{
+	case StreamTiers::FullTier:
+		return "full quality";
+	case StreamTiers::StereoTier:
+		return "22 kHz stereo";
+	case StreamTiers::MonoTier:
+		return "16 kHz mono";
+	case StreamTiers::CompressedTier:
+		return "16 kHz mono ADPCM";
+	default:
+		return "unknown";
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Encode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Encode (quint8 tier, const QByteArray & audio, const QAudioFormat & source, EncodeState & state)
+--						quint8 tier: The tier to encode to.
+--						const QByteArray & audio: Whole frames of the song in its own format.
+--						const QAudioFormat & source: The format of the song.
+--						EncodeState & state: What is carried over from the frame before, starting value initialized.
+--
+-- RETURNS:			The payload of the stream frame.
+--
+-- NOTES:
+--					The audio is converted to 16 bit, mapped onto the channels of the tier, low-passed if the tier has
+--					a lower rate and resampled to the rate of the tier with AudioKernels::ResampleCubic. The compressed
+--					tier is then encoded with IMA ADPCM.
+--
+--					The resampler looks a couple of frames ahead, so the last few frames of the song are held back
+--					until the next call. A frame always encodes to at least one frame of the tier, which at the very
+--					end of the song is made up by repeating the last frame. The state starts over whenever the tier
+--					changes.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray TierCodec::Encode(quint8 tier, const QByteArray & audio, const QAudioFormat & source, EncodeState & state)
+{
+	if (tier == StreamTiers::FullTier || tier >= STREAM_TIER_COUNT)
+	{
+		state.tier = tier;
+		return audio;
+	}
+
+	QAudioFormat format = Format(tier, source);
+	int channels = format.channelCount();
+	int frames = audio.size() / source.bytesPerFrame();
+
+	if (frames == 0)
+	{
+		return QByteArray();
+	}
+
+	if (state.tier != tier)
+	{
+		restart(tier, source, state);
+	}
+
+	QVector<qint16> samples(frames * source.channelCount());
+	AudioKernels::ToInt16(audio.constData(), samples.size(), source, samples.data());
+
+	// The frames are mapped straight in after the ones the resampler still holds, with room to pad the end of the song
+	state.held.resize((state.heldFrames + frames + 4) * channels);
+	qint16 * mapped = state.held.data() + state.heldFrames * channels;
+	AudioKernels::MapChannels(samples.constData(), frames, source.channelCount(), mapped, channels);
+
+	if (!state.coefs.isEmpty())
+	{
+		QVector<float> filtered(frames * channels);
+		AudioKernels::ToFloat((const char *)mapped, filtered.size(), format, filtered.data());
+		AudioKernels::Biquads(filtered.data(), frames, channels, state.coefs.constData(), STREAM_TIER_SECTIONS,
+			state.filter.data());
+		AudioKernels::FromFloat(filtered.constData(), filtered.size(), format, (char *)mapped);
+	}
+	state.heldFrames += frames;
+
+	double step = (double)source.sampleRate() / format.sampleRate();
+	int outFrames = qMax(1, (int)floor((state.heldFrames - 4 - state.position) / step) + 1);
+	int needed = (int)(state.position + (outFrames - 1) * step) + 4;
+
+	while (state.heldFrames < needed)
+	{
+		qint16 * end = state.held.data() + state.heldFrames * channels;
+		memcpy(end, end - channels, channels * sizeof(qint16));
+		state.heldFrames++;
+	}
+
+	QVector<qint16> resampled(outFrames * channels);
+	double position = AudioKernels::ResampleCubic(state.held.constData(), resampled.data(), outFrames, channels,
+		state.position, step);
+
+	int consumed = qMin((int)position, state.heldFrames);
+	memmove(state.held.data(), state.held.constData() + consumed * channels,
+		(state.heldFrames - consumed) * channels * sizeof(qint16));
+	state.heldFrames -= consumed;
+	state.position = position - consumed;
+
+	if (tier == StreamTiers::CompressedTier)
+	{
+		return ImaAdpcm::Encode(resampled.constData(), resampled.size());
+	}
+
+	QByteArray payload(resampled.size() * sizeof(qint16), 0);
+	AudioKernels::FromInt16(resampled.constData(), resampled.size(), format, payload.data());
+
+	return payload;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Decode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Decode (quint8 tier, const QByteArray & payload, int sourceBytes, const QAudioFormat & source,
+--						DecodeState & state)
+--						quint8 tier: The tier the frame was encoded at.
+--						const QByteArray & payload: The payload of the stream frame.
+--						int sourceBytes: The number of bytes of the song that the frame covers.
+--						const QAudioFormat & source: The format of the song.
+--						DecodeState & state: What is carried over from the frame before, starting value initialized.
+--
+-- RETURNS:			Exactly sourceBytes bytes of audio in the format of the song, or nothing if the payload is
+--					malformed.
+--
+-- NOTES:
+--					The frames of the tier are held after the ones the resampler still needs and resampled back to
+--					the rate of the song with AudioKernels::ResampleCubic. If the tier has a lower rate, the result is
+--					low-passed before it is mapped onto the channels of the song.
+--
+--					When the state starts over, the first frame of the tier is held STREAM_TIER_LEAD times so the
+--					resampler has what it looks ahead to from the first frame on. Should the tier still fall short,
+--					its last frame is repeated, so the frame always decodes to exactly as much audio as it covered.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray TierCodec::Decode(quint8 tier, const QByteArray & payload, int sourceBytes, const QAudioFormat & source,
+	DecodeState & state)
+{
+	if (tier == StreamTiers::FullTier)
+	{
+		state.tier = tier;
+		return payload.size() == sourceBytes ? payload : QByteArray();
+	}
+
+	if (tier >= STREAM_TIER_COUNT)
+	{
+		return QByteArray();
+	}
+
+	QAudioFormat format = Format(tier, source);
+	int channels = format.channelCount();
+	int frames = sourceBytes / source.bytesPerFrame();
+	QVector<qint16> samples;
+
+	if (tier == StreamTiers::CompressedTier)
+	{
+		samples = ImaAdpcm::Decode(payload);
+	}
+	else
+	{
+		samples.resize(payload.size() / sizeof(qint16));
+		AudioKernels::ToInt16(payload.constData(), samples.size(), format, samples.data());
+	}
+
+	int inFrames = samples.size() / channels;
+	if (inFrames == 0 || frames == 0)
+	{
+		return QByteArray();
+	}
+
+	if (state.tier != tier)
+	{
+		restart(tier, source, state);
+
+		state.held.resize(STREAM_TIER_LEAD * channels);
+		for (int i = 0; i < STREAM_TIER_LEAD; i++)
+		{
+			memcpy(state.held.data() + i * channels, samples.constData(), channels * sizeof(qint16));
+		}
+		state.heldFrames = STREAM_TIER_LEAD;
+	}
+
+	double step = (double)format.sampleRate() / source.sampleRate();
+	int needed = (int)(state.position + (frames - 1) * step) + 4;
+
+	state.held.resize(qMax(state.heldFrames + inFrames, needed) * channels);
+	memcpy(state.held.data() + state.heldFrames * channels, samples.constData(), inFrames * channels * sizeof(qint16));
+	state.heldFrames += inFrames;
+
+	while (state.heldFrames < needed)
+	{
+		qint16 * end = state.held.data() + state.heldFrames * channels;
+		memcpy(end, end - channels, channels * sizeof(qint16));
+		state.heldFrames++;
+	}
+
+	QVector<qint16> resampled(frames * channels);
+	double position = AudioKernels::ResampleCubic(state.held.constData(), resampled.data(), frames, channels,
+		state.position, step);
+
+	int consumed = qMin((int)position, state.heldFrames);
+	memmove(state.held.data(), state.held.constData() + consumed * channels,
+		(state.heldFrames - consumed) * channels * sizeof(qint16));
+	state.heldFrames -= consumed;
+	state.position = position - consumed;
+
+	if (!state.coefs.isEmpty())
+	{
+		QVector<float> filtered(resampled.size());
+		AudioKernels::ToFloat((const char *)resampled.constData(), filtered.size(), format, filtered.data());
+		AudioKernels::Biquads(filtered.data(), frames, channels, state.coefs.constData(), STREAM_TIER_SECTIONS,
+			state.filter.data());
+		AudioKernels::FromFloat(filtered.constData(), filtered.size(), format, (char *)resampled.data());
+	}
+
+	QVector<qint16> mapped(frames * source.channelCount());
+	QByteArray audio(sourceBytes, 0);
+
+	AudioKernels::MapChannels(resampled.constData(), frames, channels, mapped.data(), source.channelCount());
+	AudioKernels::FromInt16(mapped.constData(), mapped.size(), source, audio.data());
+
+	return audio;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		restart
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		restart (quint8 tier, const QAudioFormat & source, EncodeState & state)
+--						quint8 tier: The lower tier the upload is now encoded at.
+--						const QAudioFormat & source: The format of the song.
+--						EncodeState & state: The state to start over.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Empties the filter and the resampler and works out the low-pass filter for the tier. A tier with
+--					the same rate as the song is not filtered. Nothing is held, so the first frame encoded after this
+--					only leads into the resampler and the tier starts one frame of the song later.
+----------------------------------------------------------------------------------------------------------------------*/
+void TierCodec::restart(quint8 tier, const QAudioFormat & source, EncodeState & state)
+{
+	QAudioFormat format = Format(tier, source);
+
+	state.tier = tier;
+	state.held.clear();
+	state.heldFrames = 0;
+	state.position = 0;
+	state.coefs.clear();
+	state.filter.fill(0, STREAM_TIER_SECTIONS * format.channelCount() * 2);
+
+	if (format.sampleRate() < source.sampleRate())
+	{
+		state.coefs.resize(STREAM_TIER_SECTIONS * 5);
+		AudioKernels::LowPass(format.sampleRate() * STREAM_TIER_CUTOFF, source.sampleRate(), STREAM_TIER_SECTIONS,
+			state.coefs.data());
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		restart
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		restart (quint8 tier, const QAudioFormat & source, DecodeState & state)
+--						quint8 tier: The lower tier the stream is now decoded from.
+--						const QAudioFormat & source: The format of the song.
+--						DecodeState & state: The state to start over.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Empties the filter and the resampler and works out the low-pass filter that follows the
+--					resampler. It runs at the rate of the song, with the same cutoff as the one in front of the
+--					encoder. A tier with the same rate as the song is not filtered.
+----------------------------------------------------------------------------------------------------------------------*/
+void TierCodec::restart(quint8 tier, const QAudioFormat & source, DecodeState & state)
+{
+	QAudioFormat format = Format(tier, source);
+
+	state.tier = tier;
+	state.held.clear();
+	state.heldFrames = 0;
+	state.position = 0;
+	state.coefs.clear();
+	state.filter.fill(0, STREAM_TIER_SECTIONS * format.channelCount() * 2);
+
+	if (format.sampleRate() < source.sampleRate())
+	{
+		state.coefs.resize(STREAM_TIER_SECTIONS * 5);
+		AudioKernels::LowPass(format.sampleRate() * STREAM_TIER_CUTOFF, source.sampleRate(), STREAM_TIER_SECTIONS,
+			state.coefs.data());
+	}
+}
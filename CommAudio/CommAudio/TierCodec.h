@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "AudioKernels.h"
+#include "globals.h"
+#include "ImaAdpcm.h"
+
+class TierCodec
+{
+public:
+	// What the encoder of one upload carries from one frame to the next
+	struct EncodeState
+	{
+		quint8 tier;
+		QVector<float> coefs;
+		QVector<float> filter;
+
+		// Frames of the tier the resampler still needs, starting one before where it carries on from
+		QVector<qint16> held;
+		int heldFrames;
+		double position;
+	};
+
+	// What the decoder of one stream carries from one frame to the next
+	struct DecodeState
+	{
+		quint8 tier;
+		QVector<float> coefs;
+		QVector<float> filter;
+
+		// Frames of the tier the resampler still needs, starting one before where it carries on from
+		QVector<qint16> held;
+		int heldFrames;
+		double position;
+	};
+
+	static QAudioFormat Format(quint8 tier, const QAudioFormat & source);
+	static qint64 Bitrate(quint8 tier, const QAudioFormat & source);
+	static QString Name(quint8 tier);
+
+	static QByteArray Encode(quint8 tier, const QByteArray & audio, const QAudioFormat & source, EncodeState & state);
+	static QByteArray Decode(quint8 tier, const QByteArray & payload, int sourceBytes, const QAudioFormat & source,
+		DecodeState & state);
+
+private:
+	static void restart(quint8 tier, const QAudioFormat & source, EncodeState & state);
+	static void restart(quint8 tier, const QAudioFormat & source, DecodeState & state);
+};
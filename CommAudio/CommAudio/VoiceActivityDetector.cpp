@@ -0,0 +1,154 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		VoiceActivityDetector.cpp - Decides which captured voice frames hold speech.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					VoiceActivityDetector()
+--					bool IsSpeech(const qint16 * samples, int count)
+--					int NoiseLevel() const
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Every frame is measured by its RMS level and by how often it crosses zero. The level of the
+--					background is tracked while nobody is talking, dropping straight away to a quieter frame and
+--					rising slowly otherwise, so the detector follows a fan turning on without mistaking a voice for it.
+--
+--					Voiced sounds are much louder than the background. Hissing consonants like "s" and "f" are quiet
+--					but cross zero far more often, so they only need to be a little louder. Once speech stops the
+--					detector keeps saying speech for VOIP_VAD_HANGOVER_FRAMES more frames so the ends of words and
+--					short pauses are not cut.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "VoiceActivityDetector.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceActivityDetector
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceActivityDetector ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The noise floor is taken from the first frame.
+----------------------------------------------------------------------------------------------------------------------*/
+VoiceActivityDetector::VoiceActivityDetector()
+	: mNoise(VOIP_VAD_MIN_LEVEL)
+	, mHangover(0)
+	, mStarted(false)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsSpeech
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsSpeech (const qint16 * samples, int count)
+--						const qint16 * samples: One frame of mono audio.
+--						int count: The number of samples in the frame.
+--
+-- RETURNS:			True if the frame should be sent.
+--
+-- NOTES:
+--					Frames that are not speech, hangover aside, are folded into the noise floor.
+----------------------------------------------------------------------------------------------------------------------*/
+bool VoiceActivityDetector::IsSpeech(const qint16 * samples, int count)
+{
+	if (count <= 0)
+	{
+		return mHangover > 0;
+	}
+
+	double energy = 0;
+	int crossings = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		energy += (double)samples[i] * samples[i];
+
+		if (i > 0 && (samples[i] < 0) != (samples[i - 1] < 0))
+		{
+			crossings++;
+		}
+	}
+
+	double level = sqrt(energy / count);
+	double zcr = (double)crossings / count;
+
+	if (!mStarted)
+	{
+		mNoise = qMax(level, (double)VOIP_VAD_MIN_LEVEL);
+		mStarted = true;
+	}
+
+	bool voiced = level > mNoise * VOIP_VAD_ENERGY_RATIO;
+	bool fricative = level > mNoise * VOIP_VAD_FRICATIVE_RATIO && zcr > VOIP_VAD_FRICATIVE_ZCR;
+
+	if (voiced || fricative)
+	{
+		mHangover = VOIP_VAD_HANGOVER_FRAMES;
+
+		// Creep up in case the background itself got louder
+		mNoise *= 1.002;
+		return true;
+	}
+
+	if (level < mNoise)
+	{
+		mNoise = level;
+	}
+	else
+	{
+		mNoise = mNoise * 0.95 + level * 0.05;
+	}
+	mNoise = qMax(mNoise, (double)VOIP_VAD_MIN_LEVEL);
+
+	if (mHangover > 0)
+	{
+		mHangover--;
+		return true;
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		NoiseLevel
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		NoiseLevel ()
+--
+-- RETURNS:			The RMS level of the background, which the receiver plays back as comfort noise.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceActivityDetector::NoiseLevel() const
+{
+	return qRound(mNoise);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <cmath>
+
+#include "globals.h"
+
+class VoiceActivityDetector
+{
+public:
+	VoiceActivityDetector();
+
+	bool IsSpeech(const qint16 * samples, int count);
+	int NoiseLevel() const;
+
+private:
+	double mNoise;
+	int mHangover;
+	bool mStarted;
+};
\ No newline at end of file
@@ -0,0 +1,262 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		VoiceBridge.cpp - Mixes every voice in a session once for each peer, leaving out their own.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					VoiceBridge(int frameSamples)
+--					void Push(quint32 address, const qint16 * samples, int count)
+--					void RemoveParticipant(quint32 address)
+--					void Clear()
+--					void Mix(const qint16 * local)
+--					const qint16 * MixMinus(quint32 address)
+--					int FrameSamples() const
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					In a session every peer normally sends its voice to every other peer, so each one receives and
+--					decodes a stream from everybody else. A peer on a slow machine or a thin link can ask the host to
+--					do that for it instead, and then only ever gets one stream. The host runs this bridge for them.
+--
+--					The decoded voice of every peer is queued here as mono at the rate of the host. Once a frame, when
+--					the host captures its own microphone, one frame of every queued voice and the voice of the host are
+--					added into a 32 bit sum with AudioKernels::Accumulate. Each peer that wants one stream is then sent
+--					the sum with its own voice taken back out by AudioKernels::MixMinus, so nobody hears themselves.
+--					The sum is made once however many peers there are, so mixing costs one pass for every voice and one
+--					for every listener rather than one for every pair.
+--
+--					A voice only joins the mix once VOIP_BRIDGE_JITTER_FRAMES frames are queued, since the frames of a
+--					peer and the microphone of the host do not tick together. The peer that gets the mix has its own
+--					jitter queue on top of that, so this one is kept short. A voice that runs dry waits to fill up
+--					again, and one that has grown past VOIP_JITTER_MAX_FRAMES drops its oldest audio.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "VoiceBridge.h"
+
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceBridge
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceBridge (int frameSamples)
+--						int frameSamples: The number of mono samples in one frame at the rate of the host.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+VoiceBridge::VoiceBridge(int frameSamples)
+	: mSum(frameSamples)
+	, mOut(frameSamples)
+	, mFrameSamples(frameSamples)
+	, mVoices(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Push
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Push (quint32 address, const qint16 * samples, int count)
+--						quint32 address: The address of the peer that sent the voice.
+--						const qint16 * samples: The decoded voice, mono at the rate of the host.
+--						int count: The number of samples.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Queues the voice of the peer for the next mixes, dropping the oldest of it if the queue is too long.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceBridge::Push(quint32 address, const qint16 * samples, int count)
+{
+	if (!mParticipants.contains(address))
+	{
+		Participant participant = { QByteArray(), QVector<qint16>(mFrameSamples), false, false };
+		mParticipants[address] = participant;
+	}
+
+	Participant & participant = mParticipants[address];
+	participant.queued.append((const char *)samples, count * sizeof(qint16));
+
+	int excess = participant.queued.size() - mFrameSamples * VOIP_JITTER_MAX_FRAMES * (int)sizeof(qint16);
+	if (excess > 0)
+	{
+		participant.queued.remove(0, excess);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RemoveParticipant
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RemoveParticipant (quint32 address)
+--						quint32 address: The address of the peer that left.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceBridge::RemoveParticipant(quint32 address)
+{
+	mParticipants.remove(address);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Clear
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Clear ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Forgets every peer, used when the last peer that wants one stream has gone so the queues do not sit
+--					full until the next one comes.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceBridge::Clear()
+{
+	mParticipants.clear();
+	mVoices = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Mix
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Mix (const qint16 * local)
+--						const qint16 * local: One frame of the voice of the host, or nullptr while the host is silent.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Takes one frame from every primed queue and adds them all up with the voice of the host. Each peer
+--					then gets its share with MixMinus until the next call.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceBridge::Mix(const qint16 * local)
+{
+	const int frameBytes = mFrameSamples * sizeof(qint16);
+
+	memset(mSum.data(), 0, mFrameSamples * sizeof(qint32));
+	mVoices = 0;
+
+	if (local)
+	{
+		AudioKernels::Accumulate(mSum.data(), local, mFrameSamples);
+		mVoices++;
+	}
+
+	for (QMap<quint32, Participant>::iterator it = mParticipants.begin(); it != mParticipants.end(); ++it)
+	{
+		if (!it->primed && it->queued.size() >= frameBytes * VOIP_BRIDGE_JITTER_FRAMES)
+		{
+			it->primed = true;
+		}
+
+		it->mixed = it->primed && it->queued.size() >= frameBytes;
+
+		if (!it->mixed)
+		{
+			it->primed = false;
+			continue;
+		}
+
+		memcpy(it->frame.data(), it->queued.constData(), frameBytes);
+		it->queued.remove(0, frameBytes);
+
+		AudioKernels::Accumulate(mSum.data(), it->frame.constData(), mFrameSamples);
+		mVoices++;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		MixMinus
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		MixMinus (quint32 address)
+--						quint32 address: The address of the peer the mix is for.
+--
+-- RETURNS:			One frame of the last mix without the voice of the peer, which stays valid until the next call, or
+--					nullptr if nobody else was talking so the peer can be sent comfort noise instead.
+----------------------------------------------------------------------------------------------------------------------*/
+const qint16 * VoiceBridge::MixMinus(quint32 address)
+{
+	const qint16 * own = nullptr;
+
+	if (mParticipants.contains(address) && mParticipants[address].mixed)
+	{
+		own = mParticipants[address].frame.constData();
+	}
+
+	if (mVoices - (own ? 1 : 0) <= 0)
+	{
+		return nullptr;
+	}
+
+	AudioKernels::MixMinus(mSum.constData(), own, mOut.data(), mFrameSamples);
+	return mOut.constData();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FrameSamples
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FrameSamples ()
+--
+-- RETURNS:			The number of samples in every frame of the mix.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceBridge::FrameSamples() const
+{
+	return mFrameSamples;
+}
\ No newline at end of file
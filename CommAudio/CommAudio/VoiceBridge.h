@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMap>
+#include <QVector>
+
+#include "AudioKernels.h"
+#include "globals.h"
+
+class VoiceBridge
+{
+public:
+	VoiceBridge(int frameSamples);
+
+	void Push(quint32 address, const qint16 * samples, int count);
+	void RemoveParticipant(quint32 address);
+	void Clear();
+	void Mix(const qint16 * local);
+	const qint16 * MixMinus(quint32 address);
+	int FrameSamples() const;
+
+private:
+	struct Participant
+	{
+		QByteArray queued;
+		QVector<qint16> frame;
+		bool primed;
+		bool mixed;
+	};
+
+	QMap<quint32, Participant> mParticipants;
+	QVector<qint32> mSum;
+	QVector<qint16> mOut;
+	int mFrameSamples;
+	int mVoices;
+};
\ No newline at end of file
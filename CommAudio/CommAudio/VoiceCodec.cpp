@@ -0,0 +1,354 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		VoiceCodec.cpp - The codecs a voice stream can be sent with.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					static VoiceCodec * Create(quint8 id)
+--					static bool Linked(quint8 id)
+--					static QList<quint8> Preferred()
+--					static quint8 SupportedMask()
+--					static quint8 Choose(quint8 remoteMask)
+--					quint8 PcmCodec::Id() const
+--					QString PcmCodec::Name() const
+--					QByteArray PcmCodec::Encode(const qint16 * samples, int count)
+--					QVector<qint16> PcmCodec::Decode(const QByteArray & packet)
+--					quint8 AdpcmCodec::Id() const
+--					QString AdpcmCodec::Name() const
+--					QByteArray AdpcmCodec::Encode(const qint16 * samples, int count)
+--					QVector<qint16> AdpcmCodec::Decode(const QByteArray & packet)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Every codec turns one frame of mono 16 bit voice into one packet and back. A packet never depends
+--					on the packets before it, so a peer can start decoding at any packet.
+--
+--					The codecs that are built in are:
+--						PcmVoiceCodec:		The samples as they are, little endian.
+--						AdpcmVoiceCodec:	IMA ADPCM, a quarter of the size of PCM.
+--
+--					LowBitrateVoiceCodec is reserved for a codec with a much lower bitrate from a library. It is listed
+--					first in Preferred but is left out of the mask and the choice, and Create refuses it, until it is
+--					linked in. To link it in, subclass VoiceCodec, create it in Create and report it in Linked. Other
+--					codecs are added the same way after giving them an id in the VoiceCodecs enum. Peers that do not
+--					know a codec do not advertise it, so they keep talking with a codec they share.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "VoiceCodec.h"
+
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Create
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Create (quint8 id)
+--						quint8 id: The id of the codec from the VoiceCodecs enum.
+--
+-- RETURNS:			A new codec owned by the caller, or nullptr if the codec is reserved or not built in.
+----------------------------------------------------------------------------------------------------------------------*/
+VoiceCodec * VoiceCodec::Create(quint8 id)
+{
+	switch (id)
+	{
+	case VoiceCodecs::PcmVoiceCodec:
+		return new PcmCodec();
+	case VoiceCodecs::AdpcmVoiceCodec:
+		return new AdpcmCodec();
+	case VoiceCodecs::LowBitrateVoiceCodec:
+		// Reserved, nothing is linked in for it yet
+		return nullptr;
+	default:
+		return nullptr;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Linked
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Linked (quint8 id)
+--						quint8 id: The id of the codec from the VoiceCodecs enum.
+--
+-- RETURNS:			Whether Create can make the codec. Reserved ids return false.
+----------------------------------------------------------------------------------------------------------------------*/
+bool VoiceCodec::Linked(quint8 id)
+{
+	return id == VoiceCodecs::PcmVoiceCodec || id == VoiceCodecs::AdpcmVoiceCodec;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Preferred
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Preferred ()
+--
+-- RETURNS:			The ids of the codecs, lowest bitrate first, including ones that are not linked in.
+----------------------------------------------------------------------------------------------------------------------*/
+QList<quint8> VoiceCodec::Preferred()
+{
+	return QList<quint8>() << VoiceCodecs::LowBitrateVoiceCodec << VoiceCodecs::AdpcmVoiceCodec
+		<< VoiceCodecs::PcmVoiceCodec;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SupportedMask
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SupportedMask ()
+--
+-- RETURNS:			A bit for every codec that is linked in, sent to peers when a voice connection starts.
+----------------------------------------------------------------------------------------------------------------------*/
+quint8 VoiceCodec::SupportedMask()
+{
+	quint8 mask = 0;
+	QList<quint8> codecs = Preferred();
+
+	for (int i = 0; i < codecs.size(); i++)
+	{
+		if (Linked(codecs[i]))
+		{
+			mask |= 1 << codecs[i];
+		}
+	}
+
+	return mask;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Choose
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Choose (quint8 remoteMask)
+--						quint8 remoteMask: The codecs the peer supports.
+--
+-- RETURNS:			The codec with the lowest bitrate that both sides support. PCM is always the fallback.
+--
+-- NOTES:
+--					Both sides run the same choice on the same two masks, so they always agree. A codec that is not
+--					linked in on this side is skipped even if the peer advertises it.
+----------------------------------------------------------------------------------------------------------------------*/
+quint8 VoiceCodec::Choose(quint8 remoteMask)
+{
+	QList<quint8> codecs = Preferred();
+
+	for (int i = 0; i < codecs.size(); i++)
+	{
+		if (Linked(codecs[i]) && (remoteMask & (1 << codecs[i])))
+		{
+			return codecs[i];
+		}
+	}
+
+	return VoiceCodecs::PcmVoiceCodec;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PcmCodec::Id
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Id ()
+--
+-- RETURNS:			PcmVoiceCodec.
+----------------------------------------------------------------------------------------------------------------------*/
+quint8 PcmCodec::Id() const
+{
+	return VoiceCodecs::PcmVoiceCodec;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PcmCodec::Name
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Name ()
+--
+-- RETURNS:			The name of the codec.
+----------------------------------------------------------------------------------------------------------------------*/
+QString PcmCodec::Name() const
+{
+	return "PCM";
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PcmCodec::Encode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Encode (const qint16 * samples, int count)
+--						const qint16 * samples: The samples of the frame.
+--						int count: The number of samples.
+--
+-- RETURNS:			The samples as bytes.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray PcmCodec::Encode(const qint16 * samples, int count)
+{
+	return QByteArray((const char *)samples, count * sizeof(qint16));
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PcmCodec::Decode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Decode (const QByteArray & packet)
+--						const QByteArray & packet: The packet that arrived.
+--
+-- RETURNS:			The samples of the frame.
+----------------------------------------------------------------------------------------------------------------------*/
+QVector<qint16> PcmCodec::Decode(const QByteArray & packet)
+{
+	QVector<qint16> samples(packet.size() / sizeof(qint16));
+	memcpy(samples.data(), packet.constData(), samples.size() * sizeof(qint16));
+
+	return samples;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AdpcmCodec::Id
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Id ()
+--
+-- RETURNS:			AdpcmVoiceCodec.
+----------------------------------------------------------------------------------------------------------------------*/
+quint8 AdpcmCodec::Id() const
+{
+	return VoiceCodecs::AdpcmVoiceCodec;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AdpcmCodec::Name
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Name ()
+--
+-- RETURNS:			The name of the codec.
+----------------------------------------------------------------------------------------------------------------------*/
+QString AdpcmCodec::Name() const
+{
+	return "IMA ADPCM";
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AdpcmCodec::Encode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Encode (const qint16 * samples, int count)
+--						const qint16 * samples: The samples of the frame.
+--						int count: The number of samples.
+--
+-- RETURNS:			The frame as one IMA ADPCM block.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray AdpcmCodec::Encode(const qint16 * samples, int count)
+{
+	return ImaAdpcm::Encode(samples, count);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		AdpcmCodec::Decode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Decode (const QByteArray & packet)
+--						const QByteArray & packet: The packet that arrived.
+--
+-- RETURNS:			The samples of the frame, empty if the packet is malformed.
+----------------------------------------------------------------------------------------------------------------------*/
+QVector<qint16> AdpcmCodec::Decode(const QByteArray & packet)
+{
+	return ImaAdpcm::Decode(packet);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "globals.h"
+#include "ImaAdpcm.h"
+
+class VoiceCodec
+{
+public:
+	virtual ~VoiceCodec() = default;
+
+	virtual quint8 Id() const = 0;
+	virtual QString Name() const = 0;
+	virtual QByteArray Encode(const qint16 * samples, int count) = 0;
+	virtual QVector<qint16> Decode(const QByteArray & packet) = 0;
+
+	static VoiceCodec * Create(quint8 id);
+	static bool Linked(quint8 id);
+	static QList<quint8> Preferred();
+	static quint8 SupportedMask();
+	static quint8 Choose(quint8 remoteMask);
+};
+
+class PcmCodec : public VoiceCodec
+{
+public:
+	quint8 Id() const override;
+	QString Name() const override;
+	QByteArray Encode(const qint16 * samples, int count) override;
+	QVector<qint16> Decode(const QByteArray & packet) override;
+};
+
+class AdpcmCodec : public VoiceCodec
+{
+public:
+	quint8 Id() const override;
+	QString Name() const override;
+	QByteArray Encode(const qint16 * samples, int count) override;
+	QVector<qint16> Decode(const QByteArray & packet) override;
+};
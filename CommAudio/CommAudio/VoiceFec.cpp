@@ -0,0 +1,378 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		VoiceFec.cpp - Forward error correction for voice sent as datagrams.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					VoiceFec()
+--					QByteArray Protect(const QByteArray & packet)
+--					void ReportedLoss(quint32 received, quint32 lost)
+--					int Depth() const
+--					bool Stalled() const
+--					QList<Frame> Receive(const QByteArray & datagram)
+--					quint32 Received() const
+--					quint32 Lost() const
+--					quint32 Recovered() const
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					Voice packets sent as datagrams can be lost, and a lost frame is a 20 ms hole in the voice. Each
+--					datagram carries a sequence number and, besides its own packet, copies of the packets sent just
+--					before it in the style of RTP redundant audio. A frame whose datagram is lost is recovered from
+--					the copy in any of the next few datagrams, as long as one of them arrives before the frame is due
+--					in the jitter buffer.
+--
+--					The copies cost bandwidth, so how many are sent follows the loss the receiver reports. A clean
+--					link gets none, and every step of loss adds one up to VOIP_FEC_MAX_DEPTH. Copies are the packets
+--					as they were encoded, so with IMA ADPCM each one is a quarter of the size of the raw frame.
+--
+--					One VoiceFec is kept per peer and holds both directions: Protect and ReportedLoss for what is
+--					sent to the peer, Receive and the counters for what comes from it.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "VoiceFec.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceFec
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceFec ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Starts without copies until the first loss report comes back.
+----------------------------------------------------------------------------------------------------------------------*/
+VoiceFec::VoiceFec()
+	: mSequence(0)
+	, mDepth(0)
+	, mLoss(0)
+	, mReportedReceived(0)
+	, mReportedLost(0)
+	, mSentSinceReport(0)
+	, mStalledReports(0)
+	, mSynced(false)
+	, mExpected(0)
+	, mReceived(0)
+	, mLost(0)
+	, mRecovered(0)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Protect
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Protect (const QByteArray & packet)
+--						const QByteArray & packet: A voice packet with its type and size.
+--
+-- RETURNS:			The datagram to send.
+--
+-- NOTES:
+--					The datagram holds the packet followed by copies of the packets before it, newest first, as many
+--					as the depth allows without going over VOIP_DATAGRAM_MAX_SIZE.
+----------------------------------------------------------------------------------------------------------------------*/
+QByteArray VoiceFec::Protect(const QByteArray & packet)
+{
+	int copies = 0;
+	int size = VOIP_DATAGRAM_HEADER_SIZE + packet.size();
+
+	while (copies < qMin(mDepth, mHistory.size()) && size + mHistory[copies].size() <= VOIP_DATAGRAM_MAX_SIZE)
+	{
+		size += mHistory[copies].size();
+		copies++;
+	}
+
+	QByteArray datagram;
+	datagram.reserve(size);
+	datagram << mSequence << (quint8)(copies + 1);
+	datagram.append(packet);
+
+	for (int i = 0; i < copies; i++)
+	{
+		datagram.append(mHistory[i]);
+	}
+
+	mHistory.prepend(packet);
+	if (mHistory.size() > VOIP_FEC_MAX_DEPTH)
+	{
+		mHistory.removeLast();
+	}
+
+	mSequence++;
+	mSentSinceReport++;
+
+	return datagram;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ReportedLoss
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ReportedLoss (quint32 received, quint32 lost)
+--						quint32 received: How many datagrams the peer has received in total.
+--						quint32 lost: How many frames the peer has found missing in total, recovered or not.
+--
+-- RETURNS:			void
+--
+-- NOTES:
+--					The loss since the last report is smoothed, rising at once and falling slowly, so a burst of loss
+--					gets copies straight away and they are not dropped again on the first clean second. The depth is
+--					then picked from it.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceFec::ReportedLoss(quint32 received, quint32 lost)
+{
+	quint32 newReceived = received - mReportedReceived;
+	quint32 newLost = lost - mReportedLost;
+
+	mReportedReceived = received;
+	mReportedLost = lost;
+
+	if (newReceived + newLost > 0)
+	{
+		int loss = (int)((quint64)newLost * 1000 / (newReceived + newLost));
+		mLoss = loss > mLoss ? loss : (mLoss * 7 + loss) / 8;
+
+		mDepth = mLoss < VOIP_FEC_MIN_LOSS ? 0 : qMin(VOIP_FEC_MAX_DEPTH, 1 + mLoss / VOIP_FEC_LOSS_STEP);
+	}
+
+	if (newReceived == 0 && mSentSinceReport >= VOIP_DATAGRAM_STALL_PACKETS)
+	{
+		mStalledReports++;
+	}
+	else
+	{
+		mStalledReports = 0;
+	}
+
+	mSentSinceReport = 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Depth
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Depth ()
+--
+-- RETURNS:			How many earlier packets each datagram carries a copy of.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceFec::Depth() const
+{
+	return mDepth;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Stalled
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Stalled ()
+--
+-- RETURNS:			True if the peer has reported nothing received for VOIP_DATAGRAM_STALL_REPORTS reports in a row
+--					while datagrams were being sent to it, such as when a firewall drops them.
+----------------------------------------------------------------------------------------------------------------------*/
+bool VoiceFec::Stalled() const
+{
+	return mStalledReports >= VOIP_DATAGRAM_STALL_REPORTS;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Receive
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Receive (const QByteArray & datagram)
+--						const QByteArray & datagram: A datagram from the peer.
+--
+-- RETURNS:			The frames to play, in order. Empty if the datagram is malformed or came too late.
+--
+-- NOTES:
+--					Frames are handed on in sequence. When a datagram arrives past a gap, every missing frame is taken
+--					from the copies in it if it has one, or returned as lost so the caller can fill its time. A
+--					datagram from before the last one handed on has already been recovered or filled in, so it is
+--					dropped. Only the last VOIP_JITTER_MAX_FRAMES lost frames of a long gap are returned, the jitter
+--					buffer would drop anything older anyway.
+----------------------------------------------------------------------------------------------------------------------*/
+QList<VoiceFec::Frame> VoiceFec::Receive(const QByteArray & datagram)
+{
+	QList<Frame> frames;
+	QVector<Frame> packets;
+
+	if (datagram.size() < VOIP_DATAGRAM_HEADER_SIZE)
+	{
+		return frames;
+	}
+
+	const uchar * data = (const uchar *)datagram.constData();
+	quint16 sequence = (quint16)((data[0] << 8) | data[1]);
+	int count = data[2];
+	int offset = VOIP_DATAGRAM_HEADER_SIZE;
+
+	for (int i = 0; i < count; i++)
+	{
+		if (offset + VOIP_PACKET_HEADER_SIZE > datagram.size())
+		{
+			return frames;
+		}
+
+		int size = (data[offset + 1] << 8) | data[offset + 2];
+
+		if (offset + VOIP_PACKET_HEADER_SIZE + size > datagram.size())
+		{
+			return frames;
+		}
+
+		Frame packet = { data[offset], datagram.mid(offset + VOIP_PACKET_HEADER_SIZE, size), false, false };
+		packets.append(packet);
+		offset += VOIP_PACKET_HEADER_SIZE + size;
+	}
+
+	if (packets.isEmpty())
+	{
+		return frames;
+	}
+
+	if (!mSynced)
+	{
+		mSynced = true;
+		mExpected = sequence;
+	}
+
+	qint16 ahead = (qint16)(sequence - mExpected);
+
+	if (ahead < 0)
+	{
+		return frames;
+	}
+
+	mLost += ahead;
+
+	// Frame sequence - back is missing, its copy is packet number back in this datagram
+	for (int back = ahead; back > 0; back--)
+	{
+		if (back < packets.size())
+		{
+			Frame frame = packets[back];
+			frame.recovered = true;
+			frames.append(frame);
+			mRecovered++;
+		}
+		else if (back <= VOIP_JITTER_MAX_FRAMES)
+		{
+			Frame frame = { VoicePackets::VoiceFrame, QByteArray(), false, true };
+			frames.append(frame);
+		}
+	}
+
+	frames.append(packets[0]);
+	mReceived++;
+	mExpected = sequence + 1;
+
+	return frames;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Received
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Received ()
+--
+-- RETURNS:			How many datagrams have arrived in time.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 VoiceFec::Received() const
+{
+	return mReceived;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Lost
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Lost ()
+--
+-- RETURNS:			How many frames were found missing, including the ones that were recovered.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 VoiceFec::Lost() const
+{
+	return mLost;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Recovered
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Recovered ()
+--
+-- RETURNS:			How many missing frames were recovered from copies.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 VoiceFec::Recovered() const
+{
+	return mRecovered;
+}
\ No newline at end of file
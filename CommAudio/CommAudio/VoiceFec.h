@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include "globals.h"
+
+class VoiceFec
+{
+public:
+	// A voice packet taken out of a datagram. A frame that was lost and could not be recovered has no payload
+	struct Frame
+	{
+		quint8 type;
+		QByteArray payload;
+		bool recovered;
+		bool lost;
+	};
+
+	VoiceFec();
+
+	QByteArray Protect(const QByteArray & packet);
+	void ReportedLoss(quint32 received, quint32 lost);
+	int Depth() const;
+	bool Stalled() const;
+
+	QList<Frame> Receive(const QByteArray & datagram);
+	quint32 Received() const;
+	quint32 Lost() const;
+	quint32 Recovered() const;
+
+private:
+	// Sending side, the packets already sent are kept newest first
+	quint16 mSequence;
+	QList<QByteArray> mHistory;
+	int mDepth;
+	int mLoss;
+	quint32 mReportedReceived;
+	quint32 mReportedLost;
+	int mSentSinceReport;
+	int mStalledReports;
+
+	// Receiving side
+	bool mSynced;
+	quint16 mExpected;
+	quint32 mReceived;
+	quint32 mLost;
+	quint32 mRecovered;
+};
\ No newline at end of file
@@ -0,0 +1,710 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		VoiceMixer.cpp - A QIODevice that mixes the voices of every peer into one output.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					VoiceMixer(const QAudioFormat & format, QObject * parent = nullptr)
+--					~VoiceMixer()
+--					void Push(quint32 address, const QByteArray & audio)
+--					void RemovePeer(quint32 address)
+--					void SetGain(quint32 address, double gain)
+--					void SetComfortNoise(quint32 address, int level)
+--					void Reset()
+--					int PeerCount() const
+--					qint64 QueuedBytes(quint32 address) const
+--					int Drift(quint32 address) const
+--					int Underruns() const
+--					int Overruns() const
+--					bool isSequential() const
+--					qint64 readData(char * data, qint64 maxSize)
+--					qint64 writeData(const char * data, qint64 maxSize)
+--					int slot(quint32 address)
+--					void addNoise(Slot & slot, qint16 * mix, int samples)
+--					int resample(Slot & slot, int frames)
+--					void restart(Slot & slot)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Comfort noise fills in for peers that have stopped talking.
+--					October 19, 2026 - agent: Peers are queued in lock free ring buffers so the mix can be read on
+--						an audio thread.
+--					October 19, 2026 - agent: Every peer is played at a rate that follows the drift of its clock.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					A single QAudioOutput pulls from this device no matter how many peers are talking. The voice of
+--					every peer is pushed into its own jitter queue as it arrives. Whenever the output wants more audio,
+--					the queues are scaled by their gain and summed into one block with AudioKernels::MixAdd.
+--
+--					A queue only joins the mix once it holds VOIP_JITTER_FRAMES frames, so small hiccups in the network
+--					do not cut a voice up. If a queue runs dry it waits to fill up again. A queue that grows past
+--					VOIP_JITTER_MAX_FRAMES frames drops its oldest audio to keep the delay bounded.
+--
+--					The mixer always returns as much as the output asks for, with silence when nobody is talking, so
+--					the output keeps running for the whole session.
+--
+--					Peers stop sending while they are not talking and send the level of their background instead.
+--					Whenever such a peer has no audio queued, white noise at that level is mixed in its place so the
+--					line does not sound dead.
+--
+--					The mix is read on an AudioThread while the network pushes audio on the GUI thread. Each peer gets
+--					one of VOIP_MAX_PEERS slots, each with a RingBuffer as its jitter queue and its settings in atomics,
+--					so neither side ever locks and the audio side never allocates. The pushing side owns the mapping of
+--					addresses to slots. A slot it is done with is marked closing, and the audio side empties it and
+--					marks it free again before it can be handed out to another peer.
+--
+--					The sound card of a peer never runs at quite the same rate as ours, so over a long call its queue
+--					would slowly grow or run dry. Each slot has a DriftEstimator that watches the length of the queue
+--					and the queue is played through AudioKernels::ResampleCubic at the rate it picks, a few parts per
+--					million faster or slower, which holds the delay at the target for as long as the call lasts.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "VoiceMixer.h"
+
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoiceMixer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The slots and scratch buffers are allocated up front.
+--					October 19, 2026 - agent: Every slot has room for the frames held by its resampler.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		VoiceMixer (const QAudioFormat & format, QObject * parent)
+--						const QAudioFormat & format: The format of the voices, which must be signed 16 bit.
+--						QObject * parent: The parent object.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates an empty mixer and opens it for reading. Every ring buffer has room for twice the longest
+--					queue, so a peer only overruns if the audio side has stopped reading. A resampler never reads more
+--					than a little over one frame of the queue for every frame it plays, so twice the longest read and
+--					a few frames for the taps of the cubic is always enough to hold.
+----------------------------------------------------------------------------------------------------------------------*/
+VoiceMixer::VoiceMixer(const QAudioFormat & format, QObject * parent)
+	: QIODevice(parent)
+	, mFormat(format)
+	, mTargetBytes(format.bytesForDuration(VOIP_FRAME_MS * 1000) * VOIP_JITTER_FRAMES)
+	, mMaxBytes(format.bytesForDuration(VOIP_FRAME_MS * 1000) * VOIP_JITTER_MAX_FRAMES)
+{
+	for (int i = 0; i < VOIP_MAX_PEERS; i++)
+	{
+		mSlots[i].ring = new RingBuffer(mMaxBytes * 2);
+		mSlots[i].state.store(FreeSlot);
+		mSlots[i].gain.store(256);
+		mSlots[i].noise.store(0);
+		mSlots[i].drift.store(0);
+		mSlots[i].primed = false;
+		mSlots[i].seed = 1;
+		mSlots[i].held.resize((mMaxBytes / format.bytesPerFrame() * 2 + 8) * format.channelCount());
+		restart(mSlots[i]);
+	}
+
+	// The most that is mixed in one read, reads asking for more are given this much
+	int samples = mMaxBytes / sizeof(qint16);
+	mMix.resize(samples);
+	mPeer.resize(samples);
+	mNoise.resize(samples);
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~VoiceMixer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		~VoiceMixer ()
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+VoiceMixer::~VoiceMixer()
+{
+	for (int i = 0; i < VOIP_MAX_PEERS; i++)
+	{
+		delete mSlots[i].ring;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Push
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The audio goes into the ring buffer of the peer.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Push (quint32 address, const QByteArray & audio)
+--						quint32 address: The address of the peer that sent the audio.
+--						const QByteArray & audio: The audio that arrived, in whole frames.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Adds the audio to the jitter queue of the peer. The audio is dropped if the queue is full, which is
+--					counted as an overrun. It is also dropped if every slot is taken, which VoipModule avoids by
+--					turning away peers once VOIP_MAX_PEERS are connected.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceMixer::Push(quint32 address, const QByteArray & audio)
+{
+	int index = slot(address);
+
+	if (index >= 0)
+	{
+		mSlots[index].ring->Write(audio.constData(), audio.size());
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		RemovePeer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The slot of the peer is handed back to the audio side to empty.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		RemovePeer (quint32 address)
+--						quint32 address: The address of the peer that left.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceMixer::RemovePeer(quint32 address)
+{
+	if (mAddresses.contains(address))
+	{
+		mSlots[mAddresses.take(address)].state.storeRelease(ClosingSlot);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetGain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetGain (quint32 address, double gain)
+--						quint32 address: The address of the peer.
+--						double gain: How much to scale the voice of the peer by, 1.0 leaves it as it is.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					The gain is kept in 8.8 fixed point for MixAdd, so it is limited to just under 128.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceMixer::SetGain(quint32 address, double gain)
+{
+	int index = slot(address);
+
+	if (index >= 0)
+	{
+		mSlots[index].gain.storeRelease(qBound(0, qRound(gain * 256), 32767));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetComfortNoise
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetComfortNoise (quint32 address, int level)
+--						quint32 address: The address of the peer.
+--						int level: The RMS level of the background of the peer, 0 for silence.
+--
+-- RETURNS:			void.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceMixer::SetComfortNoise(quint32 address, int level)
+{
+	int index = slot(address);
+
+	if (index >= 0)
+	{
+		mSlots[index].noise.storeRelease(qBound(0, level, 8192));
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Reset
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Reset ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Frees the slots of peers that have left. This is normally done by the audio side, so this must only
+--					be called while nothing is reading the mixer.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceMixer::Reset()
+{
+	for (int i = 0; i < VOIP_MAX_PEERS; i++)
+	{
+		if (mSlots[i].state.loadAcquire() == ClosingSlot)
+		{
+			mSlots[i].ring->Clear();
+			restart(mSlots[i]);
+			mSlots[i].state.storeRelease(FreeSlot);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		PeerCount
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		PeerCount ()
+--
+-- RETURNS:			The number of peers being mixed.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceMixer::PeerCount() const
+{
+	return mAddresses.size();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		QueuedBytes
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		QueuedBytes (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			How much audio of the peer is waiting in its jitter queue.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 VoiceMixer::QueuedBytes(quint32 address) const
+{
+	return mAddresses.contains(address) ? mSlots[mAddresses[address]].ring->Available() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Drift
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Drift (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			How much faster the clock of the peer runs than the output, in parts per million, as estimated by
+--					the audio side the last time it played the peer.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceMixer::Drift(quint32 address) const
+{
+	return mAddresses.contains(address) ? mSlots[mAddresses[address]].drift.loadAcquire() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Underruns
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Underruns ()
+--
+-- RETURNS:			How many times a peer that was playing ran out of audio.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceMixer::Underruns() const
+{
+	int underruns = 0;
+
+	for (int i = 0; i < VOIP_MAX_PEERS; i++)
+	{
+		underruns += mSlots[i].ring->Underruns();
+	}
+
+	return underruns;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Overruns
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Overruns ()
+--
+-- RETURNS:			How many pushes were dropped because a queue was full.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceMixer::Overruns() const
+{
+	int overruns = 0;
+
+	for (int i = 0; i < VOIP_MAX_PEERS; i++)
+	{
+		overruns += mSlots[i].ring->Overruns();
+	}
+
+	return overruns;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		isSequential
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		isSequential ()
+--
+-- RETURNS:			True, the mixer is a live stream.
+----------------------------------------------------------------------------------------------------------------------*/
+bool VoiceMixer::isSequential() const
+{
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Reads the ring buffers without locking or allocating.
+--					October 19, 2026 - agent: Peers are played through their resamplers.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readData (char * data, qint64 maxSize)
+--						char * data: Where the mix is written.
+--						qint64 maxSize: The number of bytes the output wants.
+--
+-- RETURNS:			The number of bytes written, which is maxSize rounded down to whole frames and capped at the
+--					longest queue.
+--
+-- NOTES:
+--					Mixes every peer whose queue is primed into a block of silence. A peer that cannot fill the whole
+--					block is mixed for as long as it lasts and then waits for its queue to fill up again. Whatever
+--					part of the block a peer does not fill gets its comfort noise. Slots of peers that have left are
+--					emptied and freed here.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 VoiceMixer::readData(char * data, qint64 maxSize)
+{
+	int bytes = (int)qMin(maxSize, (qint64)mMaxBytes);
+	bytes -= bytes % mFormat.bytesPerFrame();
+	if (bytes <= 0)
+	{
+		return 0;
+	}
+
+	memset(mMix.data(), 0, bytes);
+
+	for (int i = 0; i < VOIP_MAX_PEERS; i++)
+	{
+		Slot & peer = mSlots[i];
+		int state = peer.state.loadAcquire();
+
+		if (state == ClosingSlot)
+		{
+			peer.ring->Skip(peer.ring->Available());
+			peer.primed = false;
+			restart(peer);
+			peer.state.storeRelease(FreeSlot);
+			continue;
+		}
+
+		if (state != ActiveSlot)
+		{
+			continue;
+		}
+
+		// Drop the oldest whole frames of a queue that has grown too long
+		int excess = peer.ring->Available() - mMaxBytes;
+		if (excess > 0)
+		{
+			excess += mFormat.bytesPerFrame() - 1;
+			peer.ring->Skip(excess - excess % mFormat.bytesPerFrame());
+		}
+
+		if (!peer.primed && peer.ring->Available() >= mTargetBytes)
+		{
+			peer.primed = true;
+			peer.estimator.Restart(peer.ring->Available() / mFormat.bytesPerFrame());
+		}
+
+		int available = 0;
+
+		if (peer.primed)
+		{
+			available = resample(peer, bytes / mFormat.bytesPerFrame()) * mFormat.bytesPerFrame();
+			AudioKernels::MixAdd(mMix.data(), mPeer.constData(), available / sizeof(qint16), peer.gain.loadAcquire());
+
+			if (available < bytes)
+			{
+				peer.primed = false;
+				restart(peer);
+			}
+		}
+
+		if (available < bytes && peer.noise.loadAcquire() > 0)
+		{
+			addNoise(peer, mMix.data() + available / sizeof(qint16), (bytes - available) / sizeof(qint16));
+		}
+	}
+
+	memcpy(data, mMix.constData(), bytes);
+	return bytes;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		writeData
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		writeData (const char * data, qint64 maxSize)
+--						const char * data: Ignored.
+--						qint64 maxSize: Ignored.
+--
+-- RETURNS:			-1, audio is added with Push instead.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 VoiceMixer::writeData(const char * data, qint64 maxSize)
+{
+	Q_UNUSED(data);
+	Q_UNUSED(maxSize);
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		slot
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		slot (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			The slot of the peer, or -1 if it is new and every slot is taken.
+--
+-- NOTES:
+--					A new peer gets a free slot at unity gain with no comfort noise, and with no drift since nothing is
+--					known about its clock yet. Its settings are stored before the slot is marked active, so the audio
+--					side sees them as soon as it sees the peer.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceMixer::slot(quint32 address)
+{
+	if (mAddresses.contains(address))
+	{
+		return mAddresses[address];
+	}
+
+	for (int i = 0; i < VOIP_MAX_PEERS; i++)
+	{
+		if (mSlots[i].state.loadAcquire() == FreeSlot)
+		{
+			mSlots[i].gain.store(256);
+			mSlots[i].noise.store(0);
+			mSlots[i].drift.store(0);
+			mSlots[i].primed = false;
+			mSlots[i].seed = address | 1;
+			mSlots[i].estimator = DriftEstimator();
+			mSlots[i].state.storeRelease(ActiveSlot);
+
+			mAddresses[address] = i;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		addNoise
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Noise is made in the scratch buffer allocated up front.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		addNoise (Slot & slot, qint16 * mix, int samples)
+--						Slot & slot: The peer whose comfort noise is added.
+--						qint16 * mix: Where in the mix the noise starts.
+--						int samples: The number of samples of noise.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Uniform noise from -a to a has an RMS level of a / sqrt(3), so the range is scaled up by sqrt(3) to
+--					match the level the peer sent. Every peer keeps its own generator so two quiet peers do not add up
+--					to the same noise twice.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceMixer::addNoise(Slot & slot, qint16 * mix, int samples)
+{
+	const int range = (int)(slot.noise.loadAcquire() * 1.7320508);
+
+	for (int i = 0; i < samples; i++)
+	{
+		slot.seed = slot.seed * 1664525 + 1013904223;
+		mNoise[i] = (qint16)((((int)(slot.seed >> 16) - 32768) * range) >> 15);
+	}
+
+	AudioKernels::MixAdd(mix, mNoise.constData(), samples, slot.gain.loadAcquire());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		resample
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		resample (Slot & slot, int frames)
+--						Slot & slot: The peer to play.
+--						int frames: The number of frames the output wants.
+--
+-- RETURNS:			The number of frames written to the peer scratch buffer, fewer than asked for if the queue ran dry.
+--
+-- NOTES:
+--					Updates the drift estimate with how much is queued, both in the ring buffer and held back by the
+--					resampler, then takes as many frames from the ring buffer as the block reaches into at the rate
+--					the estimator picked. The frames the next block still needs are kept, along with where in them it
+--					starts, so the rate can change from one block to the next without a seam.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoiceMixer::resample(Slot & slot, int frames)
+{
+	const int frameBytes = mFormat.bytesPerFrame();
+	const int channels = mFormat.channelCount();
+
+	double queued = slot.ring->Available() / frameBytes + slot.heldFrames - 1 - slot.position;
+	double ratio = slot.estimator.Update(queued, mTargetBytes / frameBytes, (double)frames / mFormat.sampleRate());
+	slot.drift.storeRelease(slot.estimator.Drift());
+
+	int needed = (int)(slot.position + (frames - 1) * ratio) + 4;
+	if (needed > slot.heldFrames)
+	{
+		qint16 * end = slot.held.data() + slot.heldFrames * channels;
+		slot.heldFrames += slot.ring->Read((char *)end, (needed - slot.heldFrames) * frameBytes) / frameBytes;
+	}
+
+	// A queue that ran dry is played as far as the frames held reach
+	if (slot.heldFrames < needed)
+	{
+		double reach = slot.heldFrames - 4 - slot.position;
+		frames = reach < 0 ? 0 : qMin(frames, (int)(reach / ratio) + 1);
+	}
+
+	double position = AudioKernels::ResampleCubic(slot.held.constData(), mPeer.data(), frames, channels, slot.position,
+		ratio);
+
+	int consumed = qMin((int)position, slot.heldFrames);
+	memmove(slot.held.data(), slot.held.constData() + consumed * channels, (slot.heldFrames - consumed) * frameBytes);
+	slot.heldFrames -= consumed;
+	slot.position = position - consumed;
+
+	return frames;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		restart
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		restart (Slot & slot)
+--						Slot & slot: The peer whose resampler starts over.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Drops whatever the resampler was holding. The first frame it plays next is taken straight from the
+--					queue, after a frame of silence that only the cubic looks back at.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoiceMixer::restart(Slot & slot)
+{
+	memset(slot.held.data(), 0, mFormat.bytesPerFrame());
+	slot.heldFrames = 1;
+	slot.position = 0;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QIODevice>
+#include <QMap>
+#include <QVector>
+
+#include "AudioKernels.h"
+#include "DriftEstimator.h"
+#include "globals.h"
+#include "RingBuffer.h"
+
+class VoiceMixer : public QIODevice
+{
+	Q_OBJECT
+
+public:
+	VoiceMixer(const QAudioFormat & format, QObject * parent = nullptr);
+	~VoiceMixer();
+
+	void Push(quint32 address, const QByteArray & audio);
+	void RemovePeer(quint32 address);
+	void SetGain(quint32 address, double gain);
+	void SetComfortNoise(quint32 address, int level);
+	void Reset();
+	int PeerCount() const;
+	qint64 QueuedBytes(quint32 address) const;
+	int Drift(quint32 address) const;
+	int Underruns() const;
+	int Overruns() const;
+
+	bool isSequential() const override;
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+	qint64 writeData(const char * data, qint64 maxSize) override;
+
+private:
+	enum SlotState
+	{
+		FreeSlot,
+		ActiveSlot,
+		ClosingSlot
+	};
+
+	struct Slot
+	{
+		RingBuffer * ring;
+		QAtomicInt state;
+		QAtomicInt gain;
+		QAtomicInt noise;
+		QAtomicInt drift;
+
+		// Only touched by the audio thread while the slot is active
+		bool primed;
+		quint32 seed;
+		DriftEstimator estimator;
+
+		// Frames taken from the ring buffer that the resampler still needs, starting one before where it plays from
+		QVector<qint16> held;
+		int heldFrames;
+		double position;
+	};
+
+	QAudioFormat mFormat;
+	Slot mSlots[VOIP_MAX_PEERS];
+
+	// Only touched by the thread that pushes audio
+	QMap<quint32, int> mAddresses;
+
+	// Scratch space for the audio thread, allocated up front
+	QVector<qint16> mMix;
+	QVector<qint16> mPeer;
+	QVector<qint16> mNoise;
+
+	int mTargetBytes;
+	int mMaxBytes;
+
+	int slot(quint32 address);
+	void addNoise(Slot & slot, qint16 * mix, int samples);
+	int resample(Slot & slot, int frames);
+	void restart(Slot & slot);
+};
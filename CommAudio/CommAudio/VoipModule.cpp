@@ -1,317 +1,1570 @@
-/*------------------------------------------------------------------------------------------------------------------
--- SOURCE FILE:		VoipModule.cpp - A module that allows for two way voice communication over TCP/IP.
---
--- PROGRAM:			CommAudio
---
--- FUNCTIONS:
---					VoipModule(QWidget * parent = nullptr)
---					~VoipModule()
---					void newConnectionHandler()
---					void incomingDataHandler()
---					void clientDisconnectHandler()
---					void newClientHandler(QHostAddress address)
---
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- NOTES:
---					This is the class that encapsulates all the voip funcitonality of the program.
-----------------------------------------------------------------------------------------------------------------------*/
-#include <VoipModule.h>
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		VoipModule
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		VoipModule (QWidget * parent)
---						QWidget * parent: The parent widget.
---
--- RETURNS:			N/A
---
--- NOTES:
---					Creates the voip module. This is where the audio format of the voice stream is established and
---					nothing else.
-----------------------------------------------------------------------------------------------------------------------*/
-VoipModule::VoipModule(QWidget * parent)
-	: QWidget(parent)
-	, mServer(this)
-{
-	// Set the voip format
-	mFormat.setSampleRate(44100);
-	mFormat.setSampleSize(16);
-	mFormat.setChannelCount(2);
-	mFormat.setCodec("audio/pcm");
-	mFormat.setByteOrder(QAudioFormat::LittleEndian);
-	mFormat.setSampleType(QAudioFormat::SignedInt);
-
-	// Create the server to listen for new connections
-	connect(&mServer, &QTcpServer::newConnection, this, &VoipModule::newConnectionHandler);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		~VoipModule
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		~VoipModule ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					Stops the voip moduele.
-----------------------------------------------------------------------------------------------------------------------*/
-VoipModule::~VoipModule()
-{
-	Stop();
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		Start	
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		Start ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					Starts the voip module by listening for TCP connections.
-----------------------------------------------------------------------------------------------------------------------*/
-void VoipModule::Start()
-{
-	mServer.listen(QHostAddress::Any, VOIP_PORT);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		Stop	
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		Stop ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					Stops the voip module by no longer listening for new connections and closing all existing connections.
-----------------------------------------------------------------------------------------------------------------------*/
-void VoipModule::Stop()
-{
-	mServer.close();
-
-	QList<quint32> addresses = mConnections.keys();
-	for (int i = 0; i < addresses.size(); i++)
-	{
-		mConnections[addresses[i]]->close();
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		newConnectionHandler	
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		newConnectionHandler ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					This is the Qt slot that is triggered when a new TCP conneciton has been accepted. This function
---					will create a QAudioInput with that socket. Then both the socket and input are saved to the maps.
-----------------------------------------------------------------------------------------------------------------------*/
-void VoipModule::newConnectionHandler()
-{
-	QTcpSocket * socket = mServer.nextPendingConnection();
-	quint32 address = socket->peerAddress().toIPv4Address();
-
-	if (mConnections.contains(address))
-	{
-		socket->close();
-		socket->deleteLater();
-		return;
-	}
-
-	connect(socket, &QTcpSocket::readyRead, this, &VoipModule::incomingDataHandler);
-	connect(socket, &QTcpSocket::disconnected, this, &VoipModule::clientDisconnectHandler);
-
-	mConnections[address] = socket;
-	mInputs[address] = new QAudioInput(mFormat, this);
-	mInputs[address]->start(socket);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		incomingDataHandler	
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		incomingDataHandler ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					This is the Qt slot that is triggered when there is data to read on a socket. This function will
---					create a QAudioOuput with the socket that triggered this function. It will then start the audio
---					output and save it to the map.
-----------------------------------------------------------------------------------------------------------------------*/
-void VoipModule::incomingDataHandler()
-{
-	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
-	quint32 address = socket->peerAddress().toIPv4Address();
-
-	if (!mOutputs.contains(address))
-	{
-		mOutputs[address] = new QAudioOutput(mFormat, this);
-		mOutputs[address]->start(mConnections[address]);
-	}
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		newClientHandler	
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		newClientHandler (QHostAddress address)
---
--- RETURNS:			N/A
---
--- NOTES:
---					This is the Qt slot that is triggered when a new client address is emited. A new socket and
---					QAudioInput is made and stored in the maps. The socket then makes a request to connect.
-----------------------------------------------------------------------------------------------------------------------*/
-void VoipModule::newClientHandler(QHostAddress address)
-{
-	if (mConnections.contains(address.toIPv4Address()))
-	{
-		return;
-	}
-
-	QTcpSocket * socket = new QTcpSocket(this);
-
-	socket->connectToHost(address, VOIP_PORT);
-
-	connect(socket, &QTcpSocket::readyRead, this, &VoipModule::incomingDataHandler);
-	connect(socket, &QTcpSocket::disconnected, this, &VoipModule::clientDisconnectHandler);
-
-	mConnections[address.toIPv4Address()] = socket;
-	mInputs[address.toIPv4Address()] = new QAudioInput(mFormat, this);
-	mInputs[address.toIPv4Address()]->start(socket);
-}
-
-/*------------------------------------------------------------------------------------------------------------------
--- FUNCTION:		clientDisconnectHandler
---
--- DATE:			March 26, 2018
---
--- REVISIONS:		N/A	
---
--- DESIGNER:		Benny Wang
---					Angus Lam
---					Roger Zhang
---
--- PROGRAMMER:		Benny Wang
---
--- INTERFACE:		clientDisconnectHandler ()
---
--- RETURNS:			N/A
---
--- NOTES:
---					This is a Qt slot that is triggered when a connection is disconnected. The socket and associated
---					QAudioInput and QAudioOuputs are closed and removed from their maps.
---
---					Special Note: Because of Qt signal/slot thread saftey issues, it is possible for this function to
---								  run after ~VoipModule() has deleted the maps. To avoid a null pointer exception from
---								  stopping the other deconstructors, we simply check the length first before executing.
-----------------------------------------------------------------------------------------------------------------------*/
-void VoipModule::clientDisconnectHandler()
-{
-	if (mConnections.size() < 0 && mOutputs.size() < 0 && mInputs.size() < 0)
-	{
-		return;
-	}
-
-	QTcpSocket * sender = (QTcpSocket *)QObject::sender();
-	quint32 address = sender->peerAddress().toIPv4Address();
-
-	mConnections.take(address)->deleteLater();
-	
-	QAudioOutput * output = mOutputs.take(address);
-	QAudioInput * input = mInputs.take(address);
-
-	if (output)
-	{
-		output->stop();
-		output->deleteLater();
-	}
-
-	if (input)
-	{
-		input->stop();
-		input->deleteLater();
-	}
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		VoipModule.cpp - A module that allows for two way voice communication over TCP/IP.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					VoipModule(QWidget * parent = nullptr)
+--					~VoipModule()
+--					void Start(bool host = false)
+--					void Stop()
+--					void SetPeerGain(quint32 address, double gain)
+--					void SetMixedMode(bool mixed)
+--					bool IsTalking(quint32 address) const
+--					qint64 BytesSaved(quint32 address) const
+--					qint64 FramesLost(quint32 address) const
+--					qint64 FramesRecovered(quint32 address) const
+--					void SetBufferSizes(int captureMs, int playbackMs)
+--					VoiceLatency Latency(quint32 address) const
+--					int ClockDrift(quint32 address) const
+--					double CpuLoad(quint32 address) const
+--					void newConnectionHandler()
+--					void incomingDataHandler()
+--					void clientDisconnectHandler()
+--					void captureHandler()
+--					void connectedHandler()
+--					void probeHandler()
+--					void datagramHandler()
+--					void newClientHandler(QHostAddress address)
+--					void addPeer(quint32 address, QTcpSocket * socket)
+--					void setVoiceOptions(QTcpSocket * socket)
+--					void readHello(quint32 address, const QByteArray & hello)
+--					void startCapture()
+--					void stopCapture()
+--					void sendFrame(const QByteArray & frame)
+--					void sendPacket(quint32 address, const QByteArray & packet)
+--					void bridgeFrame(const qint16 * local)
+--					bool bridging() const
+--					void receiveFrames(quint32 address)
+--					void receivePacket(quint32 address, quint8 type, const QByteArray & payload)
+--					void setTalking(quint32 address, bool talking)
+--
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: Every peer is mixed into a single audio output.
+--					October 19, 2026 - agent: Voice is sent in encoded frames with a codec agreed on per peer.
+--					October 19, 2026 - agent: Silence is replaced by comfort noise packets.
+--					October 19, 2026 - agent: The microphone is captured once and every frame is sent to every peer.
+--					October 19, 2026 - agent: Device buffers are sized, sockets send at once and latency is measured.
+--					October 19, 2026 - agent: The mix is played on an audio thread of its own.
+--					October 19, 2026 - agent: Devices come from the AudioBackend so voice runs without hardware.
+--					October 19, 2026 - agent: Voice can be sent as datagrams protected by forward error correction.
+--					October 19, 2026 - agent: The clock drift of every peer is tracked and made up for by the mixer.
+--					October 19, 2026 - agent: The host can mix the session into one stream for peers that ask.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- NOTES:
+--					This is the class that encapsulates all the voip funcitonality of the program. The voices of all
+--					the peers are mixed by a VoiceMixer and played on one QAudioOutput, so the number of output streams
+--					stays at one however many people are in the session. The output and the mixer run on an
+--					AudioThread, and decoded voice reaches them through lock free ring buffers, so a busy GUI thread
+--					does not make the voices stutter.
+--
+--					Voice is captured in mono at VOIP_SAMPLE_RATE. When a connection opens both sides send a hello:
+--						[VoiceHello][u8 codec mask][u32 sample rate][u8 flags]
+--					Once the hello of the peer arrives, the lower of the two rates and the best codec both sides know
+--					are used for that peer.
+--
+--					The microphone is opened once while at least one peer is ready, however many peers there are. The
+--					capture is cut into VOIP_FRAME_MS frames and every frame is encoded on its own and sent as:
+--						[VoiceFrame][u16 size][encoded frame]
+--					With IMA ADPCM at 16 kHz that is 64 kbit/s a direction for each peer instead of the 1.4 Mbit/s of
+--					raw 44.1 kHz stereo.
+--
+--					Each frame is encoded once for every codec and rate in use and the same packet is written to every
+--					peer that uses them, so with the same settings on every side a frame is encoded only once.
+--
+--					Frames are only sent while a VoiceActivityDetector hears speech. When the user goes quiet, and then
+--					every VOIP_COMFORT_NOISE_INTERVAL frames, the level of their background is sent instead:
+--						[ComfortNoise][u16 2][u16 level]
+--					The receiver plays noise at that level until speech comes back. Since people in a call are mostly
+--					listening, this sends well under half of the frames.
+--
+--					To keep the delay from mouth to ear down, the capture and playback devices get small buffers that
+--					can be changed with SetBufferSizes, and voice sockets turn off Nagle and ask for low delay
+--					delivery. Every VOIP_PROBE_INTERVAL each peer is sent a timestamp which it echoes straight back:
+--						[LatencyProbe][u16 8][u64 microseconds]
+--						[LatencyEcho][u16 8][u64 microseconds]
+--					Half the round trip is taken as the network delay. Latency adds it to the device buffers and the
+--					jitter queue of the peer to give the whole budget.
+--
+--					A side that could bind VOIP_PORT for UDP says so in the flags of its hello, and the peer then sends
+--					it voice frames and comfort noise as datagrams, so a lost packet no longer holds up every frame
+--					behind it the way a TCP retransmission does. Each datagram is protected by a VoiceFec, which adds
+--					copies of the frames before it as the loss grows. The receiver reports its totals on the TCP
+--					connection with every probe:
+--						[LossReport][u16 8][u32 datagrams received][u32 frames lost]
+--					If a peer reports that none of its datagrams are arriving, voice to it goes back to TCP.
+--
+--					A peer on a weak machine or link can be put in mixed mode with SetMixedMode, which sets
+--					VOIP_HELLO_MIXED in its hello. Nobody but the host sends it voice then. The host decodes every
+--					voice in the session anyway to play it, so it also feeds them to a VoiceBridge and sends the peer
+--					one stream of everyone but itself, encoded with the codec and rate agreed with that peer. The peer
+--					still sends its own voice to everyone, so the others hear it as before. Every other peer keeps
+--					getting a stream from everybody. The time spent decoding, mixing and encoding for every peer is
+--					measured and given as a share of one core by CpuLoad.
+----------------------------------------------------------------------------------------------------------------------*/
+#include <VoipModule.h>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		VoipModule
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The mixer and its output are created here.
+--					October 19, 2026 - agent: The latency probe timer is set up.
+--					October 19, 2026 - agent: The mixer is handed to an audio thread.
+--					October 19, 2026 - agent: The format is mono at VOIP_SAMPLE_RATE, or the nearest the device has.
+--					October 19, 2026 - agent: The nearest format and the output come from the AudioBackend.
+--					October 19, 2026 - agent: The bridge the host mixes with is created.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		VoipModule (QWidget * parent)
+--						QWidget * parent: The parent widget.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Creates the voip module. This is where the audio format of the voice stream is established along
+--					with the mixer and the one output that plays it.
+----------------------------------------------------------------------------------------------------------------------*/
+VoipModule::VoipModule(QWidget * parent)
+	: QWidget(parent)
+	, mServer(this)
+	, mDatagrams(this)
+	, mHost(false)
+	, mMixedMode(false)
+	, mInput(nullptr)
+	, mCapture(nullptr)
+	, mSilentFrames(0)
+	, mCaptureBufferMs(VOIP_CAPTURE_BUFFER_MS)
+	, mPlaybackBufferMs(VOIP_PLAYBACK_BUFFER_MS)
+{
+	// Set the voip format
+	mFormat.setSampleRate(VOIP_SAMPLE_RATE);
+	mFormat.setSampleSize(16);
+	mFormat.setChannelCount(1);
+	mFormat.setCodec("audio/pcm");
+	mFormat.setByteOrder(QAudioFormat::LittleEndian);
+	mFormat.setSampleType(QAudioFormat::SignedInt);
+
+	// Take the rate and channels of the nearest format if the device cannot capture it, the mixer needs 16 bit samples
+	QAudioFormat nearest = AudioBackend::NearestFormat(mFormat, QAudio::AudioInput);
+	mFormat.setSampleRate(nearest.sampleRate());
+	mFormat.setChannelCount(nearest.channelCount());
+
+	// Every peer is played through the one mixer, which is read on the audio thread
+	mMixer = new VoiceMixer(mFormat);
+	mAudio = new AudioThread(mFormat, mMixer, "voice", this);
+
+	// The host mixes for the peers that want one stream in mono at the capture rate
+	mBridge = new VoiceBridge(mFormat.sampleRate() * VOIP_FRAME_MS / 1000);
+
+	// Create the server to listen for new connections
+	connect(&mServer, &QTcpServer::newConnection, this, &VoipModule::newConnectionHandler);
+	connect(&mDatagrams, &QUdpSocket::readyRead, this, &VoipModule::datagramHandler);
+
+	// Probes are timestamped against this clock
+	mClock.start();
+	connect(&mProbeTimer, &QTimer::timeout, this, &VoipModule::probeHandler);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		~VoipModule
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The mixer is deleted once the audio thread has stopped.
+--					October 19, 2026 - agent: The bridge is deleted.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		~VoipModule ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Stops the voip moduele.
+----------------------------------------------------------------------------------------------------------------------*/
+VoipModule::~VoipModule()
+{
+	Stop();
+	delete mMixer;
+	delete mBridge;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Start	
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The mixer output is started.
+--					October 19, 2026 - agent: The output buffer is sized and latency probes start.
+--					October 19, 2026 - agent: The output is started on the audio thread.
+--					October 19, 2026 - agent: The voice datagram socket is bound.
+--					October 19, 2026 - agent: The host mixes for the peers in mixed mode.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		Start (bool host)
+--						bool host: Whether this side is hosting the session, and so mixes for the peers that ask.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Starts the voip module by listening for TCP connections and starting the output of the mixer. If
+--					the UDP port cannot be bound, peers are told not to send datagrams and all voice stays on TCP.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::Start(bool host)
+{
+	mHost = host;
+
+	mServer.listen(QHostAddress::Any, VOIP_PORT);
+
+	if (mDatagrams.bind(QHostAddress::Any, VOIP_PORT))
+	{
+		mDatagrams.setSocketOption(QAbstractSocket::TypeOfServiceOption, VOIP_LOW_DELAY_TOS);
+	}
+
+	mAudio->Start(mFormat.bytesForDuration(mPlaybackBufferMs * 1000));
+	mProbeTimer.start(VOIP_PROBE_INTERVAL);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Stop	
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The microphone is closed and probes stop.
+--					October 19, 2026 - agent: The audio thread is stopped and the slots of the mixer are freed.
+--					October 19, 2026 - agent: The voice datagram socket is closed.
+--					October 19, 2026 - agent: The bridge is emptied.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		Stop ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Stops the voip module by no longer listening for new connections and closing all existing connections.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::Stop()
+{
+	mServer.close();
+	mDatagrams.close();
+	mAudio->Stop();
+	mProbeTimer.stop();
+	stopCapture();
+
+	QList<quint32> addresses = mConnections.keys();
+	for (int i = 0; i < addresses.size(); i++)
+	{
+		mConnections[addresses[i]]->close();
+	}
+
+	// Nothing is reading the mixer now, so free the slots of the peers that just left
+	mMixer->Reset();
+	mBridge->Clear();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		newConnectionHandler	
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: A peer is turned away once the mixer is full.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		newConnectionHandler ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the Qt slot that is triggered when a new TCP conneciton has been accepted. The socket is
+--					saved to the map and the hello is sent. Capture starts once the hello of the peer has arrived. The
+--					connection is refused if the mixer has no room left for another peer.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::newConnectionHandler()
+{
+	QTcpSocket * socket = mServer.nextPendingConnection();
+	quint32 address = socket->peerAddress().toIPv4Address();
+
+	if (mConnections.contains(address))
+	{
+		socket->close();
+		socket->deleteLater();
+		return;
+	}
+
+	if (mConnections.size() >= VOIP_MAX_PEERS)
+	{
+		qWarning() << "The call is full," << socket->peerAddress().toString() << "is turned away.";
+		socket->close();
+		socket->deleteLater();
+		return;
+	}
+
+	addPeer(address, socket);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		incomingDataHandler	
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The audio is pushed to the mixer instead of its own output.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		incomingDataHandler ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the Qt slot that is triggered when there is data to read on a socket. The first thing a
+--					peer sends is its hello, everything after that is encoded frames which are decoded and pushed into
+--					the jitter queue of the peer in the mixer.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::incomingDataHandler()
+{
+	QTcpSocket * socket = (QTcpSocket *)QObject::sender();
+	quint32 address = socket->peerAddress().toIPv4Address();
+
+	if (!mPeers.contains(address))
+	{
+		return;
+	}
+
+	Peer & peer = mPeers[address];
+	peer.received.append(socket->readAll());
+
+	if (!peer.codec)
+	{
+		if (peer.received.size() < VOIP_HELLO_SIZE)
+		{
+			return;
+		}
+
+		if (peer.received[0] != (char)Headers::VoiceHello)
+		{
+			socket->close();
+			return;
+		}
+
+		readHello(address, peer.received.left(VOIP_HELLO_SIZE));
+		peer.received.remove(0, VOIP_HELLO_SIZE);
+	}
+
+	receiveFrames(address);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetPeerGain
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetPeerGain (quint32 address, double gain)
+--						quint32 address: The address of the peer.
+--						double gain: How much to scale the voice of the peer by, 1.0 leaves it as it is.
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::SetPeerGain(quint32 address, double gain)
+{
+	mMixer->SetGain(address, gain);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetMixedMode
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetMixedMode (bool mixed)
+--						bool mixed: True to get one stream mixed by the host, false to get a stream from every peer.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The choice goes out in the hello, so it takes effect from the next session. The host never asks
+--					for a mix since it is the one making them.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::SetMixedMode(bool mixed)
+{
+	mMixedMode = mixed;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsTalking
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsTalking (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			True if the peer is sending speech, false if it is quiet or unknown.
+----------------------------------------------------------------------------------------------------------------------*/
+bool VoipModule::IsTalking(quint32 address) const
+{
+	return mPeers.contains(address) && mPeers[address].talking;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		BytesSaved
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		BytesSaved (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			How many fewer bytes have been sent to the peer than without silence suppression, after taking
+--					off the comfort noise packets.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 VoipModule::BytesSaved(quint32 address) const
+{
+	return mPeers.contains(address) ? mPeers[address].bytesSaved : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FramesLost
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FramesLost (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			How many frames of the voice datagrams from the peer went missing, including the ones that were
+--					recovered.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 VoipModule::FramesLost(quint32 address) const
+{
+	return mPeers.contains(address) ? mPeers[address].fec.Lost() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FramesRecovered
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FramesRecovered (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			How many of the lost frames from the peer were recovered from the copies in later datagrams.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 VoipModule::FramesRecovered(quint32 address) const
+{
+	return mPeers.contains(address) ? mPeers[address].fec.Recovered() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetBufferSizes
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetBufferSizes (int captureMs, int playbackMs)
+--						int captureMs: How much audio the microphone buffers.
+--						int playbackMs: How much audio the speakers buffer.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Devices that are running are restarted with the new sizes. Qt does not let the period be set, but
+--					the device picks a period to fit in its buffer.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::SetBufferSizes(int captureMs, int playbackMs)
+{
+	mCaptureBufferMs = qMax(captureMs, VOIP_FRAME_MS);
+	mPlaybackBufferMs = qMax(playbackMs, VOIP_FRAME_MS);
+
+	if (mAudio->isRunning())
+	{
+		mAudio->Start(mFormat.bytesForDuration(mPlaybackBufferMs * 1000));
+	}
+
+	if (mInput)
+	{
+		stopCapture();
+		startCapture();
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Latency
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A	
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Latency (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			The delay from the peer speaking to this side hearing it, broken down by stage.
+--
+-- NOTES:
+--					Capture is the capture buffer plus the frame being filled, network is half the smoothed round trip
+--					time, jitter is what the peer has queued in the mixer and playout is what the output device has
+--					yet to play. The capture buffer of the peer is assumed to be the same as ours.
+----------------------------------------------------------------------------------------------------------------------*/
+VoiceLatency VoipModule::Latency(quint32 address) const
+{
+	VoiceLatency latency = { 0, 0, 0, 0 };
+
+	latency.capture = (qint64)(mCaptureBufferMs + VOIP_FRAME_MS) * 1000;
+	latency.jitter = mFormat.durationForBytes((qint32)mMixer->QueuedBytes(address));
+
+	if (mPeers.contains(address) && mPeers[address].rtt >= 0)
+	{
+		latency.network = mPeers[address].rtt / 2;
+	}
+
+	latency.playout = mFormat.durationForBytes(mAudio->BufferedBytes());
+
+	return latency;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ClockDrift
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ClockDrift (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			How much faster the sound card of the peer runs than ours, in parts per million.
+--
+-- NOTES:
+--					The mixer plays the peer that much faster or slower so its share of the latency stays put. The
+--					estimate only moves while the peer is talking and takes a few minutes of speech to settle.
+----------------------------------------------------------------------------------------------------------------------*/
+int VoipModule::ClockDrift(quint32 address) const
+{
+	return mMixer->Drift(address);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		CpuLoad
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		CpuLoad (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			The percent of one core spent on the peer over the last probe interval.
+--
+-- NOTES:
+--					Counts decoding the voice of the peer and, on the host, mixing and encoding the one stream of a
+--					peer in mixed mode. Making the shared sum of the bridge is split evenly between those peers.
+----------------------------------------------------------------------------------------------------------------------*/
+double VoipModule::CpuLoad(quint32 address) const
+{
+	return mPeers.contains(address) ? mPeers[address].cpuLoad : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		newClientHandler	
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: No peer is called once the mixer is full.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		newClientHandler (QHostAddress address)
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the Qt slot that is triggered when a new client address is emited. A new socket is made
+--					and stored in the map. The socket then makes a request to connect and the hello is queued on it.
+--					No connection is made if the mixer has no room left for another peer.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::newClientHandler(QHostAddress address)
+{
+	if (mConnections.contains(address.toIPv4Address()))
+	{
+		return;
+	}
+
+	if (mConnections.size() >= VOIP_MAX_PEERS)
+	{
+		qWarning() << "The call is full," << address.toString() << "is not called.";
+		return;
+	}
+
+	QTcpSocket * socket = new QTcpSocket(this);
+
+	socket->connectToHost(address, VOIP_PORT);
+
+	addPeer(address.toIPv4Address(), socket);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		clientDisconnectHandler
+--
+-- DATE:			March 26, 2018
+--
+-- REVISIONS:		October 19, 2026 - agent: The codec of the peer is released and capture stops with the last peer.
+--
+-- DESIGNER:		Benny Wang
+--					Angus Lam
+--					Roger Zhang
+--
+-- PROGRAMMER:		Benny Wang
+--
+-- INTERFACE:		clientDisconnectHandler ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is a Qt slot that is triggered when a connection is disconnected. The socket and codec of the
+--					peer are released and removed from their maps and the peer is taken out of the mixer. If no other
+--					peer is ready the microphone is closed.
+--
+--					Special Note: Because of Qt signal/slot thread saftey issues, it is possible for this function to
+--								  run after ~VoipModule() has deleted the maps. To avoid a null pointer exception from
+--								  stopping the other deconstructors, we simply check the length first before executing.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::clientDisconnectHandler()
+{
+	if (mConnections.size() < 0 && mPeers.size() < 0)
+	{
+		return;
+	}
+
+	QTcpSocket * sender = (QTcpSocket *)QObject::sender();
+	quint32 address = sender->peerAddress().toIPv4Address();
+
+	mConnections.take(address)->deleteLater();
+	mMixer->RemovePeer(address);
+	mBridge->RemoveParticipant(address);
+
+	Peer peer = mPeers.take(address);
+	delete peer.codec;
+
+	// Stop queueing voices once nobody wants a mix
+	if (!bridging())
+	{
+		mBridge->Clear();
+	}
+
+	// Close the microphone once nobody is left to send to
+	for (const Peer & remaining : mPeers)
+	{
+		if (remaining.codec)
+		{
+			return;
+		}
+	}
+	stopCapture();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		captureHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: There is one capture for all peers.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		captureHandler ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the Qt slot that is triggered when the microphone has captured audio. The audio is
+--					collected until there is a whole frame and each frame is sent to every peer.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::captureHandler()
+{
+	if (!mCapture)
+	{
+		return;
+	}
+
+	mCaptured.append(mCapture->readAll());
+
+	int frameBytes = mFormat.bytesForDuration(VOIP_FRAME_MS * 1000);
+	int offset = 0;
+
+	while (mCaptured.size() - offset >= frameBytes)
+	{
+		sendFrame(mCaptured.mid(offset, frameBytes));
+		offset += frameBytes;
+	}
+
+	mCaptured.remove(0, offset);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		connectedHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		connectedHandler ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the Qt slot that is triggered when a voice socket we opened has connected, which is the
+--					first time its options can be set.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::connectedHandler()
+{
+	setVoiceOptions((QTcpSocket *)QObject::sender());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		probeHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Peers sending datagrams are sent a loss report.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		probeHandler ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the Qt slot that is triggered every VOIP_PROBE_INTERVAL. Every peer that has said hello is
+--					sent the current time to echo back. If this side takes datagrams every peer is also told how many
+--					of its datagrams arrived and how many frames were missing.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::probeHandler()
+{
+	quint64 now = mClock.nsecsElapsed() / 1000;
+
+	QByteArray probe;
+	probe << (quint8)VoicePackets::LatencyProbe << (quint16)VOIP_PROBE_SIZE << (quint32)(now >> 32) << (quint32)now;
+
+	for (QMap<quint32, Peer>::iterator it = mPeers.begin(); it != mPeers.end(); ++it)
+	{
+		it->cpuLoad = it->cpuNs / (VOIP_PROBE_INTERVAL * 10000.0);
+		it->cpuNs = 0;
+
+		if (!it->codec)
+		{
+			continue;
+		}
+
+		mConnections[it.key()]->write(probe);
+
+		// Sent even when nothing has arrived, that is how the peer finds out its datagrams are blocked
+		if (mDatagrams.state() == QAbstractSocket::BoundState)
+		{
+			QByteArray report;
+			report << (quint8)VoicePackets::LossReport << (quint16)VOIP_LOSS_REPORT_SIZE << it->fec.Received()
+				<< it->fec.Lost();
+			mConnections[it.key()]->write(report);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		datagramHandler
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		datagramHandler ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					This is the Qt slot that is triggered when voice datagrams arrive. Datagrams from an address
+--					without a voice connection that has said hello are dropped. The rest go through the VoiceFec of
+--					the peer, and its frames are handled like packets from the connection. A frame that was lost and
+--					not recovered is filled with silence while the peer is talking, so the jitter queue keeps its
+--					depth. While the peer is quiet the comfort noise covers the gap.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::datagramHandler()
+{
+	while (mDatagrams.hasPendingDatagrams())
+	{
+		QByteArray datagram((int)mDatagrams.pendingDatagramSize(), 0);
+		QHostAddress sender;
+		mDatagrams.readDatagram(datagram.data(), datagram.size(), &sender);
+
+		quint32 address = sender.toIPv4Address();
+
+		if (!mPeers.contains(address) || !mPeers[address].codec)
+		{
+			continue;
+		}
+
+		QList<VoiceFec::Frame> frames = mPeers[address].fec.Receive(datagram);
+
+		for (int i = 0; i < frames.size(); i++)
+		{
+			if (!frames[i].lost)
+			{
+				receivePacket(address, frames[i].type, frames[i].payload);
+			}
+			else if (mPeers[address].talking)
+			{
+				mMixer->Push(address, QByteArray(mFormat.bytesForDuration(VOIP_FRAME_MS * 1000), 0));
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		addPeer
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The socket is set up for low delay.
+--					October 19, 2026 - agent: The hello says whether this side takes voice datagrams.
+--					October 19, 2026 - agent: The hello says whether this side wants one mixed stream.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		addPeer (quint32 address, QTcpSocket * socket)
+--						quint32 address: The address of the peer.
+--						QTcpSocket * socket: The voice connection to the peer.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Saves the socket, sets it up for low delay and sends the hello with the codecs and sample rate of
+--					this side.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::addPeer(quint32 address, QTcpSocket * socket)
+{
+	connect(socket, &QTcpSocket::readyRead, this, &VoipModule::incomingDataHandler);
+	connect(socket, &QTcpSocket::disconnected, this, &VoipModule::clientDisconnectHandler);
+
+	// Socket options only take once the socket is connected
+	if (socket->state() == QAbstractSocket::ConnectedState)
+	{
+		setVoiceOptions(socket);
+	}
+	else
+	{
+		connect(socket, &QTcpSocket::connected, this, &VoipModule::connectedHandler);
+	}
+
+	Peer peer = { nullptr, mFormat.sampleRate(), QByteArray(), 0, 0, false, -1, false, VoiceFec(), false, 0, 0, 0 };
+	mConnections[address] = socket;
+	mPeers[address] = peer;
+
+	quint8 flags = mDatagrams.state() == QAbstractSocket::BoundState ? VOIP_HELLO_DATAGRAMS : 0;
+	if (mMixedMode && !mHost)
+	{
+		flags |= VOIP_HELLO_MIXED;
+	}
+
+	QByteArray hello;
+	hello << (quint8)Headers::VoiceHello << VoiceCodec::SupportedMask() << (quint32)mFormat.sampleRate() << flags;
+	socket->write(hello);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		setVoiceOptions
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setVoiceOptions (QTcpSocket * socket)
+--						QTcpSocket * socket: A connected voice socket.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Turns off Nagle so a frame is sent the moment it is written instead of waiting to be batched with
+--					the next one, and marks the traffic for low delay.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::setVoiceOptions(QTcpSocket * socket)
+{
+	socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+	socket->setSocketOption(QAbstractSocket::TypeOfServiceOption, VOIP_LOW_DELAY_TOS);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		readHello
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The shared capture is started with the first peer.
+--					October 19, 2026 - agent: Voice goes out as datagrams if the peer takes them.
+--					October 19, 2026 - agent: Notes whether the peer wants one mixed stream.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		readHello (quint32 address, const QByteArray & hello)
+--						quint32 address: The address of the peer.
+--						const QByteArray & hello: The hello the peer sent.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Settles the codec and sample rate used with the peer and makes sure the microphone is capturing.
+--					Both sides pick from the same two hellos, so they end up with the same codec and rate. The size of
+--					an encoded frame is noted so the bytes silence suppression saves can be counted. Voice is sent as
+--					datagrams if the peer says it takes them, and only the host sends to a peer that wants a mix.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::readHello(quint32 address, const QByteArray & hello)
+{
+	quint8 header;
+	quint8 mask;
+	quint32 sampleRate;
+	quint8 flags;
+
+	QDataStream stream(hello);
+	stream >> header >> mask >> sampleRate >> flags;
+
+	Peer & peer = mPeers[address];
+	peer.codec = VoiceCodec::Create(VoiceCodec::Choose(mask));
+	peer.datagrams = (flags & VOIP_HELLO_DATAGRAMS) != 0;
+	peer.mixed = (flags & VOIP_HELLO_MIXED) != 0;
+
+	if (sampleRate > 0)
+	{
+		peer.sampleRate = qMin((int)sampleRate, mFormat.sampleRate());
+	}
+
+	QVector<qint16> silence(peer.sampleRate * VOIP_FRAME_MS / 1000);
+	peer.frameBytes = VOIP_PACKET_HEADER_SIZE + peer.codec->Encode(silence.constData(), silence.size()).size();
+
+	startCapture();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		startCapture
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: The microphone is a source from the AudioBackend.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		startCapture ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Opens the microphone if it is not open already, with a buffer of the capture size. The audio is
+--					pulled from it in captureHandler, which is woken at least once a frame.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::startCapture()
+{
+	if (mInput)
+	{
+		return;
+	}
+
+	mInput = AudioBackend::CreateSource(mFormat, "microphone", this);
+	mInput->setBufferSize(mFormat.bytesForDuration(mCaptureBufferMs * 1000));
+	mInput->setNotifyInterval(VOIP_FRAME_MS);
+	mCapture = mInput->start();
+	mCaptured.clear();
+	mSilentFrames = 0;
+
+	if (mCapture)
+	{
+		connect(mCapture, &QIODevice::readyRead, this, &VoipModule::captureHandler);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		stopCapture
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		stopCapture ()
+--
+-- RETURNS:			N/A
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::stopCapture()
+{
+	if (!mInput)
+	{
+		return;
+	}
+
+	mInput->stop();
+	mInput->deleteLater();
+	mInput = nullptr;
+	mCapture = nullptr;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		sendFrame
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Frames without speech are replaced by comfort noise packets.
+--					October 19, 2026 - agent: The frame goes to every peer and is encoded once per codec and rate.
+--					October 19, 2026 - agent: Packets are sent through sendPacket.
+--					October 19, 2026 - agent: Peers in mixed mode get the mix of the host instead.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		sendFrame (const QByteArray & frame)
+--						const QByteArray & frame: One frame of captured audio.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The frame is mixed down to mono and checked for speech once. If it holds speech it is resampled to
+--					the rate of each peer and encoded with its codec, reusing the packet made for an earlier peer with
+--					the same codec and rate. Otherwise every peer gets a comfort noise packet every
+--					VOIP_COMFORT_NOISE_INTERVAL frames and the size the frame would have had is counted as saved.
+--
+--					Peers in mixed mode are skipped. The host puts the frame in their mix instead and anyone else
+--					reaches them through the host.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::sendFrame(const QByteArray & frame)
+{
+	int frames = frame.size() / mFormat.bytesPerFrame();
+
+	QVector<qint16> mono(frames);
+	AudioKernels::MapChannels((const qint16 *)frame.constData(), frames, mFormat.channelCount(), mono.data(), 1);
+
+	bool speech = mVad.IsSpeech(mono.constData(), frames);
+
+	if (bridging())
+	{
+		bridgeFrame(speech ? mono.constData() : nullptr);
+	}
+
+	if (!speech)
+	{
+		QByteArray packet;
+
+		if (mSilentFrames % VOIP_COMFORT_NOISE_INTERVAL == 0)
+		{
+			packet << (quint8)VoicePackets::ComfortNoise << (quint16)sizeof(quint16) << (quint16)mVad.NoiseLevel();
+		}
+		mSilentFrames++;
+
+		for (QMap<quint32, Peer>::iterator it = mPeers.begin(); it != mPeers.end(); ++it)
+		{
+			if (!it->codec || it->mixed)
+			{
+				continue;
+			}
+
+			if (!packet.isEmpty())
+			{
+				sendPacket(it.key(), packet);
+			}
+			it->bytesSaved += it->frameBytes - packet.size();
+		}
+		return;
+	}
+
+	mSilentFrames = 0;
+
+	// Packets already made this frame, keyed by the codec in the top byte and the rate below it
+	QMap<quint32, QByteArray> packets;
+
+	for (QMap<quint32, Peer>::iterator it = mPeers.begin(); it != mPeers.end(); ++it)
+	{
+		if (!it->codec || it->mixed)
+		{
+			continue;
+		}
+
+		quint32 key = ((quint32)it->codec->Id() << 24) | it->sampleRate;
+
+		if (!packets.contains(key))
+		{
+			int wireFrames = (int)((qint64)frames * it->sampleRate / mFormat.sampleRate());
+			QVector<qint16> wire(wireFrames);
+			AudioKernels::Resample(mono.constData(), frames, wire.data(), wireFrames, 1);
+
+			QByteArray payload = it->codec->Encode(wire.constData(), wire.size());
+
+			QByteArray packet;
+			packet << (quint8)VoicePackets::VoiceFrame << (quint16)payload.size();
+			packet.append(payload);
+			packets[key] = packet;
+		}
+
+		sendPacket(it.key(), packets[key]);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		sendPacket
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		sendPacket (quint32 address, const QByteArray & packet)
+--						quint32 address: The address of the peer.
+--						const QByteArray & packet: A voice frame or comfort noise packet.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Sends the packet as a datagram protected by the VoiceFec of the peer if it takes datagrams, or on
+--					its connection if not.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::sendPacket(quint32 address, const QByteArray & packet)
+{
+	Peer & peer = mPeers[address];
+
+	if (peer.datagrams)
+	{
+		mDatagrams.writeDatagram(peer.fec.Protect(packet), QHostAddress(address), VOIP_PORT);
+	}
+	else
+	{
+		mConnections[address]->write(packet);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		bridgeFrame
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bridgeFrame (const qint16 * local)
+--						const qint16 * local: One frame of the voice of the host in mono, nullptr while it is silent.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Called on the host once for every captured frame while a peer is in mixed mode. Mixes one frame of
+--					every voice on the bridge and sends every peer in mixed mode the mix without itself, resampled to
+--					its rate and encoded with its codec. A peer with nobody else to hear gets comfort noise at the
+--					level of the background of the host every VOIP_COMFORT_NOISE_INTERVAL frames instead.
+--
+--					The time taken for each peer is added to its CPU time, along with an even share of the mix.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::bridgeFrame(const qint16 * local)
+{
+	const int frames = mBridge->FrameSamples();
+
+	QElapsedTimer timer;
+	timer.start();
+	mBridge->Mix(local);
+	qint64 mixNs = timer.nsecsElapsed();
+
+	int listeners = 0;
+	for (const Peer & peer : mPeers)
+	{
+		if (peer.codec && peer.mixed)
+		{
+			listeners++;
+		}
+	}
+
+	for (QMap<quint32, Peer>::iterator it = mPeers.begin(); it != mPeers.end(); ++it)
+	{
+		if (!it->codec || !it->mixed)
+		{
+			continue;
+		}
+
+		timer.restart();
+
+		QByteArray packet;
+		const qint16 * mix = mBridge->MixMinus(it.key());
+
+		if (mix)
+		{
+			int wireFrames = (int)((qint64)frames * it->sampleRate / mFormat.sampleRate());
+			QVector<qint16> wire(wireFrames);
+			AudioKernels::Resample(mix, frames, wire.data(), wireFrames, 1);
+
+			QByteArray payload = it->codec->Encode(wire.constData(), wire.size());
+			packet << (quint8)VoicePackets::VoiceFrame << (quint16)payload.size();
+			packet.append(payload);
+			it->silentFrames = 0;
+		}
+		else
+		{
+			if (it->silentFrames % VOIP_COMFORT_NOISE_INTERVAL == 0)
+			{
+				packet << (quint8)VoicePackets::ComfortNoise << (quint16)sizeof(quint16) << (quint16)mVad.NoiseLevel();
+			}
+			it->silentFrames++;
+		}
+
+		if (!packet.isEmpty())
+		{
+			sendPacket(it.key(), packet);
+		}
+
+		it->cpuNs += timer.nsecsElapsed() + mixNs / listeners;
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		bridging
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		bridging ()
+--
+-- RETURNS:			True if this side is the host and at least one peer is in mixed mode.
+----------------------------------------------------------------------------------------------------------------------*/
+bool VoipModule::bridging() const
+{
+	if (!mHost)
+	{
+		return false;
+	}
+
+	for (const Peer & peer : mPeers)
+	{
+		if (peer.codec && peer.mixed)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		receiveFrames
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Comfort noise packets are passed to the mixer.
+--					October 19, 2026 - agent: Latency probes are echoed and echoes update the round trip time.
+--					October 19, 2026 - agent: Each packet is handled by receivePacket.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		receiveFrames (quint32 address)
+--						quint32 address: The address of the peer.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Splits what has arrived on the connection of the peer into whole packets and handles each one.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::receiveFrames(quint32 address)
+{
+	Peer & peer = mPeers[address];
+
+	while (peer.received.size() >= VOIP_PACKET_HEADER_SIZE)
+	{
+		quint8 type;
+		quint16 size;
+		QDataStream stream(peer.received.left(VOIP_PACKET_HEADER_SIZE));
+		stream >> type >> size;
+
+		if (peer.received.size() < VOIP_PACKET_HEADER_SIZE + size)
+		{
+			return;
+		}
+
+		QByteArray payload = peer.received.mid(VOIP_PACKET_HEADER_SIZE, size);
+		peer.received.remove(0, VOIP_PACKET_HEADER_SIZE + size);
+
+		receivePacket(address, type, payload);
+	}
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		receivePacket
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		October 19, 2026 - agent: Voice is also queued on the bridge and the time it takes is counted.
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		receivePacket (quint32 address, quint8 type, const QByteArray & payload)
+--						quint32 address: The address of the peer.
+--						quint8 type: The type of the packet from VoicePackets.
+--						const QByteArray & payload: What follows the header of the packet.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Handles one packet from the connection or a datagram of the peer. A voice frame is decoded,
+--					converted to the format of the mixer and pushed. A frame that fails to decode is dropped and the
+--					jitter queue covers the gap. A comfort noise packet sets the level of the noise the mixer plays
+--					while the peer is quiet. Probes are sent straight back, an echo of one of ours gives a new round
+--					trip time and a loss report sets how much redundancy the datagrams to the peer carry. A packet of
+--					any other type is dropped.
+--
+--					While the host is mixing for anyone, the decoded voice is queued on the bridge as well. The time
+--					spent decoding and queueing is added to the CPU time of the peer.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::receivePacket(quint32 address, quint8 type, const QByteArray & payload)
+{
+	Peer & peer = mPeers[address];
+
+	if (type == VoicePackets::LatencyProbe)
+	{
+		QByteArray echo;
+		echo << (quint8)VoicePackets::LatencyEcho << (quint16)payload.size();
+		echo.append(payload);
+		mConnections[address]->write(echo);
+		return;
+	}
+
+	if (type == VoicePackets::LatencyEcho)
+	{
+		if (payload.size() >= VOIP_PROBE_SIZE)
+		{
+			quint64 sent;
+			QDataStream(payload) >> sent;
+
+			// Smoothed the same way TCP smooths its round trip time
+			qint64 rtt = mClock.nsecsElapsed() / 1000 - (qint64)sent;
+			peer.rtt = peer.rtt < 0 ? rtt : (peer.rtt * 7 + rtt) / 8;
+
+			emit latencyMeasured(address, Latency(address));
+		}
+		return;
+	}
+
+	if (type == VoicePackets::LossReport)
+	{
+		if (payload.size() >= VOIP_LOSS_REPORT_SIZE)
+		{
+			quint32 received;
+			quint32 lost;
+			QDataStream(payload) >> received >> lost;
+
+			peer.fec.ReportedLoss(received, lost);
+
+			if (peer.datagrams && peer.fec.Stalled())
+			{
+				qWarning() << "Voice datagrams are not reaching" << QHostAddress(address).toString() << "so TCP is used instead.";
+				peer.datagrams = false;
+			}
+		}
+		return;
+	}
+
+	if (type == VoicePackets::ComfortNoise)
+	{
+		if (payload.size() >= (int)sizeof(quint16))
+		{
+			quint16 level;
+			QDataStream(payload) >> level;
+			mMixer->SetComfortNoise(address, level);
+		}
+
+		setTalking(address, false);
+		return;
+	}
+
+	// A type from a newer peer that this side does not know is dropped rather than played as noise
+	if (type != VoicePackets::VoiceFrame)
+	{
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QVector<qint16> wire = peer.codec->Decode(payload);
+
+	if (wire.isEmpty())
+	{
+		return;
+	}
+
+	int frames = (int)((qint64)wire.size() * mFormat.sampleRate() / peer.sampleRate);
+
+	QVector<qint16> mono(frames);
+	QVector<qint16> audio(frames * mFormat.channelCount());
+	AudioKernels::Resample(wire.constData(), wire.size(), mono.data(), frames, 1);
+	AudioKernels::MapChannels(mono.constData(), frames, 1, audio.data(), mFormat.channelCount());
+
+	mMixer->Push(address, QByteArray((const char *)audio.constData(), audio.size() * sizeof(qint16)));
+
+	if (bridging())
+	{
+		mBridge->Push(address, mono.constData(), frames);
+	}
+
+	peer.cpuNs += timer.nsecsElapsed();
+
+	setTalking(address, true);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		setTalking
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		setTalking (quint32 address, bool talking)
+--						quint32 address: The address of the peer.
+--						bool talking: Whether the peer is sending speech.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					Emits talkingChanged when the peer starts or stops talking.
+----------------------------------------------------------------------------------------------------------------------*/
+void VoipModule::setTalking(quint32 address, bool talking)
+{
+	Peer & peer = mPeers[address];
+
+	if (peer.talking != talking)
+	{
+		peer.talking = talking;
+		emit talkingChanged(address, talking);
+	}
 }
\ No newline at end of file
@@ -1,40 +1,118 @@
-#pragma once
-
-#include <QAudioFormat>
-#include <QAudioInput>
-#include <QAudioOutput>
-#include <QHostAddress>
-#include <QMap>
-#include <QTcpServer>
-#include <QTcpSocket>
-#include <QWidget>
-
-#include "globals.h"
-
-class VoipModule : public QWidget
-{
-	Q_OBJECT
-
-public:
-	VoipModule(QWidget * parent = nullptr);
-	~VoipModule();
-
-	void Start();
-	void Stop();
-
-private:
-	QAudioFormat mFormat;
-
-	QTcpServer mServer;
-	QMap<quint32, QTcpSocket *> mConnections;
-	QMap<quint32, QAudioInput *> mInputs;
-	QMap<quint32, QAudioOutput *> mOutputs;
-
-private slots:
-	void newConnectionHandler();
-	void incomingDataHandler();
-	void clientDisconnectHandler();
-
-public slots:
-	void newClientHandler(QHostAddress address);
-};
+#pragma once
+
+#include <QAudioFormat>
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QMap>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QWidget>
+
+#include "AudioBackend.h"
+#include "AudioKernels.h"
+#include "AudioThread.h"
+#include "globals.h"
+#include "VoiceActivityDetector.h"
+#include "VoiceBridge.h"
+#include "VoiceCodec.h"
+#include "VoiceFec.h"
+#include "VoiceMixer.h"
+
+class VoipModule : public QWidget
+{
+	Q_OBJECT
+
+public:
+	VoipModule(QWidget * parent = nullptr);
+	~VoipModule();
+
+	void Start(bool host = false);
+	void Stop();
+
+	void SetPeerGain(quint32 address, double gain);
+	void SetMixedMode(bool mixed);
+	bool IsTalking(quint32 address) const;
+	qint64 BytesSaved(quint32 address) const;
+	qint64 FramesLost(quint32 address) const;
+	qint64 FramesRecovered(quint32 address) const;
+
+	void SetBufferSizes(int captureMs, int playbackMs);
+	VoiceLatency Latency(quint32 address) const;
+	int ClockDrift(quint32 address) const;
+	double CpuLoad(quint32 address) const;
+
+private:
+	struct Peer
+	{
+		VoiceCodec * codec;
+		int sampleRate;
+		QByteArray received;
+		int frameBytes;
+		qint64 bytesSaved;
+		bool talking;
+		qint64 rtt;
+		bool datagrams;
+		VoiceFec fec;
+		bool mixed;
+		int silentFrames;
+		qint64 cpuNs;
+		double cpuLoad;
+	};
+
+	QAudioFormat mFormat;
+
+	QTcpServer mServer;
+	QUdpSocket mDatagrams;
+	QMap<quint32, QTcpSocket *> mConnections;
+	QMap<quint32, Peer> mPeers;
+	VoiceMixer * mMixer;
+	AudioThread * mAudio;
+
+	bool mHost;
+	bool mMixedMode;
+	VoiceBridge * mBridge;
+
+	AudioSource * mInput;
+	QIODevice * mCapture;
+	QByteArray mCaptured;
+	VoiceActivityDetector mVad;
+	int mSilentFrames;
+
+	int mCaptureBufferMs;
+	int mPlaybackBufferMs;
+	QTimer mProbeTimer;
+	QElapsedTimer mClock;
+
+	void addPeer(quint32 address, QTcpSocket * socket);
+	void setVoiceOptions(QTcpSocket * socket);
+	void readHello(quint32 address, const QByteArray & hello);
+	void startCapture();
+	void stopCapture();
+	void sendFrame(const QByteArray & frame);
+	void sendPacket(quint32 address, const QByteArray & packet);
+	void bridgeFrame(const qint16 * local);
+	bool bridging() const;
+	void receiveFrames(quint32 address);
+	void receivePacket(quint32 address, quint8 type, const QByteArray & payload);
+	void setTalking(quint32 address, bool talking);
+
+private slots:
+	void newConnectionHandler();
+	void incomingDataHandler();
+	void clientDisconnectHandler();
+	void captureHandler();
+	void connectedHandler();
+	void probeHandler();
+	void datagramHandler();
+
+public slots:
+	void newClientHandler(QHostAddress address);
+
+signals:
+	void talkingChanged(quint32 address, bool talking);
+	void latencyMeasured(quint32 address, VoiceLatency latency);
+};
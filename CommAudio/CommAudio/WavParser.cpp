@@ -0,0 +1,594 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		WavParser.cpp - Finds the format and the audio of a wav file by walking its chunks.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					WavParser()
+--					bool Read(QIODevice & device)
+--					bool Parse(const uchar * data, qint64 size, qint64 fileSize)
+--					bool IsValid() const
+--					QString ErrorString() const
+--					QAudioFormat Format() const
+--					quint16 FormatTag() const
+--					quint16 ValidBits() const
+--					quint32 ChannelMask() const
+--					qint64 DataOffset() const
+--					qint64 DataSize() const
+--					qint64 DataEnd() const
+--					bool Truncated() const
+--					int BytesPerSecond() const
+--					qint64 Duration() const
+--					bool parseFormat(const uchar * chunk, quint32 size)
+--					bool fail(const QString & error)
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					A wav file is a RIFF file: a "RIFF" id, the size of the rest of the file and "WAVE", followed by
+--					chunks that start with a four letter id and a little endian size. Only the "fmt " chunk, which
+--					describes the audio, and the "data" chunk, which holds it, matter for playing. Many files have
+--					others between them, such as LIST chunks with the artist and title or a fact chunk, so the offset
+--					of the audio can not be assumed to be 44. A chunk with an odd size is followed by a pad byte.
+--
+--					The file is mapped rather than read, so walking the chunks only touches the pages that hold their
+--					headers, however big the chunks in between are. A file that can not be mapped, such as one too big
+--					for the address space of a 32 bit build, falls back to reading its first WAV_HEADER_READ_SIZE
+--					bytes.
+--
+--					PCM and IEEE float audio are understood, also when wrapped in WAVE_FORMAT_EXTENSIBLE. The format
+--					is checked against itself, so a file that says it has 16 bit stereo but 6 byte frames is refused.
+--					A data chunk that claims more than the file holds, as when a download was cut short, is cut to
+--					what is there and marked as truncated. A size of zero or 0xFFFFFFFF, which some recorders leave
+--					while they write, means the audio runs to the end of the file.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "WavParser.h"
+
+#include <cstring>
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WavParser
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		WavParser ()
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The parser is not valid until a file has been read.
+----------------------------------------------------------------------------------------------------------------------*/
+WavParser::WavParser()
+	: mError("No file has been read")
+	, mTag(0)
+	, mValidBits(0)
+	, mChannelMask(0)
+	, mDataOffset(0)
+	, mDataSize(0)
+	, mTruncated(false)
+	, mValid(false)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Read
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Read (QIODevice & device)
+--						QIODevice & device: The opened wav file.
+--
+-- RETURNS:			True if the file is a wav file that can be played, otherwise false.
+--
+-- NOTES:
+--					Maps the file and parses it. A device that is not a QFile has the start of it read instead. On
+--					success the device is left at the first byte of audio.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavParser::Read(QIODevice & device)
+{
+	QFile * file = qobject_cast<QFile *>(&device);
+	qint64 size = device.size();
+	uchar * view = file && size > 0 ? file->map(0, size) : nullptr;
+	bool valid;
+
+	if (view)
+	{
+		valid = Parse(view, size, size);
+		file->unmap(view);
+	}
+	else
+	{
+		device.seek(0);
+		QByteArray start = device.read(WAV_HEADER_READ_SIZE);
+		valid = Parse((const uchar *)start.constData(), start.size(), size);
+	}
+
+	if (valid)
+	{
+		device.seek(mDataOffset);
+	}
+
+	return valid;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Parse
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Parse (const uchar * data, qint64 size, qint64 fileSize)
+--						const uchar * data: The start of the file.
+--						qint64 size: How many bytes of the file data holds.
+--						qint64 fileSize: The size of the whole file.
+--
+-- RETURNS:			True if the file is a wav file that can be played, otherwise false.
+--
+-- NOTES:
+--					Walks the chunks until the "data" chunk is found. The "fmt " chunk has to come before it, as the
+--					format says how the audio is to be cut into frames. Everything else is skipped.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavParser::Parse(const uchar * data, qint64 size, qint64 fileSize)
+{
+	*this = WavParser();
+
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+	{
+		return fail("Not a RIFF WAVE file");
+	}
+
+	bool hasFormat = false;
+	qint64 position = 12;
+
+	while (position + 8 <= size)
+	{
+		const uchar * chunk = data + position;
+		quint32 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+
+		if (memcmp(chunk, "fmt ", 4) == 0)
+		{
+			if (position + 8 + chunkSize > size)
+			{
+				return fail("The fmt chunk runs past the end of the file");
+			}
+
+			if (!parseFormat(chunk + 8, chunkSize))
+			{
+				return false;
+			}
+
+			hasFormat = true;
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			if (!hasFormat)
+			{
+				return fail("The data chunk comes before the fmt chunk");
+			}
+
+			mDataOffset = position + 8;
+			qint64 available = qMax<qint64>(0, fileSize - mDataOffset);
+
+			if (chunkSize == 0 || chunkSize == 0xFFFFFFFF)
+			{
+				mDataSize = available;
+			}
+			else
+			{
+				mDataSize = qMin<qint64>(chunkSize, available);
+				mTruncated = chunkSize > available;
+			}
+
+			// Half a frame at the end can not be played
+			mDataSize -= mDataSize % mFormat.bytesPerFrame();
+			mValid = true;
+			mError.clear();
+
+			return true;
+		}
+
+		position += 8 + (qint64)chunkSize + (chunkSize & 1);
+	}
+
+	return fail(hasFormat ? "No data chunk" : "No fmt chunk");
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		IsValid
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		IsValid ()
+--
+-- RETURNS:			True if the last file read is a wav file that can be played.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavParser::IsValid() const
+{
+	return mValid;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ErrorString
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ErrorString ()
+--
+-- RETURNS:			Why the last file read could not be played, empty if it can.
+----------------------------------------------------------------------------------------------------------------------*/
+QString WavParser::ErrorString() const
+{
+	return mError;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Format
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Format ()
+--
+-- RETURNS:			The format of the audio. 8 bit audio is unsigned, float audio is 32 bit and the rest is signed.
+----------------------------------------------------------------------------------------------------------------------*/
+QAudioFormat WavParser::Format() const
+{
+	return mFormat;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		FormatTag
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		FormatTag ()
+--
+-- RETURNS:			WAV_FORMAT_PCM or WAV_FORMAT_FLOAT, taken from the sub format of an extensible file.
+----------------------------------------------------------------------------------------------------------------------*/
+quint16 WavParser::FormatTag() const
+{
+	return mTag;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ValidBits
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ValidBits ()
+--
+-- RETURNS:			How many bits of each sample hold audio, such as 20 in a 24 bit container. The sample size for
+--					files that are not extensible.
+----------------------------------------------------------------------------------------------------------------------*/
+quint16 WavParser::ValidBits() const
+{
+	return mValidBits;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		ChannelMask
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		ChannelMask ()
+--
+-- RETURNS:			Which speaker each channel is for, 0 for files that are not extensible.
+----------------------------------------------------------------------------------------------------------------------*/
+quint32 WavParser::ChannelMask() const
+{
+	return mChannelMask;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DataOffset
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DataOffset ()
+--
+-- RETURNS:			The position in the file of the first byte of audio.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 WavParser::DataOffset() const
+{
+	return mDataOffset;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DataSize
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DataSize ()
+--
+-- RETURNS:			The number of bytes of audio in the file, always whole frames.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 WavParser::DataSize() const
+{
+	return mDataSize;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		DataEnd
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		DataEnd ()
+--
+-- RETURNS:			The position in the file where the audio ends. Chunks after it are not audio.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 WavParser::DataEnd() const
+{
+	return mDataOffset + mDataSize;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Truncated
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Truncated ()
+--
+-- RETURNS:			True if the data chunk says it holds more audio than the file does.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavParser::Truncated() const
+{
+	return mTruncated;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		BytesPerSecond
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		BytesPerSecond ()
+--
+-- RETURNS:			How many bytes of audio play each second, 0 if the parser is not valid.
+--
+-- NOTES:
+--					Worked out from the format rather than taken from the fmt chunk, which some writers get wrong.
+----------------------------------------------------------------------------------------------------------------------*/
+int WavParser::BytesPerSecond() const
+{
+	return mValid ? mFormat.sampleRate() * mFormat.bytesPerFrame() : 0;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Duration
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Duration ()
+--
+-- RETURNS:			How long the audio plays for in microseconds, 0 if the parser is not valid.
+--
+-- NOTES:
+--					Worked out in 64 bits rather than with QAudioFormat::durationForBytes, which takes a 32 bit count
+--					and would overflow on a data chunk past 2 GB.
+----------------------------------------------------------------------------------------------------------------------*/
+qint64 WavParser::Duration() const
+{
+	if (!mValid)
+	{
+		return 0;
+	}
+
+	qint64 frames = mDataSize / mFormat.bytesPerFrame();
+
+	return frames * 1000000 / mFormat.sampleRate();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		parseFormat
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		parseFormat (const uchar * chunk, quint32 size)
+--						const uchar * chunk: The body of the fmt chunk.
+--						quint32 size: The size of the body.
+--
+-- RETURNS:			True if the format can be played, otherwise false.
+--
+-- NOTES:
+--					The fmt chunk holds the tag, channels, sample rate, bytes per second, bytes per frame and bits per
+--					sample. An extensible one adds the valid bits, the channel mask and a sub format whose first two
+--					bytes are the real tag. The bytes per second are not checked since the format already gives them.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavParser::parseFormat(const uchar * chunk, quint32 size)
+{
+	if (size < 16)
+	{
+		return fail("The fmt chunk is too short");
+	}
+
+	quint16 channels = qFromLittleEndian<quint16>(chunk + 2);
+	quint32 sampleRate = qFromLittleEndian<quint32>(chunk + 4);
+	quint16 blockAlign = qFromLittleEndian<quint16>(chunk + 12);
+	quint16 bitsPerSample = qFromLittleEndian<quint16>(chunk + 14);
+
+	mTag = qFromLittleEndian<quint16>(chunk);
+	mValidBits = bitsPerSample;
+	mChannelMask = 0;
+
+	if (mTag == WAV_FORMAT_EXTENSIBLE)
+	{
+		if (size < 26)
+		{
+			return fail("The extensible fmt chunk is too short");
+		}
+
+		mValidBits = qFromLittleEndian<quint16>(chunk + 18);
+		mChannelMask = qFromLittleEndian<quint32>(chunk + 20);
+		mTag = qFromLittleEndian<quint16>(chunk + 24);
+
+		if (mValidBits == 0 || mValidBits > bitsPerSample)
+		{
+			mValidBits = bitsPerSample;
+		}
+	}
+
+	if (mTag != WAV_FORMAT_PCM && mTag != WAV_FORMAT_FLOAT)
+	{
+		return fail(QString("Format tag %1 is not PCM or float").arg(mTag, 4, 16, QChar('0')));
+	}
+
+	if (channels == 0 || sampleRate == 0)
+	{
+		return fail("The file has no channels or no sample rate");
+	}
+
+	bool integer = bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32;
+	if ((mTag == WAV_FORMAT_PCM && !integer) || (mTag == WAV_FORMAT_FLOAT && bitsPerSample != 32))
+	{
+		return fail(QString("%1 bit samples are not supported").arg(bitsPerSample));
+	}
+
+	if (blockAlign != channels * bitsPerSample / 8)
+	{
+		return fail("The size of a frame does not match the channels and sample size");
+	}
+
+	mFormat.setSampleRate(sampleRate);
+	mFormat.setChannelCount(channels);
+	mFormat.setSampleSize(bitsPerSample);
+	mFormat.setCodec("audio/pcm");
+	mFormat.setByteOrder(QAudioFormat::LittleEndian);
+
+	if (mTag == WAV_FORMAT_FLOAT)
+	{
+		mFormat.setSampleType(QAudioFormat::Float);
+	}
+	else if (bitsPerSample == 8)
+	{
+		mFormat.setSampleType(QAudioFormat::UnSignedInt);
+	}
+	else
+	{
+		mFormat.setSampleType(QAudioFormat::SignedInt);
+	}
+
+	return true;
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		fail
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		fail (const QString & error)
+--						const QString & error: Why the file can not be played.
+--
+-- RETURNS:			False, so that it can be returned straight away.
+----------------------------------------------------------------------------------------------------------------------*/
+bool WavParser::fail(const QString & error)
+{
+	mError = error;
+	mValid = false;
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QAudioFormat>
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QString>
+#include <QtEndian>
+
+#include "globals.h"
+
+class WavParser
+{
+public:
+	WavParser();
+
+	bool Read(QIODevice & device);
+	bool Parse(const uchar * data, qint64 size, qint64 fileSize);
+
+	bool IsValid() const;
+	QString ErrorString() const;
+
+	QAudioFormat Format() const;
+	quint16 FormatTag() const;
+	quint16 ValidBits() const;
+	quint32 ChannelMask() const;
+
+	qint64 DataOffset() const;
+	qint64 DataSize() const;
+	qint64 DataEnd() const;
+	bool Truncated() const;
+
+	int BytesPerSecond() const;
+	qint64 Duration() const;
+
+private:
+	QAudioFormat mFormat;
+	QString mError;
+	quint16 mTag;
+	quint16 mValidBits;
+	quint32 mChannelMask;
+	qint64 mDataOffset;
+	qint64 mDataSize;
+	bool mTruncated;
+	bool mValid;
+
+	bool parseFormat(const uchar * chunk, quint32 size);
+	bool fail(const QString & error);
+};
\ No newline at end of file
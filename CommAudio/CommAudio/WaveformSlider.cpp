@@ -0,0 +1,259 @@
+/*------------------------------------------------------------------------------------------------------------------
+-- SOURCE FILE:		WaveformSlider.cpp - A seek bar that shows the waveform of the song.
+--
+-- PROGRAM:			CommAudio
+--
+-- FUNCTIONS:
+--					WaveformSlider(QWidget * parent = nullptr)
+--					void SetPeaks(const PeakFile & peaks)
+--					void Clear()
+--					void paintEvent(QPaintEvent * event)
+--					void resizeEvent(QResizeEvent * event)
+--					QRect waveformRect()
+--					void buildColumns()
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- NOTES:
+--					The slider is drawn as usual on top of the waveform, so seeking works the same with or without
+--					one. The part of the song that has been played is drawn in the highlight colour. The waveform is
+--					reduced to a column for every pixel only when it or the width of the slider changes, which leaves
+--					two lines for every pixel to draw whenever the position moves.
+----------------------------------------------------------------------------------------------------------------------*/
+#include "WaveformSlider.h"
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		WaveformSlider
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		WaveformSlider (QWidget * parent)
+--						QWidget * parent: The parent widget.
+--
+-- RETURNS:			N/A
+--
+-- NOTES:
+--					The slider starts without a waveform and looks like a plain horizontal slider.
+----------------------------------------------------------------------------------------------------------------------*/
+WaveformSlider::WaveformSlider(QWidget * parent)
+	: QSlider(Qt::Horizontal, parent)
+{
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		SetPeaks
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		SetPeaks (const PeakFile & peaks)
+--						const PeakFile & peaks: The waveform of the song being played.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+void WaveformSlider::SetPeaks(const PeakFile & peaks)
+{
+	mPeaks = peaks;
+	buildColumns();
+	update();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		Clear
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		Clear ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Goes back to a plain slider until the waveform of the next song is set.
+----------------------------------------------------------------------------------------------------------------------*/
+void WaveformSlider::Clear()
+{
+	mPeaks = PeakFile();
+	mColumns.clear();
+	update();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		paintEvent
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		paintEvent (QPaintEvent * event)
+--						QPaintEvent * event: The part of the slider to draw.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Draws a line from the lowest to the highest sample of every column, with a darker line over it as
+--					far as the RMS reaches either side of the middle, then the slider itself on top.
+----------------------------------------------------------------------------------------------------------------------*/
+void WaveformSlider::paintEvent(QPaintEvent * event)
+{
+	if (!mColumns.isEmpty())
+	{
+		QPainter painter(this);
+		int middle = mArea.center().y();
+		double scale = mArea.height() / 65536.0;
+		int played = QStyle::sliderPositionFromValue(minimum(), maximum(), value(), mArea.width());
+
+		QColor colors[2] = { palette().color(QPalette::Mid), palette().color(QPalette::Highlight) };
+
+		for (int i = 0; i < mColumns.size(); i++)
+		{
+			const Peak & column = mColumns[i];
+			const QColor & color = colors[i < played];
+			int x = mArea.left() + i;
+			int rms = (int)(column.rms * scale);
+
+			painter.setPen(color);
+			painter.drawLine(x, middle - (int)(column.maximum * scale), x, middle - (int)(column.minimum * scale));
+			painter.setPen(color.darker(PEAK_RMS_SHADE));
+			painter.drawLine(x, middle - rms, x, middle + rms);
+		}
+	}
+
+	QSlider::paintEvent(event);
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		resizeEvent
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		resizeEvent (QResizeEvent * event)
+--						QResizeEvent * event: The new size of the slider.
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					N/A
+----------------------------------------------------------------------------------------------------------------------*/
+void WaveformSlider::resizeEvent(QResizeEvent * event)
+{
+	QSlider::resizeEvent(event);
+	buildColumns();
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		waveformRect
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		waveformRect ()
+--
+-- RETURNS:			Where the waveform is drawn.
+--
+-- NOTES:
+--					The waveform spans the groove of the slider from side to side, so the handle lines up with the
+--					part of the song it seeks to, and the whole height of the slider.
+----------------------------------------------------------------------------------------------------------------------*/
+QRect WaveformSlider::waveformRect()
+{
+	QStyleOptionSlider option;
+	initStyleOption(&option);
+
+	QRect groove = style()->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderGroove, this);
+
+	return QRect(groove.left(), 0, groove.width(), height());
+}
+
+/*------------------------------------------------------------------------------------------------------------------
+-- FUNCTION:		buildColumns
+--
+-- DATE:			October 19, 2026
+--
+-- REVISIONS:		N/A
+--
+-- DESIGNER:		agent
+--
+-- PROGRAMMER:		agent
+--
+-- INTERFACE:		buildColumns ()
+--
+-- RETURNS:			void.
+--
+-- NOTES:
+--					Merges the columns of the coarsest level that still has one for every pixel down to exactly one
+--					for every pixel, which is only a few columns each. A song too short to have that many columns is
+--					stretched across the slider instead.
+----------------------------------------------------------------------------------------------------------------------*/
+void WaveformSlider::buildColumns()
+{
+	mColumns.clear();
+	mArea = waveformRect();
+
+	if (!mPeaks.IsValid() || mArea.width() <= 0)
+	{
+		return;
+	}
+
+	const QVector<Peak> & level = mPeaks.Columns(mArea.width());
+	int width = mArea.width();
+
+	mColumns.resize(width);
+	for (int x = 0; x < width; x++)
+	{
+		int first = (int)((qint64)x * level.size() / width);
+		int last = qMax(first + 1, (int)((qint64)(x + 1) * level.size() / width));
+		Peak & column = mColumns[x];
+		double squares = 0;
+
+		column = level[first];
+		for (int i = first; i < last; i++)
+		{
+			column.minimum = qMin(column.minimum, level[i].minimum);
+			column.maximum = qMax(column.maximum, level[i].maximum);
+			squares += (double)level[i].rms * level[i].rms;
+		}
+
+		column.rms = (quint16)std::sqrt(squares / (last - first));
+	}
+}
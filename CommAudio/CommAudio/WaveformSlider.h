@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QColor>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QRect>
+#include <QResizeEvent>
+#include <QSlider>
+#include <QStyle>
+#include <QStyleOptionSlider>
+#include <QVector>
+
+#include <cmath>
+
+#include "globals.h"
+#include "PeakFile.h"
+
+// A seek bar that draws the waveform of the song behind its handle
+class WaveformSlider : public QSlider
+{
+	Q_OBJECT
+
+public:
+	WaveformSlider(QWidget * parent = nullptr);
+
+	void SetPeaks(const PeakFile & peaks);
+	void Clear();
+
+protected:
+	void paintEvent(QPaintEvent * event) override;
+	void resizeEvent(QResizeEvent * event) override;
+
+private:
+	PeakFile mPeaks;
+
+	// A column for every pixel of the waveform, made again whenever the waveform or the width changes
+	QVector<Peak> mColumns;
+	QRect mArea;
+
+	QRect waveformRect();
+	void buildColumns();
+};
@@ -36,6 +36,7 @@
 #define VOIP_PORT		42070
 #define DOWNLOAD_PORT	42071
 #define STREAM_PORT		42072
+#define PEAK_PORT		42073
 
 #define CONNECT_TIMEOUT 5 * 1000
 
@@ -46,11 +47,293 @@
 #define DOWNLOAD_CHUNCK_SIZE 8192
 #define DOWNLOAD_TIMEOUT 5 * 1000
 
-#define SUPPORTED_FORMATS { "*.wav" }
+// Header + sample rate + channels + sample size + sample type + length of the audio data
+#define STREAM_FORMAT_SIZE (1 + 4 + 2 + 2 + 1 + 4)
+
+// Header + key + song name + offset into the audio data to start streaming from
+#define STREAM_REQUEST_SIZE (1 + KEY_SIZE + SONGNAME_SIZE + 4)
+
+// Header + key + cache key of the song + offset into the audio data, sent to a peer that relays the song
+#define STREAM_RELAY_REQUEST_SIZE (1 + KEY_SIZE + CACHE_KEY_SIZE + 4)
+
+// Header + key + number of streams being uploaded + number of cache keys that follow
+#define SOURCE_ANNOUNCE_SIZE (1 + KEY_SIZE + 1 + 4)
+
+// Song name + file size + modification time of every song in a song list
+#define SONG_ENTRY_SIZE (SONGNAME_SIZE + 4 + 4)
+
+// Header + key + whether the list is replaced + number of songs removed, followed by their names, the number of songs
+// added and their entries
+#define SONG_CHANGES_SIZE (1 + KEY_SIZE + 1 + 4)
+
+#define STREAM_CACHE_FOLDER "/comm-audio/.cache"
+#define STREAM_CACHE_SIZE 512 * 1024 * 1024
+
+// Songs in the stream cache are keyed by a hex SHA-1
+#define CACHE_KEY_SIZE 40
+
+// How far ahead of the end of a song the next song is opened or streamed
+#define PREFETCH_SECONDS 5
+
+// Streamed audio is sent in frames of this many sample frames of the song, each frame is preceded by its tier, the
+// number of bytes of the song it covers and the size of its payload
+#define STREAM_FRAME_SIZE 4096
+#define STREAM_FRAME_HEADER_SIZE (1 + 4 + 4)
+#define STREAM_TIER_COUNT 4
+
+// The most a stream upload keeps queued in the socket, the less there is the faster a tier change takes effect
+#define STREAM_UPLOAD_WINDOW 64 * 1024
+
+// Seconds of buffered audio below which the receiver steps down a tier and above which it may step back up
+#define STREAM_LOW_BUFFER 2
+#define STREAM_HIGH_BUFFER 8
+#define STREAM_TIER_HOLD 3 * 1000
+
+// A song is low-passed at this fraction of the rate of a lower tier before it is resampled to it, through this many
+// biquads that together make a Butterworth filter of twice the order
+#define STREAM_TIER_CUTOFF 0.4
+#define STREAM_TIER_SECTIONS 4
+
+// A lower tier is decoded this many of its frames late, so the resampler always has the frames it looks ahead to
+#define STREAM_TIER_LEAD 8
+
+// Audio converted to a lower rate for the device is low-passed at this fraction of the new rate before it is
+// resampled, and audio converted to a higher rate is low-passed at this fraction of its own rate after
+#define CONVERTER_CUTOFF 0.45
+#define CONVERTER_SECTIONS 6
+
+// Incoming voice is mixed in frames of this many milliseconds. Each peer is buffered until it has the target number
+// of frames queued and anything past the maximum is dropped so a late burst cannot add lasting delay
+#define VOIP_FRAME_MS 20
+#define VOIP_JITTER_FRAMES 3
+#define VOIP_JITTER_MAX_FRAMES 10
+
+// The clocks of two machines never run at quite the same rate, so each peer is played a little faster or slower to
+// hold its queue at the target. The rate follows the drift of the peer and a share of how far the smoothed queue is off
+// the target, all in parts per million of the sample rate and never more than the maximum, which is far too little to
+// be heard as a change in pitch. The tracking is how fast the drift estimate moves per second of audio
+#define VOIP_DRIFT_MAX_PPM 5000
+#define VOIP_DRIFT_SMOOTHING_MS 1000
+#define VOIP_DRIFT_GAIN 2000
+#define VOIP_DRIFT_TRACKING 15
+
+// Voice is captured at this rate in mono. Each side of a voice connection first sends a hello with the codecs it
+// supports, its sample rate and its flags, the lower rate and the best shared codec are used in both directions
+#define VOIP_SAMPLE_RATE 16000
+#define VOIP_HELLO_SIZE (1 + 1 + 4 + 1)
+
+// Hello flag of a side that takes voice as datagrams on VOIP_PORT
+#define VOIP_HELLO_DATAGRAMS 0x01
+
+// Hello flag of a side that only wants one stream, mixed for it by the host, instead of a stream from every peer
+#define VOIP_HELLO_MIXED 0x02
+
+// How many frames of each voice the host queues before mixing it for the peers that want one stream
+#define VOIP_BRIDGE_JITTER_FRAMES 2
+
+// Every voice packet is preceded by its type from VoicePackets and its size
+#define VOIP_PACKET_HEADER_SIZE (1 + 2)
+
+// A frame is speech when it is this many times louder than the tracked noise floor, or a little louder with as many
+// zero crossings as a hissing consonant. Speech is held for the hangover so word endings and short pauses are sent.
+// The floor never drops under the minimum level so a dead quiet line does not make every click count as speech
+#define VOIP_VAD_ENERGY_RATIO 3.0
+#define VOIP_VAD_FRICATIVE_RATIO 1.5
+#define VOIP_VAD_FRICATIVE_ZCR 0.3
+#define VOIP_VAD_MIN_LEVEL 60
+#define VOIP_VAD_HANGOVER_FRAMES 10
+
+// While silent a comfort noise packet with the level of the background is sent once every this many frames
+#define VOIP_COMFORT_NOISE_INTERVAL 25
+
+// A voice datagram is a sequence number and a count of the voice packets that follow, the newest first and then copies
+// of the ones sent before it. The receiver reports what it got and lost every probe interval. Copies start once loss
+// reaches the minimum and one more is added for every step, both in parts per thousand
+#define VOIP_DATAGRAM_HEADER_SIZE (2 + 1)
+#define VOIP_DATAGRAM_MAX_SIZE 1200
+#define VOIP_LOSS_REPORT_SIZE (4 + 4)
+#define VOIP_FEC_MAX_DEPTH 3
+#define VOIP_FEC_MIN_LOSS 2
+#define VOIP_FEC_LOSS_STEP 50
+
+// A peer that reports no datagrams this many times in a row, while at least the given number were sent each time, is
+// sent voice over its TCP connection instead
+#define VOIP_DATAGRAM_STALL_REPORTS 2
+#define VOIP_DATAGRAM_STALL_PACKETS 10
+
+// Default sizes of the buffers of the voice capture and playback devices. Smaller buffers take delay off every frame
+// but can run dry on a busy machine
+#define VOIP_CAPTURE_BUFFER_MS 40
+#define VOIP_PLAYBACK_BUFFER_MS 40
+
+// Every peer is sent a timestamped probe this often to measure the network part of the latency
+#define VOIP_PROBE_INTERVAL 1000
+#define VOIP_PROBE_SIZE 8
+
+// Voice from at most this many peers can be mixed at once. Each has its own ring buffer to the audio thread
+#define VOIP_MAX_PEERS 16
+
+// How often an AudioThread checks how full its device is
+#define AUDIO_THREAD_NOTIFY_MS 10
+
+// The headless audio backends move audio every this many milliseconds and buffer this much unless told otherwise,
+// about what a sound card does
+#define HEADLESS_AUDIO_PERIOD_MS 10
+#define HEADLESS_AUDIO_BUFFER_MS 100
+
+// Type of service for voice sockets, DSCP expedited forwarding which routers that honour it queue ahead of bulk data
+#define VOIP_LOW_DELAY_TOS 0xB8
+
+// How many frames each codec is run over when benchmarking, and how many peers every client sends to in a 10 person
+// mesh when working out the uplink
+#define BENCHMARK_ITERATIONS 2000
+#define BENCHMARK_MESH_PEERS 9
+
+// How many small wav files the parser benchmark writes to a temporary folder and then reads back
+#define BENCHMARK_WAV_FILES 50000
+
+// How many folders the library benchmark spreads those files over
+#define BENCHMARK_LIBRARY_FOLDERS 50
+
+// Format tags of the fmt chunk of a wav file. Extensible files keep the real tag in the first two bytes of their sub
+// format
+#define WAV_FORMAT_PCM 0x0001
+#define WAV_FORMAT_FLOAT 0x0003
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+// How much of the start of a wav file is read to find its chunks when the file can not be mapped
+#define WAV_HEADER_READ_SIZE 65536
+
+// How far ahead of the play position a mapped song asks for its pages to be loaded, about 6 seconds of CD audio, and
+// what the requests are aligned to, a multiple of the page size on every platform
+#define MAPPED_SONG_READ_AHEAD (1024 * 1024)
+#define MAPPED_SONG_ALIGN 65536
+
+// How long the song that the playback benchmark reads through is
+#define BENCHMARK_SONG_SECONDS 120
+
+// The block size, LPC order and coefficient precision of the FLAC file the decoder benchmark encodes
+#define BENCHMARK_FLAC_BLOCK 4096
+#define BENCHMARK_FLAC_ORDER 8
+#define BENCHMARK_FLAC_PRECISION 12
+
+// The LPC order and coefficient precision of the short FLAC file that checks orders above 16, with a precision low
+// enough that 16 bit channels still take the SSE2 restore
+#define BENCHMARK_FLAC_HIGH_ORDER 20
+#define BENCHMARK_FLAC_HIGH_PRECISION 11
+
+// How many songs the loudness benchmark writes for the library to measure, and how long each one is
+#define BENCHMARK_LOUDNESS_SONGS 40
+#define BENCHMARK_LOUDNESS_SECONDS 30
+
+// How many songs the playlist benchmark moves through
+#define BENCHMARK_PLAYLIST_TRACKS 100000
+
+// How many seconds of audio every node of the playback chain is timed over
+#define BENCHMARK_DSP_SECONDS 60
+
+// How much audio a compressed song is decoded ahead of where it is read, how many frames are decoded at a time and how
+// long the decoder sleeps before it looks for room in its ring buffer again
+#define DECODE_AHEAD_MS 2000
+#define DECODE_CHUNK_FRAMES 4096
+#define DECODE_WAIT_MS 20
+
+// A seek in a FLAC file halves the part of the file the frame can be in until it is this many bytes, then steps
+// forward a frame at a time from there. The last frame of a file whose largest frame size is not known is looked for this far from the
+// end
+#define FLAC_SEEK_SPAN 65536
+#define FLAC_TAIL_SEARCH (1024 * 1024)
+
+// How often the player shows where it is in the song, and how much audio its output device buffers. The position
+// slider counts milliseconds
+#define MEDIA_PLAYER_NOTIFY_MS 100
+#define MEDIA_PLAYER_BUFFER_MS 200
+
+// How many songs and events can be waiting between the player and the queue on its audio thread
+#define PLAYBACK_QUEUE_MESSAGES 64
+
+// A stream is played out of a ring buffer this big. What does not fit yet is kept and moved into it every
+// PLAYBACK_FEED_MS as the audio thread makes room
+#define PLAYBACK_FEED_BYTES (1024 * 1024)
+#define PLAYBACK_FEED_MS 50
+
+// Where the index of every song folder is kept, and how many songs are parsed by one job of a library scan
+#define LIBRARY_INDEX_FOLDER "/comm-audio/.index"
+#define LIBRARY_PARSE_BATCH 256
+
+// Changes to a watched song folder are gathered until there have been none for LIBRARY_WATCH_DEBOUNCE_MS, but for no
+// longer than LIBRARY_WATCH_MAX_DELAY_MS. Songs written to in the last LIBRARY_WATCH_SETTLE_MS may still be being
+// copied in, so they are looked at again once that long has passed
+#define LIBRARY_WATCH_DEBOUNCE_MS 500
+#define LIBRARY_WATCH_MAX_DELAY_MS 3000
+#define LIBRARY_WATCH_SETTLE_MS 2000
+
+// When more songs than this change at once the local song list is built again instead of being updated
+#define LIBRARY_LIST_REBUILD_CHANGES 1000
+
+// The finest level of the waveform of a song has a column for every PEAK_BASE_FRAMES frames, and every level above it
+// has PEAK_LEVEL_FACTOR times fewer columns, up to the first level with no more than PEAK_TOP_COLUMNS
+#define PEAK_BASE_FRAMES 1024
+#define PEAK_LEVEL_FACTOR 4
+#define PEAK_TOP_COLUMNS 256
+
+// How many frames of a song are converted at a time while its waveform is worked out, and how many songs of the folder
+// are worked out at once in the background
+#define PEAK_CHUNK_FRAMES (PEAK_BASE_FRAMES * 16)
+#define PEAK_BACKGROUND_JOBS 1
+
+// Peers are only sent the levels of a waveform with no more than PEAK_SHARE_COLUMNS columns. A waveform that has
+// not arrived in PEAK_FETCH_TIMEOUT is given up on, and only the newest PEAK_REMOTE_FILES waveforms of remote songs
+// are kept
+#define PEAK_SHARE_COLUMNS 4096
+#define PEAK_FETCH_TIMEOUT 10 * 1000
+#define PEAK_REMOTE_FILES 1000
+
+// Header + key + song name
+#define PEAK_REQUEST_SIZE (1 + KEY_SIZE + SONGNAME_SIZE)
+
+// Header + length of the waveform file that follows
+#define PEAK_RESPONSE_SIZE (1 + 4)
+
+// How much darker the RMS of a column is drawn than its peaks, as a QColor::darker factor
+#define PEAK_RMS_SHADE 150
+
+// Loudness is measured in blocks of LOUDNESS_BLOCK_STEPS steps of LOUDNESS_STEP_MS, so a new block starts every step,
+// while the song is read LOUDNESS_CHUNK_FRAMES frames at a time. Blocks quieter than LOUDNESS_ABSOLUTE_GATE in LUFS,
+// or more than LOUDNESS_RELATIVE_GATE in LU below the loudness of the blocks that are left, do not count
+#define LOUDNESS_STEP_MS 100
+#define LOUDNESS_BLOCK_STEPS 4
+#define LOUDNESS_CHUNK_FRAMES 16384
+#define LOUDNESS_ABSOLUTE_GATE -70.0
+#define LOUDNESS_RELATIVE_GATE 10.0
+
+// Songs are turned up or down to play LOUDNESS_TARGET_LUFS loud, the reference level of ReplayGain 2, but never up by
+// more than LOUDNESS_MAX_BOOST_DB or so far that their loudest sample would clip
+#define LOUDNESS_TARGET_LUFS -18.0
+#define LOUDNESS_MAX_BOOST_DB 12.0
+
+// How many songs one job of the loudness analysis measures, and how many are measured before the index is saved
+#define LIBRARY_ANALYZE_BATCH 8
+#define LIBRARY_ANALYZE_PASS 256
+
+// When crossfading is on, a song fades into the next over its last CROSSFADE_MS. The chain songs are played through
+// works on at most DSP_BLOCK_FRAMES frames at a time
+#define CROSSFADE_MS 4000
+#define DSP_BLOCK_FRAMES 1024
+
+// The centre of each band of the equalizer in Hz, an octave apart, and how narrow each band is. The boosts are the
+// gain in dB of every band
+#define EQUALIZER_BANDS 10
+#define EQUALIZER_FREQUENCIES { 31.25, 62.5, 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0, 16000.0 }
+#define EQUALIZER_Q 1.41
+#define EQUALIZER_BASS_BOOST { 6.0f, 5.0f, 3.5f, 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }
+#define EQUALIZER_TREBLE_BOOST { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.5f, 3.5f, 5.0f, 6.0f }
+
+#define SUPPORTED_FORMATS { "*.wav", "*.flac" }
 
 #include <QByteArray>
 
-// Wave file header format
+// The header written at the start of new wave files. Files are read with WavParser, since most have more chunks
 struct WavHeader
 {
     char   id[4];            // should always contain "RIFF"
@@ -81,7 +364,53 @@ enum Headers
 	RespondAudioStream,
 	RequestDownload,
 	RespondDownload,
-	NotifyQuit
+	NotifyQuit,
+	RequestStreamTier,
+	RequestRelayStream,
+	AnnounceSource,
+	VoiceHello,
+	SongsChanged,
+	RequestPeaks,
+	RespondPeaks
+};
+
+// Quality tiers a song can be streamed at, from the highest bitrate to the lowest
+enum StreamTiers
+{
+	FullTier,
+	StereoTier,
+	MonoTier,
+	CompressedTier
+};
+
+// Codecs a voice stream can be sent with. LowBitrateVoiceCodec is reserved for a codec from a library, such as Opus,
+// and is never advertised or created until one is linked in
+enum VoiceCodecs
+{
+	PcmVoiceCodec,
+	AdpcmVoiceCodec,
+	LowBitrateVoiceCodec
+};
+
+// Packets sent on a voice connection after the hello, or inside a voice datagram
+enum VoicePackets
+{
+	VoiceFrame,
+	ComfortNoise,
+	LatencyProbe,
+	LatencyEcho,
+	LossReport
+};
+
+// Where the time goes between a voice being captured and being played, all in microseconds
+struct VoiceLatency
+{
+	qint64 capture;
+	qint64 network;
+	qint64 jitter;
+	qint64 playout;
+
+	qint64 total() const { return capture + network + jitter + playout; }
 };
 
 // Following functions from - https://stackoverflow.com/questions/30660127/append-quint16-unsigned-short-to-qbytearray-quickly
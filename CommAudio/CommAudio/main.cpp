@@ -1,10 +1,28 @@
-#include "CommAudio.h"
-#include <QtWidgets/QApplication>
-
-int main(int argc, char *argv[])
-{
-	QApplication a(argc, argv);
-	CommAudio w;
-	w.show();
-	return a.exec();
-}
+#include "Benchmark.h"
+#include "CommAudio.h"
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QtWidgets/QApplication>
+
+#include <cstring>
+
+int main(int argc, char *argv[])
+{
+	// The benchmark needs neither a display nor a sound card, so it runs without the GUI
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--benchmark") == 0)
+		{
+			QCoreApplication a(argc, argv);
+			QTextStream out(stdout);
+			out << Benchmark::Run().join("\n") << endl;
+			return 0;
+		}
+	}
+
+	QApplication a(argc, argv);
+
+	CommAudio w;
+	w.show();
+	return a.exec();
+}